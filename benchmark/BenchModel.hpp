@@ -0,0 +1,97 @@
+#pragma once
+
+// Task-independent model interface for the benchmark tools.
+//
+// Every task header (det/, obb/, pose/, seg/, class/) defines its own Detection, BoundingBox
+// and utils, so no translation unit can include two of them. Each task is therefore wrapped
+// in its own bench_<task>.cpp behind BenchModel, and createBenchModel() picks one by task name.
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "tools/DetectorOptions.hpp"
+
+// Stage timings of the last call, when the task class reports them
+struct BenchStageTimes {
+  bool available = false;
+  double preprocessMs = 0.0;
+  double inferenceMs = 0.0;
+  double postprocessMs = 0.0;
+};
+
+// One task output in original image coordinates; axis-aligned boxes have angle 0 and
+// classification results an empty box
+struct BenchPrediction {
+  int classId = -1;
+  float score = 0.0f;
+  cv::RotatedRect box;
+};
+
+class BenchModel {
+public:
+  virtual ~BenchModel() = default;
+
+  // Runs the task on one image / on a batch (results are discarded)
+  virtual void run(const cv::Mat& image) = 0;
+  virtual void runBatch(const std::vector<cv::Mat>& images) = 0;
+
+  // Runs the task on one image and returns its outputs (for accuracy measurements);
+  // a negative confThreshold keeps the task's default threshold
+  virtual std::vector<BenchPrediction> predict(const cv::Mat& image, float confThreshold) = 0;
+
+  virtual BenchStageTimes lastStageTimes() const { return {}; }
+  // Numeric precision detected from the model: "fp32", "fp16" or "int8"
+  virtual std::string precision() const = 0;
+  // Requested device; task classes that report the one actually used override it
+  virtual std::string device() const { return device_; }
+
+protected:
+  explicit BenchModel(const yolos::DetectorOptions& options)
+      : device_(!options.providers.empty() && yolos::isCudaProvider(options.providers.front()) ? "GPU" : "CPU") {}
+
+private:
+  std::string device_;
+};
+
+// Holds the task class; subclasses map run()/runBatch() onto its calls
+template <typename Model>
+class BenchModelAdapter : public BenchModel {
+public:
+  BenchModelAdapter(const std::string& modelPath, const std::string& labelsPath, const yolos::DetectorOptions& options)
+      : BenchModel(options), model(modelPath, labelsPath, options) {}
+
+protected:
+  Model model;
+};
+
+// One factory per task, each defined in its bench_<task>.cpp
+std::unique_ptr<BenchModel> makeDetectionBenchModel(const std::string& modelPath, const std::string& labelsPath,
+                                                    const yolos::DetectorOptions& options);
+std::unique_ptr<BenchModel> makeSegmentationBenchModel(const std::string& modelPath, const std::string& labelsPath,
+                                                       const yolos::DetectorOptions& options);
+std::unique_ptr<BenchModel> makeOBBBenchModel(const std::string& modelPath, const std::string& labelsPath,
+                                              const yolos::DetectorOptions& options);
+std::unique_ptr<BenchModel> makePoseBenchModel(const std::string& modelPath, const std::string& labelsPath,
+                                               const yolos::DetectorOptions& options);
+std::unique_ptr<BenchModel> makeClassificationBenchModel(const std::string& modelPath, const std::string& labelsPath,
+                                                         const yolos::DetectorOptions& options);
+
+// Task names accepted by createBenchModel()
+inline const std::vector<std::string>& benchTasks() {
+  static const std::vector<std::string> tasks = {"detection", "segmentation", "obb", "pose", "classification"};
+  return tasks;
+}
+
+inline std::unique_ptr<BenchModel> createBenchModel(const std::string& task, const std::string& modelPath,
+                                                    const std::string& labelsPath, const yolos::DetectorOptions& options) {
+  if (task == "detection") return makeDetectionBenchModel(modelPath, labelsPath, options);
+  if (task == "segmentation") return makeSegmentationBenchModel(modelPath, labelsPath, options);
+  if (task == "obb") return makeOBBBenchModel(modelPath, labelsPath, options);
+  if (task == "pose") return makePoseBenchModel(modelPath, labelsPath, options);
+  if (task == "classification") return makeClassificationBenchModel(modelPath, labelsPath, options);
+  throw std::runtime_error("Unsupported task type: " + task);
+}
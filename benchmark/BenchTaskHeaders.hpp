@@ -0,0 +1,46 @@
+#pragma once
+
+// Everything the task headers include, at global scope.
+//
+// Detection, BoundingBox, utils and friends are defined differently by each task header, and
+// the headers define some functions without inline. Linking two tasks into one binary would
+// then either clash or, worse, silently merge differently laid out std::vector<Detection>
+// code. Each bench_<task>.cpp therefore includes this file first and its task header inside
+// an anonymous namespace: the dependencies below are already included (their guards keep
+// them at global scope) and the task's own names get internal linkage.
+
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "tools/Debug.hpp"
+#include "tools/ScopedTimer.hpp"
+#include "tools/TensorBinding.hpp"
+#include "tools/Preprocessing.hpp"
+#include "tools/Decode.hpp"
+#include "tools/NMS.hpp"
+#include "tools/RotatedNMS.hpp"
+#include "tools/InstanceMask.hpp"
+#include "tools/CudaPipeline.hpp"
+#include "tools/SharedRuntime.hpp"
+#include "tools/DetectorOptions.hpp"
+#include "tools/ModelCache.hpp"
+#include "tools/YoloCore.hpp"
+#include "tools/Tiling.hpp"
+#include "tools/Softmax.hpp"
+#include "tools/Overlay.hpp"
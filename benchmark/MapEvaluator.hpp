@@ -0,0 +1,372 @@
+#pragma once
+
+// COCO-style mAP evaluation for the benchmark tools.
+//
+// Annotations are read either from a COCO instances JSON file (axis-aligned boxes) or from a
+// DOTA labelTxt directory (oriented boxes, one polygon per line); categories are mapped onto
+// the model's classes by name. MapEvaluator collects the predictions of every image and then
+// computes mAP@0.5 and mAP@0.5:0.95 with the COCO protocol (greedy matching by score, 101-point
+// interpolated precision, at most maxDetections per class and image, crowd / difficult objects
+// ignored).
+//
+// The evaluation is split the way pycocotools splits it, but runs in parallel: every image is
+// matched at all ten IoU thresholds at once from a single IoU matrix per class (images in
+// parallel), and the per-class precision/recall curves are then accumulated in parallel.
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "BenchModel.hpp"
+
+// One annotated object; ignored objects (COCO crowd, DOTA difficult) neither count as
+// ground truth nor turn the detections matching them into false positives
+struct EvalObject {
+  int classId = -1;
+  cv::RotatedRect box;
+  bool ignore = false;
+};
+
+struct EvalImage {
+  std::string path;
+  std::vector<EvalObject> objects;
+};
+
+struct EvalDataset {
+  std::vector<EvalImage> images;
+  int numClasses = 0;
+};
+
+struct MapResult {
+  double map50 = 0.0;         // mAP at IoU 0.5
+  double map50_95 = 0.0;      // mAP averaged over IoU 0.5:0.05:0.95
+  int images = 0;
+  int classes = 0;            // Classes with at least one ground-truth object
+};
+
+// ----------------- Geometry -----------------
+inline double evalIntersection(const cv::RotatedRect& a, const cv::RotatedRect& b) {
+  if (a.angle == 0.0f && b.angle == 0.0f) {
+    return (a.boundingRect2f() & b.boundingRect2f()).area();
+  }
+  std::vector<cv::Point2f> region;
+  if (cv::rotatedRectangleIntersection(a, b, region) == cv::INTERSECT_NONE || region.size() < 3) return 0.0;
+  std::vector<cv::Point2f> hull;
+  cv::convexHull(region, hull);
+  return cv::contourArea(hull);
+}
+
+// IoU of two (possibly rotated) boxes; 0 for empty boxes
+inline double evalIoU(const cv::RotatedRect& a, const cv::RotatedRect& b) {
+  const double areaA = static_cast<double>(a.size.area()), areaB = static_cast<double>(b.size.area());
+  if (areaA <= 0.0 || areaB <= 0.0) return 0.0;
+  const double inter = evalIntersection(a, b);
+  return inter / (areaA + areaB - inter);
+}
+
+// ----------------- Dataset loading -----------------
+namespace evaldetail {
+
+// "Small-Vehicle", "small_vehicle" and "small vehicle" all name the same class
+inline std::string normalizeName(const std::string& name) {
+  std::string out;
+  for (char c : name) {
+    if (c == '-' || c == '_') c = ' ';
+    out += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  const size_t begin = out.find_first_not_of(" \t\r");
+  const size_t end = out.find_last_not_of(" \t\r");
+  return begin == std::string::npos ? std::string() : out.substr(begin, end - begin + 1);
+}
+
+inline std::vector<std::string> readClassNames(const std::string& labelsPath) {
+  std::ifstream file(labelsPath);
+  if (!file) throw std::runtime_error("Cannot open labels file: " + labelsPath);
+  std::vector<std::string> names;
+  for (std::string line; std::getline(file, line);) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (!line.empty()) names.push_back(line);
+  }
+  return names;
+}
+
+inline int classIndex(const std::vector<std::string>& classNames, const std::string& name) {
+  const std::string key = normalizeName(name);
+  for (size_t i = 0; i < classNames.size(); ++i) {
+    if (normalizeName(classNames[i]) == key) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+} // namespace evaldetail
+
+// COCO instances JSON; images are looked up by file_name under imagesDir
+inline EvalDataset loadCocoDataset(const std::string& annotationsPath, const std::string& imagesDir,
+                                   const std::vector<std::string>& classNames) {
+  cv::FileStorage fs(annotationsPath, cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+  if (!fs.isOpened()) throw std::runtime_error("Cannot open COCO annotations: " + annotationsPath);
+
+  // Category ids are sparse (1..90 for COCO): map them by name, or by id order when no name matches
+  std::vector<std::pair<int, std::string>> categories;
+  for (const auto& c : fs["categories"]) categories.emplace_back(static_cast<int>(c["id"]), static_cast<std::string>(c["name"]));
+  std::sort(categories.begin(), categories.end());
+  std::map<int, int> categoryToClass;
+  for (const auto& [id, name] : categories) {
+    const int cls = evaldetail::classIndex(classNames, name);
+    if (cls >= 0) categoryToClass[id] = cls;
+  }
+  if (categoryToClass.empty()) {
+    for (size_t i = 0; i < categories.size() && i < classNames.size(); ++i) categoryToClass[categories[i].first] = static_cast<int>(i);
+  }
+
+  EvalDataset dataset;
+  dataset.numClasses = static_cast<int>(classNames.size());
+  std::map<int, size_t> imageIndex;
+  for (const auto& img : fs["images"]) {
+    imageIndex[static_cast<int>(img["id"])] = dataset.images.size();
+    dataset.images.push_back({(std::filesystem::path(imagesDir) / static_cast<std::string>(img["file_name"])).string(), {}});
+  }
+
+  for (const auto& ann : fs["annotations"]) {
+    const auto image = imageIndex.find(static_cast<int>(ann["image_id"]));
+    const auto cls = categoryToClass.find(static_cast<int>(ann["category_id"]));
+    if (image == imageIndex.end() || cls == categoryToClass.end()) continue;
+    std::vector<float> bbox;
+    ann["bbox"] >> bbox;
+    if (bbox.size() != 4) continue;
+    EvalObject object;
+    object.classId = cls->second;
+    object.box = cv::RotatedRect({bbox[0] + bbox[2] * 0.5f, bbox[1] + bbox[3] * 0.5f}, {bbox[2], bbox[3]}, 0.0f);
+    object.ignore = !ann["iscrowd"].empty() && static_cast<int>(ann["iscrowd"]) != 0;
+    dataset.images[image->second].objects.push_back(object);
+  }
+  return dataset;
+}
+
+// DOTA labelTxt directory: "x1 y1 x2 y2 x3 y3 x4 y4 category difficult" per object; the image of
+// label P0001.txt is P0001.{png,jpg,...} under imagesDir
+inline EvalDataset loadDotaDataset(const std::string& labelDir, const std::string& imagesDir,
+                                   const std::vector<std::string>& classNames) {
+  static const char* kExtensions[] = {".png", ".jpg", ".jpeg", ".bmp", ".tif"};
+
+  std::vector<std::filesystem::path> labelFiles;
+  for (const auto& entry : std::filesystem::directory_iterator(labelDir)) {
+    if (entry.path().extension() == ".txt") labelFiles.push_back(entry.path());
+  }
+  std::sort(labelFiles.begin(), labelFiles.end());
+
+  EvalDataset dataset;
+  dataset.numClasses = static_cast<int>(classNames.size());
+  for (const auto& labelFile : labelFiles) {
+    EvalImage image;
+    for (const char* ext : kExtensions) {
+      const auto candidate = std::filesystem::path(imagesDir) / (labelFile.stem().string() + ext);
+      if (std::filesystem::exists(candidate)) { image.path = candidate.string(); break; }
+    }
+    if (image.path.empty()) continue;
+
+    std::ifstream file(labelFile);
+    for (std::string line; std::getline(file, line);) {
+      std::istringstream fields(line);
+      std::array<cv::Point2f, 4> corners;
+      std::string category;
+      int difficult = 0;
+      bool ok = true;
+      for (auto& p : corners) ok = ok && static_cast<bool>(fields >> p.x >> p.y);
+      // Header lines ("imagesource:...", "gsd:...") do not parse as coordinates
+      if (!ok || !(fields >> category)) continue;
+      fields >> difficult;
+      const int cls = evaldetail::classIndex(classNames, category);
+      if (cls < 0) continue;
+      image.objects.push_back({cls, cv::minAreaRect(std::vector<cv::Point2f>(corners.begin(), corners.end())), difficult != 0});
+    }
+    dataset.images.push_back(std::move(image));
+  }
+  return dataset;
+}
+
+// A .json file is read as COCO, a directory as DOTA labelTxt
+inline EvalDataset loadEvalDataset(const std::string& annotationsPath, const std::string& imagesDir, const std::string& labelsPath) {
+  const std::vector<std::string> classNames = evaldetail::readClassNames(labelsPath);
+  if (std::filesystem::is_directory(annotationsPath)) return loadDotaDataset(annotationsPath, imagesDir, classNames);
+  return loadCocoDataset(annotationsPath, imagesDir, classNames);
+}
+
+// ----------------- Evaluation -----------------
+class MapEvaluator {
+public:
+  static constexpr int kThresholds = 10;      // IoU 0.50, 0.55, .., 0.95
+
+  explicit MapEvaluator(int numClasses, int maxDetections = 100)
+      : numClasses_(numClasses), maxDetections_(maxDetections) {}
+
+  // Records the ground truth and predictions of one image; like pycocotools' maxDets, the cap
+  // applies to each class of the image separately
+  void add(const std::vector<EvalObject>& objects, std::vector<BenchPrediction> predictions) {
+    std::stable_sort(predictions.begin(), predictions.end(),
+                     [](const BenchPrediction& a, const BenchPrediction& b) { return a.score > b.score; });
+    std::vector<int> kept(numClasses_, 0);
+    predictions.erase(std::remove_if(predictions.begin(), predictions.end(),
+                                     [&](const BenchPrediction& p) {
+                                       return p.classId < 0 || p.classId >= numClasses_ || kept[p.classId]++ >= maxDetections_;
+                                     }),
+                      predictions.end());
+    images_.push_back({objects, std::move(predictions)});
+  }
+
+  MapResult evaluate() const {
+    // Per image: match every detection at all thresholds (images in parallel)
+    std::vector<std::vector<Scored>> perImage(images_.size());
+    std::vector<std::vector<int>> groundTruthPerImage(images_.size(), std::vector<int>(numClasses_, 0));
+    cv::parallel_for_(cv::Range(0, static_cast<int>(images_.size())), [&](const cv::Range& range) {
+      for (int i = range.start; i < range.end; ++i) {
+        matchImage(images_[i], perImage[i], groundTruthPerImage[i]);
+      }
+    });
+
+    // Per class: gather its detections and accumulate the ten precision/recall curves
+    std::vector<std::vector<Scored>> perClass(numClasses_);
+    std::vector<int> groundTruth(numClasses_, 0);
+    for (size_t i = 0; i < images_.size(); ++i) {
+      for (const Scored& s : perImage[i]) perClass[s.classId].push_back(s);
+      for (int c = 0; c < numClasses_; ++c) groundTruth[c] += groundTruthPerImage[i][c];
+    }
+
+    std::vector<std::array<double, kThresholds>> ap(numClasses_);
+    cv::parallel_for_(cv::Range(0, numClasses_), [&](const cv::Range& range) {
+      for (int c = range.start; c < range.end; ++c) {
+        if (groundTruth[c] > 0) ap[c] = averagePrecision(perClass[c], groundTruth[c]);
+      }
+    });
+
+    MapResult result;
+    result.images = static_cast<int>(images_.size());
+    for (int c = 0; c < numClasses_; ++c) {
+      if (groundTruth[c] == 0) continue;
+      ++result.classes;
+      result.map50 += ap[c][0];
+      double sum = 0.0;
+      for (double v : ap[c]) sum += v;
+      result.map50_95 += sum / kThresholds;
+    }
+    if (result.classes > 0) {
+      result.map50 /= result.classes;
+      result.map50_95 /= result.classes;
+    }
+    return result;
+  }
+
+private:
+  struct ImageEntry {
+    std::vector<EvalObject> objects;
+    std::vector<BenchPrediction> predictions;   // Score-sorted, at most maxDetections per class
+  };
+
+  // A detection with its outcome at every threshold (bit t = IoU threshold 0.5 + 0.05 t)
+  struct Scored {
+    float score = 0.0f;
+    int classId = -1;
+    uint16_t truePositive = 0;
+    uint16_t ignored = 0;
+  };
+
+  static double threshold(int t) { return 0.5 + 0.05 * t; }
+
+  void matchImage(const ImageEntry& image, std::vector<Scored>& out, std::vector<int>& groundTruth) const {
+    for (const auto& object : image.objects) {
+      if (!object.ignore && object.classId >= 0 && object.classId < numClasses_) ++groundTruth[object.classId];
+    }
+
+    // Overlaps of every detection with every object of its class; crowd regions use the
+    // fraction of the detection they cover, as in pycocotools
+    const size_t numObjects = image.objects.size();
+    std::vector<double> overlap(image.predictions.size() * numObjects, 0.0);
+    for (size_t d = 0; d < image.predictions.size(); ++d) {
+      const BenchPrediction& p = image.predictions[d];
+      for (size_t g = 0; g < numObjects; ++g) {
+        const EvalObject& o = image.objects[g];
+        if (o.classId != p.classId) continue;
+        if (o.ignore) {
+          const double area = p.box.size.area();
+          overlap[d * numObjects + g] = area > 0.0 ? evalIntersection(p.box, o.box) / area : 0.0;
+        } else {
+          overlap[d * numObjects + g] = evalIoU(p.box, o.box);
+        }
+      }
+    }
+
+    std::vector<uint16_t> taken(numObjects, 0);   // Bit t: object matched at threshold t
+    for (size_t d = 0; d < image.predictions.size(); ++d) {
+      const BenchPrediction& p = image.predictions[d];
+      if (p.classId < 0 || p.classId >= numClasses_) continue;
+      Scored scored{p.score, p.classId, 0, 0};
+      for (int t = 0; t < kThresholds; ++t) {
+        const uint16_t bit = static_cast<uint16_t>(1u << t);
+        const double minOverlap = std::min(threshold(t), 1.0 - 1e-10);
+        // Best free real object; an ignored object (which may absorb any number of detections)
+        // only when no real one matches
+        int best = -1;
+        double bestOverlap = minOverlap;
+        for (size_t g = 0; g < numObjects; ++g) {
+          const double v = overlap[d * numObjects + g];
+          if (image.objects[g].ignore || (taken[g] & bit) || image.objects[g].classId != p.classId || v < bestOverlap) continue;
+          best = static_cast<int>(g);
+          bestOverlap = v;
+        }
+        if (best >= 0) {
+          scored.truePositive |= bit;
+          taken[best] |= bit;
+          continue;
+        }
+        for (size_t g = 0; g < numObjects; ++g) {
+          if (image.objects[g].ignore && image.objects[g].classId == p.classId && overlap[d * numObjects + g] >= minOverlap) {
+            scored.ignored |= bit;
+            break;
+          }
+        }
+      }
+      out.push_back(scored);
+    }
+  }
+
+  static std::array<double, kThresholds> averagePrecision(std::vector<Scored> detections, int groundTruth) {
+    std::stable_sort(detections.begin(), detections.end(), [](const Scored& a, const Scored& b) { return a.score > b.score; });
+    std::array<double, kThresholds> ap{};
+    std::vector<double> precision, recall;
+    for (int t = 0; t < kThresholds; ++t) {
+      const uint16_t bit = static_cast<uint16_t>(1u << t);
+      precision.clear();
+      recall.clear();
+      int tp = 0, fp = 0;
+      for (const Scored& s : detections) {
+        if (s.ignored & bit) continue;
+        (s.truePositive & bit) ? ++tp : ++fp;
+        precision.push_back(static_cast<double>(tp) / (tp + fp));
+        recall.push_back(static_cast<double>(tp) / groundTruth);
+      }
+      // Precision envelope, then sampled at recall 0, 0.01, .., 1
+      for (size_t i = precision.size(); i-- > 1;) precision[i - 1] = std::max(precision[i - 1], precision[i]);
+      double sum = 0.0;
+      for (int r = 0; r <= 100; ++r) {
+        const auto it = std::lower_bound(recall.begin(), recall.end(), r / 100.0);
+        if (it != recall.end()) sum += precision[it - recall.begin()];
+      }
+      ap[t] = sum / 101.0;
+    }
+    return ap;
+  }
+
+  int numClasses_;
+  int maxDetections_;
+  std::vector<ImageEntry> images_;
+};
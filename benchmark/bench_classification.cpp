@@ -0,0 +1,29 @@
+// BenchModel for image classification (YOLOv8 / YOLO11 classifiers, 224x224 input)
+
+#include "BenchModel.hpp"
+#include "BenchTaskHeaders.hpp"
+
+namespace {
+
+#include "class/YOLO11CLASS.hpp"
+
+class ClassificationBenchModel : public BenchModelAdapter<YOLO11Classifier> {
+public:
+  using BenchModelAdapter::BenchModelAdapter;
+
+  void run(const cv::Mat& image) override { model.classify(image); }
+  void runBatch(const std::vector<cv::Mat>& images) override { model.classifyBatch(images); }
+
+  std::vector<BenchPrediction> predict(const cv::Mat& image, float) override {
+    const ClassificationResult result = model.classify(image);
+    return {{result.classId, result.confidence, cv::RotatedRect()}};
+  }
+  std::string precision() const override { return model.getPrecision(); }
+};
+
+} // namespace
+
+std::unique_ptr<BenchModel> makeClassificationBenchModel(const std::string& modelPath, const std::string& labelsPath,
+                                                         const yolos::DetectorOptions& options) {
+  return std::make_unique<ClassificationBenchModel>(modelPath, labelsPath, options);
+}
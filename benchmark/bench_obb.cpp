@@ -0,0 +1,33 @@
+// BenchModel for oriented bounding boxes (YOLOv8 / YOLO11 output layout)
+
+#include "BenchModel.hpp"
+#include "BenchTaskHeaders.hpp"
+
+namespace {
+
+#include "obb/YOLO11-OBB.hpp"
+
+class OBBBenchModel : public BenchModelAdapter<YOLO11OBBDetector> {
+public:
+  using BenchModelAdapter::BenchModelAdapter;
+
+  void run(const cv::Mat& image) override { model.detect(image); }
+  void runBatch(const std::vector<cv::Mat>& images) override { model.detectBatch(images); }
+
+  std::vector<BenchPrediction> predict(const cv::Mat& image, float confThreshold) override {
+    std::vector<BenchPrediction> predictions;
+    for (const auto& d : confThreshold < 0.0f ? model.detect(image) : model.detect(image, confThreshold)) {
+      const float degrees = d.box.angle * 180.0f / static_cast<float>(CV_PI);
+      predictions.push_back({d.classId, d.conf, cv::RotatedRect({d.box.x, d.box.y}, {d.box.width, d.box.height}, degrees)});
+    }
+    return predictions;
+  }
+  std::string precision() const override { return model.getPrecision(); }
+};
+
+} // namespace
+
+std::unique_ptr<BenchModel> makeOBBBenchModel(const std::string& modelPath, const std::string& labelsPath,
+                                              const yolos::DetectorOptions& options) {
+  return std::make_unique<OBBBenchModel>(modelPath, labelsPath, options);
+}
@@ -0,0 +1,33 @@
+// BenchModel for pose estimation (YOLOv8 / YOLO11 output layout)
+
+#include "BenchModel.hpp"
+#include "BenchTaskHeaders.hpp"
+
+namespace {
+
+#include "pose/YOLO11-POSE.hpp"
+
+class PoseBenchModel : public BenchModelAdapter<YOLO11POSEDetector> {
+public:
+  using BenchModelAdapter::BenchModelAdapter;
+
+  void run(const cv::Mat& image) override { model.detect(image); }
+  void runBatch(const std::vector<cv::Mat>& images) override { model.detectBatch(images); }
+
+  std::vector<BenchPrediction> predict(const cv::Mat& image, float confThreshold) override {
+    std::vector<BenchPrediction> predictions;
+    for (const auto& d : confThreshold < 0.0f ? model.detect(image) : model.detect(image, confThreshold)) {
+      const cv::Rect2f box(d.box.x, d.box.y, d.box.width, d.box.height);
+      predictions.push_back({d.classId, d.conf, cv::RotatedRect((box.tl() + box.br()) * 0.5f, box.size(), 0.0f)});
+    }
+    return predictions;
+  }
+  std::string precision() const override { return model.getPrecision(); }
+};
+
+} // namespace
+
+std::unique_ptr<BenchModel> makePoseBenchModel(const std::string& modelPath, const std::string& labelsPath,
+                                               const yolos::DetectorOptions& options) {
+  return std::make_unique<PoseBenchModel>(modelPath, labelsPath, options);
+}
@@ -0,0 +1,39 @@
+// BenchModel for instance segmentation (YOLOv8 / YOLO11 output layout)
+
+#include "BenchModel.hpp"
+#include "BenchTaskHeaders.hpp"
+
+// The segmentation header defines its own DEBUG_PRINT
+#undef DEBUG_PRINT
+
+namespace {
+
+#include "seg/YOLO11Seg.hpp"
+
+class SegmentationBenchModel : public BenchModelAdapter<YOLOv11SegDetector> {
+public:
+  using BenchModelAdapter::BenchModelAdapter;
+
+  void run(const cv::Mat& image) override { model.segment(image); }
+  void runBatch(const std::vector<cv::Mat>& images) override { model.segmentBatch(images); }
+
+  std::vector<BenchPrediction> predict(const cv::Mat& image, float confThreshold) override {
+    // Only the boxes are compared, so the masks are never rendered
+    model.setDeferredMasks(true);
+    std::vector<BenchPrediction> predictions;
+    for (const auto& s : confThreshold < 0.0f ? model.segment(image) : model.segment(image, confThreshold)) {
+      const cv::Rect2f box(s.box.x, s.box.y, s.box.width, s.box.height);
+      predictions.push_back({s.classId, s.conf, cv::RotatedRect((box.tl() + box.br()) * 0.5f, box.size(), 0.0f)});
+    }
+    model.setDeferredMasks(false);
+    return predictions;
+  }
+  std::string precision() const override { return model.getPrecision(); }
+};
+
+} // namespace
+
+std::unique_ptr<BenchModel> makeSegmentationBenchModel(const std::string& modelPath, const std::string& labelsPath,
+                                                       const yolos::DetectorOptions& options) {
+  return std::make_unique<SegmentationBenchModel>(modelPath, labelsPath, options);
+}
@@ -1,15 +1,22 @@
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <sstream>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 #include <cstdio>
 #include <ctime>
@@ -17,8 +24,11 @@
 #include <opencv2/opencv.hpp>
 
 // Project headers
-#include "det/YOLO.hpp"
-#include "tools/ScopedTimer.hpp"
+#include "BenchModel.hpp"
+#include "MapEvaluator.hpp"
+#include "tools/LatencyHistogram.hpp"
+#include "tools/RingQueue.hpp"
+#include "tools/Instrumentation.hpp"
 
 #ifdef DEBUG
   #define DBG_STDOUT 1
@@ -38,6 +48,7 @@
   #include <psapi.h>
   #pragma comment(lib, "psapi.lib")
 #else
+  #include <sched.h>
   #include <sys/resource.h>
   #include <sys/stat.h>
   #include <unistd.h>
@@ -49,10 +60,40 @@ struct BenchmarkConfig {
   std::string model_path;
   std::string labels_path;
   bool use_gpu = false;
-  int thread_count = 1;
+  int thread_count = 0;               // Intra-op threads, 0 = detector default
   bool quantized = false;
-  std::string precision = "fp32";
+  std::string precision = "fp32";     // Detected from the model once it is loaded
   std::string device = "CPU";
+  std::vector<yolos::InputBucket> buckets;  // Input buckets of dynamic-shape models (empty = none)
+  std::string reference_path;         // Model the outputs are compared with (e.g. the FP32 export)
+  int agreement_frames = 100;         // Frames of a video compared with the reference
+
+  // mAP evaluation (empty annotations_path = none)
+  std::string annotations_path;       // COCO instances JSON or DOTA labelTxt directory
+  std::string images_dir;             // Images the annotations refer to
+  float eval_conf = 0.001f;           // Confidence threshold while evaluating
+  int eval_images = 0;                // Images evaluated (0 = all)
+
+  // Measurement protocol
+  int iterations = 100;               // Measured runs per trial (image mode)
+  int duration_seconds = 30;          // Measured time per trial (camera mode)
+  int trials = 1;                     // Independent trials, each with a fresh detector
+  int warmup_min = 10;                // Warmup runs before the steady-state check
+  int warmup_max = 500;               // Warmup cap when the latency never settles
+  int steady_window = 10;             // Runs per steady-state window
+  double steady_tolerance = 0.05;     // Steady once two consecutive window means differ by less than this
+  std::vector<int> pin_cores;         // Cores to pin the process to (empty = no pinning)
+  std::string json_path;              // JSON results file (empty = none in single-run modes)
+  std::string trace_path;             // Chrome trace of the run (empty = no trace)
+  std::string metrics_path;           // Prometheus dump of the stage histograms (empty = none)
+
+  // Throughput mode: every combination is one point of the sweep
+  std::vector<int> sweep_workers;     // Concurrent detectors (empty = 1, 2, 4, .. up to the core count)
+  std::vector<int> sweep_threads;     // Intra-op threads per detector (empty = cores / workers)
+  std::vector<int> sweep_streams{1, 2, 4, 8, 16};  // Closed-loop request streams
+  std::vector<int> sweep_batch{1};    // Most requests a worker merges into one batched call
+  int point_seconds = 5;              // Measured time per point
+  double p99_budget_ms = 0.0;         // Latency budget for the recommended split (0 = none)
 };
 
 struct PerformanceMetrics {
@@ -63,7 +104,9 @@ struct PerformanceMetrics {
   double total_avg_ms = 0.0;
   double fps = 0.0;
   double memory_mb = 0.0;
-  double map_score = 0.0;
+  double map_score = 0.0;             // mAP@0.5:0.95 on the annotation set (0 when not evaluated)
+  double map50 = 0.0;                 // mAP@0.5
+  int map_images = 0;                 // Annotated images evaluated
   int frame_count = 0;
 
   // Extra monitoring
@@ -76,6 +119,30 @@ struct PerformanceMetrics {
   double latency_min_ms = 0.0;
   double latency_max_ms = 0.0;
   std::string environment_type = "CPU";
+
+  // Tail latency over all trials (HDR histograms)
+  double latency_p50_ms = 0.0;
+  double latency_p90_ms = 0.0;
+  double latency_p99_ms = 0.0;
+  double latency_p999_ms = 0.0;
+  double preprocess_p99_ms = 0.0;
+  double inference_p99_ms = 0.0;
+  double postprocess_p99_ms = 0.0;
+  int warmup_frames = 0;              // Warmup runs of the first trial until steady state
+  int trials = 1;
+
+  // 95% confidence half-widths across trials (0 with a single trial)
+  double total_avg_ci95_ms = 0.0;
+  double latency_p99_ci95_ms = 0.0;
+  double fps_ci95 = 0.0;
+
+  // Per-trial values: total_avg_ms, latency_p99_ms, fps
+  std::vector<double> trial_avg_ms, trial_p99_ms, trial_fps;
+
+  // Comparison with the reference model (--reference), -1 when not measured
+  double agreement = -1.0;            // Detection F1 at IoU 0.5 / top-1 agreement with the reference outputs
+  double reference_avg_ms = -1.0;     // Mean latency of the reference on the same frames
+  double speedup = -1.0;              // reference_avg_ms / mean latency of the model on those frames
 };
 
 // ----------------- Monitoring -----------------
@@ -157,322 +224,623 @@ double getCurrentMemoryUsageMB() {
 #endif
 }
 
-// ----------------- Detector wrapper -----------------
-class DetectorFactory {
+// ----------------- Resource sampling -----------------
+// Samples CPU/GPU usage on its own thread, so the nvidia-smi call stays out of the timed loop
+class ResourceSampler {
 public:
-  static std::unique_ptr<YOLODetector> createDetector(const BenchmarkConfig& config) {
-    bool is_quantized = config.model_path.find("quantized") != std::string::npos;
-
-    if (config.model_type == "yolo11" && config.task_type == "detection") {
-      if (is_quantized) DEBUG_LOG("Note: Testing YOLO11 quantized model (smaller size)\n");
-      return std::make_unique<YOLODetector>(config.model_path, config.labels_path, config.use_gpu);
-    } else if (config.model_type == "yolo8" && config.task_type == "detection") {
-      if (is_quantized) DEBUG_LOG("Note: Testing YOLO8 quantized model (smaller size)\n");
-      else DEBUG_LOG("Note: Using YOLO11 detector for YOLO8 model (compat mode)\n");
-      return std::make_unique<YOLODetector>(config.model_path, config.labels_path, config.use_gpu);
-    } else if (config.model_type == "yolo11_quantized" && config.task_type == "detection") {
-      DEBUG_LOG("Note: Testing YOLO11 quantized model (smaller size)\n");
-      return std::make_unique<YOLODetector>(config.model_path, config.labels_path, config.use_gpu);
-    } else if (config.model_type == "yolo8_quantized" && config.task_type == "detection") {
-      DEBUG_LOG("Note: Testing YOLO8 quantized model (smaller size)\n");
-      return std::make_unique<YOLODetector>(config.model_path, config.labels_path, config.use_gpu);
-    }
-
-    throw std::runtime_error("Unsupported model type: " + config.model_type + " with task: " + config.task_type);
+  explicit ResourceSampler(std::chrono::milliseconds period = std::chrono::milliseconds(250)) {
+    SystemMonitor::getCPUUsage();
+    worker = std::thread([this, period]() {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (!stopped) {
+        if (stopSignal.wait_for(lock, period, [this]() { return stopped; })) break;
+        lock.unlock();
+        double cpu = SystemMonitor::getCPUUsage();
+        auto gpu   = SystemMonitor::getGPUUsage();
+        lock.lock();
+        cpu_samples.push_back(cpu);
+        gpu_samples.push_back(gpu.first);
+        gpu_mem_samples.push_back(gpu.second);
+      }
+    });
   }
 
-  static std::vector<Detection> detect(YOLODetector* detector, const BenchmarkConfig&, const cv::Mat& image) {
-    static int call_count = 0; call_count++;
-    if (call_count <= 3) {
-      DEBUG_LOG("  Processing frame " << call_count << " | Input: " << image.cols << "x" << image.rows
-                 << " -> Model Input: 640x640\n");
+  ~ResourceSampler() { stop(); }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopped = true;
     }
-    return detector->detect(image);
+    stopSignal.notify_all();
+    if (worker.joinable()) worker.join();
   }
-};
-
-// ----------------- Bench: Image -----------------
-PerformanceMetrics benchmark_image_comprehensive(BenchmarkConfig& config,
-                                                 const std::string& image_path,
-                                                 int iterations = 100) {
-  PerformanceMetrics metrics;
-
-  auto load_start = std::chrono::high_resolution_clock::now();
-  auto detector   = DetectorFactory::createDetector(config);
-  config.device = detector->getDevice();
-  auto load_end   = std::chrono::high_resolution_clock::now();
-  metrics.load_time_ms = std::chrono::duration<double, std::milli>(load_end - load_start).count();
 
-  metrics.environment_type = config.device;
-
-  cv::Mat image = cv::imread(image_path);
-  if (image.empty()) throw std::runtime_error("Could not read image: " + image_path);
+  std::vector<double> cpu_samples, gpu_samples, gpu_mem_samples;   // Read after stop()
 
-  std::vector<double> preprocess_times, inference_times, postprocess_times, total_times, latency_times;
-
-  for (int i = 0; i < 10; ++i) DetectorFactory::detect(detector.get(), config, image); // warmup
-
-  double initial_memory = getCurrentMemoryUsageMB();
-  double initial_sys_memory = SystemMonitor::getSystemMemoryUsage();
-  SystemMonitor::getCPUUsage();
-
-  std::vector<double> cpu_samples, gpu_samples, gpu_mem_samples;
+private:
+  std::thread worker;
+  std::mutex mutex;
+  std::condition_variable stopSignal;
+  bool stopped = false;
+};
 
-  for (int i = 0; i < iterations; ++i) {
-    double cpu = SystemMonitor::getCPUUsage();
-    auto gpu   = SystemMonitor::getGPUUsage();
-    cpu_samples.push_back(cpu);
-    gpu_samples.push_back(gpu.first);
-    gpu_mem_samples.push_back(gpu.second);
+// ----------------- Core pinning -----------------
+// Pins the whole process; threads created afterwards (ONNX Runtime's pools) inherit the mask
+static bool pinToCores(const std::vector<int>& cores) {
+  if (cores.empty()) return true;
+#if defined(_WIN32)
+  DWORD_PTR mask = 0;
+  for (int c : cores) mask |= (DWORD_PTR(1) << c);
+  return SetProcessAffinityMask(GetCurrentProcess(), mask) != 0;
+#elif defined(__linux__)
+  cpu_set_t set; CPU_ZERO(&set);
+  for (int c : cores) CPU_SET(c, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  return false; // No affinity API (macOS)
+#endif
+}
 
-    cv::TickMeter tm; tm.start();
-    auto total_start = std::chrono::high_resolution_clock::now();
-    auto infer_start = std::chrono::high_resolution_clock::now();
-    auto results     = DetectorFactory::detect(detector.get(), config, image); (void)results;
-    auto infer_end   = std::chrono::high_resolution_clock::now();
-    auto total_end   = std::chrono::high_resolution_clock::now();
-    tm.stop();
+// ----------------- Statistics -----------------
+static double mean(const std::vector<double>& v) {
+  return v.empty() ? 0.0 : std::accumulate(v.begin(), v.end(), 0.0) / v.size();
+}
 
-    double infer_ms  = std::chrono::duration<double, std::milli>(infer_end - infer_start).count();
-    double total_ms  = std::chrono::duration<double, std::milli>(total_end - total_start).count();
-    double latency   = tm.getTimeMilli();
+// Half-width of the 95% confidence interval of the mean (Student's t)
+static double ci95(const std::vector<double>& v) {
+  if (v.size() < 2) return 0.0;
+  static const double t975[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+  const double m = mean(v);
+  double ss = 0.0;
+  for (double x : v) ss += (x - m) * (x - m);
+  const double stddev = std::sqrt(ss / (v.size() - 1));
+  const size_t df = v.size() - 1;
+  const double t = df <= 30 ? t975[df - 1] : 1.960;
+  return t * stddev / std::sqrt(static_cast<double>(v.size()));
+}
 
-    preprocess_times.push_back(0.0);
-    inference_times.push_back(infer_ms);
-    postprocess_times.push_back(0.0);
-    total_times.push_back(total_ms);
-    latency_times.push_back(latency);
+// ----------------- Model wrapper -----------------
+// Every task goes through BenchModel (see BenchModel.hpp); YOLODetector, the OBB, pose and
+// segmentation detectors and the classifier each read the output layouts of several versions
+class DetectorFactory {
+public:
+  static yolos::DetectorOptions makeOptions(const BenchmarkConfig& config, int thread_count) {
+    yolos::DetectorOptions options = yolos::DetectorOptions::fromUseGPU(config.use_gpu);
+    if (thread_count > 0) options.intraOpThreads = thread_count;
+    options.inputBuckets = config.buckets;
+    return options;
   }
 
-  double final_memory = getCurrentMemoryUsageMB();
-  double final_sys_memory = SystemMonitor::getSystemMemoryUsage();
-  metrics.memory_mb = final_memory - initial_memory;
-  metrics.system_memory_used_mb = final_sys_memory - initial_sys_memory;
+  static std::unique_ptr<BenchModel> createDetector(const BenchmarkConfig& config) {
+    return createDetector(config, config.thread_count);
+  }
 
-  auto avg    = [](const std::vector<double>& v){ return v.empty()? 0.0 : std::accumulate(v.begin(), v.end(), 0.0)/v.size(); };
-  auto minmax = [](const std::vector<double>& v){ if (v.empty()) return std::make_pair(0.0,0.0); auto mm = std::minmax_element(v.begin(), v.end()); return std::make_pair(*mm.first, *mm.second); };
+  static std::unique_ptr<BenchModel> createDetector(const BenchmarkConfig& config, int thread_count) {
+    if (config.model_type.rfind("yolo", 0) != 0) {
+      throw std::runtime_error("Unsupported model type: " + config.model_type + " with task: " + config.task_type);
+    }
+    if (config.model_path.find("quantized") != std::string::npos) {
+      DEBUG_LOG("Note: Testing " << config.model_type << " quantized model (smaller size)\n");
+    }
+    return createBenchModel(config.task_type, config.model_path, config.labels_path, makeOptions(config, thread_count));
+  }
 
-  metrics.preprocess_avg_ms = avg(preprocess_times);
-  metrics.inference_avg_ms  = avg(inference_times);
-  metrics.postprocess_avg_ms= avg(postprocess_times);
-  metrics.total_avg_ms      = avg(total_times);
-  metrics.fps               = (metrics.total_avg_ms > 0.0) ? (1000.0 / metrics.total_avg_ms) : 0.0;
+  static void detect(BenchModel* detector, const BenchmarkConfig&, const cv::Mat& image) {
+    static int call_count = 0; call_count++;
+    if (call_count <= 3) {
+      DEBUG_LOG("  Processing frame " << call_count << " | Input: " << image.cols << "x" << image.rows << "\n");
+    }
+    detector->run(image);
+  }
+};
 
-  metrics.latency_avg_ms = avg(latency_times);
-  auto lat = minmax(latency_times);
-  metrics.latency_min_ms = lat.first;
-  metrics.latency_max_ms = lat.second;
+// ----------------- Measurement -----------------
+// Next frame of a trial; returns false when the input is exhausted
+using FrameSource = std::function<bool(cv::Mat&)>;
 
-  metrics.cpu_usage_percent = avg(cpu_samples);
-  metrics.gpu_usage_percent = avg(gpu_samples);
-  metrics.gpu_memory_used_mb= avg(gpu_mem_samples);
+struct TrialResult {
+  double load_time_ms = 0.0;
+  double wall_time_ms = 0.0;
+  int warmup_frames = 0;
+  yolos::LatencyHistogram total, preprocess, inference, postprocess;
+};
 
-  metrics.frame_count = iterations;
-  return metrics;
+// Warms up on one frame: at least warmup_min runs, then windows of steady_window runs
+// until two consecutive window means differ by less than steady_tolerance (or warmup_max)
+static int warmUp(BenchModel* detector, const BenchmarkConfig& cfg, const cv::Mat& frame) {
+  auto timedRun = [&]() {
+    auto start = std::chrono::steady_clock::now();
+    DetectorFactory::detect(detector, cfg, frame);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  int runs = 0;
+  for (; runs < cfg.warmup_min; ++runs) timedRun();
+
+  const int window = std::max(1, cfg.steady_window);
+  double previous = -1.0;
+  while (runs < cfg.warmup_max) {
+    std::vector<double> times;
+    for (int i = 0; i < window && runs < cfg.warmup_max; ++i, ++runs) times.push_back(timedRun());
+    const double current = mean(times);
+    if (previous > 0.0 && std::abs(current - previous) <= cfg.steady_tolerance * previous) break;
+    previous = current;
+  }
+  return runs;
 }
 
-// ----------------- Bench: Video file -----------------
-PerformanceMetrics benchmark_video_comprehensive(BenchmarkConfig& config,
-                                                 const std::string& video_path) {
-  PerformanceMetrics metrics;
+// One trial: fresh detector, warmup to steady state, then timed runs over the frame source
+static TrialResult runTrial(BenchmarkConfig& config, const FrameSource& next) {
+  TrialResult trial;
 
-  auto load_start = std::chrono::high_resolution_clock::now();
+  auto load_start = std::chrono::steady_clock::now();
   auto detector   = DetectorFactory::createDetector(config);
-  config.device = detector->getDevice();
-  auto load_end   = std::chrono::high_resolution_clock::now();
-  metrics.load_time_ms = std::chrono::duration<double, std::milli>(load_end - load_start).count();
+  config.device = detector->device();
+  config.precision = detector->precision();
+  trial.load_time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
 
-  metrics.environment_type = config.device;
-
-  cv::VideoCapture cap(video_path);
-  if (!cap.isOpened()) throw std::runtime_error("Could not open video: " + video_path);
+  cv::Mat frame;
+  if (!next(frame) || frame.empty()) throw std::runtime_error("No input frame to benchmark");
+  trial.warmup_frames = warmUp(detector.get(), config, frame);
+
+  auto start_time = std::chrono::steady_clock::now();
+  do {
+    if (frame.empty()) continue;
+    auto frame_start = std::chrono::steady_clock::now();
+    DetectorFactory::detect(detector.get(), config, frame);
+    auto frame_end   = std::chrono::steady_clock::now();
+
+    trial.total.recordMs(std::chrono::duration<double, std::milli>(frame_end - frame_start).count());
+    const BenchStageTimes stages = detector->lastStageTimes();
+    if (stages.available) {
+      trial.preprocess.recordMs(stages.preprocessMs);
+      trial.inference.recordMs(stages.inferenceMs);
+      trial.postprocess.recordMs(stages.postprocessMs);
+    }
+  } while (next(frame));
+  trial.wall_time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  return trial;
+}
 
-  std::vector<double> frame_times, latency_times;
-  std::vector<double> cpu_samples, gpu_samples, gpu_mem_samples;
+// Runs config.trials trials; makeSource(trial) opens the input of a trial
+static PerformanceMetrics runBenchmark(BenchmarkConfig& config, const std::function<FrameSource(int)>& makeSource) {
+  PerformanceMetrics metrics;
+  yolos::LatencyHistogram total, preprocess, inference, postprocess;
+  std::vector<double> load_times;
 
   double initial_memory = getCurrentMemoryUsageMB();
   double initial_sys_memory = SystemMonitor::getSystemMemoryUsage();
-  SystemMonitor::getCPUUsage();
-
-  auto start_time = std::chrono::high_resolution_clock::now();
-  int frame_count = 0;
-  cv::Mat frame;
-
-  while (cap.read(frame) && !frame.empty()) {
-    double cpu = SystemMonitor::getCPUUsage();
-    auto gpu   = SystemMonitor::getGPUUsage();
-    cpu_samples.push_back(cpu);
-    gpu_samples.push_back(gpu.first);
-    gpu_mem_samples.push_back(gpu.second);
-
-    cv::TickMeter tm; tm.start();
-    auto frame_start = std::chrono::high_resolution_clock::now();
-    auto results     = DetectorFactory::detect(detector.get(), config, frame); (void)results;
-    auto frame_end   = std::chrono::high_resolution_clock::now();
-    tm.stop();
-
-    double frame_ms = std::chrono::duration<double, std::milli>(frame_end - frame_start).count();
-    double latency  = tm.getTimeMilli();
-
-    frame_times.push_back(frame_ms);
-    latency_times.push_back(latency);
-    frame_count++;
+  ResourceSampler sampler;
+
+  const int trials = std::max(1, config.trials);
+  for (int t = 0; t < trials; ++t) {
+    TrialResult trial = runTrial(config, makeSource(t));
+    if (t == 0) metrics.warmup_frames = trial.warmup_frames;
+    load_times.push_back(trial.load_time_ms);
+    metrics.trial_avg_ms.push_back(trial.total.meanMs());
+    metrics.trial_p99_ms.push_back(trial.total.percentileMs(99.0));
+    metrics.trial_fps.push_back(trial.wall_time_ms > 0.0 ? trial.total.count() * 1000.0 / trial.wall_time_ms : 0.0);
+    total.merge(trial.total);
+    preprocess.merge(trial.preprocess);
+    inference.merge(trial.inference);
+    postprocess.merge(trial.postprocess);
   }
-
-  auto end_time = std::chrono::high_resolution_clock::now();
-  double total_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+  sampler.stop();
 
   double final_memory = getCurrentMemoryUsageMB();
   double final_sys_memory = SystemMonitor::getSystemMemoryUsage();
   metrics.memory_mb = final_memory - initial_memory;
   metrics.system_memory_used_mb = final_sys_memory - initial_sys_memory;
+  metrics.environment_type = config.device;
 
-  auto avg    = [](const std::vector<double>& v){ return v.empty()? 0.0 : std::accumulate(v.begin(), v.end(), 0.0)/v.size(); };
-  auto minmax = [](const std::vector<double>& v){ if (v.empty()) return std::make_pair(0.0,0.0); auto mm = std::minmax_element(v.begin(), v.end()); return std::make_pair(*mm.first, *mm.second); };
-
-  metrics.frame_count     = frame_count;
-  metrics.total_avg_ms    = avg(frame_times);
-  metrics.fps             = (total_time_ms > 0.0) ? ((frame_count * 1000.0) / total_time_ms) : 0.0;
-  metrics.latency_avg_ms  = avg(latency_times);
-  auto lat                = minmax(latency_times);
-  metrics.latency_min_ms  = lat.first;
-  metrics.latency_max_ms  = lat.second;
-  metrics.cpu_usage_percent = avg(cpu_samples);
-  metrics.gpu_usage_percent = avg(gpu_samples);
-  metrics.gpu_memory_used_mb= avg(gpu_mem_samples);
-
+  metrics.trials             = trials;
+  metrics.frame_count        = static_cast<int>(total.count());
+  metrics.load_time_ms       = mean(load_times);
+  metrics.preprocess_avg_ms  = preprocess.meanMs();
+  metrics.inference_avg_ms   = inference.meanMs();
+  metrics.postprocess_avg_ms = postprocess.meanMs();
+  metrics.total_avg_ms       = total.meanMs();
+  metrics.fps                = mean(metrics.trial_fps);
+
+  metrics.latency_avg_ms  = total.meanMs();
+  metrics.latency_min_ms  = total.minMs();
+  metrics.latency_max_ms  = total.maxMs();
+  metrics.latency_p50_ms  = total.percentileMs(50.0);
+  metrics.latency_p90_ms  = total.percentileMs(90.0);
+  metrics.latency_p99_ms  = total.percentileMs(99.0);
+  metrics.latency_p999_ms = total.percentileMs(99.9);
+  metrics.preprocess_p99_ms  = preprocess.percentileMs(99.0);
+  metrics.inference_p99_ms   = inference.percentileMs(99.0);
+  metrics.postprocess_p99_ms = postprocess.percentileMs(99.0);
+
+  metrics.total_avg_ci95_ms   = ci95(metrics.trial_avg_ms);
+  metrics.latency_p99_ci95_ms = ci95(metrics.trial_p99_ms);
+  metrics.fps_ci95            = ci95(metrics.trial_fps);
+
+  metrics.cpu_usage_percent  = mean(sampler.cpu_samples);
+  metrics.gpu_usage_percent  = mean(sampler.gpu_samples);
+  metrics.gpu_memory_used_mb = mean(sampler.gpu_mem_samples);
   return metrics;
 }
 
-// ----------------- Bench: Camera -----------------
-PerformanceMetrics benchmark_camera_comprehensive(BenchmarkConfig& config,
-                                                  int camera_id = 0,
-                                                  int duration_seconds = 30) {
-  PerformanceMetrics metrics;
+// ----------------- Accuracy delta -----------------
+// The model under test and a reference (typically the FP32 export of the same network) run
+// on the same frames; outputs are matched greedily by score within each class at IoU >= 0.5.
+// The agreement is the F1 of that matching (top-1 agreement for classification), so a
+// quantized or half-precision model is judged against its own float outputs without labels.
+
+// Matched pairs between two output sets of one frame
+static int matchPredictions(std::vector<BenchPrediction> candidate, const std::vector<BenchPrediction>& reference) {
+  std::sort(candidate.begin(), candidate.end(), [](const BenchPrediction& a, const BenchPrediction& b) { return a.score > b.score; });
+  std::vector<bool> used(reference.size(), false);
+  int matches = 0;
+  for (const auto& c : candidate) {
+    int best = -1;
+    double bestIoU = 0.5;
+    for (size_t r = 0; r < reference.size(); ++r) {
+      if (used[r] || reference[r].classId != c.classId) continue;
+      const double iou = evalIoU(c.box, reference[r].box);
+      if (iou >= bestIoU) { bestIoU = iou; best = static_cast<int>(r); }
+    }
+    if (best >= 0) { used[best] = true; ++matches; }
+  }
+  return matches;
+}
 
-  auto load_start = std::chrono::high_resolution_clock::now();
-  auto detector   = DetectorFactory::createDetector(config);
-  config.device = detector->getDevice();
-  auto load_end   = std::chrono::high_resolution_clock::now();
-  metrics.load_time_ms = std::chrono::duration<double, std::milli>(load_end - load_start).count();
+static void compareWithReference(const BenchmarkConfig& config, const std::vector<cv::Mat>& frames, PerformanceMetrics& metrics) {
+  if (config.reference_path.empty() || frames.empty()) return;
+  BenchmarkConfig refConfig = config;
+  refConfig.model_path = config.reference_path;
+  auto model     = DetectorFactory::createDetector(config);
+  auto reference = DetectorFactory::createDetector(refConfig);
+  warmUp(model.get(), config, frames.front());
+  warmUp(reference.get(), refConfig, frames.front());
+
+  const bool classification = config.task_type == "classification";
+  double modelMs = 0.0, referenceMs = 0.0;
+  int64_t matched = 0, outputs = 0;
+  for (const auto& frame : frames) {
+    auto t0 = std::chrono::steady_clock::now();
+    const auto ours = model->predict(frame, -1.0f);
+    auto t1 = std::chrono::steady_clock::now();
+    const auto theirs = reference->predict(frame, -1.0f);
+    auto t2 = std::chrono::steady_clock::now();
+    modelMs     += std::chrono::duration<double, std::milli>(t1 - t0).count();
+    referenceMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    if (classification) {
+      outputs += 1;
+      matched += (!ours.empty() && !theirs.empty() && ours.front().classId == theirs.front().classId) ? 1 : 0;
+    } else {
+      outputs += static_cast<int64_t>(ours.size() + theirs.size());
+      matched += 2 * matchPredictions(ours, theirs);
+    }
+  }
+  metrics.agreement        = outputs > 0 ? static_cast<double>(matched) / outputs : 1.0;
+  metrics.reference_avg_ms = referenceMs / frames.size();
+  metrics.speedup          = modelMs > 0.0 ? referenceMs / modelMs : 0.0;
+}
 
-  metrics.environment_type = config.device;
+// ----------------- mAP -----------------
+// Runs a fresh model over the annotation set (images decoded in parallel, a chunk ahead of
+// inference) and scores it with MapEvaluator; independent of the input used for timing
+static MapResult evaluateAccuracy(const BenchmarkConfig& config) {
+  if (config.task_type == "classification") throw std::runtime_error("mAP evaluation needs a box-producing task");
+  EvalDataset dataset = loadEvalDataset(config.annotations_path, config.images_dir, config.labels_path);
+  if (config.eval_images > 0 && static_cast<int>(dataset.images.size()) > config.eval_images) {
+    dataset.images.resize(config.eval_images);
+  }
+  if (dataset.images.empty()) throw std::runtime_error("No annotated images found for " + config.annotations_path);
+
+  auto model = DetectorFactory::createDetector(config);
+  MapEvaluator evaluator(dataset.numClasses);
+
+  const int chunk = 32;
+  std::vector<cv::Mat> decoded(chunk), next(chunk);
+  auto decode = [&](int begin, std::vector<cv::Mat>& out) {
+    const int end = std::min<int>(begin + chunk, static_cast<int>(dataset.images.size()));
+    cv::parallel_for_(cv::Range(begin, end), [&](const cv::Range& range) {
+      for (int i = range.start; i < range.end; ++i) out[i - begin] = cv::imread(dataset.images[i].path);
+    });
+  };
+
+  decode(0, decoded);
+  for (int begin = 0; begin < static_cast<int>(dataset.images.size()); begin += chunk) {
+    std::thread prefetch;
+    if (begin + chunk < static_cast<int>(dataset.images.size())) prefetch = std::thread(decode, begin + chunk, std::ref(next));
+    const int end = std::min<int>(begin + chunk, static_cast<int>(dataset.images.size()));
+    try {
+      for (int i = begin; i < end; ++i) {
+        const cv::Mat& image = decoded[i - begin];
+        if (image.empty()) {
+          std::cerr << "Warning: could not read " << dataset.images[i].path << ", skipped\n";
+          continue;
+        }
+        evaluator.add(dataset.images[i].objects, model->predict(image, config.eval_conf));
+      }
+    } catch (...) {
+      if (prefetch.joinable()) prefetch.join();
+      throw;
+    }
+    if (prefetch.joinable()) prefetch.join();
+    std::swap(decoded, next);
+  }
+  return evaluator.evaluate();
+}
 
-  cv::VideoCapture cap(camera_id);
-  if (!cap.isOpened()) throw std::runtime_error("Could not open camera with ID: " + std::to_string(camera_id));
+static void applyAccuracy(const MapResult& result, PerformanceMetrics& metrics) {
+  metrics.map_score  = result.map50_95;
+  metrics.map50      = result.map50;
+  metrics.map_images = result.images;
+}
 
-  std::vector<double> frame_times, latency_times;
-  std::vector<double> cpu_samples, gpu_samples, gpu_mem_samples;
+// ----------------- Bench: Image -----------------
+PerformanceMetrics benchmark_image_comprehensive(BenchmarkConfig& config,
+                                                 const std::string& image_path) {
+  cv::Mat image = cv::imread(image_path);
+  if (image.empty()) throw std::runtime_error("Could not read image: " + image_path);
 
-  double initial_memory = getCurrentMemoryUsageMB();
-  double initial_sys_memory = SystemMonitor::getSystemMemoryUsage();
-  SystemMonitor::getCPUUsage();
+  PerformanceMetrics metrics = runBenchmark(config, [&](int) -> FrameSource {
+    auto remaining = std::make_shared<int>(config.iterations);
+    return [&image, remaining](cv::Mat& frame) {
+      if ((*remaining)-- <= 0) return false;
+      frame = image;
+      return true;
+    };
+  });
+  compareWithReference(config, {image}, metrics);
+  return metrics;
+}
 
-  auto start_time = std::chrono::high_resolution_clock::now();
-  auto end_target = start_time + std::chrono::seconds(duration_seconds);
-  int frame_count = 0;
-  cv::Mat frame;
+// ----------------- Bench: Video file -----------------
+PerformanceMetrics benchmark_video_comprehensive(BenchmarkConfig& config,
+                                                 const std::string& video_path) {
+  PerformanceMetrics metrics = runBenchmark(config, [&](int) -> FrameSource {
+    auto cap = std::make_shared<cv::VideoCapture>(video_path);
+    if (!cap->isOpened()) throw std::runtime_error("Could not open video: " + video_path);
+    return [cap](cv::Mat& frame) { return cap->read(frame) && !frame.empty(); };
+  });
+
+  if (!config.reference_path.empty()) {
+    std::vector<cv::Mat> frames;
+    cv::VideoCapture cap(video_path);
+    cv::Mat frame;
+    while (static_cast<int>(frames.size()) < config.agreement_frames && cap.read(frame) && !frame.empty()) {
+      frames.push_back(frame.clone());
+    }
+    compareWithReference(config, frames, metrics);
+  }
+  return metrics;
+}
 
-  while (std::chrono::high_resolution_clock::now() < end_target) {
-    if (!cap.read(frame) || frame.empty()) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); continue; }
+// ----------------- Bench: Camera -----------------
+PerformanceMetrics benchmark_camera_comprehensive(BenchmarkConfig& config,
+                                                  int camera_id = 0) {
+  auto cap = std::make_shared<cv::VideoCapture>(camera_id);
+  if (!cap->isOpened()) throw std::runtime_error("Could not open camera with ID: " + std::to_string(camera_id));
+
+  return runBenchmark(config, [&](int) -> FrameSource {
+    // The first frame is the warmup frame; the clock starts with the next one
+    auto end_target = std::make_shared<std::chrono::steady_clock::time_point>(std::chrono::steady_clock::time_point::max());
+    auto calls      = std::make_shared<int>(0);
+    const auto duration = std::chrono::seconds(config.duration_seconds);
+    return [cap, end_target, calls, duration](cv::Mat& frame) {
+      const auto now = std::chrono::steady_clock::now();
+      if (++*calls == 2) *end_target = now + duration;
+      else if (now >= *end_target) return false;
+      while (!cap->read(frame) || frame.empty()) {
+        if (std::chrono::steady_clock::now() >= *end_target) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      return true;
+    };
+  });
+}
 
-    double cpu = SystemMonitor::getCPUUsage();
-    auto gpu   = SystemMonitor::getGPUUsage();
-    cpu_samples.push_back(cpu);
-    gpu_samples.push_back(gpu.first);
-    gpu_mem_samples.push_back(gpu.second);
+// ----------------- Bench: Throughput sweep -----------------
+// K closed-loop streams submit requests (one image each) to a shared queue and wait for
+// the result before sending the next one; W workers, each with its own detector of T
+// intra-op threads, take up to B queued requests per call. Every (W, T, K, B) is one point
+// of the throughput-vs-latency curve; latency is measured per request, from submission to
+// completion, so it includes the time spent queued behind other streams.
+struct ThroughputPoint {
+  int workers = 0;
+  int threads = 0;
+  int streams = 0;
+  int batch = 0;
+  int64_t requests = 0;
+  double images_per_s = 0.0;
+  double mean_ms = 0.0, p50_ms = 0.0, p90_ms = 0.0, p99_ms = 0.0, p999_ms = 0.0;
+  double avg_batch = 0.0;             // Requests per detector call
+};
 
-    cv::TickMeter tm; tm.start();
-    auto frame_start = std::chrono::high_resolution_clock::now();
-    auto results     = DetectorFactory::detect(detector.get(), config, frame); (void)results;
-    auto frame_end   = std::chrono::high_resolution_clock::now();
-    tm.stop();
+struct ThroughputRequest {
+  int stream = -1;
+  std::chrono::steady_clock::time_point submitted;
+};
 
-    double frame_ms = std::chrono::duration<double, std::milli>(frame_end - frame_start).count();
-    double latency  = tm.getTimeMilli();
+// Completion mailbox of one stream (at most one request in flight)
+struct StreamSlot {
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  bool done = false;
+  std::chrono::steady_clock::time_point completed;
+};
 
-    frame_times.push_back(frame_ms);
-    latency_times.push_back(latency);
-    frame_count++;
+static ThroughputPoint runThroughputPoint(const std::vector<std::unique_ptr<BenchModel>>& models,
+                                          const cv::Mat& image, int threads, int streams, int batch, int seconds) {
+  using clock = std::chrono::steady_clock;
+  const int workers = static_cast<int>(models.size());
+
+  MpmcRingQueue<ThroughputRequest> queue(static_cast<size_t>(streams));
+  std::vector<StreamSlot> slots(static_cast<size_t>(streams));
+  std::vector<yolos::LatencyHistogram> latencies(static_cast<size_t>(streams));
+  std::atomic<int64_t> measured_calls{0};   // Detector calls completed in the measured window
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  // The first fifth of the point (at most a second) ramps up and is not measured
+  const auto start        = clock::now();
+  const auto measure_from = start + std::min<clock::duration>(std::chrono::seconds(1), std::chrono::seconds(seconds) / 5);
+  const auto stop_at      = start + std::chrono::seconds(seconds);
+
+  std::vector<std::thread> worker_threads;
+  for (int w = 0; w < workers; ++w) {
+    worker_threads.emplace_back([&, w]() {
+      std::vector<ThroughputRequest> taken;
+      std::vector<cv::Mat> images;
+      ThroughputRequest request;
+      while (queue.dequeue(request)) {
+        taken.assign(1, request);
+        while (static_cast<int>(taken.size()) < batch && queue.try_dequeue(request)) taken.push_back(request);
+        try {
+          if (!failed) {
+            if (taken.size() == 1) {
+              models[w]->run(image);
+            } else {
+              images.assign(taken.size(), image);
+              models[w]->runBatch(images);
+            }
+          }
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error) error = std::current_exception();
+          failed = true;
+        }
+        const auto completed = clock::now();
+        if (completed >= measure_from) measured_calls.fetch_add(1, std::memory_order_relaxed);
+        for (const auto& r : taken) {
+          StreamSlot& slot = slots[r.stream];
+          {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            slot.done = true;
+            slot.completed = completed;
+          }
+          slot.done_cv.notify_one();
+        }
+      }
+    });
   }
 
-  auto end_time = std::chrono::high_resolution_clock::now();
-  double total_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+  std::vector<std::thread> stream_threads;
+  for (int k = 0; k < streams; ++k) {
+    stream_threads.emplace_back([&, k]() {
+      StreamSlot& slot = slots[k];
+      for (auto now = clock::now(); now < stop_at && !failed; now = clock::now()) {
+        {
+          std::lock_guard<std::mutex> lock(slot.mutex);
+          slot.done = false;
+        }
+        if (!queue.enqueue({k, now})) break;
+        std::unique_lock<std::mutex> lock(slot.mutex);
+        slot.done_cv.wait(lock, [&]() { return slot.done; });
+        if (now >= measure_from) {
+          latencies[k].record(std::chrono::duration_cast<std::chrono::microseconds>(slot.completed - now).count());
+        }
+      }
+    });
+  }
+  for (auto& t : stream_threads) t.join();
+  const auto end = clock::now();
+  queue.set_finished();
+  for (auto& t : worker_threads) t.join();
+  if (error) std::rethrow_exception(error);
+
+  yolos::LatencyHistogram total;
+  for (const auto& h : latencies) total.merge(h);
+
+  ThroughputPoint point;
+  point.workers  = workers;
+  point.threads  = threads;
+  point.streams  = streams;
+  point.batch    = batch;
+  point.requests = total.count();
+  const double measured_s = std::chrono::duration<double>(end - measure_from).count();
+  point.images_per_s = measured_s > 0.0 ? total.count() / measured_s : 0.0;
+  point.mean_ms = total.meanMs();
+  point.p50_ms  = total.percentileMs(50.0);
+  point.p90_ms  = total.percentileMs(90.0);
+  point.p99_ms  = total.percentileMs(99.0);
+  point.p999_ms = total.percentileMs(99.9);
+  const int64_t call_count = measured_calls.load();
+  point.avg_batch = call_count > 0 ? static_cast<double>(total.count()) / call_count : 0.0;
+  return point;
+}
 
-  double final_memory = getCurrentMemoryUsageMB();
-  double final_sys_memory = SystemMonitor::getSystemMemoryUsage();
-  metrics.memory_mb = final_memory - initial_memory;
-  metrics.system_memory_used_mb = final_sys_memory - initial_sys_memory;
+// (workers, intra-op threads) splits to sweep; by default every power-of-two worker count
+// up to the core count, each with the cores shared evenly
+static std::vector<std::pair<int, int>> throughputSplits(const BenchmarkConfig& config) {
+  const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  std::vector<int> workers = config.sweep_workers;
+  if (workers.empty()) {
+    for (int w = 1; w <= cores; w *= 2) workers.push_back(w);
+  }
+  std::vector<std::pair<int, int>> splits;
+  for (int w : workers) {
+    if (config.sweep_threads.empty()) splits.emplace_back(w, std::max(1, cores / w));
+    else for (int t : config.sweep_threads) splits.emplace_back(w, t);
+  }
+  return splits;
+}
 
-  auto avg    = [](const std::vector<double>& v){ return v.empty()? 0.0 : std::accumulate(v.begin(), v.end(), 0.0)/v.size(); };
-  auto minmax = [](const std::vector<double>& v){ if (v.empty()) return std::make_pair(0.0,0.0); auto mm = std::minmax_element(v.begin(), v.end()); return std::make_pair(*mm.first, *mm.second); };
+// Runs the whole sweep; detectors are created once per split and reused for its points.
+// onPoint is called as soon as each point is measured.
+static std::vector<ThroughputPoint> benchmark_throughput(BenchmarkConfig& config, const std::string& image_path,
+                                                         const std::function<void(const ThroughputPoint&)>& onPoint) {
+  cv::Mat image = cv::imread(image_path);
+  if (image.empty()) throw std::runtime_error("Could not read image: " + image_path);
 
-  metrics.frame_count     = frame_count;
-  metrics.total_avg_ms    = avg(frame_times);
-  metrics.fps             = (total_time_ms > 0.0) ? ((frame_count * 1000.0) / total_time_ms) : 0.0;
-  metrics.latency_avg_ms  = avg(latency_times);
-  auto lat                = minmax(latency_times);
-  metrics.latency_min_ms  = lat.first;
-  metrics.latency_max_ms  = lat.second;
-  metrics.cpu_usage_percent = avg(cpu_samples);
-  metrics.gpu_usage_percent = avg(gpu_samples);
-  metrics.gpu_memory_used_mb= avg(gpu_mem_samples);
+  std::vector<ThroughputPoint> points;
+  for (const auto& [workers, threads] : throughputSplits(config)) {
+    std::vector<std::unique_ptr<BenchModel>> models;
+    for (int w = 0; w < workers; ++w) {
+      models.push_back(DetectorFactory::createDetector(config, threads));
+      warmUp(models.back().get(), config, image);
+    }
+    config.device = models.front()->device();
+    config.precision = models.front()->precision();
 
-  return metrics;
+    for (int batch : config.sweep_batch) {
+      if (batch > 1) {
+        // Batched calls allocate their own buffers on first use
+        for (auto& model : models) model->runBatch(std::vector<cv::Mat>(batch, image));
+      }
+      for (int streams : config.sweep_streams) {
+        points.push_back(runThroughputPoint(models, image, threads, streams, batch, std::max(1, config.point_seconds)));
+        onPoint(points.back());
+      }
+    }
+  }
+  return points;
 }
 
 // ----------------- CSV helpers -----------------
-static inline void printCSVHeader() {
-  std::cout
-    << "model_type,task_type,InputType,environment,device,threads,precision,"
-    << "load_ms,preprocess_ms,inference_ms,postprocess_ms,total_ms,fps,"
-    << "memory_mb,system_memory_mb,cpu_usage_%,gpu_usage_%,gpu_memory_mb,"
-    << "latency_avg_ms,latency_min_ms,latency_max_ms,map_score,frame_count\n";
-}
-
-static inline void printCSVRow(const BenchmarkConfig& config,
+static const char* kCSVHeader =
+    "model_type,task_type,InputType,environment,device,threads,precision,"
+    "load_ms,preprocess_ms,inference_ms,postprocess_ms,total_ms,fps,"
+    "memory_mb,system_memory_mb,cpu_usage_%,gpu_usage_%,gpu_memory_mb,"
+    "latency_avg_ms,latency_min_ms,latency_max_ms,map_score,frame_count,"
+    "latency_p50_ms,latency_p90_ms,latency_p99_ms,latency_p999_ms,"
+    "preprocess_p99_ms,inference_p99_ms,postprocess_p99_ms,"
+    "warmup_frames,trials,total_ci95_ms,latency_p99_ci95_ms,fps_ci95,"
+    "agreement,accuracy_delta,reference_ms,speedup,map50,map_images\n";
+
+static inline void writeCSVRow(std::ostream& out,
+                               const BenchmarkConfig& config,
                                const PerformanceMetrics& m,
-                               const std::string& inputType) {
-  std::cout << config.model_type << ","
-            << config.task_type << ","
-            << inputType << ","
-            << m.environment_type << ","
-            << config.device << ","
-            << config.thread_count << ","
-            << config.precision << ","
-            << std::fixed << std::setprecision(3)
-            << m.load_time_ms << ","
-            << m.preprocess_avg_ms << ","
-            << m.inference_avg_ms << ","
-            << m.postprocess_avg_ms << ","
-            << m.total_avg_ms << ","
-            << m.fps << ","
-            << m.memory_mb << ","
-            << m.system_memory_used_mb << ","
-            << m.cpu_usage_percent << ","
-            << m.gpu_usage_percent << ","
-            << m.gpu_memory_used_mb << ","
-            << m.latency_avg_ms << ","
-            << m.latency_min_ms << ","
-            << m.latency_max_ms << ","
-            << m.map_score << ","
-            << m.frame_count << "\n";
-}
-
-// Append a single CSV row to a file
-static inline void appendCSVRowToFile(const std::string& filePath,
-                                      const BenchmarkConfig& cfg,
-                                      const PerformanceMetrics& m,
-                                      const std::string& inputType) {
-  std::ofstream out(filePath, std::ios::app);
-  if (!out) throw std::runtime_error("Cannot append to results file: " + filePath);
-  out << cfg.model_type << ","
-      << cfg.task_type << ","
+                               const std::string& inputType,
+                               const std::string& device) {
+  out << config.model_type << ","
+      << config.task_type << ","
       << inputType << ","
       << m.environment_type << ","
-      << (cfg.use_gpu ? "gpu" : "cpu") << ","
-      << cfg.thread_count << ","
-      << cfg.precision << ","
+      << device << ","
+      << config.thread_count << ","
+      << config.precision << ","
       << std::fixed << std::setprecision(3)
       << m.load_time_ms << ","
       << m.preprocess_avg_ms << ","
@@ -489,18 +857,339 @@ static inline void appendCSVRowToFile(const std::string& filePath,
       << m.latency_min_ms << ","
       << m.latency_max_ms << ","
       << m.map_score << ","
-      << m.frame_count << "\n";
+      << m.frame_count << ","
+      << m.latency_p50_ms << ","
+      << m.latency_p90_ms << ","
+      << m.latency_p99_ms << ","
+      << m.latency_p999_ms << ","
+      << m.preprocess_p99_ms << ","
+      << m.inference_p99_ms << ","
+      << m.postprocess_p99_ms << ","
+      << m.warmup_frames << ","
+      << m.trials << ","
+      << m.total_avg_ci95_ms << ","
+      << m.latency_p99_ci95_ms << ","
+      << m.fps_ci95 << ",";
+  // Empty cells when no reference was given
+  if (m.agreement >= 0.0) {
+    out << m.agreement << "," << (1.0 - m.agreement) << "," << m.reference_avg_ms << "," << m.speedup << ",";
+  } else {
+    out << ",,,,";
+  }
+  out << m.map50 << "," << m.map_images << "\n";
+}
+
+static inline void printCSVHeader() {
+  std::cout << kCSVHeader;
+}
+
+static inline void printCSVRow(const BenchmarkConfig& config,
+                               const PerformanceMetrics& m,
+                               const std::string& inputType) {
+  writeCSVRow(std::cout, config, m, inputType, config.device);
+}
+
+// Append a single CSV row to a file
+static inline void appendCSVRowToFile(const std::string& filePath,
+                                      const BenchmarkConfig& cfg,
+                                      const PerformanceMetrics& m,
+                                      const std::string& inputType) {
+  std::ofstream out(filePath, std::ios::app);
+  if (!out) throw std::runtime_error("Cannot append to results file: " + filePath);
+  writeCSVRow(out, cfg, m, inputType, cfg.use_gpu ? "gpu" : "cpu");
+}
+
+// ----------------- JSON helpers -----------------
+static std::string jsonString(const std::string& s) {
+  std::string out = "\"";
+  for (char c : s) {
+    switch (c) {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) { char buf[8]; std::snprintf(buf, sizeof buf, "\\u%04x", c); out += buf; }
+        else out += c;
+    }
+  }
+  return out + "\"";
+}
+
+static std::string jsonArray(const std::vector<double>& v) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3) << "[";
+  for (size_t i = 0; i < v.size(); ++i) out << (i ? ", " : "") << v[i];
+  out << "]";
+  return out.str();
+}
+
+// One benchmark run as a JSON object
+static std::string toJSON(const BenchmarkConfig& cfg, const PerformanceMetrics& m, const std::string& inputType) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3);
+  out << "  {\n"
+      << "    \"model_type\": " << jsonString(cfg.model_type) << ",\n"
+      << "    \"task_type\": " << jsonString(cfg.task_type) << ",\n"
+      << "    \"model_path\": " << jsonString(cfg.model_path) << ",\n"
+      << "    \"input_type\": " << jsonString(inputType) << ",\n"
+      << "    \"device\": " << jsonString(cfg.device) << ",\n"
+      << "    \"threads\": " << cfg.thread_count << ",\n"
+      << "    \"precision\": " << jsonString(cfg.precision) << ",\n"
+      << "    \"pinned_cores\": [";
+  for (size_t i = 0; i < cfg.pin_cores.size(); ++i) out << (i ? ", " : "") << cfg.pin_cores[i];
+  out << "],\n"
+      << "    \"trials\": " << m.trials << ",\n"
+      << "    \"warmup_frames\": " << m.warmup_frames << ",\n"
+      << "    \"frame_count\": " << m.frame_count << ",\n"
+      << "    \"load_ms\": " << m.load_time_ms << ",\n"
+      << "    \"fps\": {\"mean\": " << m.fps << ", \"ci95\": " << m.fps_ci95 << "},\n"
+      << "    \"latency_ms\": {\"mean\": " << m.latency_avg_ms << ", \"ci95\": " << m.total_avg_ci95_ms
+      << ", \"min\": " << m.latency_min_ms << ", \"p50\": " << m.latency_p50_ms << ", \"p90\": " << m.latency_p90_ms
+      << ", \"p99\": " << m.latency_p99_ms << ", \"p99_ci95\": " << m.latency_p99_ci95_ms
+      << ", \"p999\": " << m.latency_p999_ms << ", \"max\": " << m.latency_max_ms << "},\n"
+      << "    \"stages_ms\": {\n"
+      << "      \"preprocess\": {\"mean\": " << m.preprocess_avg_ms << ", \"p99\": " << m.preprocess_p99_ms << "},\n"
+      << "      \"inference\": {\"mean\": " << m.inference_avg_ms << ", \"p99\": " << m.inference_p99_ms << "},\n"
+      << "      \"postprocess\": {\"mean\": " << m.postprocess_avg_ms << ", \"p99\": " << m.postprocess_p99_ms << "}\n"
+      << "    },\n"
+      << "    \"per_trial\": {\"latency_mean_ms\": " << jsonArray(m.trial_avg_ms) << ", \"latency_p99_ms\": "
+      << jsonArray(m.trial_p99_ms) << ", \"fps\": " << jsonArray(m.trial_fps) << "},\n"
+      << "    \"memory_mb\": " << m.memory_mb << ",\n"
+      << "    \"cpu_usage_percent\": " << m.cpu_usage_percent << ",\n"
+      << "    \"gpu_usage_percent\": " << m.gpu_usage_percent << ",\n"
+      << "    \"gpu_memory_mb\": " << m.gpu_memory_used_mb << ",\n"
+      << "    \"reference\": ";
+  if (m.agreement >= 0.0) {
+    out << "{\"model_path\": " << jsonString(cfg.reference_path) << ", \"agreement\": " << m.agreement
+        << ", \"accuracy_delta\": " << (1.0 - m.agreement) << ", \"reference_latency_ms\": " << m.reference_avg_ms
+        << ", \"speedup\": " << m.speedup << "},\n";
+  } else {
+    out << "null,\n";
+  }
+  out << "    \"accuracy\": ";
+  if (m.map_images > 0) {
+    out << "{\"annotations\": " << jsonString(cfg.annotations_path) << ", \"images\": " << m.map_images
+        << ", \"map50\": " << m.map50 << ", \"map50_95\": " << m.map_score << "}\n";
+  } else {
+    out << "null\n";
+  }
+  out << "  }";
+  return out.str();
+}
+
+static void writeJSONFile(const std::string& filePath, const std::vector<std::string>& runs) {
+  std::ofstream out(filePath);
+  if (!out) throw std::runtime_error("Cannot open JSON results file: " + filePath);
+  out << "[\n";
+  for (size_t i = 0; i < runs.size(); ++i) out << runs[i] << (i + 1 < runs.size() ? ",\n" : "\n");
+  out << "]\n";
+}
+
+// ----------------- Throughput output -----------------
+static const char* kThroughputCSVHeader =
+    "model_type,task_type,device,workers,threads,streams,batch,requests,images_per_s,"
+    "avg_batch,latency_mean_ms,latency_p50_ms,latency_p90_ms,latency_p99_ms,latency_p999_ms\n";
+
+static void writeThroughputRow(std::ostream& out, const BenchmarkConfig& cfg, const ThroughputPoint& p) {
+  out << cfg.model_type << "," << cfg.task_type << "," << cfg.device << ","
+      << p.workers << "," << p.threads << "," << p.streams << "," << p.batch << "," << p.requests << ","
+      << std::fixed << std::setprecision(3)
+      << p.images_per_s << "," << p.avg_batch << "," << p.mean_ms << "," << p.p50_ms << ","
+      << p.p90_ms << "," << p.p99_ms << "," << p.p999_ms << "\n";
+}
+
+static std::string throughputPointJSON(const ThroughputPoint& p) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3)
+      << "{\"workers\": " << p.workers << ", \"threads\": " << p.threads << ", \"streams\": " << p.streams
+      << ", \"batch\": " << p.batch << ", \"requests\": " << p.requests << ", \"images_per_s\": " << p.images_per_s
+      << ", \"avg_batch\": " << p.avg_batch << ", \"latency_ms\": {\"mean\": " << p.mean_ms << ", \"p50\": " << p.p50_ms
+      << ", \"p90\": " << p.p90_ms << ", \"p99\": " << p.p99_ms << ", \"p999\": " << p.p999_ms << "}}";
+  return out.str();
+}
+
+// Highest throughput, optionally among the points whose p99 fits the budget (nullptr if none)
+static const ThroughputPoint* bestThroughputPoint(const std::vector<ThroughputPoint>& points, double p99_budget_ms) {
+  const ThroughputPoint* best = nullptr;
+  for (const auto& p : points) {
+    if (p99_budget_ms > 0.0 && p.p99_ms > p99_budget_ms) continue;
+    if (!best || p.images_per_s > best->images_per_s) best = &p;
+  }
+  return best;
+}
+
+// The sweep as one JSON object: the curve points and the recommended splits
+static std::string throughputJSON(const BenchmarkConfig& cfg, const std::vector<ThroughputPoint>& points) {
+  const ThroughputPoint* best = bestThroughputPoint(points, 0.0);
+  const ThroughputPoint* within = cfg.p99_budget_ms > 0.0 ? bestThroughputPoint(points, cfg.p99_budget_ms) : nullptr;
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3);
+  out << "  {\n"
+      << "    \"model_type\": " << jsonString(cfg.model_type) << ",\n"
+      << "    \"task_type\": " << jsonString(cfg.task_type) << ",\n"
+      << "    \"model_path\": " << jsonString(cfg.model_path) << ",\n"
+      << "    \"input_type\": \"Throughput\",\n"
+      << "    \"device\": " << jsonString(cfg.device) << ",\n"
+      << "    \"cores\": " << std::thread::hardware_concurrency() << ",\n"
+      << "    \"point_seconds\": " << cfg.point_seconds << ",\n"
+      << "    \"p99_budget_ms\": " << cfg.p99_budget_ms << ",\n"
+      << "    \"best\": " << (best ? throughputPointJSON(*best) : "null") << ",\n"
+      << "    \"best_within_budget\": " << (within ? throughputPointJSON(*within) : "null") << ",\n"
+      << "    \"points\": [\n";
+  for (size_t i = 0; i < points.size(); ++i) {
+    out << "      " << throughputPointJSON(points[i]) << (i + 1 < points.size() ? ",\n" : "\n");
+  }
+  out << "    ]\n"
+      << "  }";
+  return out.str();
+}
+
+static void printThroughputSummary(const BenchmarkConfig& cfg, const std::vector<ThroughputPoint>& points) {
+  auto describe = [](const ThroughputPoint& p) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << p.workers << " workers x " << p.threads << " threads, "
+        << p.streams << " streams, batch " << p.batch << ": " << p.images_per_s << " images/s at p99 " << p.p99_ms << " ms";
+    return out.str();
+  };
+  if (const ThroughputPoint* best = bestThroughputPoint(points, 0.0)) {
+    std::cerr << "Best throughput: " << describe(*best) << "\n";
+  }
+  if (cfg.p99_budget_ms > 0.0) {
+    const ThroughputPoint* within = bestThroughputPoint(points, cfg.p99_budget_ms);
+    std::cerr << "Best within p99 <= " << cfg.p99_budget_ms << " ms: " << (within ? describe(*within) : "no point meets the budget") << "\n";
+  }
+}
+
+// ----------------- Pareto report -----------------
+// One benchmarked configuration (model, precision, device) with its accuracy and speed
+struct ParetoPoint {
+  std::string model_type, task_type, precision, device, input_type;
+  double map50 = 0.0, map50_95 = 0.0, p99_ms = 0.0, fps = 0.0;
+  bool optimal = false;
+};
+
+static ParetoPoint makeParetoPoint(const BenchmarkConfig& cfg, const PerformanceMetrics& m, const std::string& inputType) {
+  return {cfg.model_type, cfg.task_type, cfg.precision, cfg.device, inputType, m.map50, m.map_score, m.latency_p99_ms, m.fps, false};
+}
+
+// A point is optimal when no other point of the same task and input is at least as good on
+// mAP@0.5:0.95, p99 and FPS and strictly better on one of them
+static void markParetoFront(std::vector<ParetoPoint>& points) {
+  for (auto& p : points) {
+    p.optimal = std::none_of(points.begin(), points.end(), [&](const ParetoPoint& q) {
+      if (&q == &p || q.task_type != p.task_type || q.input_type != p.input_type) return false;
+      const bool noWorse = q.map50_95 >= p.map50_95 && q.p99_ms <= p.p99_ms && q.fps >= p.fps;
+      const bool better  = q.map50_95 > p.map50_95 || q.p99_ms < p.p99_ms || q.fps > p.fps;
+      return noWorse && better;
+    });
+  }
+}
+
+// CSV grouped by task and input, most accurate first
+static void writeParetoReport(const std::string& filePath, std::vector<ParetoPoint> points) {
+  std::ofstream out(filePath);
+  if (!out) throw std::runtime_error("Cannot open Pareto report: " + filePath);
+  std::sort(points.begin(), points.end(), [](const ParetoPoint& a, const ParetoPoint& b) {
+    if (a.task_type != b.task_type) return a.task_type < b.task_type;
+    if (a.input_type != b.input_type) return a.input_type < b.input_type;
+    return a.map50_95 > b.map50_95;
+  });
+  out << "model_type,task_type,precision,device,input_type,map50,map50_95,latency_p99_ms,fps,pareto_optimal\n"
+      << std::fixed << std::setprecision(3);
+  for (const auto& p : points) {
+    out << p.model_type << "," << p.task_type << "," << p.precision << "," << p.device << "," << p.input_type << ","
+        << p.map50 << "," << p.map50_95 << "," << p.p99_ms << "," << p.fps << "," << (p.optimal ? 1 : 0) << "\n";
+  }
+}
+
+static void printParetoFront(const std::vector<ParetoPoint>& points) {
+  std::cerr << "Pareto-optimal configurations (mAP@0.5:0.95 / p99 / FPS):\n" << std::fixed << std::setprecision(3);
+  for (const auto& p : points) {
+    if (!p.optimal) continue;
+    std::cerr << "  " << p.task_type << " " << p.input_type << ": " << p.model_type << " " << p.precision << " on " << p.device
+              << "  mAP " << p.map50_95 << " (@0.5 " << p.map50 << "), p99 " << p.p99_ms << " ms, " << p.fps << " FPS\n";
+  }
 }
 
 // ----------------- Arg parse -----------------
+// "aspect" or "384x640,640x640" (height x width)
+static std::vector<yolos::InputBucket> parseBuckets(const std::string& text) {
+  if (text == "aspect") return yolos::DetectorOptions::aspectBuckets();
+  std::vector<yolos::InputBucket> buckets;
+  std::stringstream list(text); std::string item;
+  while (std::getline(list, item, ',')) {
+    const size_t x = item.find('x');
+    if (x == std::string::npos) throw std::runtime_error("Invalid bucket (expected HxW): " + item);
+    buckets.push_back({std::stoi(item.substr(0, x)), std::stoi(item.substr(x + 1))});
+  }
+  return buckets;
+}
+
+static const char* kOptionsHelp =
+    "Options: --gpu, --cpu, --threads=N, --quantized, --iterations=N, --duration=N,\n"
+    "         --trials=N, --warmup=N, --max-warmup=N, --steady-window=N, --steady-tolerance=F,\n"
+    "         --pin=C0,C1,..., --json=PATH, --trace=PATH, --metrics=PATH\n"
+    "Accuracy: --reference=MODEL (compare outputs and speed with e.g. the FP32 model),\n"
+    "         --agreement-frames=N, --annotations=COCO.json|DOTA_LABEL_DIR, --images=DIR,\n"
+    "         --eval-conf=F, --eval-images=N\n"
+    "Shapes: --buckets=aspect|HxW,HxW,... (dynamic-shape models)\n"
+    "Throughput: --sweep-workers=W0,W1,..., --sweep-threads=T0,T1,..., --streams=K0,K1,...,\n"
+    "         --batch=B0,B1,..., --point-seconds=N, --p99-budget=MS\n";
+
+// "1,2,4" -> {1, 2, 4}; entries below min_value are dropped
+static std::vector<int> parseIntList(const std::string& text, int min_value = 1) {
+  std::vector<int> values;
+  std::stringstream list(text); std::string item;
+  while (std::getline(list, item, ',')) {
+    if (!item.empty() && std::stoi(item) >= min_value) values.push_back(std::stoi(item));
+  }
+  return values;
+}
+
+static void parseOptions(BenchmarkConfig& cfg, int argc, char** argv, int first) {
+  for (int i = first; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--gpu" || arg == "gpu") cfg.use_gpu = true;
+    else if (arg == "--cpu" || arg == "cpu") cfg.use_gpu = false;
+    else if (arg.rfind("--threads=", 0) == 0) cfg.thread_count = std::stoi(arg.substr(10));
+    else if (arg == "--quantized") cfg.quantized = true;
+    else if (arg.rfind("--reference=", 0) == 0) cfg.reference_path = arg.substr(12);
+    else if (arg.rfind("--agreement-frames=", 0) == 0) cfg.agreement_frames = std::stoi(arg.substr(19));
+    else if (arg.rfind("--annotations=", 0) == 0) cfg.annotations_path = arg.substr(14);
+    else if (arg.rfind("--images=", 0) == 0) cfg.images_dir = arg.substr(9);
+    else if (arg.rfind("--eval-conf=", 0) == 0) cfg.eval_conf = std::stof(arg.substr(12));
+    else if (arg.rfind("--eval-images=", 0) == 0) cfg.eval_images = std::stoi(arg.substr(14));
+    else if (arg.rfind("--buckets=", 0) == 0) cfg.buckets = parseBuckets(arg.substr(10));
+    else if (arg.rfind("--iterations=", 0) == 0) cfg.iterations = std::stoi(arg.substr(13));
+    else if (arg.rfind("--duration=", 0) == 0) cfg.duration_seconds = std::stoi(arg.substr(11));
+    else if (arg.rfind("--trials=", 0) == 0) cfg.trials = std::stoi(arg.substr(9));
+    else if (arg.rfind("--warmup=", 0) == 0) cfg.warmup_min = std::stoi(arg.substr(9));
+    else if (arg.rfind("--max-warmup=", 0) == 0) cfg.warmup_max = std::stoi(arg.substr(13));
+    else if (arg.rfind("--steady-window=", 0) == 0) cfg.steady_window = std::stoi(arg.substr(16));
+    else if (arg.rfind("--steady-tolerance=", 0) == 0) cfg.steady_tolerance = std::stod(arg.substr(19));
+    else if (arg.rfind("--json=", 0) == 0) cfg.json_path = arg.substr(7);
+    else if (arg.rfind("--trace=", 0) == 0) cfg.trace_path = arg.substr(8);
+    else if (arg.rfind("--metrics=", 0) == 0) cfg.metrics_path = arg.substr(10);
+    else if (arg.rfind("--pin=", 0) == 0) cfg.pin_cores = parseIntList(arg.substr(6), 0);
+    else if (arg.rfind("--sweep-workers=", 0) == 0) cfg.sweep_workers = parseIntList(arg.substr(16));
+    else if (arg.rfind("--sweep-threads=", 0) == 0) cfg.sweep_threads = parseIntList(arg.substr(16));
+    else if (arg.rfind("--streams=", 0) == 0) cfg.sweep_streams = parseIntList(arg.substr(10));
+    else if (arg.rfind("--batch=", 0) == 0) cfg.sweep_batch = parseIntList(arg.substr(8));
+    else if (arg.rfind("--point-seconds=", 0) == 0) cfg.point_seconds = std::stoi(arg.substr(16));
+    else if (arg.rfind("--p99-budget=", 0) == 0) cfg.p99_budget_ms = std::stod(arg.substr(13));
+  }
+  cfg.warmup_max = std::max(cfg.warmup_max, cfg.warmup_min);
+}
+
 static BenchmarkConfig parseConfig(int argc, char** argv) {
-  if (argc < 6) {
+  if (argc < 7) {
     std::cerr
       << "Usage: " << argv[0] << " <mode> <model_type> <task_type> <model_path> <labels_path> <input_path> [options]\n"
-      << "Modes: image, video, camera, comprehensive\n"
+      << "Modes: image, video, camera, throughput, comprehensive\n"
       << "Model types: yolo5..yolo12\n"
-      << "Task types: detection, segmentation, obb, pose\n"
-      << "Options: --gpu, --cpu, --threads=N, --quantized, --iterations=N, --duration=N\n";
+      << "Task types: detection, segmentation, obb, pose, classification\n"
+      << kOptionsHelp;
     throw std::runtime_error("Invalid arguments");
   }
 
@@ -509,14 +1198,7 @@ static BenchmarkConfig parseConfig(int argc, char** argv) {
   cfg.task_type   = argv[3];
   cfg.model_path  = argv[4];
   cfg.labels_path = argv[5];
-
-  for (int i = 7; i < argc; ++i) {
-    std::string arg = argv[i];
-    if (arg == "--gpu" || arg == "gpu") cfg.use_gpu = true;
-    else if (arg == "--cpu" || arg == "cpu") cfg.use_gpu = false;
-    else if (arg.rfind("--threads=", 0) == 0) cfg.thread_count = std::stoi(arg.substr(10));
-    else if (arg == "--quantized") { cfg.quantized = true; cfg.precision = "int8"; }
-  }
+  parseOptions(cfg, argc, argv, 7);
   return cfg;
 }
 
@@ -526,8 +1208,8 @@ int main(int argc, char** argv) {
     if (argc < 2) {
       std::cerr
         << "Usage: " << argv[0] << " <mode> <model_type> <task_type> <model_path> <labels_path> <input_path> [options]\n"
-        << "Modes: image, video, camera, comprehensive\n"
-        << "Options: --gpu, --cpu, --threads=N, --quantized, --iterations=N, --duration=N\n";
+        << "Modes: image, video, camera, throughput, comprehensive\n"
+        << kOptionsHelp;
       return 1;
     }
 
@@ -537,12 +1219,23 @@ int main(int argc, char** argv) {
       std::cout << "YOLO Performance Analyzer - running comprehensive benchmarks...\n";
       std::filesystem::create_directories("results");
 
-      // candidate models (add freely here)
-      std::vector<std::tuple<std::string,std::string,std::string>> test_configs = {
-        {"yolo11", "detection", "models/yolo11n.onnx"},
-        {"yolo8",  "detection", "models/yolov8n.onnx"},
-        {"yolo11_quantized", "detection", "quantized_models/yolo11n_quantized.onnx"},
-        {"yolo8_quantized",  "detection", "quantized_models/yolov8n_quantized.onnx"},
+      // Protocol options apply to every run
+      BenchmarkConfig base;
+      parseOptions(base, argc, argv, 2);
+      if (!pinToCores(base.pin_cores)) std::cerr << "Warning: could not pin to the requested cores\n";
+
+      // candidate models (add freely here); reduced-precision models name their FP32 reference
+      std::vector<std::tuple<std::string,std::string,std::string,std::string,std::string>> test_configs = {
+        {"yolo11", "detection", "models/yolo11n.onnx", "models/coco.names", ""},
+        {"yolo8",  "detection", "models/yolov8n.onnx", "models/coco.names", ""},
+        {"yolo11_quantized", "detection", "quantized_models/yolo11n_quantized.onnx", "models/coco.names", "models/yolo11n.onnx"},
+        {"yolo8_quantized",  "detection", "quantized_models/yolov8n_quantized.onnx", "models/coco.names", "models/yolov8n.onnx"},
+        {"yolo11_int8", "detection", "quantized_models/yolo11n_int8.onnx", "models/coco.names", "models/yolo11n.onnx"},
+        {"yolo11_fp16", "detection", "quantized_models/yolo11n_fp16.onnx", "models/coco.names", "models/yolo11n.onnx"},
+        {"yolo11", "segmentation", "models/yolo11n-seg.onnx", "models/coco.names", ""},
+        {"yolo11", "obb", "models/yolo11n-obb.onnx", "models/Dota.names", ""},
+        {"yolo11", "pose", "models/yolo11n-pose.onnx", "models/coco.names", ""},
+        {"yolo11", "classification", "models/yolo11n-cls.onnx", "models/ImageNet.names", ""},
       };
 
       const std::string image_path = "data/dog.jpg";
@@ -550,42 +1243,53 @@ int main(int argc, char** argv) {
       const bool has_image = std::filesystem::exists(image_path);
       const bool has_video = std::filesystem::exists(video_path);
 
-      const int image_iterations = 100; // single fixed iterations → no duplicate rows
-
-      std::string results_file = "results/comprehensive_benchmark_" + std::to_string(std::time(nullptr)) + ".csv";
+      const std::string results_stem = "results/comprehensive_benchmark_" + std::to_string(std::time(nullptr));
+      const std::string results_file = results_stem + ".csv";
+      const std::string json_file    = base.json_path.empty() ? results_stem + ".json" : base.json_path;
       {
         std::ofstream file(results_file);
         if (!file) throw std::runtime_error("Cannot open results file: " + results_file);
-        file << "model_type,task_type,InputType,environment,device,threads,precision,"
-                "load_ms,preprocess_ms,inference_ms,postprocess_ms,total_ms,fps,"
-                "memory_mb,system_memory_mb,cpu_usage_%,gpu_usage_%,gpu_memory_mb,"
-                "latency_avg_ms,latency_min_ms,latency_max_ms,map_score,frame_count\n";
+        file << kCSVHeader;
       }
+      std::vector<std::string> json_runs;
+      std::vector<ParetoPoint> pareto_points;
+      // A COCO file scores the axis-aligned tasks, a DOTA label directory the OBB models
+      const bool dota_annotations = !base.annotations_path.empty() && std::filesystem::is_directory(base.annotations_path);
 
       // For each available model: run CPU(Image,Video) then GPU(Image,Video)
-      for (const auto& [model_type, task_type, model_path] : test_configs) {
+      for (const auto& [model_type, task_type, model_path, labels_path, reference_path] : test_configs) {
         if (!std::filesystem::exists(model_path)) {
           std::cerr << "Skipping " << model_type << "/" << task_type << " - model not found: " << model_path << "\n";
           continue;
         }
 
         for (bool use_gpu : {false, true}) {
-          BenchmarkConfig cfg;
+          BenchmarkConfig cfg = base;
           cfg.model_type  = model_type;
           cfg.task_type   = task_type;
           cfg.model_path  = model_path;
-          cfg.labels_path = "models/coco.names";
+          cfg.labels_path = labels_path;
           cfg.use_gpu     = use_gpu;
-          cfg.thread_count= 1;
+          cfg.reference_path = std::filesystem::exists(reference_path) ? reference_path : "";
 
+          const bool evaluate = !cfg.annotations_path.empty() && task_type != "classification" &&
+                                (task_type == "obb") == dota_annotations;
           try {
+            MapResult accuracy;
+            if (evaluate) accuracy = evaluateAccuracy(cfg);
             if (has_image) {
-              auto m_img = benchmark_image_comprehensive(cfg, image_path, image_iterations);
+              auto m_img = benchmark_image_comprehensive(cfg, image_path);
+              if (evaluate) applyAccuracy(accuracy, m_img);
               appendCSVRowToFile(results_file, cfg, m_img, "Image");
+              json_runs.push_back(toJSON(cfg, m_img, "Image"));
+              if (evaluate) pareto_points.push_back(makeParetoPoint(cfg, m_img, "Image"));
             }
             if (has_video) {
               auto m_vid = benchmark_video_comprehensive(cfg, video_path);
+              if (evaluate) applyAccuracy(accuracy, m_vid);
               appendCSVRowToFile(results_file, cfg, m_vid, "Video");
+              json_runs.push_back(toJSON(cfg, m_vid, "Video"));
+              if (evaluate) pareto_points.push_back(makeParetoPoint(cfg, m_vid, "Video"));
             }
             // small breather
             std::this_thread::sleep_for(std::chrono::milliseconds(150));
@@ -595,42 +1299,76 @@ int main(int argc, char** argv) {
           }
         }
       }
+      writeJSONFile(json_file, json_runs);
 
       std::cout << "Comprehensive benchmark completed.\n";
-      std::cout << "Results saved to: " << results_file << "\n";
+      std::cout << "Results saved to: " << results_file << " and " << json_file << "\n";
+      if (!pareto_points.empty()) {
+        const std::string pareto_file = results_stem + "_pareto.csv";
+        markParetoFront(pareto_points);
+        writeParetoReport(pareto_file, pareto_points);
+        printParetoFront(pareto_points);
+        std::cout << "Accuracy/latency Pareto report: " << pareto_file << "\n";
+      }
       return 0;
     }
 
     // Single-run modes
     BenchmarkConfig cfg = parseConfig(argc, argv);
     std::string input_path = argv[6];
-
-    int iterations = 100;
-    int duration   = 30;
-    for (int i = 7; i < argc; ++i) {
-      std::string arg = argv[i];
-      if (arg.rfind("--iterations=", 0) == 0) iterations = std::stoi(arg.substr(13));
-      else if (arg.rfind("--duration=", 0) == 0) duration = std::stoi(arg.substr(11));
+    if (!pinToCores(cfg.pin_cores)) std::cerr << "Warning: could not pin to the requested cores\n";
+    if (!cfg.metrics_path.empty()) yolos::instrumentation::setEnabled(true);
+    if (!cfg.trace_path.empty()) yolos::instrumentation::startTrace();
+
+    // Writes the trace and the stage metrics requested on the command line
+    auto writeInstrumentation = [&cfg]() {
+      if (!cfg.trace_path.empty()) {
+        yolos::instrumentation::stopTrace();
+        const uint64_t dropped = yolos::instrumentation::writeChromeTrace(cfg.trace_path);
+        if (dropped) std::cerr << "Warning: " << dropped << " trace events did not fit in the trace buffers\n";
+      }
+      if (!cfg.metrics_path.empty()) {
+        std::ofstream out(cfg.metrics_path);
+        if (!out) throw std::runtime_error("Cannot open metrics file: " + cfg.metrics_path);
+        yolos::instrumentation::writePrometheus(out);
+      }
+    };
+
+    if (mode == "throughput") {
+      std::cout << kThroughputCSVHeader;
+      auto points = benchmark_throughput(cfg, input_path, [&](const ThroughputPoint& p) {
+        writeThroughputRow(std::cout, cfg, p);
+        std::cout.flush();
+      });
+      printThroughputSummary(cfg, points);
+      if (!cfg.json_path.empty()) writeJSONFile(cfg.json_path, {throughputJSON(cfg, points)});
+      writeInstrumentation();
+      return 0;
     }
 
     // Print CSV header + one row to stdout
     printCSVHeader();
 
     PerformanceMetrics m;
+    std::string input_type;
     if (mode == "image") {
-      m = benchmark_image_comprehensive(cfg, input_path, iterations);
-      printCSVRow(cfg, m, "Image");
+      m = benchmark_image_comprehensive(cfg, input_path);
+      input_type = "Image";
     } else if (mode == "video") {
       m = benchmark_video_comprehensive(cfg, input_path);
-      printCSVRow(cfg, m, "Video");
+      input_type = "Video";
     } else if (mode == "camera") {
       int cam_id = std::stoi(input_path);
-      m = benchmark_camera_comprehensive(cfg, cam_id, duration);
-      printCSVRow(cfg, m, "Video"); // treat camera as Video stream
+      m = benchmark_camera_comprehensive(cfg, cam_id);
+      input_type = "Video"; // treat camera as Video stream
     } else {
-      std::cerr << "Error: invalid mode '" << mode << "'. Use image|video|camera|comprehensive.\n";
+      std::cerr << "Error: invalid mode '" << mode << "'. Use image|video|camera|throughput|comprehensive.\n";
       return 1;
     }
+    if (!cfg.annotations_path.empty()) applyAccuracy(evaluateAccuracy(cfg), m);
+    printCSVRow(cfg, m, input_type);
+    if (!cfg.json_path.empty()) writeJSONFile(cfg.json_path, {toJSON(cfg, m, input_type)});
+    writeInstrumentation();
   } catch (const std::exception& e) {
     std::cerr << "Exception: " << e.what() << "\n";
     return 1;
@@ -43,6 +43,9 @@
 // Assuming these are in a common 'tools' directory relative to this header
 #include "tools/Debug.hpp"
 #include "tools/ScopedTimer.hpp"
+#include "tools/YoloCore.hpp"
+#include "tools/DetectorOptions.hpp"
+#include "tools/Softmax.hpp"
 
 /**
  * @brief Struct to represent a classification result.
@@ -63,7 +66,7 @@ struct ClassificationResult {
  */
 namespace utils {
 
-    // ... (clamp, getClassNames, vectorProduct, preprocessImageToTensor, drawClassificationResult utilities remain the same as previous correct version) ...
+    // ... (clamp, getClassNames, vectorProduct, drawClassificationResult utilities remain the same as previous correct version) ...
     /**
      * @brief A robust implementation of a clamp function.
      * Restricts a value to lie within a specified range [low, high].
@@ -110,49 +113,6 @@ namespace utils {
         return std::accumulate(vector.begin(), vector.end(), 1LL, std::multiplies<int64_t>());
     }
 
-    /**
-     * @brief Prepares an image for model input by resizing and padding (letterboxing style) or simple resize.
-     */
-    inline void preprocessImageToTensor(const cv::Mat& image, cv::Mat& outImage,
-                                      const cv::Size& targetShape,
-                                      const cv::Scalar& color = cv::Scalar(0, 0, 0),
-                                      bool scaleUp = true,
-                                      const std::string& strategy = "resize") {
-        if (image.empty()) {
-            std::cerr << "ERROR: Input image to preprocessImageToTensor is empty." << std::endl;
-            return;
-        }
-
-        if (strategy == "letterbox") {
-            float r = std::min(static_cast<float>(targetShape.height) / image.rows,
-                               static_cast<float>(targetShape.width) / image.cols);
-            if (!scaleUp) {
-                r = std::min(r, 1.0f);
-            }
-            int newUnpadW = static_cast<int>(std::round(image.cols * r));
-            int newUnpadH = static_cast<int>(std::round(image.rows * r));
-
-            cv::Mat resizedTemp;
-            cv::resize(image, resizedTemp, cv::Size(newUnpadW, newUnpadH), 0, 0, cv::INTER_LINEAR);
-
-            int dw = targetShape.width - newUnpadW;
-            int dh = targetShape.height - newUnpadH;
-
-            int top = dh / 2;
-            int bottom = dh - top;
-            int left = dw / 2;
-            int right = dw - left;
-
-            cv::copyMakeBorder(resizedTemp, outImage, top, bottom, left, right, cv::BORDER_CONSTANT, color);
-        } else { // Default to "resize"
-            if (image.size() == targetShape) {
-                outImage = image.clone();
-            } else {
-                cv::resize(image, outImage, targetShape, 0, 0, cv::INTER_LINEAR);
-            }
-        }
-    }
-
     /**
      * @brief Draws the classification result on the image.
      */
@@ -204,6 +164,16 @@ namespace utils {
 }; // end namespace utils
 
 
+/**
+ * @brief YoloCore policy: input resized (not letterboxed) to the target shape, one [1, num_classes] output.
+ */
+struct ClassificationTaskPolicy {
+    static constexpr yolos::InputTransform transform = yolos::InputTransform::Stretch;
+    static constexpr size_t outputs = 1;
+    static constexpr const char *preprocessStage = "classification.preprocess";
+    static constexpr const char *preprocessBatchStage = "classification.preprocess_batch";
+};
+
 /**
  * @brief YOLO11Classifier class handles loading the classification model,
  * preprocessing images, running inference, and postprocessing results.
@@ -216,11 +186,47 @@ public:
     YOLO11Classifier(const std::string &modelPath, const std::string &labelsPath,
                     bool useGPU = false, const cv::Size& targetInputShape = cv::Size(224, 224));
 
+    /**
+     * @brief Constructor with explicit execution-provider and threading options.
+     */
+    YOLO11Classifier(const std::string &modelPath, const std::string &labelsPath,
+                     const yolos::DetectorOptions &options, const cv::Size& targetInputShape = cv::Size(224, 224));
+
     /**
      * @brief Runs classification on the provided image.
      */
     ClassificationResult classify(const cv::Mat &image);
 
+    /**
+     * @brief Runs classification on a batch of images with a single session run per model batch.
+     *        Dynamic-batch models take the whole request at once; fixed-batch models run in chunks.
+     */
+    std::vector<ClassificationResult> classifyBatch(const std::vector<cv::Mat> &images);
+
+    /**
+     * @brief Returns the topK best classes of the image, best first.
+     *
+     * @param probabilities Report softmax probabilities as confidence; false skips the softmax
+     *                      and reports the raw scores (enough when only the ranking matters).
+     */
+    std::vector<ClassificationResult> classifyTopK(const cv::Mat &image, int topK, bool probabilities = true);
+
+    /**
+     * @brief Classifies regions of one frame (e.g. detected objects) in a single batch.
+     *
+     * The regions are read in place as views of the frame and resized in parallel into one batch
+     * tensor; the top-k decoding of the crops runs in parallel as well. ROIs are clipped to the
+     * frame; an ROI with nothing left gets an empty result.
+     *
+     * @param frame Parent frame.
+     * @param rois Regions to classify, in frame coordinates.
+     * @param topK Classes returned per region, best first.
+     * @param probabilities Softmax probabilities (true) or raw scores (false) as confidence.
+     * @return One top-k list per ROI, in ROI order.
+     */
+    std::vector<std::vector<ClassificationResult>> classifyBatch(const cv::Mat &frame, const std::vector<cv::Rect> &rois,
+                                                                 int topK = 1, bool probabilities = true);
+
     /**
      * @brief Draws the classification result on the image.
      */
@@ -229,113 +235,79 @@ public:
         utils::drawClassificationResult(image, result, position);
     }
 
-    cv::Size getInputShape() const { return inputImageShape_; } // CORRECTED
-    bool isModelInputShapeDynamic() const { return isDynamicInputShape_; } // CORRECTED
+    cv::Size getInputShape() const { return core_.inputImageShape(); }
+    bool isModelInputShapeDynamic() const { return core_.isDynamicInputShape(); }
+    const std::string &getPrecision() const { return core_.precision(); }
 
+    /**
+     * @brief Runs dummy inferences so that lazy initialization (memory arenas, kernel and
+     *        algorithm selection, TensorRT engine builds) happens before the first real frame.
+     *
+     * @param imageSizes Frame sizes to expect; they matter for dynamic-shape models, whose
+     *                   letterbox follows the aspect ratio (default: every input bucket, or
+     *                   the model input size).
+     * @param iterations Runs per size.
+     */
+    void warmup(const std::vector<cv::Size> &imageSizes = {}, int iterations = 2) {
+        const std::vector<cv::Size> sizes = imageSizes.empty() ? core_.warmupSizes() : imageSizes;
+        for (const cv::Size &size : sizes) {
+            const cv::Mat frame(size, CV_8UC3, cv::Scalar(114, 114, 114));
+            for (int i = 0; i < iterations; ++i) {
+                classify(frame);
+            }
+        }
+    }
 
 private:
-    Ort::Env env_{nullptr};
-    Ort::SessionOptions sessionOptions_{nullptr};
-    Ort::Session session_{nullptr};
-
-    bool isDynamicInputShape_{};
-    cv::Size inputImageShape_{};
-
-    std::vector<Ort::AllocatedStringPtr> inputNodeNameAllocatedStrings_{};
-    std::vector<const char *> inputNames_{};
-    std::vector<Ort::AllocatedStringPtr> outputNodeNameAllocatedStrings_{};
-    std::vector<const char *> outputNames_{};
+    yolos::YoloCore<ClassificationTaskPolicy> core_;  // Session, bound tensors, preprocessing and batching
 
-    size_t numInputNodes_{}, numOutputNodes_{};
     int numClasses_{0};
 
     std::vector<std::string> classNames_{};
 
-    void preprocess(const cv::Mat &image, float *&blob, std::vector<int64_t> &inputTensorShape);
-    ClassificationResult postprocess(const std::vector<Ort::Value> &outputTensors);
+    ClassificationResult postprocess(const float *rawOutput, const std::vector<int64_t> &outputShape) const;
+    // Thread-safe: batches decode their images in parallel
+    std::vector<ClassificationResult> postprocessTopK(const float *rawOutput, const std::vector<int64_t> &outputShape,
+                                                      int topK, bool probabilities) const;
 };
 
 // Implementation of YOLO11Classifier constructor
 YOLO11Classifier::YOLO11Classifier(const std::string &modelPath, const std::string &labelsPath,
-                                 bool useGPU, const cv::Size& targetInputShape)
-    : inputImageShape_(targetInputShape) {
-    env_ = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "ONNX_CLASSIFICATION_ENV");
-    sessionOptions_ = Ort::SessionOptions();
-
-    sessionOptions_.SetIntraOpNumThreads(std::min(4, static_cast<int>(std::thread::hardware_concurrency())));
-    sessionOptions_.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-
-    std::vector<std::string> availableProviders = Ort::GetAvailableProviders();
-    auto cudaAvailable = std::find(availableProviders.begin(), availableProviders.end(), "CUDAExecutionProvider");
-    OrtCUDAProviderOptions cudaOption{};
-
-    if (useGPU && cudaAvailable != availableProviders.end()) {
-        DEBUG_PRINT("Attempting to use GPU for inference.");
-        sessionOptions_.AppendExecutionProvider_CUDA(cudaOption);
-    } else {
-        if (useGPU) {
-            std::cout << "Warning: GPU requested but CUDAExecutionProvider is not available. Falling back to CPU." << std::endl;
-        }
-        DEBUG_PRINT("Using CPU for inference.");
-    }
-
-#ifdef _WIN32
-    std::wstring w_modelPath = std::wstring(modelPath.begin(), modelPath.end());
-    session_ = Ort::Session(env_, w_modelPath.c_str(), sessionOptions_);
-#else
-    session_ = Ort::Session(env_, modelPath.c_str(), sessionOptions_);
-#endif
+                                   bool useGPU, const cv::Size& targetInputShape)
+    : YOLO11Classifier(modelPath, labelsPath, yolos::DetectorOptions::fromUseGPU(useGPU, 4), targetInputShape) {}
 
-    Ort::AllocatorWithDefaultOptions allocator;
-
-    numInputNodes_ = session_.GetInputCount();
-    numOutputNodes_ = session_.GetOutputCount();
-
-    if (numInputNodes_ == 0) throw std::runtime_error("Model has no input nodes.");
-    if (numOutputNodes_ == 0) throw std::runtime_error("Model has no output nodes.");
-
-    auto input_node_name = session_.GetInputNameAllocated(0, allocator);
-    inputNodeNameAllocatedStrings_.push_back(std::move(input_node_name));
-    inputNames_.push_back(inputNodeNameAllocatedStrings_.back().get());
-
-    Ort::TypeInfo inputTypeInfo = session_.GetInputTypeInfo(0);
-    auto inputTensorInfo = inputTypeInfo.GetTensorTypeAndShapeInfo();
-    std::vector<int64_t> modelInputTensorShapeVec = inputTensorInfo.GetShape();
+YOLO11Classifier::YOLO11Classifier(const std::string &modelPath, const std::string &labelsPath,
+                                   const yolos::DetectorOptions &options, const cv::Size& targetInputShape)
+    : core_(modelPath, options, nullptr, nullptr, targetInputShape) {
+    const cv::Size &inputImageShape = core_.inputImageShape();
+    const std::vector<int64_t> &modelInputTensorShapeVec = core_.modelInputShape();
 
     if (modelInputTensorShapeVec.size() == 4) {
-        isDynamicInputShape_ = (modelInputTensorShapeVec[2] == -1 || modelInputTensorShapeVec[3] == -1);
         DEBUG_PRINT("Model input tensor shape from metadata: "
                     << modelInputTensorShapeVec[0] << "x" << modelInputTensorShapeVec[1] << "x"
                     << modelInputTensorShapeVec[2] << "x" << modelInputTensorShapeVec[3]);
 
-        if (!isDynamicInputShape_) {
+        if (!core_.isDynamicInputShape()) {
             int modelH = static_cast<int>(modelInputTensorShapeVec[2]);
             int modelW = static_cast<int>(modelInputTensorShapeVec[3]);
-            if (modelH != inputImageShape_.height || modelW != inputImageShape_.width) {
-                std::cout << "Warning: Target preprocessing shape (" << inputImageShape_.height << "x" << inputImageShape_.width
+            if (modelH != inputImageShape.height || modelW != inputImageShape.width) {
+                std::cout << "Warning: Target preprocessing shape (" << inputImageShape.height << "x" << inputImageShape.width
                           << ") differs from model's fixed input shape (" << modelH << "x" << modelW << "). "
-                          << "Image will be preprocessed to " << inputImageShape_.height << "x" << inputImageShape_.width << "."
+                          << "Image will be preprocessed to " << inputImageShape.height << "x" << inputImageShape.width << "."
                           << " Consider aligning these for optimal performance/accuracy." << std::endl;
             }
         } else {
             DEBUG_PRINT("Model has dynamic input H/W. Preprocessing to specified target: "
-                        << inputImageShape_.height << "x" << inputImageShape_.width);
+                        << inputImageShape.height << "x" << inputImageShape.width);
         }
     } else {
         std::cerr << "Warning: Model input tensor does not have 4 dimensions as expected (NCHW). Shape: [";
         for(size_t i=0; i<modelInputTensorShapeVec.size(); ++i) std::cerr << modelInputTensorShapeVec[i] << (i==modelInputTensorShapeVec.size()-1 ? "" : ", ");
         std::cerr << "]. Assuming dynamic shape and proceeding with target HxW: "
-                  << inputImageShape_.height << "x" << inputImageShape_.width << std::endl;
-        isDynamicInputShape_ = true;
+                  << inputImageShape.height << "x" << inputImageShape.width << std::endl;
     }
 
-    auto output_node_name = session_.GetOutputNameAllocated(0, allocator);
-    outputNodeNameAllocatedStrings_.push_back(std::move(output_node_name));
-    outputNames_.push_back(outputNodeNameAllocatedStrings_.back().get());
-
-    Ort::TypeInfo outputTypeInfo = session_.GetOutputTypeInfo(0);
-    auto outputTensorInfo = outputTypeInfo.GetTensorTypeAndShapeInfo();
-    std::vector<int64_t> outputTensorShapeVec = outputTensorInfo.GetShape();
+    const std::vector<int64_t> outputTensorShapeVec = core_.modelOutputShape(0);
     
     if (!outputTensorShapeVec.empty()) {
         if (outputTensorShapeVec.size() == 2 && outputTensorShapeVec[0] > 0) { 
@@ -384,100 +356,20 @@ YOLO11Classifier::YOLO11Classifier(const std::string &modelPath, const std::stri
     std::cout << "YOLO11Classifier initialized successfully. Model: " << modelPath << std::endl;
 }
 
-// ... (preprocess, postprocess, and classify methods remain the same as previous correct version) ...
-void YOLO11Classifier::preprocess(const cv::Mat &image, float *&blob, std::vector<int64_t> &inputTensorShape) {
-    ScopedTimer timer("Preprocessing (Ultralytics-style)");
-
-    if (image.empty()) {
-        throw std::runtime_error("Input image to preprocess is empty.");
-    }
-
-    cv::Mat processedImage;
-    // 1. Resize to target input shape (e.g., 224x224).
-    //    The color cv::Scalar(0,0,0) is for padding if 'letterbox' strategy were used; unused for 'resize'.
-    utils::preprocessImageToTensor(image, processedImage, inputImageShape_, cv::Scalar(0, 0, 0), true, "resize");
-
-    // 2. Convert BGR (OpenCV default) to RGB
-    cv::Mat rgbImageMat; // Use a different name to avoid confusion if processedImage was already RGB
-    cv::cvtColor(processedImage, rgbImageMat, cv::COLOR_BGR2RGB);
-
-    // 3. Convert to float32. At this point, values are typically in [0, 255] range.
-    cv::Mat floatRgbImage;
-    rgbImageMat.convertTo(floatRgbImage, CV_32F);
-
-    // Set the actual NCHW tensor shape for this specific input
-    // Model expects NCHW: Batch=1, Channels=3 (RGB), Height, Width
-    inputTensorShape = {1, 3, static_cast<int64_t>(floatRgbImage.rows), static_cast<int64_t>(floatRgbImage.cols)};
-
-    if (static_cast<int>(inputTensorShape[2]) != inputImageShape_.height || static_cast<int>(inputTensorShape[3]) != inputImageShape_.width) {
-        std::cerr << "CRITICAL WARNING: Preprocessed image dimensions (" << inputTensorShape[2] << "x" << inputTensorShape[3]
-                  << ") do not match target inputImageShape_ (" << inputImageShape_.height << "x" << inputImageShape_.width
-                  << ") after resizing! This indicates an issue in utils::preprocessImageToTensor or logic." << std::endl;
-    }
-
-    size_t tensorSize = utils::vectorProduct(inputTensorShape); // 1 * C * H * W
-    blob = new float[tensorSize];
-
-    // 4. Scale pixel values to [0.0, 1.0] and convert HWC to CHW
-    int h = static_cast<int>(inputTensorShape[2]); // Height
-    int w = static_cast<int>(inputTensorShape[3]); // Width
-    int num_channels = static_cast<int>(inputTensorShape[1]); // Should be 3
-
-    if (num_channels != 3) {
-         delete[] blob; // Clean up allocated memory
-         throw std::runtime_error("Expected 3 channels for image blob after RGB conversion, but tensor shape indicates: " + std::to_string(num_channels));
-    }
-    if (floatRgbImage.channels() != 3) {
-        delete[] blob;
-        throw std::runtime_error("Expected 3 channels in cv::Mat floatRgbImage, but got: " + std::to_string(floatRgbImage.channels()));
-    }
-
-    for (int c_idx = 0; c_idx < num_channels; ++c_idx) {      // Iterate over R, G, B channels
-        for (int i = 0; i < h; ++i) {     // Iterate over rows (height)
-            for (int j = 0; j < w; ++j) { // Iterate over columns (width)
-                // floatRgbImage is HWC (i is row, j is col, c_idx is channel index in Vec3f)
-                // floatRgbImage pixel values are float and in [0, 255] range.
-                float pixel_value = floatRgbImage.at<cv::Vec3f>(i, j)[c_idx];
-
-                // Scale to [0.0, 1.0]
-                float scaled_pixel = pixel_value / 255.0f;
-
-                // Store in blob (CHW format)
-                blob[c_idx * (h * w) + i * w + j] = scaled_pixel;
-            }
-        }
-    }
-
-    DEBUG_PRINT("Preprocessing completed (RGB, scaled [0,1]). Actual input tensor shape: "
-                << inputTensorShape[0] << "x" << inputTensorShape[1] << "x"
-                << inputTensorShape[2] << "x" << inputTensorShape[3]);
+ClassificationResult YOLO11Classifier::postprocess(const float *rawOutput, const std::vector<int64_t> &outputShape) const {
+    std::vector<ClassificationResult> best = postprocessTopK(rawOutput, outputShape, 1, true);
+    return best.empty() ? ClassificationResult{} : std::move(best.front());
 }
-ClassificationResult YOLO11Classifier::postprocess(const std::vector<Ort::Value> &outputTensors) {
-    ScopedTimer timer("Postprocessing");
 
-    if (outputTensors.empty()) {
-        std::cerr << "Error: No output tensors for postprocessing." << std::endl;
-        return {};
-    }
+std::vector<ClassificationResult> YOLO11Classifier::postprocessTopK(const float *rawOutput, const std::vector<int64_t> &outputShape,
+                                                                    int topK, bool probabilities) const {
+    ScopedTimer timer("classification.postprocess");
 
-    const float* rawOutput = outputTensors[0].GetTensorData<float>();
     if (!rawOutput) {
         std::cerr << "Error: rawOutput pointer is null." << std::endl;
         return {};
     }
 
-    const std::vector<int64_t> outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
-    size_t numScores = utils::vectorProduct(outputShape);
-
-    // Debug output shape
-    std::ostringstream oss_shape;
-    oss_shape << "Output tensor shape: [";
-    for (size_t i = 0; i < outputShape.size(); ++i) {
-        oss_shape << outputShape[i] << (i == outputShape.size() - 1 ? "" : ", ");
-    }
-    oss_shape << "]";
-    DEBUG_PRINT(oss_shape.str());
-
     // Determine the effective number of classes
     int currentNumClasses = numClasses_ > 0 ? numClasses_ : static_cast<int>(classNames_.size());
     if (currentNumClasses <= 0) {
@@ -485,137 +377,131 @@ ClassificationResult YOLO11Classifier::postprocess(const std::vector<Ort::Value>
         return {};
     }
 
-    // Debug first few raw scores
-    std::ostringstream oss_scores;
-    oss_scores << "First few raw scores: ";
-    for (size_t i = 0; i < std::min(size_t(5), numScores); ++i) {
-        oss_scores << rawOutput[i] << " ";
-    }
-    DEBUG_PRINT(oss_scores.str());
-
-    // Find maximum score and its corresponding class
-    int bestClassId = -1;
-    float maxScore = -std::numeric_limits<float>::infinity();
-    std::vector<float> scores(currentNumClasses);
-
-    // Handle different output shapes
-    if (outputShape.size() == 2 && outputShape[0] == 1) {
-        // Case 1: [1, num_classes] shape
-        for (int i = 0; i < currentNumClasses && i < static_cast<int>(outputShape[1]); ++i) {
-            scores[i] = rawOutput[i];
-            if (scores[i] > maxScore) {
-                maxScore = scores[i];
-                bestClassId = i;
-            }
-        }
-    } else if (outputShape.size() == 1 || (outputShape.size() == 2 && outputShape[0] > 1)) {
-        // Case 2: [num_classes] shape or [batch_size, num_classes] shape (take first batch)
-        for (int i = 0; i < currentNumClasses && i < static_cast<int>(numScores); ++i) {
-            scores[i] = rawOutput[i];
-            if (scores[i] > maxScore) {
-                maxScore = scores[i];
-                bestClassId = i;
-            }
-        }
-    }
-
-    if (bestClassId == -1) {
+    // [1, num_classes] or [num_classes] (a [batch, num_classes] tensor is read from its first row);
+    // the scores are read in place
+    const int numScores = static_cast<int>(std::min<size_t>(currentNumClasses, utils::vectorProduct(outputShape)));
+    if (numScores <= 0) {
         std::cerr << "Error: Could not determine best class ID." << std::endl;
         return {};
     }
 
-    // Apply softmax to get probabilities
-    float sumExp = 0.0f;
-    std::vector<float> probabilities(currentNumClasses);
-    
-    // Compute softmax with numerical stability
-    for (int i = 0; i < currentNumClasses; ++i) {
-        probabilities[i] = std::exp(scores[i] - maxScore);
-        sumExp += probabilities[i];
-    }
+    // Ranking is done on the raw scores (softmax is monotonic); the softmax only normalises the reported ones
+    thread_local std::vector<int> indices;
+    yolos::topKIndices(rawOutput, numScores, std::max(1, topK), indices);
+    const yolos::SoftmaxNorm norm = probabilities ? yolos::softmaxNorm(rawOutput, numScores) : yolos::SoftmaxNorm{};
 
-    // Calculate final confidence
-    float confidence = sumExp > 0 ? probabilities[bestClassId] / sumExp : 0.0f;
-
-    // Get class name
-    std::string className = "Unknown";
-    if (bestClassId >= 0 && static_cast<size_t>(bestClassId) < classNames_.size()) {
-        className = classNames_[bestClassId];
-    } else if (bestClassId >= 0) {
-        className = "ClassID_" + std::to_string(bestClassId);
+    std::vector<ClassificationResult> results;
+    results.reserve(indices.size());
+    for (int classId : indices) {
+        const float confidence = probabilities ? norm.probability(rawOutput[classId]) : rawOutput[classId];
+        std::string className = static_cast<size_t>(classId) < classNames_.size()
+                                    ? classNames_[classId]
+                                    : "ClassID_" + std::to_string(classId);
+        results.emplace_back(classId, confidence, std::move(className));
     }
 
-    DEBUG_PRINT("Best class ID: " << bestClassId << ", Name: " << className << ", Confidence: " << confidence);
-    return ClassificationResult(bestClassId, confidence, className);
+    DEBUG_PRINT("Best class ID: " << results.front().classId << ", Name: " << results.front().className
+                << ", Confidence: " << results.front().confidence);
+    return results;
 }
 
 ClassificationResult YOLO11Classifier::classify(const cv::Mat& image) {
-    ScopedTimer timer("Overall classification task");
+    ScopedTimer timer("classification.classify");
 
     if (image.empty()) {
         std::cerr << "Error: Input image for classification is empty." << std::endl;
         return {};
     }
 
-    float* blobPtr = nullptr;
-    std::vector<int64_t> currentInputTensorShape; 
-
+    // The image is resized straight into the bound input tensor; the scores land in the pre-bound output buffer
     try {
-        preprocess(image, blobPtr, currentInputTensorShape);
+        return core_.run(image, [this](const cv::Size &, const cv::Size &, const yolos::ImageOutputs &outputs) {
+            return postprocess(outputs.data(), outputs.shape());
+        });
+    } catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime Exception during Run(): " << e.what() << std::endl;
+        return {};
     } catch (const std::exception& e) {
-        std::cerr << "Exception during preprocessing: " << e.what() << std::endl;
-        if (blobPtr) delete[] blobPtr;
+        std::cerr << "Exception during classification: " << e.what() << std::endl;
         return {};
     }
+}
 
-    if (!blobPtr) {
-        std::cerr << "Error: Preprocessing failed to produce a valid data blob." << std::endl;
-        return {};
-    }
+std::vector<ClassificationResult> YOLO11Classifier::classifyBatch(const std::vector<cv::Mat>& images) {
+    ScopedTimer timer("classification.classify_batch");
 
-    size_t inputTensorSize = utils::vectorProduct(currentInputTensorShape);
-    if (inputTensorSize == 0) {
-        std::cerr << "Error: Input tensor size is zero after preprocessing." << std::endl;
-        delete[] blobPtr;
-        return {};
+    try {
+        // Every image is decoded from its [1, num_classes] row of the batched scores, in parallel
+        return core_.runBatch<true>(images, [this](const cv::Size &, const cv::Size &, const yolos::ImageOutputs &outputs) {
+            try {
+                return postprocess(outputs.data(), outputs.shape());
+            } catch (const std::exception& e) {
+                std::cerr << "Exception during postprocessing: " << e.what() << std::endl;
+                return ClassificationResult{};
+            }
+        });
+    } catch (const std::exception& e) {
+        std::cerr << "Exception during batch classification: " << e.what() << std::endl;
+        // Keep results aligned with the inputs
+        return std::vector<ClassificationResult>(images.size());
     }
+}
 
-    Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-        memoryInfo,
-        blobPtr, 
-        inputTensorSize,
-        currentInputTensorShape.data(),
-        currentInputTensorShape.size()
-    );
+std::vector<ClassificationResult> YOLO11Classifier::classifyTopK(const cv::Mat &image, int topK, bool probabilities) {
+    ScopedTimer timer("classification.classify");
 
-    delete[] blobPtr;
-    blobPtr = nullptr;
+    if (image.empty()) {
+        std::cerr << "Error: Input image for classification is empty." << std::endl;
+        return {};
+    }
 
-    std::vector<Ort::Value> outputTensors;
     try {
-        outputTensors = session_.Run(
-            Ort::RunOptions{nullptr},
-            inputNames_.data(),
-            &inputTensor,
-            numInputNodes_,
-            outputNames_.data(),
-            numOutputNodes_
-        );
-    } catch (const Ort::Exception& e) {
-        std::cerr << "ONNX Runtime Exception during Run(): " << e.what() << std::endl;
+        return core_.run(image, [&](const cv::Size &, const cv::Size &, const yolos::ImageOutputs &outputs) {
+            return postprocessTopK(outputs.data(), outputs.shape(), topK, probabilities);
+        });
+    } catch (const std::exception& e) {
+        std::cerr << "Exception during classification: " << e.what() << std::endl;
         return {};
     }
+}
 
-    if (outputTensors.empty()) {
-        std::cerr << "Error: ONNX Runtime Run() produced no output tensors." << std::endl;
-        return {};
+std::vector<std::vector<ClassificationResult>> YOLO11Classifier::classifyBatch(const cv::Mat &frame, const std::vector<cv::Rect> &rois,
+                                                                               int topK, bool probabilities) {
+    ScopedTimer timer("classification.classify_batch");
+
+    std::vector<std::vector<ClassificationResult>> results(rois.size());
+    if (frame.empty()) {
+        std::cerr << "Error: Input frame for classification is empty." << std::endl;
+        return results;
+    }
+
+    // Views into the frame: no pixel is copied before the batch tensor
+    const cv::Rect bounds(0, 0, frame.cols, frame.rows);
+    std::vector<cv::Mat> crops;
+    std::vector<size_t> owners;
+    crops.reserve(rois.size());
+    owners.reserve(rois.size());
+    for (size_t i = 0; i < rois.size(); ++i) {
+        const cv::Rect roi = rois[i] & bounds;
+        if (roi.area() > 0) {
+            crops.emplace_back(frame, roi);
+            owners.push_back(i);
+        }
+    }
+    if (crops.empty()) {
+        return results;
     }
 
     try {
-        return postprocess(outputTensors);
+        std::vector<std::vector<ClassificationResult>> decoded = core_.runBatch<true>(
+            crops, [&](const cv::Size &, const cv::Size &, const yolos::ImageOutputs &outputs) {
+                return postprocessTopK(outputs.data(), outputs.shape(), topK, probabilities);
+            });
+        for (size_t c = 0; c < decoded.size(); ++c) {
+            results[owners[c]] = std::move(decoded[c]);
+        }
     } catch (const std::exception& e) {
-        std::cerr << "Exception during postprocessing: " << e.what() << std::endl;
-        return {};
+        std::cerr << "Exception during batch classification: " << e.what() << std::endl;
     }
-}
\ No newline at end of file
+    return results;
+}
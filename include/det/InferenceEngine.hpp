@@ -0,0 +1,332 @@
+#pragma once
+
+// ===================================
+// Multi-Stream Inference Engine Header File
+// ===================================
+//
+// This header defines the InferenceEngine class, which serves detection requests from many
+// producers (e.g. one thread per camera) with a pool of YOLODetector sessions sharing one
+// ONNX Runtime environment.
+//
+// ================================
+
+/**
+ * @file InferenceEngine.hpp
+ * @brief Session pool with fair, micro-batched scheduling across streams.
+ *
+ * A YOLODetector is not safe to call concurrently, so serving N cameras used to mean N
+ * detectors, each with its own Env, thread pool and weights. InferenceEngine creates a
+ * small pool of detectors on one yolos::SharedRuntime (one Env, shared prepacked weights,
+ * optionally one global thread pool) and feeds them from per-stream bounded queues:
+ *
+ *  - Each stream has its own BoundedThreadSafeQueue, so a fast producer blocks on its own
+ *    queue instead of starving the others.
+ *  - A worker assembles a micro-batch by visiting the streams round-robin, taking at most
+ *    one frame per stream per pass, until it has maxBatch frames or maxWait has elapsed
+ *    since it started waiting. The next sweep starts after the last stream served.
+ *  - The batch runs through YOLODetector::detectBatch() and every frame's std::future is
+ *    fulfilled; while one worker runs its batch, the next one is already gathering.
+ */
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "det/YOLO.hpp"
+#include "tools/BoundedThreadSafeQueue.hpp"
+#include "tools/SharedRuntime.hpp"
+
+/**
+ * @brief Configuration of an InferenceEngine.
+ */
+struct InferenceEngineOptions {
+    size_t numSessions = 2;                                 // Detectors (sessions) in the pool
+    size_t maxBatch = 8;                                    // Frames per micro-batch (capped by a fixed model batch)
+    std::chrono::microseconds maxWait{2000};                // Longest wait for a batch to fill up
+    size_t queueCapacity = 4;                               // Pending frames per stream before submit() blocks
+    yolos::DetectorOptions detector;                        // Providers of the sessions; intraOpThreads/allowSpinning
+                                                            // configure the shared ONNX Runtime pool
+    float confThreshold = 0.4f;                             // Confidence threshold of every request
+    float iouThreshold = 0.45f;                             // IoU threshold of every request
+    int warmupIterations = 0;                               // Dummy runs per session before serving
+};
+
+class InferenceEngine {
+public:
+    /**
+     * @brief Loads the model into numSessions detectors and starts one worker per detector.
+     *
+     * @param modelPath Path to the ONNX model file.
+     * @param labelsPath Path to the file containing class labels.
+     * @param options Pool and scheduling configuration.
+     */
+    InferenceEngine(const std::string &modelPath, const std::string &labelsPath,
+                    const InferenceEngineOptions &options = InferenceEngineOptions())
+        : options(options) {
+        if (this->options.numSessions == 0 || this->options.maxBatch == 0 || this->options.queueCapacity == 0) {
+            throw std::invalid_argument("InferenceEngine: numSessions, maxBatch and queueCapacity must be positive.");
+        }
+
+        runtime = std::make_shared<yolos::SharedRuntime>(this->options.detector.intraOpThreads,
+                                                         this->options.detector.allowSpinning);
+        for (size_t i = 0; i < this->options.numSessions; ++i) {
+            detectors.emplace_back(new YOLODetector(modelPath, labelsPath, this->options.detector, runtime));
+        }
+
+        // Fixed-batch models run in chunks of their batch size; larger batches would only queue up inside detectBatch()
+        const int64_t modelBatch = detectors.front()->getBatchSize();
+        if (modelBatch > 0) {
+            this->options.maxBatch = std::min(this->options.maxBatch, static_cast<size_t>(modelBatch));
+        }
+
+        // Warm up before the workers own the detectors
+        if (this->options.warmupIterations > 0) {
+            for (auto &detector : detectors) {
+                detector->warmup({}, this->options.warmupIterations);
+            }
+        }
+
+        for (size_t i = 0; i < detectors.size(); ++i) {
+            workers.emplace_back(&InferenceEngine::workerLoop, this, detectors[i].get());
+        }
+    }
+
+    ~InferenceEngine() { stop(); }
+
+    InferenceEngine(const InferenceEngine &) = delete;
+    InferenceEngine &operator=(const InferenceEngine &) = delete;
+
+    /**
+     * @brief Registers a new producer stream.
+     *
+     * @return int Stream id to pass to submit().
+     */
+    int addStream() {
+        std::lock_guard<std::mutex> lock(streamsMutex);
+        streams.emplace_back(new BoundedThreadSafeQueue<Request>(options.queueCapacity));
+        // stop() finishes the streams it finds under streamsMutex; one added after that starts finished
+        bool stopped;
+        {
+            std::lock_guard<std::mutex> signal(signalMutex);
+            stopped = stopping;
+        }
+        if (stopped) {
+            streams.back()->set_finished();
+        }
+        return static_cast<int>(streams.size()) - 1;
+    }
+
+    /**
+     * @brief Stops accepting frames from a stream; frames already queued are still processed.
+     */
+    void closeStream(int streamId) { stream(streamId).set_finished(); }
+
+    /**
+     * @brief Queues a frame of a stream for detection, blocking while the stream's queue is full.
+     *
+     * @param streamId Id returned by addStream().
+     * @param frame Input image; it is shared, not copied, so the caller must not write to it until the result is ready.
+     * @return std::future<std::vector<Detection>> Detections of the frame. If the engine is stopped or the
+     *         stream closed, the future holds a std::runtime_error.
+     */
+    std::future<std::vector<Detection>> submit(int streamId, const cv::Mat &frame) {
+        BoundedThreadSafeQueue<Request> &queue = stream(streamId);
+        {
+            // Counted before the enqueue, so a concurrent stop() keeps the workers until it is settled
+            std::lock_guard<std::mutex> lock(signalMutex);
+            if (stopping) {
+                return rejected("InferenceEngine: engine is stopped.");
+            }
+            ++submitting;
+        }
+
+        Request request;
+        request.frame = frame;
+        std::future<std::vector<Detection>> result = request.promise.get_future();
+        const bool queued = queue.enqueue(std::move(request));
+
+        bool stopped;
+        {
+            std::lock_guard<std::mutex> lock(signalMutex);
+            --submitting;
+            if (queued) {
+                ++pending;
+            }
+            stopped = stopping;
+        }
+        if (stopped) {
+            frameAvailable.notify_all();
+        } else if (queued) {
+            frameAvailable.notify_one();
+        }
+        return queued ? std::move(result) : rejected("InferenceEngine: stream is closed.");
+    }
+
+    /**
+     * @brief Processes the queued frames, then joins the workers. Later submissions are rejected,
+     *        including those to streams added after the call.
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(signalMutex);
+            if (stopping) {
+                return;
+            }
+            stopping = true;
+        }
+        {
+            std::lock_guard<std::mutex> lock(streamsMutex);
+            for (auto &queue : streams) {
+                queue->set_finished();
+            }
+        }
+        frameAvailable.notify_all();
+        for (std::thread &worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the effective scheduling configuration (maxBatch is capped to a fixed model batch).
+     */
+    const InferenceEngineOptions &getOptions() const { return options; }
+
+    /**
+     * @brief Draws bounding boxes on the image based on detections.
+     */
+    void drawBoundingBox(cv::Mat &image, const std::vector<Detection> &detections) const {
+        detectors.front()->drawBoundingBox(image, detections);
+    }
+
+private:
+    struct Request {
+        cv::Mat frame;
+        std::promise<std::vector<Detection>> promise;
+    };
+
+    InferenceEngineOptions options;
+    std::shared_ptr<yolos::SharedRuntime> runtime;              // Env and weights shared by the pool
+    std::vector<std::unique_ptr<YOLODetector>> detectors;       // One per worker
+    std::vector<std::thread> workers;
+
+    std::mutex streamsMutex;                                    // Guards streams and nextStream
+    std::vector<std::unique_ptr<BoundedThreadSafeQueue<Request>>> streams;
+    size_t nextStream = 0;                                      // Round-robin cursor
+
+    std::mutex gatherMutex;                                     // One worker gathers a batch at a time
+    std::mutex signalMutex;                                     // Guards pending and stopping
+    std::condition_variable frameAvailable;
+    long pending = 0;                                           // Frames queued over all streams
+    long submitting = 0;                                        // submit() calls between their check and enqueue
+    bool stopping = false;
+
+    static std::future<std::vector<Detection>> rejected(const char *message) {
+        std::promise<std::vector<Detection>> promise;
+        promise.set_exception(std::make_exception_ptr(std::runtime_error(message)));
+        return promise.get_future();
+    }
+
+    // Stopped with nothing queued and no submission in flight (signalMutex held)
+    bool drained() const { return stopping && pending <= 0 && submitting == 0; }
+
+    BoundedThreadSafeQueue<Request> &stream(int streamId) {
+        std::lock_guard<std::mutex> lock(streamsMutex);
+        if (streamId < 0 || static_cast<size_t>(streamId) >= streams.size()) {
+            throw std::out_of_range("InferenceEngine: unknown stream id.");
+        }
+        return *streams[streamId];
+    }
+
+    // One round-robin sweep over the streams, taking at most one frame from each
+    void pullRoundRobin(std::vector<Request> &batch) {
+        size_t taken = 0;
+        {
+            std::lock_guard<std::mutex> lock(streamsMutex);
+            const size_t count = streams.size();
+            for (size_t visited = 0; visited < count && batch.size() < options.maxBatch; ++visited) {
+                const size_t s = (nextStream + visited) % count;
+                Request request;
+                if (streams[s]->try_dequeue(request)) {
+                    batch.push_back(std::move(request));
+                    ++taken;
+                    nextStream = (s + 1) % count;
+                }
+            }
+        }
+        if (taken > 0) {
+            std::lock_guard<std::mutex> lock(signalMutex);
+            pending -= static_cast<long>(taken);
+        }
+    }
+
+    // Collects up to maxBatch frames; returns false once the engine is stopped and drained
+    bool gatherBatch(std::vector<Request> &batch) {
+        std::lock_guard<std::mutex> gather(gatherMutex);
+        batch.clear();
+
+        {
+            std::unique_lock<std::mutex> lock(signalMutex);
+            frameAvailable.wait(lock, [this]() { return pending > 0 || drained(); });
+            if (drained()) {
+                return false;
+            }
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + options.maxWait;
+        for (;;) {
+            pullRoundRobin(batch);
+            if (batch.size() >= options.maxBatch) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(signalMutex);
+            if (!frameAvailable.wait_until(lock, deadline, [this]() { return pending > 0 || drained(); })) {
+                break;
+            }
+            // When stopping, do not wait for the batch to fill up
+            if (drained()) {
+                break;
+            }
+        }
+        std::lock_guard<std::mutex> lock(signalMutex);
+        return !batch.empty() || !drained();
+    }
+
+    void workerLoop(YOLODetector *detector) {
+        std::vector<Request> batch;
+        std::vector<cv::Mat> frames;
+        while (gatherBatch(batch)) {
+            if (batch.empty()) {
+                continue;
+            }
+            frames.clear();
+            for (const Request &request : batch) {
+                frames.push_back(request.frame);
+            }
+
+            std::vector<std::vector<Detection>> results;
+            try {
+                results = detector->detectBatch(frames, options.confThreshold, options.iouThreshold);
+            } catch (...) {
+                const std::exception_ptr error = std::current_exception();
+                for (Request &request : batch) {
+                    request.promise.set_exception(error);
+                }
+                continue;
+            }
+            for (size_t i = 0; i < batch.size(); ++i) {
+                batch[i].promise.set_value(std::move(results[i]));
+            }
+        }
+    }
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+// ===================================
+// Motion-Gated Detection Header File
+// ===================================
+//
+// This header defines MotionGatedStream, which runs a YOLODetector on the changed regions
+// of a fixed-camera stream only and carries the previous detections forward everywhere else.
+//
+// ================================
+
+/**
+ * @file MotionGate.hpp
+ * @brief Region-of-interest detection driven by a background model, for fixed cameras.
+ *
+ * For every frame, yolos::MotionRegions reports the regions that changed. Each region is
+ * grown to a minimum size (so the crop keeps some context) and to cover the previous
+ * detections it touches (so an object that starts to move is re-detected whole), then the
+ * regions are merged, letterboxed as separate crops and batched through
+ * YOLODetector::detectRegions(), which maps the boxes back to frame coordinates. Previous
+ * detections outside every region are carried forward unchanged.
+ *
+ * The whole frame is detected instead on the first frame, every refreshEvery frames and
+ * whenever the regions cover more than maxRegionCoverage of the frame, where one full pass
+ * is cheaper than many crops.
+ */
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "det/YOLO.hpp"
+#include "tools/MotionRegions.hpp"
+
+/**
+ * @brief Configuration of a MotionGatedStream.
+ */
+struct MotionGateOptions {
+    yolos::MotionOptions motion;          // Background model
+    int refreshEvery = 150;               // Frames between full-frame detections (<= 0: only when needed)
+    float maxRegionCoverage = 0.4f;       // Region area, as a fraction of the frame, above which the full frame is detected
+    cv::Size minRegionSize;               // Smallest crop; empty uses half the model input size
+    int maxBatch = 8;                     // Crops per batched run
+    float confThreshold = 0.4f;           // Confidence threshold of every detection
+    float iouThreshold = 0.45f;           // IoU threshold of every detection
+};
+
+class MotionGatedStream {
+public:
+    MotionGatedStream(YOLODetector &detector, const MotionGateOptions &options = MotionGateOptions())
+        : detector(detector), options(options), motion(options.motion) {}
+
+    /**
+     * @brief Processes the next frame of the stream.
+     *
+     * Frames must be passed in stream order, from one thread at a time.
+     *
+     * @return const std::vector<Detection>& Detections of this frame, in frame coordinates.
+     */
+    const std::vector<Detection> &process(const cv::Mat &frame) {
+        const std::vector<cv::Rect> &changed = motion.update(frame);
+
+        const bool refresh = frames++ == 0 || frame.size() != frameSize ||
+                             (options.refreshEvery > 0 && ++sinceRefresh >= options.refreshEvery);
+        frameSize = frame.size();
+        regions.clear();
+        if (!refresh && changed.empty()) {
+            ++idleFrames;
+            return detections;
+        }
+        if (!refresh) {
+            growRegions(changed, frame.size());
+        }
+
+        double coverage = 0.0;
+        for (const cv::Rect &region : regions) {
+            coverage += region.area();
+        }
+        if (refresh || coverage > options.maxRegionCoverage * frame.size().area()) {
+            detections = detector.detect(frame, options.confThreshold, options.iouThreshold);
+            regions.assign(1, cv::Rect(0, 0, frame.cols, frame.rows));
+            sinceRefresh = 0;
+            ++fullFrames;
+            return detections;
+        }
+
+        // Detections outside every region carry over; those inside are re-detected with the region
+        std::vector<Detection> next = detector.detectRegions(frame, regions, options.confThreshold,
+                                                             options.iouThreshold, options.maxBatch);
+        for (const Detection &det : detections) {
+            if (!touchesRegion(det.box)) {
+                next.push_back(det);
+            }
+        }
+        detections.swap(next);
+        ++regionFrames;
+        return detections;
+    }
+
+    /// Regions detected on the last frame (the whole frame after a full-frame pass)
+    const std::vector<cv::Rect> &lastRegions() const { return regions; }
+
+    uint64_t fullFrameCount() const { return fullFrames; }
+    uint64_t regionFrameCount() const { return regionFrames; }
+    uint64_t idleFrameCount() const { return idleFrames; }
+
+    /// Forgets the background and the detections, e.g. after the camera moved
+    void reset() {
+        motion.reset();
+        detections.clear();
+        frames = 0;
+    }
+
+private:
+    static cv::Rect toRect(const BoundingBox &box) { return cv::Rect(box.x, box.y, box.width, box.height); }
+
+    bool touchesRegion(const BoundingBox &box) const {
+        const cv::Rect rect = toRect(box);
+        for (const cv::Rect &region : regions) {
+            if ((rect & region).area() > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void growRegions(const std::vector<cv::Rect> &changed, const cv::Size &imageSize) {
+        const cv::Size input = detector.getInputSize();
+        const cv::Size minSize = options.minRegionSize.empty() ? cv::Size(input.width / 2, input.height / 2)
+                                                               : options.minRegionSize;
+        const cv::Rect bounds(0, 0, imageSize.width, imageSize.height);
+
+        // At least minSize around the centre, shifted back inside the frame
+        for (const cv::Rect &region : changed) {
+            const int w = std::min(std::max(region.width, minSize.width), imageSize.width);
+            const int h = std::min(std::max(region.height, minSize.height), imageSize.height);
+            const int x = std::min(std::max(region.x + region.width / 2 - w / 2, 0), imageSize.width - w);
+            const int y = std::min(std::max(region.y + region.height / 2 - h / 2, 0), imageSize.height - h);
+            regions.emplace_back(x, y, w, h);
+        }
+
+        // Whole objects that overlap a region join it, so they are not re-detected as fragments
+        bool grown = true;
+        while (grown) {
+            grown = false;
+            for (cv::Rect &region : regions) {
+                for (const Detection &det : detections) {
+                    const cv::Rect rect = toRect(det.box) & bounds;
+                    if ((rect & region).area() > 0 && !((rect & region) == rect)) {
+                        region |= rect;
+                        grown = true;
+                    }
+                }
+            }
+            yolos::mergeRects(regions);
+        }
+    }
+
+    YOLODetector &detector;
+    MotionGateOptions options;
+    yolos::MotionRegions motion;
+    std::vector<Detection> detections;        // Detections of the last frame
+    std::vector<cv::Rect> regions;            // Regions detected on the last frame
+    cv::Size frameSize;
+    uint64_t frames = 0;
+    int sinceRefresh = 0;
+    uint64_t fullFrames = 0, regionFrames = 0, idleFrames = 0;
+};
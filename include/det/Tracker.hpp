@@ -0,0 +1,395 @@
+#pragma once
+
+// ===================================
+// Multi-Object Tracker Header File
+// ===================================
+//
+// This header defines ByteTracker, a SORT/ByteTrack-style tracker over the detections of
+// YOLODetector, and TrackedStream, which combines it with a yolos::DetectionScheduler so
+// that the detector only runs on some frames of a video stream.
+//
+// ================================
+
+/**
+ * @file Tracker.hpp
+ * @brief Kalman + IoU tracking of detections, and detector frame skipping for video.
+ *
+ * Every track carries a constant-velocity Kalman filter over (centre x, centre y, aspect
+ * ratio, height), with noise proportional to the box height as in DeepSORT/ByteTrack. With
+ * that model the filter decouples into four independent [position, velocity] filters, so a
+ * track is updated with a few 2x2 operations instead of 8x8 matrix algebra.
+ *
+ * Association follows ByteTrack: detections above highThreshold are matched to all tracks
+ * first, then the remaining low-score detections (occluded or blurred objects) are matched
+ * to the tracks still unmatched. Matching is greedy on IoU, highest first. Unmatched
+ * high-score detections start tentative tracks, which are confirmed after minHits
+ * detections; tracks missed by maxMisses detection rounds in a row are dropped.
+ *
+ * On frames the scheduler skips, predict() advances every track by its velocity.
+ */
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "det/YOLO.hpp"
+#include "tools/DetectionScheduler.hpp"
+
+/**
+ * @brief Configuration of a ByteTracker.
+ */
+struct TrackerOptions {
+    float highThreshold = 0.5f;       // Detections at or above this take part in the first association
+    float lowThreshold = 0.1f;        // Detections below this are ignored (the detector should run at this threshold)
+    float newTrackThreshold = 0.6f;   // Unmatched detections need this score to start a track
+    float matchIou = 0.2f;            // Minimum IoU of a first-stage match
+    float lowMatchIou = 0.5f;         // Minimum IoU of a second-stage (low-score) match
+    int minHits = 3;                  // Detections before a track is confirmed (the first frame confirms at once)
+    int maxMisses = 30;               // Detection rounds a track may go unmatched before it is dropped
+    bool classAware = true;           // Only match detections of the track's class
+};
+
+/**
+ * @brief A tracked object.
+ */
+struct Track {
+    int id = 0;                 // Unique, increasing track id
+    BoundingBox box;            // Current (predicted or updated) box
+    float conf = 0.0f;          // Score of the last matched detection
+    int classId = 0;            // Class of the last matched detection
+    int hits = 0;               // Matched detections so far
+    int misses = 0;             // Detection rounds missed in a row
+    int framesSinceUpdate = 0;  // Frames (detected or predicted) since the last match
+    bool confirmed = false;     // Reached minHits, or was created on the first frame
+};
+
+class ByteTracker {
+public:
+    explicit ByteTracker(const TrackerOptions &options = TrackerOptions()) : options(options) {
+        if (!(options.lowThreshold <= options.highThreshold)) {
+            throw std::invalid_argument("ByteTracker: lowThreshold must not exceed highThreshold.");
+        }
+        if (options.minHits < 1 || options.maxMisses < 0) {
+            throw std::invalid_argument("ByteTracker: minHits must be positive and maxMisses non-negative.");
+        }
+    }
+
+    /**
+     * @brief Advances every track by one frame without a detection.
+     *
+     * @return const std::vector<Track>& All live tracks (confirmed and tentative).
+     */
+    const std::vector<Track> &predict() {
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            filters[i].predict();
+            ++tracks[i].framesSinceUpdate;
+            tracks[i].box = filters[i].box();
+        }
+        return tracks;
+    }
+
+    /**
+     * @brief Advances the tracks by one frame and corrects them with this frame's detections.
+     *
+     * @param detections Detections of the current frame, at the detector's (low) threshold.
+     * @return const std::vector<Track>& All live tracks (confirmed and tentative).
+     */
+    const std::vector<Track> &update(const std::vector<Detection> &detections) {
+        predict();
+
+        high.clear();
+        low.clear();
+        for (size_t d = 0; d < detections.size(); ++d) {
+            const float conf = detections[d].conf;
+            if (conf >= options.highThreshold) {
+                high.push_back(static_cast<int>(d));
+            } else if (conf >= options.lowThreshold) {
+                low.push_back(static_cast<int>(d));
+            }
+        }
+
+        trackMatched.assign(tracks.size(), false);
+        associate(detections, high, options.matchIou);
+        // Low-score detections only rescue tracks already established
+        unmatchedHigh.swap(unmatched);
+        associate(detections, low, options.lowMatchIou);
+
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            if (!trackMatched[i]) {
+                ++tracks[i].misses;
+            }
+        }
+
+        // Drop lost tracks, keeping the filters in step
+        size_t kept = 0;
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            if (tracks[i].misses <= options.maxMisses) {
+                tracks[kept] = tracks[i];
+                filters[kept] = filters[i];
+                ++kept;
+            }
+        }
+        tracks.resize(kept);
+        filters.erase(filters.begin() + kept, filters.end());
+
+        const bool firstFrame = frameCount == 0;
+        for (int d : unmatchedHigh) {
+            const Detection &det = detections[d];
+            if (det.conf < options.newTrackThreshold) {
+                continue;
+            }
+            Track track;
+            track.id = nextId++;
+            track.box = det.box;
+            track.conf = det.conf;
+            track.classId = det.classId;
+            track.hits = 1;
+            track.confirmed = firstFrame || options.minHits <= 1;
+            tracks.push_back(track);
+            filters.emplace_back(det.box);
+        }
+        ++frameCount;
+        return tracks;
+    }
+
+    /**
+     * @brief Confirmed tracks as detections, e.g. for YOLODetector::drawBoundingBox().
+     */
+    std::vector<Detection> detections() const {
+        std::vector<Detection> out;
+        out.reserve(tracks.size());
+        for (const Track &track : tracks) {
+            if (track.confirmed) {
+                out.emplace_back(track.box, track.conf, track.classId);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Largest positional uncertainty of the confirmed tracks: the standard deviation
+     *        of the predicted centre relative to the box height (0 without tracks).
+     */
+    float uncertainty() const {
+        float worst = 0.0f;
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            if (tracks[i].confirmed) {
+                worst = std::max(worst, filters[i].uncertainty());
+            }
+        }
+        return worst;
+    }
+
+    const std::vector<Track> &activeTracks() const { return tracks; }
+
+    /// Drops every track (e.g. after a scene cut); ids keep increasing
+    void reset() {
+        tracks.clear();
+        filters.clear();
+        frameCount = 0;
+    }
+
+private:
+    // One [position, velocity] Kalman filter with noise on both components
+    struct AxisFilter {
+        float p = 0.0f, v = 0.0f;               // State
+        float p00 = 0.0f, p01 = 0.0f, p11 = 0.0f; // Symmetric covariance
+
+        void init(float position, float stdPos, float stdVel) {
+            p = position;
+            v = 0.0f;
+            p00 = stdPos * stdPos;
+            p01 = 0.0f;
+            p11 = stdVel * stdVel;
+        }
+
+        void predict(float stdPos, float stdVel) {
+            p += v;
+            // P = F P F^T + Q with F = [[1, 1], [0, 1]]
+            p00 += 2.0f * p01 + p11 + stdPos * stdPos;
+            p01 += p11;
+            p11 += stdVel * stdVel;
+        }
+
+        void update(float measurement, float stdMeas) {
+            const float s = p00 + stdMeas * stdMeas;
+            const float k0 = p00 / s, k1 = p01 / s;
+            const float residual = measurement - p;
+            p += k0 * residual;
+            v += k1 * residual;
+            // P = (I - K H) P
+            const float n00 = (1.0f - k0) * p00;
+            const float n01 = (1.0f - k0) * p01;
+            const float n11 = p11 - k1 * p01;
+            p00 = n00;
+            p01 = n01;
+            p11 = n11;
+        }
+    };
+
+    // Constant-velocity filter over (cx, cy, aspect, height), noise scaled by the height
+    struct BoxFilter {
+        AxisFilter cx, cy, aspect, height;
+
+        static constexpr float kStdPos = 1.0f / 20.0f;
+        static constexpr float kStdVel = 1.0f / 160.0f;
+
+        explicit BoxFilter(const BoundingBox &box) {
+            const float h = std::max(1.0f, static_cast<float>(box.height));
+            cx.init(box.x + box.width * 0.5f, 2.0f * kStdPos * h, 10.0f * kStdVel * h);
+            cy.init(box.y + box.height * 0.5f, 2.0f * kStdPos * h, 10.0f * kStdVel * h);
+            aspect.init(static_cast<float>(box.width) / h, 1e-2f, 1e-5f);
+            height.init(h, 2.0f * kStdPos * h, 10.0f * kStdVel * h);
+        }
+
+        void predict() {
+            const float h = std::max(1.0f, height.p);
+            cx.predict(kStdPos * h, kStdVel * h);
+            cy.predict(kStdPos * h, kStdVel * h);
+            aspect.predict(1e-2f, 1e-5f);
+            height.predict(kStdPos * h, kStdVel * h);
+        }
+
+        void update(const BoundingBox &box) {
+            const float h = std::max(1.0f, height.p);
+            const float measuredH = std::max(1.0f, static_cast<float>(box.height));
+            cx.update(box.x + box.width * 0.5f, kStdPos * h);
+            cy.update(box.y + box.height * 0.5f, kStdPos * h);
+            aspect.update(static_cast<float>(box.width) / measuredH, 1e-1f);
+            height.update(measuredH, kStdPos * h);
+        }
+
+        BoundingBox box() const {
+            const float h = std::max(1.0f, height.p);
+            const float w = std::max(1.0f, aspect.p * h);
+            return BoundingBox(static_cast<int>(std::round(cx.p - w * 0.5f)), static_cast<int>(std::round(cy.p - h * 0.5f)),
+                               static_cast<int>(std::round(w)), static_cast<int>(std::round(h)));
+        }
+
+        float uncertainty() const {
+            return std::sqrt(cx.p00 + cy.p00) / std::max(1.0f, height.p);
+        }
+    };
+
+    static float iou(const BoundingBox &a, const BoundingBox &b) {
+        const int x1 = std::max(a.x, b.x), y1 = std::max(a.y, b.y);
+        const int x2 = std::min(a.x + a.width, b.x + b.width), y2 = std::min(a.y + a.height, b.y + b.height);
+        const float inter = static_cast<float>(std::max(0, x2 - x1)) * static_cast<float>(std::max(0, y2 - y1));
+        const float uni = static_cast<float>(a.width) * a.height + static_cast<float>(b.width) * b.height - inter;
+        return uni > 0.0f ? inter / uni : 0.0f;
+    }
+
+    // Greedy IoU matching of the given detections to the unmatched tracks; leaves the rest in `unmatched`
+    void associate(const std::vector<Detection> &detections, const std::vector<int> &candidates, float minIou) {
+        pairs.clear();
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            if (trackMatched[i]) {
+                continue;
+            }
+            for (int d : candidates) {
+                if (options.classAware && detections[d].classId != tracks[i].classId) {
+                    continue;
+                }
+                const float overlap = iou(tracks[i].box, detections[d].box);
+                if (overlap >= minIou) {
+                    pairs.push_back({overlap, static_cast<int>(i), d});
+                }
+            }
+        }
+        std::sort(pairs.begin(), pairs.end(), [](const Pair &a, const Pair &b) { return a.iou > b.iou; });
+
+        detectionMatched.assign(detections.size(), false);
+        for (const Pair &pair : pairs) {
+            if (trackMatched[pair.track] || detectionMatched[pair.detection]) {
+                continue;
+            }
+            trackMatched[pair.track] = true;
+            detectionMatched[pair.detection] = true;
+
+            const Detection &det = detections[pair.detection];
+            Track &track = tracks[pair.track];
+            filters[pair.track].update(det.box);
+            track.box = filters[pair.track].box();
+            track.conf = det.conf;
+            track.classId = det.classId;
+            track.misses = 0;
+            track.framesSinceUpdate = 0;
+            track.confirmed = track.confirmed || ++track.hits >= options.minHits;
+        }
+
+        unmatched.clear();
+        for (int d : candidates) {
+            if (!detectionMatched[d]) {
+                unmatched.push_back(d);
+            }
+        }
+    }
+
+    struct Pair {
+        float iou;
+        int track;
+        int detection;
+    };
+
+    TrackerOptions options;
+    std::vector<Track> tracks;
+    std::vector<BoxFilter> filters;              // filters[i] belongs to tracks[i]
+    int nextId = 1;
+    uint64_t frameCount = 0;                     // Detection rounds since the last reset
+
+    // Scratch buffers reused between frames
+    std::vector<int> high, low, unmatched, unmatchedHigh;
+    std::vector<Pair> pairs;
+    std::vector<bool> trackMatched, detectionMatched;
+};
+
+/**
+ * @brief Runs a YOLODetector on the frames a DetectionScheduler picks and tracks in between.
+ *
+ * Frames must be passed in stream order, from one thread at a time.
+ */
+class TrackedStream {
+public:
+    TrackedStream(YOLODetector &detector, const TrackerOptions &trackerOptions = TrackerOptions(),
+                  const yolos::SchedulerOptions &schedulerOptions = yolos::SchedulerOptions())
+        : detector(detector), tracker(trackerOptions), scheduler(schedulerOptions),
+          lowThreshold(trackerOptions.lowThreshold) {}
+
+    /**
+     * @brief Processes the next frame of the stream.
+     *
+     * @param frame Frame to process.
+     * @param iouThreshold IoU threshold of the detector's NMS.
+     * @return std::vector<Detection> Confirmed tracks on this frame, detected or predicted.
+     */
+    std::vector<Detection> process(const cv::Mat &frame, float iouThreshold = 0.45f) {
+        lastReason = scheduler.schedule(frame, tracker.uncertainty());
+        if (lastReason == yolos::ScheduleReason::Skip) {
+            tracker.predict();
+        } else {
+            tracker.update(detector.detect(frame, lowThreshold, iouThreshold));
+        }
+        return tracker.detections();
+    }
+
+    const ByteTracker &tracks() const { return tracker; }
+    const yolos::DetectionScheduler &schedule() const { return scheduler; }
+    yolos::ScheduleReason lastDecision() const { return lastReason; }
+
+    /// Restarts tracking and scheduling (e.g. after a seek)
+    void reset() {
+        tracker.reset();
+        scheduler.reset();
+    }
+
+private:
+    YOLODetector &detector;
+    ByteTracker tracker;
+    yolos::DetectionScheduler scheduler;
+    float lowThreshold;                       // The detector runs at the tracker's low threshold
+    yolos::ScheduleReason lastReason = yolos::ScheduleReason::Skip;
+};
@@ -38,6 +38,14 @@
 // Include debug and custom ScopedTimer tools for performance measurement
 #include "tools/Debug.hpp"
 #include "tools/ScopedTimer.hpp"
+#include "tools/YoloCore.hpp"
+#include "tools/Decode.hpp"
+#include "tools/NMS.hpp"
+#include "tools/Tiling.hpp"
+#include "tools/CudaPipeline.hpp"
+#include "tools/SharedRuntime.hpp"
+#include "tools/DetectorOptions.hpp"
+#include "tools/Overlay.hpp"
 
 #include <opencv2/opencv.hpp>
 
@@ -120,106 +128,6 @@ namespace utils
     class ImagePreprocessingUtils
     {
     public:
-        /**
-         * @brief Resizes an image with letterboxing to maintain aspect ratio.
-         *
-         * @param image Input image.
-         * @param outImage Output resized and padded image.
-         * @param newShape Desired output size.
-         * @param color Padding color (default is gray).
-         * @param auto_ Automatically adjust padding to be multiple of stride.
-         * @param scaleFill Whether to scale to fill the new shape without keeping aspect ratio.
-         * @param scaleUp Whether to allow scaling up of the image.
-         * @param stride Stride size for padding alignment.
-         */
-        static inline void letterBox(const cv::Mat &image, cv::Mat &outImage,
-                                     const cv::Size &newShape,
-                                     const cv::Scalar &color = cv::Scalar(114, 114, 114),
-                                     bool auto_ = true,
-                                     bool scaleFill = false,
-                                     bool scaleUp = true,
-                                     int stride = 32)
-        {
-            // Calculate the scaling ratio to fit the image within the new shape
-            float ratio = std::min(static_cast<float>(newShape.height) / image.rows,
-                                   static_cast<float>(newShape.width) / image.cols);
-
-            // Prevent scaling up if not allowed
-            if (!scaleUp)
-            {
-                ratio = std::min(ratio, 1.0f);
-            }
-
-            // Calculate new dimensions after scaling
-            int newUnpadW = static_cast<int>(std::round(image.cols * ratio));
-            int newUnpadH = static_cast<int>(std::round(image.rows * ratio));
-
-            // Calculate padding needed to reach the desired shape
-            int dw = newShape.width - newUnpadW;
-            int dh = newShape.height - newUnpadH;
-
-            if (auto_)
-            {
-                // Ensure padding is a multiple of stride for model compatibility
-                dw = (dw % stride) / 2;
-                dh = (dh % stride) / 2;
-            }
-            else if (scaleFill)
-            {
-                // Scale to fill without maintaining aspect ratio
-                newUnpadW = newShape.width;
-                newUnpadH = newShape.height;
-                ratio = std::min(static_cast<float>(newShape.width) / image.cols,
-                                 static_cast<float>(newShape.height) / image.rows);
-                dw = 0;
-                dh = 0;
-            }
-            else
-            {
-                // Evenly distribute padding on both sides
-                // Calculate separate padding for left/right and top/bottom to handle odd padding
-                int padLeft = dw / 2;
-                int padRight = dw - padLeft;
-                int padTop = dh / 2;
-                int padBottom = dh - padTop;
-
-                // Resize the image if the new dimensions differ
-                if (image.cols != newUnpadW || image.rows != newUnpadH)
-                {
-                    cv::resize(image, outImage, cv::Size(newUnpadW, newUnpadH), 0, 0, cv::INTER_LINEAR);
-                }
-                else
-                {
-                    // Avoid unnecessary copying if dimensions are the same
-                    outImage = image;
-                }
-
-                // Apply padding to reach the desired shape
-                cv::copyMakeBorder(outImage, outImage, padTop, padBottom, padLeft, padRight, cv::BORDER_CONSTANT, color);
-                return; // Exit early since padding is already applied
-            }
-
-            // Resize the image if the new dimensions differ
-            if (image.cols != newUnpadW || image.rows != newUnpadH)
-            {
-                cv::resize(image, outImage, cv::Size(newUnpadW, newUnpadH), 0, 0, cv::INTER_LINEAR);
-            }
-            else
-            {
-                // Avoid unnecessary copying if dimensions are the same
-                outImage = image;
-            }
-
-            // Calculate separate padding for left/right and top/bottom to handle odd padding
-            int padLeft = dw / 2;
-            int padRight = dw - padLeft;
-            int padTop = dh / 2;
-            int padBottom = dh - padTop;
-
-            // Apply padding to reach the desired shape
-            cv::copyMakeBorder(outImage, outImage, padTop, padBottom, padLeft, padRight, cv::BORDER_CONSTANT, color);
-        }
-
         /**
          * @brief Scales detection coordinates back to the original image size.
          *
@@ -302,73 +210,50 @@ namespace utils
             return colorCache[hashKey];
         }
 
+        /**
+         * @brief Renderer of the free drawing functions (full resolution, shared label cache).
+         */
+        static inline const yolos::OverlayRenderer &sharedRenderer()
+        {
+            static const yolos::OverlayRenderer renderer;
+            return renderer;
+        }
+
         /**
          * @brief Draws bounding boxes and labels on the image based on detections.
          *
-         * @param image Image on which to draw.
+         * @param image Image on which to draw (replaced by the preview if the renderer draws one).
          * @param detections Vector of detections.
          * @param classNames Vector of class names corresponding to object IDs.
          * @param colors Vector of colors for each class.
+         * @param renderer Renderer drawing the overlay (label cache, preview and headless options).
          */
         static inline void drawBoundingBox(cv::Mat &image, const std::vector<Detection> &detections,
-                                           const std::vector<std::string> &classNames, const std::vector<cv::Scalar> &colors, const float confidence_threshold = 0.0)
+                                           const std::vector<std::string> &classNames, const std::vector<cv::Scalar> &colors, const float confidence_threshold = 0.0,
+                                           const yolos::OverlayRenderer &renderer = sharedRenderer())
         {
-            // Iterate through each detection to draw bounding boxes and labels
-            for (const auto &detection : detections)
-            {
-                // Skip detections below the confidence threshold
-                if (detection.conf <= confidence_threshold)
-                    continue;
-
-                // Ensure the object ID is within valid range
-                if (detection.classId < 0 || static_cast<size_t>(detection.classId) >= classNames.size())
-                    continue;
-
-                // Select color based on object ID for consistent coloring
-                const cv::Scalar &color = colors[detection.classId % colors.size()];
-
-                // Draw the bounding box rectangle
-                cv::rectangle(image, cv::Point(detection.box.x, detection.box.y),
-                              cv::Point(detection.box.x + detection.box.width, detection.box.y + detection.box.height),
-                              color, 2, cv::LINE_AA);
-
-                // Prepare label text with class name and confidence percentage
-                std::string label = classNames[detection.classId] + ": " + std::to_string(static_cast<int>(detection.conf * 100)) + "%";
-
-                // Define text properties for labels
-                int fontFace = cv::FONT_HERSHEY_SIMPLEX;
-                double fontScale = std::min(image.rows, image.cols) * 0.0008;
-                const int thickness = std::max(1, static_cast<int>(std::min(image.rows, image.cols) * 0.002));
-                int baseline = 0;
-
-                // Calculate text size for background rectangles
-                cv::Size textSize = cv::getTextSize(label, fontFace, fontScale, thickness, &baseline);
-
-                // Define positions for the label
-                int labelY = std::max(detection.box.y, textSize.height + 5);
-                cv::Point labelTopLeft(detection.box.x, labelY - textSize.height - 5);
-                cv::Point labelBottomRight(detection.box.x + textSize.width + 5, labelY + baseline - 5);
-
-                // Draw background rectangle for label
-                cv::rectangle(image, labelTopLeft, labelBottomRight, color, cv::FILLED);
-
-                // Put label text
-                cv::putText(image, label, cv::Point(detection.box.x + 2, labelY - 2), fontFace, fontScale, cv::Scalar(255, 255, 255), thickness, cv::LINE_AA);
-            }
+            yolos::OverlayStyle style;
+            style.fontSize = 0.0008;
+            style.fontWeight = 0.002;
+            renderer.render(image, overlayItems(detections, classNames, colors, confidence_threshold), style);
         }
 
         /**
          * @brief Draws bounding boxes and semi-transparent masks on the image based on detections.
          *
-         * @param image Image on which to draw.
+         * Only the pixels inside the boxes are blended; labels come from the renderer's cache.
+         *
+         * @param image Image on which to draw (replaced by the preview if the renderer draws one).
          * @param detections Vector of detections.
          * @param classNames Vector of class names corresponding to object IDs.
          * @param classColors Vector of colors for each class.
          * @param maskAlpha Alpha value for the mask transparency.
+         * @param renderer Renderer drawing the overlay (label cache, preview and headless options).
          */
         static inline void drawBoundingBoxMask(cv::Mat &image, const std::vector<Detection> &detections,
                                                const std::vector<std::string> &classNames, const std::vector<cv::Scalar> &classColors,
-                                               float maskAlpha = 0.4f, const float confidence_threshold = 0.0)
+                                               float maskAlpha = 0.4f, const float confidence_threshold = 0.0,
+                                               const yolos::OverlayRenderer &renderer = sharedRenderer())
         {
             // Validate input image
             if (image.empty())
@@ -377,62 +262,35 @@ namespace utils
                 return;
             }
 
-            const int imgHeight = image.rows;
-            const int imgWidth = image.cols;
-
-            // Precompute dynamic font size and thickness based on image dimensions
-            const double fontSize = std::min(imgHeight, imgWidth) * 0.0006;
-            const int textThickness = std::max(1, static_cast<int>(std::min(imgHeight, imgWidth) * 0.001));
+            yolos::OverlayStyle style;
+            style.boxAlpha = maskAlpha;
+            renderer.render(image, overlayItems(detections, classNames, classColors, confidence_threshold), style);
 
-            // Create a mask image for blending (initialized to zero)
-            cv::Mat maskImage(image.size(), image.type(), cv::Scalar::all(0));
+            DEBUG_PRINT("Bounding boxes and masks drawn on image.");
+        }
 
-            // Pre-filter detections to include only those above the confidence threshold and with valid class IDs
-            std::vector<const Detection *> filteredDetections;
+    private:
+        // Detections above the threshold with a valid class, as renderer items
+        static inline std::vector<yolos::OverlayItem> overlayItems(const std::vector<Detection> &detections,
+                                                                   const std::vector<std::string> &classNames,
+                                                                   const std::vector<cv::Scalar> &colors, float confidence_threshold)
+        {
+            std::vector<yolos::OverlayItem> items;
+            items.reserve(detections.size());
             for (const auto &detection : detections)
             {
-                if (detection.conf > confidence_threshold &&
-                    detection.classId >= 0 &&
-                    static_cast<size_t>(detection.classId) < classNames.size())
-                {
-                    filteredDetections.emplace_back(&detection);
-                }
-            }
-
-            // Draw filled rectangles on the mask image for the semi-transparent overlay
-            for (const auto *detection : filteredDetections)
-            {
-                cv::Rect box(detection->box.x, detection->box.y, detection->box.width, detection->box.height);
-                const cv::Scalar &color = classColors[detection->classId];
-                cv::rectangle(maskImage, box, color, cv::FILLED);
-            }
-
-            // Blend the maskImage with the original image to apply the semi-transparent masks
-            cv::addWeighted(maskImage, maskAlpha, image, 1.0f, 0, image);
-
-            // Draw bounding boxes and labels on the original image
-            for (const auto *detection : filteredDetections)
-            {
-                cv::Rect box(detection->box.x, detection->box.y, detection->box.width, detection->box.height);
-                const cv::Scalar &color = classColors[detection->classId];
-                cv::rectangle(image, box, color, 2, cv::LINE_AA);
-
-                std::string label = classNames[detection->classId] + ": " + std::to_string(static_cast<int>(detection->conf * 100)) + "%";
-                int baseLine = 0;
-                cv::Size labelSize = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, fontSize, textThickness, &baseLine);
-
-                int labelY = std::max(detection->box.y, labelSize.height + 5);
-                cv::Point labelTopLeft(detection->box.x, labelY - labelSize.height - 5);
-                cv::Point labelBottomRight(detection->box.x + labelSize.width + 5, labelY + baseLine - 5);
-
-                // Draw background rectangle for label
-                cv::rectangle(image, labelTopLeft, labelBottomRight, color, cv::FILLED);
+                if (detection.conf <= confidence_threshold ||
+                    detection.classId < 0 || static_cast<size_t>(detection.classId) >= classNames.size() || colors.empty())
+                    continue;
 
-                // Put label text
-                cv::putText(image, label, cv::Point(detection->box.x + 2, labelY - 2), cv::FONT_HERSHEY_SIMPLEX, fontSize, cv::Scalar(255, 255, 255), textThickness, cv::LINE_AA);
+                yolos::OverlayItem item;
+                item.box = cv::Rect(detection.box.x, detection.box.y, detection.box.width, detection.box.height);
+                item.confidence = detection.conf;
+                item.color = colors[detection.classId % colors.size()];
+                item.name = &classNames[detection.classId];
+                items.push_back(std::move(item));
             }
-
-            DEBUG_PRINT("Bounding boxes and masks drawn on image.");
+            return items;
         }
     };
 
@@ -467,126 +325,19 @@ namespace utils
         return classNames;
     }
 
-    /**
-     * @brief Performs Non-Maximum Suppression (NMS) on the bounding boxes.
-     *
-     * @param boundingBoxes Vector of bounding boxes.
-     * @param scores Vector of confidence scores corresponding to each bounding box.
-     * @param scoreThreshold Confidence threshold to filter boxes.
-     * @param nmsThreshold IoU threshold for NMS.
-     * @param indices Output vector of indices that survive NMS.
-     */
-    // Optimized Non-Maximum Suppression Function
-    void NMSBoxes(const std::vector<BoundingBox> &boundingBoxes,
-                  const std::vector<float> &scores,
-                  float scoreThreshold,
-                  float nmsThreshold,
-                  std::vector<int> &indices)
-    {
-        indices.clear();
-
-        const size_t numBoxes = boundingBoxes.size();
-        if (numBoxes == 0)
-        {
-            DEBUG_PRINT("No bounding boxes to process in NMS");
-            return;
-        }
-
-        // Step 1: Filter out boxes with scores below the threshold
-        // and create a list of indices sorted by descending scores
-        std::vector<int> sortedIndices;
-        sortedIndices.reserve(numBoxes);
-        for (size_t i = 0; i < numBoxes; ++i)
-        {
-            if (scores[i] >= scoreThreshold)
-            {
-                sortedIndices.push_back(static_cast<int>(i));
-            }
-        }
-
-        // If no boxes remain after thresholding
-        if (sortedIndices.empty())
-        {
-            DEBUG_PRINT("No bounding boxes above score threshold");
-            return;
-        }
-
-        // Sort the indices based on scores in descending order
-        std::sort(sortedIndices.begin(), sortedIndices.end(),
-                  [&scores](int idx1, int idx2)
-                  {
-                      return scores[idx1] > scores[idx2];
-                  });
-
-        // Step 2: Precompute the areas of all boxes
-        std::vector<float> areas(numBoxes, 0.0f);
-        for (size_t i = 0; i < numBoxes; ++i)
-        {
-            areas[i] = boundingBoxes[i].width * boundingBoxes[i].height;
-        }
-
-        // Step 3: Suppression mask to mark boxes that are suppressed
-        std::vector<bool> suppressed(numBoxes, false);
-
-        // Step 4: Iterate through the sorted list and suppress boxes with high IoU
-        for (size_t i = 0; i < sortedIndices.size(); ++i)
-        {
-            int currentIdx = sortedIndices[i];
-            if (suppressed[currentIdx])
-            {
-                continue;
-            }
-
-            // Select the current box as a valid detection
-            indices.push_back(currentIdx);
-
-            const BoundingBox &currentBox = boundingBoxes[currentIdx];
-            const float x1_max = currentBox.x;
-            const float y1_max = currentBox.y;
-            const float x2_max = currentBox.x + currentBox.width;
-            const float y2_max = currentBox.y + currentBox.height;
-            const float area_current = areas[currentIdx];
-
-            // Compare IoU of the current box with the rest
-            for (size_t j = i + 1; j < sortedIndices.size(); ++j)
-            {
-                int compareIdx = sortedIndices[j];
-                if (suppressed[compareIdx])
-                {
-                    continue;
-                }
-
-                const BoundingBox &compareBox = boundingBoxes[compareIdx];
-                const float x1 = std::max(x1_max, static_cast<float>(compareBox.x));
-                const float y1 = std::max(y1_max, static_cast<float>(compareBox.y));
-                const float x2 = std::min(x2_max, static_cast<float>(compareBox.x + compareBox.width));
-                const float y2 = std::min(y2_max, static_cast<float>(compareBox.y + compareBox.height));
-
-                const float interWidth = x2 - x1;
-                const float interHeight = y2 - y1;
-
-                if (interWidth <= 0 || interHeight <= 0)
-                {
-                    continue;
-                }
-
-                const float intersection = interWidth * interHeight;
-                const float unionArea = area_current + areas[compareIdx] - intersection;
-                const float iou = (unionArea > 0.0f) ? (intersection / unionArea) : 0.0f;
-
-                if (iou > nmsThreshold)
-                {
-                    suppressed[compareIdx] = true;
-                }
-            }
-        }
+};
 
-        DEBUG_PRINT("NMS completed with " + std::to_string(indices.size()) + " indices remaining");
-    }
 
+/**
+ * @brief YoloCore policy: letterboxed input, one output whose layout selects the decoder (see yolos::DetectionLayout).
+ */
+struct DetectionTaskPolicy {
+    static constexpr yolos::InputTransform transform = yolos::InputTransform::Letterbox;
+    static constexpr size_t outputs = 1;
+    static constexpr const char *preprocessStage = "detection.preprocess";
+    static constexpr const char *preprocessBatchStage = "detection.preprocess_batch";
 };
 
-
 /**
  * @brief YOLODetector class handles loading the YOLO model, preprocessing images, running inference, and postprocessing results.
  */
@@ -600,6 +351,17 @@ public:
      * @param useGPU Whether to use GPU for inference (default is false).
      */
     YOLODetector(const std::string &modelPath, const std::string &labelsPath, bool useGPU = false);
+
+    /**
+     * @brief Constructor with explicit execution-provider and threading options.
+     *
+     * @param modelPath Path to the ONNX model file.
+     * @param labelsPath Path to the file containing class labels.
+     * @param options Execution providers (in order of preference) and threading.
+     * @param runtime Runtime shared with other detectors (see InferenceEngine); a private one if null.
+     */
+    YOLODetector(const std::string &modelPath, const std::string &labelsPath, const yolos::DetectorOptions &options,
+                 std::shared_ptr<yolos::SharedRuntime> runtime = nullptr);
     
     /**
      * @brief Runs detection on the provided image.
@@ -610,6 +372,98 @@ public:
      * @return std::vector<Detection> Vector of detections.
      */
     std::vector<Detection> detect(const cv::Mat &image, float confThreshold = 0.4f, float iouThreshold = 0.45f);
+
+    /**
+     * @brief Runs detection on a batch of images with a single session run per model batch.
+     *
+     * All images are letterboxed into one contiguous NCHW blob. Dynamic-batch models consume the
+     * whole request in one run; fixed-batch models are fed in chunks of their exported batch size,
+     * with unused slots of the last chunk zero-filled and ignored.
+     *
+     * @param images Input images for detection.
+     * @param confThreshold Confidence threshold to filter detections (default is 0.4).
+     * @param iouThreshold IoU threshold for Non-Maximum Suppression (default is 0.45).
+     * @return std::vector<std::vector<Detection>> Detections for each input image, in input order.
+     */
+    std::vector<std::vector<Detection>> detectBatch(const std::vector<cv::Mat> &images, float confThreshold = 0.4f, float iouThreshold = 0.45f);
+
+    /**
+     * @brief Runs sliced inference for images much larger than the model input (4K, aerial).
+     *
+     * The image is cut into overlapping tiles (yolos::TilingOptions), tiles ruled out by the
+     * optional mask or texture test are skipped, the rest go through detectBatch() as ROI views
+     * and the per-tile detections are merged with NMS in image coordinates.
+     *
+     * @param image Input image for detection.
+     * @param tiling Tile size, overlap, batching and tile filtering.
+     * @param confThreshold Confidence threshold to filter detections (default is 0.4).
+     * @param iouThreshold IoU threshold for the per-tile and merging NMS (default is 0.45).
+     * @return std::vector<Detection> Detections in image coordinates.
+     */
+    std::vector<Detection> detectTiled(const cv::Mat &image, const yolos::TilingOptions &tiling,
+                                       float confThreshold = 0.4f, float iouThreshold = 0.45f);
+
+    /**
+     * @brief Runs detection on regions of an image only (e.g. the parts of a frame that changed).
+     *
+     * Every region is letterboxed on its own, the crops are batched through detectBatch() and
+     * the detections are mapped back to image coordinates and merged with NMS.
+     *
+     * @param image Input image for detection.
+     * @param regions Regions of interest in image coordinates (clipped to the image).
+     * @param confThreshold Confidence threshold to filter detections (default is 0.4).
+     * @param iouThreshold IoU threshold for the per-crop and merging NMS (default is 0.45).
+     * @param maxBatch Maximum number of crops per batched run; <= 0 runs all at once (default is 8).
+     * @return std::vector<Detection> Detections in image coordinates.
+     */
+    std::vector<Detection> detectRegions(const cv::Mat &image, const std::vector<cv::Rect> &regions,
+                                         float confThreshold = 0.4f, float iouThreshold = 0.45f, int maxBatch = 8);
+
+#ifdef YOLOS_WITH_CUDA
+    /**
+     * @brief Runs detection on a frame that is already in device memory (e.g. decoded by NVDEC
+     *        through cv::cudacodec), letterboxing it on the device without a host round-trip.
+     *
+     * The frame must be complete (its producer's stream synchronized). Models the device
+     * decoder does not support download the frame and take the host path.
+     *
+     * @param frame 8-bit BGR or BGRA device frame.
+     * @param confThreshold Confidence threshold to filter detections (default is 0.4).
+     * @param iouThreshold IoU threshold for Non-Maximum Suppression (default is 0.45).
+     * @return std::vector<Detection> Vector of detections.
+     */
+    std::vector<Detection> detect(const cv::cuda::GpuMat &frame, float confThreshold = 0.4f, float iouThreshold = 0.45f);
+
+    /**
+     * @brief Draws box outlines (no labels) in the class colors into a device frame.
+     *
+     * @param frame 8-bit BGR or BGRA device frame, updated in place.
+     * @param detections Vector of detections.
+     * @param renderer Renderer of the calling thread.
+     * @param thickness Line thickness in pixels.
+     */
+    void drawBoundingBox(cv::cuda::GpuMat &frame, const std::vector<Detection> &detections,
+                         CudaBoxRenderer &renderer, int thickness = 2) const {
+        std::vector<yolos::cuda::DeviceBox> boxes;
+        boxes.reserve(detections.size());
+        for (const Detection &detection : detections) {
+            if (detection.classId < 0 || static_cast<size_t>(detection.classId) >= classColors.size()) {
+                continue;
+            }
+            const cv::Scalar &color = classColors[detection.classId];
+            yolos::cuda::DeviceBox box;
+            box.x = detection.box.x;
+            box.y = detection.box.y;
+            box.width = detection.box.width;
+            box.height = detection.box.height;
+            for (int c = 0; c < 3; ++c) {
+                box.color[c] = cv::saturate_cast<uint8_t>(color[c]);
+            }
+            boxes.push_back(box);
+        }
+        renderer.draw(frame.ptr<uint8_t>(), frame.step, frame.size(), frame.channels(), boxes, thickness);
+    }
+#endif
     
     /**
      * @brief Draws bounding boxes on the image based on detections.
@@ -618,7 +472,7 @@ public:
      * @param detections Vector of detections.
      */
     void drawBoundingBox(cv::Mat &image, const std::vector<Detection> &detections) const {
-        utils::DrawingUtils::drawBoundingBox(image, detections, classNames, classColors);
+        utils::DrawingUtils::drawBoundingBox(image, detections, classNames, classColors, 0.0f, overlay);
     }
     
     /**
@@ -629,9 +483,15 @@ public:
      * @param maskAlpha Alpha value for mask transparency (default is 0.4).
      */
     void drawBoundingBoxMask(cv::Mat &image, const std::vector<Detection> &detections, float maskAlpha = 0.4f) const {
-        utils::DrawingUtils::drawBoundingBoxMask(image, detections, classNames, classColors, maskAlpha);
+        utils::DrawingUtils::drawBoundingBoxMask(image, detections, classNames, classColors, maskAlpha, 0.0f, overlay);
     }
 
+    /**
+     * @brief Sets how drawBoundingBox() / drawBoundingBoxMask() draw: on a downscaled preview that
+     *        replaces the image, or not at all (headless).
+     */
+    void setRenderOptions(const yolos::RenderOptions &options) { overlay.setOptions(options); }
+
     /**
      * @brief Gets the device used for inference.
      * 
@@ -639,283 +499,374 @@ public:
      */
     std::string getDevice() const { return device_used; }
 
-private:
-    Ort::Env env{nullptr};                         // ONNX Runtime environment
-    Ort::SessionOptions sessionOptions{nullptr};   // Session options for ONNX Runtime
-    Ort::Session session{nullptr};                 // ONNX Runtime session for running inference
-    bool isDynamicInputShape{};                    // Flag indicating if input shape is dynamic
-    cv::Size inputImageShape;                      // Expected input image shape for the model
+    /**
+     * @brief Gets the batch size the model was exported with.
+     *
+     * @return int64_t Fixed batch size, or -1 if the model accepts a dynamic batch dimension.
+     */
+    int64_t getBatchSize() const { return core.batchSize(); }
 
-    // Vectors to hold allocated input and output node names
-    std::vector<Ort::AllocatedStringPtr> inputNodeNameAllocatedStrings;
-    std::vector<const char *> inputNames;
-    std::vector<Ort::AllocatedStringPtr> outputNodeNameAllocatedStrings;
-    std::vector<const char *> outputNames;
+    /**
+     * @brief Gets the model input size every image is letterboxed to.
+     */
+    cv::Size getInputSize() const { return core.inputImageShape(); }
 
-    size_t numInputNodes, numOutputNodes;          // Number of input and output nodes in the model
+    /**
+     * @brief Gets the numeric precision of the model: "fp32", "fp16" or "int8".
+     */
+    const std::string &getPrecision() const { return core.precision(); }
+
+    /**
+     * @brief Wall-clock time spent in each stage of the last detect() / detectBatch() call.
+     *        Batched calls report the totals over all chunks.
+     */
+    using StageTimings = yolos::StageTimings;
+
+    /**
+     * @brief Gets the stage timings of the last detection call.
+     */
+    const StageTimings &getLastTimings() const { return core.lastTimings(); }
+
+    /**
+     * @brief Sets the NMS mode and caps (class-agnostic, max detections, top-k candidates).
+     *        The score and IoU thresholds still come from the detect() arguments.
+     */
+    void setNMSOptions(const yolos::NMSOptions &options) { nmsOptions = options; }
+
+    /**
+     * @brief Runs dummy inferences so that lazy initialization (memory arenas, kernel and
+     *        algorithm selection, TensorRT engine builds) happens before the first real frame.
+     *
+     * @param imageSizes Frame sizes to expect; they matter for dynamic-shape models, whose
+     *                   letterbox follows the aspect ratio (default: every input bucket, or
+     *                   the model input size).
+     * @param iterations Runs per size.
+     */
+    void warmup(const std::vector<cv::Size> &imageSizes = {}, int iterations = 2) {
+        const std::vector<cv::Size> sizes = imageSizes.empty() ? core.warmupSizes() : imageSizes;
+        for (const cv::Size &size : sizes) {
+            const cv::Mat frame(size, CV_8UC3, cv::Scalar(114, 114, 114));
+            for (int i = 0; i < iterations; ++i) {
+                detect(frame);
+            }
+        }
+        core.resetTimings();
+    }
+
+private:
+#ifdef YOLOS_WITH_CUDA
+    yolos::cuda::Stream cudaStream;                // Stream shared by ONNX Runtime and the CUDA kernels (outlives the session)
+#endif
+    yolos::YoloCore<DetectionTaskPolicy> core;     // Session, bound tensors, preprocessing and batching
+    yolos::DetectionLayout outputLayout{yolos::DetectionLayout::ChannelMajor}; // Output layout, resolved at load time
+    yolos::CandidateBuffer candidateBuffer;        // Reused struct-of-arrays buffer of decoded candidates
+    yolos::NMSEngine nmsEngine;                    // Bucketed NMS with reusable buffers
+    yolos::NMSOptions nmsOptions;                  // Per-class by default, no caps
+#ifdef YOLOS_WITH_CUDA
+    CudaDetectionPipeline cudaPipeline;            // Device-side letterbox and threshold/argmax (CUDA EP only)
+    cv::Mat downloadedFrame;                       // Host copy of device frames when the device pipeline is inactive
+#endif
 
     std::vector<std::string> classNames;            // Vector of class names loaded from file
     std::vector<cv::Scalar> classColors;            // Vector of colors for each class
+    yolos::OverlayRenderer overlay;                // Draws the CPU overlays (label cache, preview, headless)
     std::string device_used;                        // Device used for inference: "GPU" or "CPU"
 
+#ifdef YOLOS_WITH_CUDA
     /**
-     * @brief Preprocesses the input image for model inference.
-     * 
-     * @param image Input image.
-     * @param blob Reference to pointer where preprocessed data will be stored.
-     * @param inputTensorShape Reference to vector representing input tensor shape.
-     * @return cv::Mat Resized image after preprocessing.
+     * @brief Runs the device pipeline through runPipeline(params) and postprocesses its candidates.
+     */
+    template <typename RunPipeline>
+    std::vector<Detection> detectWithPipeline(const cv::Size &imageSize, float confThreshold, float iouThreshold,
+                                              RunPipeline &&runPipeline) {
+        using Clock = std::chrono::steady_clock;
+        auto elapsedMs = [](Clock::time_point from, Clock::time_point to) {
+            return std::chrono::duration<double, std::milli>(to - from).count();
+        };
+        const Clock::time_point t0 = Clock::now();
+
+        const yolos::LetterboxParams params = core.geometry(imageSize);
+        const std::vector<yolos::cuda::Candidate> &candidates = runPipeline(params);
+        const Clock::time_point t1 = Clock::now();
+        std::vector<Detection> detections = postprocessCandidates(imageSize, params.outShape, candidates, confThreshold, iouThreshold);
+
+        // Device letterbox and decode are asynchronous, so they are accounted to inference
+        yolos::StageTimings timings;
+        timings.inferenceMs = elapsedMs(t0, t1);
+        timings.postprocessMs = elapsedMs(t1, Clock::now());
+        core.setLastTimings(timings);
+        return detections;
+    }
+#endif
+
+    /**
+     * @brief CUDA stream handed to the CUDA provider, so the pre/post kernels are ordered with inference.
      */
-    cv::Mat preprocess(const cv::Mat &image, float *&blob, std::vector<int64_t> &inputTensorShape);
+    void *providerStream() {
+#ifdef YOLOS_WITH_CUDA
+        return cudaStream.get();
+#else
+        return nullptr;
+#endif
+    }
+
+    /**
+     * @brief Decodes one image of a run with the decoder of the given output layout.
+     *
+     * @param originalImageSize Size of the original input image.
+     * @param resizedImageShape Size of the image after preprocessing.
+     * @param outputs Outputs of this image.
+     * @param confThreshold Confidence threshold to filter detections.
+     * @param iouThreshold IoU threshold for Non-Maximum Suppression.
+     * @return std::vector<Detection> Vector of detections.
+     */
+    template <yolos::DetectionLayout Layout>
+    std::vector<Detection> decode(const cv::Size &originalImageSize, const cv::Size &resizedImageShape,
+                                  const yolos::ImageOutputs &outputs, float confThreshold, float iouThreshold) {
+        if constexpr (Layout == yolos::DetectionLayout::FlatTable) {
+            // YOLOv7 end-to-end models emit one [num_detections, 7] table tagged with batch indices
+            return postprocess_yolo7(originalImageSize, resizedImageShape, outputs.batchData(), outputs.batchShape(),
+                                     confThreshold, iouThreshold, outputs.batchIndex());
+        } else if constexpr (Layout == yolos::DetectionLayout::EndToEnd) {
+            return postprocess_yolo10(originalImageSize, resizedImageShape, outputs.data(), outputs.shape(), confThreshold, iouThreshold);
+        } else {
+            return postprocess(originalImageSize, resizedImageShape, outputs.data(), outputs.shape(), confThreshold, iouThreshold);
+        }
+    }
+
+    /**
+     * @brief Calls fn with the decoder of the model's output layout. The layout is switched on once
+     *        per call; each decoder gets its own instantiation of the core's decode loop.
+     */
+    template <typename Fn>
+    auto withDecoder(float confThreshold, float iouThreshold, Fn &&fn) {
+        auto decoder = [this, confThreshold, iouThreshold](auto layout) {
+            return [this, confThreshold, iouThreshold](const cv::Size &originalImageSize, const cv::Size &resizedImageShape,
+                                                       const yolos::ImageOutputs &outputs) {
+                return decode<decltype(layout)::value>(originalImageSize, resizedImageShape, outputs, confThreshold, iouThreshold);
+            };
+        };
+        using Layout = yolos::DetectionLayout;
+        switch (outputLayout) {
+        case Layout::FlatTable:
+            return fn(decoder(std::integral_constant<Layout, Layout::FlatTable>{}));
+        case Layout::EndToEnd:
+            return fn(decoder(std::integral_constant<Layout, Layout::EndToEnd>{}));
+        case Layout::ChannelMajor:
+        default:
+            return fn(decoder(std::integral_constant<Layout, Layout::ChannelMajor>{}));
+        }
+    }
     
     /**
      * @brief Postprocesses the model output to extract detections.
      * 
      * @param originalImageSize Size of the original input image.
      * @param resizedImageShape Size of the image after preprocessing.
-     * @param outputTensors Vector of output tensors from the model.
+     * @param rawOutput Raw output data of a single image.
+     * @param outputShape Output shape of a single image ([1, num_features, num_detections]).
      * @param confThreshold Confidence threshold to filter detections.
      * @param iouThreshold IoU threshold for Non-Maximum Suppression.
      * @return std::vector<Detection> Vector of detections.
      */
     std::vector<Detection> postprocess(const cv::Size &originalImageSize, const cv::Size &resizedImageShape,
-                                      const std::vector<Ort::Value> &outputTensors,
+                                      const float *rawOutput, const std::vector<int64_t> &outputShape,
+                                      float confThreshold, float iouThreshold);
+
+    /**
+     * @brief Scales decoded candidates to the original image and applies class-aware NMS.
+     * 
+     * @param originalImageSize Size of the original input image.
+     * @param resizedImageShape Size of the image after preprocessing.
+     * @param candidates Candidates above the confidence threshold, in letterboxed coordinates.
+     * @param confThreshold Confidence threshold to filter detections.
+     * @param iouThreshold IoU threshold for Non-Maximum Suppression.
+     * @return std::vector<Detection> Vector of detections.
+     */
+    std::vector<Detection> detectionsFromCandidates(const cv::Size &originalImageSize, const cv::Size &resizedImageShape,
+                                      const yolos::CandidateBuffer &candidates,
                                       float confThreshold, float iouThreshold);
+
+    /**
+     * @brief Detects on crops of one image and merges the results in image coordinates.
+     *
+     * @param views Crops (ROI views) of the image.
+     * @param rects Position of every crop in the image.
+     */
+    std::vector<Detection> detectCrops(const std::vector<cv::Mat> &views, const std::vector<cv::Rect> &rects,
+                                       float confThreshold, float iouThreshold, int maxBatch);
+
+    /**
+     * @brief Combines the configured NMS mode with the thresholds of the current call.
+     */
+    yolos::NMSOptions nmsOptionsFor(float confThreshold, float iouThreshold) const {
+        yolos::NMSOptions options = nmsOptions;
+        options.scoreThreshold = confThreshold;
+        options.iouThreshold = iouThreshold;
+        return options;
+    }
+
     /**
      * @brief Postprocesses the model output to extract detections.
      * 
      * @param originalImageSize Size of the original input image.
      * @param resizedImageShape Size of the image after preprocessing.
-     * @param outputTensors Vector of output tensors from the model.
+     * @param rawOutput Raw output data of a single image.
+     * @param outputShape Output shape of a single image ([1, num_detections, 6]).
      * @param confThreshold Confidence threshold to filter detections.
      * @param iouThreshold IoU threshold for Non-Maximum Suppression.
      * @return std::vector<Detection> Vector of detections.
      */
     std::vector<Detection> postprocess_yolo10(const cv::Size &originalImageSize, const cv::Size &resizedImageShape,
-                                      const std::vector<Ort::Value> &outputTensors,
+                                      const float *rawOutput, const std::vector<int64_t> &outputShape,
                                       float confThreshold, float iouThreshold);
+#ifdef YOLOS_WITH_CUDA
+    /**
+     * @brief Turns the candidates decoded on the device into detections (scaling and NMS on the host).
+     * 
+     * @param originalImageSize Size of the original input image.
+     * @param resizedImageShape Size of the image after preprocessing.
+     * @param candidates Candidates above the confidence threshold, in anchor order.
+     * @param confThreshold Confidence threshold to filter detections.
+     * @param iouThreshold IoU threshold for Non-Maximum Suppression.
+     * @return std::vector<Detection> Vector of detections.
+     */
+    std::vector<Detection> postprocessCandidates(const cv::Size &originalImageSize, const cv::Size &resizedImageShape,
+                                      const std::vector<yolos::cuda::Candidate> &candidates,
+                                      float confThreshold, float iouThreshold);
+#endif
     /**
      * @brief Postprocesses the model output to extract detections.
      * 
      * @param originalImageSize Size of the original input image.
      * @param resizedImageShape Size of the image after preprocessing.
-     * @param outputTensors Vector of output tensors from the model.
+     * @param rawOutput Raw output data of the whole batch.
+     * @param outputShape Output shape of the whole batch ([num_detections, 7]).
      * @param confThreshold Confidence threshold to filter detections.
      * @param iouThreshold IoU threshold for Non-Maximum Suppression.
+     * @param batchIndex Only rows tagged with this batch index are decoded.
      * @return std::vector<Detection> Vector of detections.
      */
     std::vector<Detection> postprocess_yolo7(const cv::Size &originalImageSize, const cv::Size &resizedImageShape,
-                                      const std::vector<Ort::Value> &outputTensors,
-                                      float confThreshold, float iouThreshold);
+                                      const float *rawOutput, const std::vector<int64_t> &outputShape,
+                                      float confThreshold, float iouThreshold, size_t batchIndex = 0);
     
 };
 
 // Implementation of YOLODetector constructor
-YOLODetector::YOLODetector(const std::string &modelPath, const std::string &labelsPath, bool useGPU) {
-    // Initialize ONNX Runtime environment with warning level
-    env = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "ONNX_DETECTION");
-    sessionOptions = Ort::SessionOptions();
-
-    // Set number of intra-op threads for parallelism
-    sessionOptions.SetIntraOpNumThreads(std::min(6, static_cast<int>(std::thread::hardware_concurrency())));
-    sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-
-    // Retrieve available execution providers (e.g., CPU, CUDA)
-    std::vector<std::string> availableProviders = Ort::GetAvailableProviders();
-    auto cudaAvailable = std::find(availableProviders.begin(), availableProviders.end(), "CUDAExecutionProvider");
-    OrtCUDAProviderOptions cudaOption;
-
-    // Configure session options based on whether GPU is to be used and available
-    if (useGPU && cudaAvailable != availableProviders.end()) {
-        std::cout << "Inference device: GPU" << std::endl;
-        sessionOptions.AppendExecutionProvider_CUDA(cudaOption); // Append CUDA execution provider
-        device_used = "gpu";
-    } else {
-        if (useGPU) {
-            std::cout << "GPU is not supported by your ONNXRuntime build. Fallback to CPU." << std::endl;
+YOLODetector::YOLODetector(const std::string &modelPath, const std::string &labelsPath, bool useGPU)
+    : YOLODetector(modelPath, labelsPath, yolos::DetectorOptions::fromUseGPU(useGPU)) {}
+
+YOLODetector::YOLODetector(const std::string &modelPath, const std::string &labelsPath,
+                           const yolos::DetectorOptions &options, std::shared_ptr<yolos::SharedRuntime> runtime)
+    : core(modelPath, options, std::move(runtime), providerStream()) {
+    device_used = yolos::isCudaProvider(core.provider()) ? "gpu" : "cpu";
+
+    // The decoder follows the output layout of the model, known from its metadata
+    outputLayout = yolos::detectionLayoutOf(core.modelOutputShape(0));
+
+#ifdef YOLOS_WITH_CUDA
+    // Keep letterboxing and the threshold/argmax stage on the device for static single-image FP32/INT8 models
+    if (core.provider() == yolos::ExecutionProvider::CUDA && !core.isDynamicInputShape() && core.modelBatchSize() == 1 &&
+        !core.hasHalfTensors()) {
+        const cv::Size &inputImageShape = core.inputImageShape();
+        const std::vector<int64_t> cudaInputShape = {1, 3, inputImageShape.height, inputImageShape.width};
+        if (cudaPipeline.init(core.session(), core.inputName(), core.outputName(0), cudaInputShape, core.modelOutputShape(0),
+                              cudaStream.get(), options.deviceId)) {
+            std::cout << "GPU-resident pre/postprocessing enabled" << std::endl;
         }
-        std::cout << "Inference device: CPU" << std::endl;
-        device_used = "cpu";
     }
-
-    // Load the ONNX model into the session
-#ifdef _WIN32
-    std::wstring w_modelPath(modelPath.begin(), modelPath.end());
-    session = Ort::Session(env, w_modelPath.c_str(), sessionOptions);
-#else
-    session = Ort::Session(env, modelPath.c_str(), sessionOptions);
 #endif
 
-    Ort::AllocatorWithDefaultOptions allocator;
-
-    // Retrieve input tensor shape information
-    Ort::TypeInfo inputTypeInfo = session.GetInputTypeInfo(0);
-    std::vector<int64_t> inputTensorShapeVec = inputTypeInfo.GetTensorTypeAndShapeInfo().GetShape();
-    isDynamicInputShape = (inputTensorShapeVec.size() >= 4) && (inputTensorShapeVec[2] == -1 && inputTensorShapeVec[3] == -1); // Check for dynamic dimensions
-
-    // Allocate and store input node names
-    auto input_name = session.GetInputNameAllocated(0, allocator);
-    inputNodeNameAllocatedStrings.push_back(std::move(input_name));
-    inputNames.push_back(inputNodeNameAllocatedStrings.back().get());
-
-    // Allocate and store output node names
-    auto output_name = session.GetOutputNameAllocated(0, allocator);
-    outputNodeNameAllocatedStrings.push_back(std::move(output_name));
-    outputNames.push_back(outputNodeNameAllocatedStrings.back().get());
-
-    // Set the expected input image shape based on the model's input tensor
-    if (inputTensorShapeVec.size() >= 4) {
-        inputImageShape = cv::Size(static_cast<int>(inputTensorShapeVec[3]), static_cast<int>(inputTensorShapeVec[2]));
-    } else {
-        throw std::runtime_error("Invalid input tensor shape.");
-    }
-
-    // Get the number of input and output nodes
-    numInputNodes = session.GetInputCount();
-    numOutputNodes = session.GetOutputCount();
-
     // Load class names and generate corresponding colors
     classNames = utils::getClassNames(labelsPath);
     classColors = utils::DrawingUtils::generateColors(classNames);
 
-    std::cout << "Model loaded successfully with " << numInputNodes << " input nodes and " << numOutputNodes << " output nodes." << std::endl;
+    std::cout << "Model loaded successfully with " << core.numInputNodes() << " input nodes and " << core.numOutputNodes() << " output nodes." << std::endl;
 }
 
-// Preprocess function implementation
-cv::Mat YOLODetector::preprocess(const cv::Mat &image, float *&blob, std::vector<int64_t> &inputTensorShape) {
-    ScopedTimer timer("preprocessing");
-
-    cv::Mat resizedImage;
-    // Resize and pad the image using letterBox utility
-    utils::ImagePreprocessingUtils::letterBox(image, resizedImage, inputImageShape, cv::Scalar(114, 114, 114), isDynamicInputShape, false, true, 32);
-
-    // Update input tensor shape based on resized image dimensions
-    inputTensorShape[2] = resizedImage.rows;
-    inputTensorShape[3] = resizedImage.cols;
-
-    // Convert image to float and normalize to [0, 1]
-    resizedImage.convertTo(resizedImage, CV_32FC3, 1 / 255.0f);
-
-    // Allocate memory for the image blob in CHW format
-    blob = new float[resizedImage.cols * resizedImage.rows * resizedImage.channels()];
-
-    // Split the image into separate channels and store in the blob
-    std::vector<cv::Mat> chw(resizedImage.channels());
-    for (int i = 0; i < resizedImage.channels(); ++i) {
-        chw[i] = cv::Mat(resizedImage.rows, resizedImage.cols, CV_32FC1, blob + i * resizedImage.cols * resizedImage.rows);
-    }
-    cv::split(resizedImage, chw); // Split channels into the blob
-
-    DEBUG_PRINT("Preprocessing completed")
-
-    return resizedImage;
-}
 // Postprocess function to convert raw model output into detections
 std::vector<Detection> YOLODetector::postprocess(
     const cv::Size &originalImageSize,
     const cv::Size &resizedImageShape,
-    const std::vector<Ort::Value> &outputTensors,
+    const float *rawOutput,
+    const std::vector<int64_t> &outputShape,
     float confThreshold,
     float iouThreshold
 ) {
-    ScopedTimer timer("postprocessing"); // Measure postprocessing time
-
-    std::vector<Detection> detections;
-    const float* rawOutput = outputTensors[0].GetTensorData<float>(); // Extract raw output data from the first output tensor
-    const std::vector<int64_t> outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
+    ScopedTimer timer("detection.postprocess"); // Measure postprocessing time
 
     // Determine the number of features and detections
     const size_t num_features = outputShape[1];
     const size_t num_detections = outputShape[2];
-    // std::cout << "num_features " << num_features << " num_detections " << num_detections << " " << outputShape[3] << std::endl;
     // Early exit if no detections
     if (num_detections == 0) {
-        return detections;
+        return {};
     }
 
     // Calculate number of classes based on output shape
     const int numClasses = static_cast<int>(num_features) - 4;
     if (numClasses <= 0) {
         // Invalid number of classes
-        return detections;
+        return {};
     }
 
-    // Reserve memory for efficient appending
-    std::vector<BoundingBox> boxes;
-    boxes.reserve(num_detections);
-    std::vector<float> confs;
-    confs.reserve(num_detections);
-    std::vector<int> classIds;
-    classIds.reserve(num_detections);
-    std::vector<BoundingBox> nms_boxes;
-    nms_boxes.reserve(num_detections);
-
-    // Constants for indexing
-    const float* ptr = rawOutput;
-
-    for (size_t d = 0; d < num_detections; ++d) {
-        // Extract bounding box coordinates (center x, center y, width, height)
-        float centerX = ptr[0 * num_detections + d];
-        float centerY = ptr[1 * num_detections + d];
-        float width = ptr[2 * num_detections + d];
-        float height = ptr[3 * num_detections + d];
-
-        // Find class with the highest confidence score
-        int classId = -1;
-        float maxScore = -FLT_MAX;
-        for (int c = 0; c < numClasses; ++c) {
-            const float score = ptr[d + (4 + c) * num_detections];
-            if (score > maxScore) {
-                maxScore = score;
-                classId = c;
-            }
-        }
-
-        // Proceed only if confidence exceeds threshold
-        if (maxScore > confThreshold) {
-            // Convert center coordinates to top-left (x1, y1)
-            float left = centerX - width / 2.0f;
-            float top = centerY - height / 2.0f;
+    // Threshold + argmax sweeping each class row contiguously; survivors land in the reused SoA buffer
+    candidateBuffer.clear();
+    yolos::decodeChannelMajor(rawOutput, numClasses, static_cast<int>(num_detections), confThreshold, candidateBuffer);
 
-            // Scale to original image size
-            BoundingBox scaledBox = utils::ImagePreprocessingUtils::scaleCoords(
-                resizedImageShape,
-                BoundingBox(left, top, width, height),
-                originalImageSize,
-                true
-            );
-
-            // Round coordinates for integer pixel positions
-            BoundingBox roundedBox;
-            roundedBox.x = std::round(scaledBox.x);
-            roundedBox.y = std::round(scaledBox.y);
-            roundedBox.width = std::round(scaledBox.width);
-            roundedBox.height = std::round(scaledBox.height);
+    return detectionsFromCandidates(originalImageSize, resizedImageShape, candidateBuffer, confThreshold, iouThreshold);
+}
 
-            // Adjust NMS box coordinates to prevent overlap between classes
-            BoundingBox nmsBox = roundedBox;
-            nmsBox.x += classId * 7680; // Arbitrary offset to differentiate classes
-            nmsBox.y += classId * 7680;
+// Scales decoded candidates back to the original image and runs class-aware NMS
+std::vector<Detection> YOLODetector::detectionsFromCandidates(
+    const cv::Size &originalImageSize,
+    const cv::Size &resizedImageShape,
+    const yolos::CandidateBuffer &candidates,
+    float confThreshold,
+    float iouThreshold
+) {
+    std::vector<Detection> detections;
+    const size_t count = candidates.size();
 
-            // Add to respective containers
-            nms_boxes.emplace_back(nmsBox);
-            boxes.emplace_back(roundedBox);
-            confs.emplace_back(maxScore);
-            classIds.emplace_back(classId);
-        }
+    // Reserve memory for efficient appending
+    std::vector<BoundingBox> boxes;
+    boxes.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        // Convert center coordinates to top-left (x1, y1)
+        float left = candidates.cx[i] - candidates.w[i] / 2.0f;
+        float top = candidates.cy[i] - candidates.h[i] / 2.0f;
+
+        // Scale to original image size
+        BoundingBox scaledBox = utils::ImagePreprocessingUtils::scaleCoords(
+            resizedImageShape,
+            BoundingBox(left, top, candidates.w[i], candidates.h[i]),
+            originalImageSize,
+            true
+        );
+
+        // Round coordinates for integer pixel positions
+        BoundingBox roundedBox;
+        roundedBox.x = std::round(scaledBox.x);
+        roundedBox.y = std::round(scaledBox.y);
+        roundedBox.width = std::round(scaledBox.width);
+        roundedBox.height = std::round(scaledBox.height);
+
+        boxes.emplace_back(roundedBox);
     }
 
-    // Apply Non-Maximum Suppression (NMS) to eliminate redundant detections
+    // Apply per-class Non-Maximum Suppression (NMS) to eliminate redundant detections
     std::vector<int> indices;
-    utils::NMSBoxes(nms_boxes, confs, confThreshold, iouThreshold, indices);
+    nmsEngine.run(boxes, candidates.score, &candidates.classId, nmsOptionsFor(confThreshold, iouThreshold), indices);
 
     // Collect filtered detections into the result vector
     detections.reserve(indices.size());
     for (const int idx : indices) {
         detections.emplace_back(Detection{
-            boxes[idx],       // Bounding box
-            confs[idx],       // Confidence score
-            classIds[idx]     // Class ID
+            boxes[idx],                  // Bounding box
+            candidates.score[idx],       // Confidence score
+            candidates.classId[idx]      // Class ID
         });
     }
 
@@ -923,23 +874,37 @@ std::vector<Detection> YOLODetector::postprocess(
 
     return detections;
 }
+#ifdef YOLOS_WITH_CUDA
+// Converts device-decoded candidates into detections
+std::vector<Detection> YOLODetector::postprocessCandidates(
+    const cv::Size &originalImageSize,
+    const cv::Size &resizedImageShape,
+    const std::vector<yolos::cuda::Candidate> &candidates,
+    float confThreshold,
+    float iouThreshold
+) {
+    ScopedTimer timer("detection.postprocess");
+
+    candidateBuffer.clear();
+    for (const yolos::cuda::Candidate &c : candidates) {
+        candidateBuffer.push(c.cx, c.cy, c.w, c.h, c.score, c.classId);
+    }
+    return detectionsFromCandidates(originalImageSize, resizedImageShape, candidateBuffer, confThreshold, iouThreshold);
+}
+#endif
+
 // Postprocess function implementation
 std::vector<Detection> YOLODetector::postprocess_yolo10(
     const cv::Size &originalImageSize,
     const cv::Size &resizedImageShape,
-    const std::vector<Ort::Value> &outputTensors,
+    const float *rawOutput,
+    const std::vector<int64_t> &outputShape,
     float confThreshold,
     float iouThreshold
 ) {
     // Start timing the postprocessing step
-    ScopedTimer timer("Postprocessing");
+    ScopedTimer timer("detection.postprocess");
     std::vector<Detection> detections;
-    // Retrieve raw output data from the first output tensor
-    auto *rawOutput = outputTensors[0].GetTensorData<float>();
-    std::vector<int64_t> outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
-    size_t count = outputTensors[0].GetTensorTypeAndShapeInfo().GetElementCount();
-
-    std::vector<Detection> detectionVector;
 
     // Assume the second dimension represents the number of detections
     int num_detections = outputShape[1];
@@ -953,8 +918,6 @@ std::vector<Detection> YOLODetector::postprocess_yolo10(
     confs.reserve(num_detections);
     std::vector<int> classIds;
     classIds.reserve(num_detections);
-    std::vector<BoundingBox> nms_boxes;
-    nms_boxes.reserve(num_detections);
     // Iterate through each detection and filter based on confidence threshold
     for (int i = 0; i < num_detections; i++) {
         float x1 = rawOutput[i * 6 + 0];
@@ -981,22 +944,16 @@ std::vector<Detection> YOLODetector::postprocess_yolo10(
             roundedBox.width = std::round(scaledBox.width);
             roundedBox.height = std::round(scaledBox.height);
 
-            // Adjust NMS box coordinates to prevent overlap between classes
-            BoundingBox nmsBox = roundedBox;
-            nmsBox.x += classId * 7680; // Arbitrary offset to differentiate classes
-            nmsBox.y += classId * 7680;
-
             // Add to respective containers
-            nms_boxes.emplace_back(nmsBox);
             boxes.emplace_back(roundedBox);
             confs.emplace_back(confidence);
             classIds.emplace_back(classId);
         }
     }
 
-    // Apply Non-Maximum Suppression (NMS) to eliminate redundant detections
+    // Apply per-class Non-Maximum Suppression (NMS) to eliminate redundant detections
     std::vector<int> indices;
-    utils::NMSBoxes(nms_boxes, confs, confThreshold, iouThreshold, indices);
+    nmsEngine.run(boxes, confs, &classIds, nmsOptionsFor(confThreshold, iouThreshold), indices);
 
     // Collect filtered detections into the result vector
     detections.reserve(indices.size());
@@ -1018,19 +975,15 @@ std::vector<Detection> YOLODetector::postprocess_yolo10(
 std::vector<Detection> YOLODetector::postprocess_yolo7(
     const cv::Size &originalImageSize,
     const cv::Size &resizedImageShape,
-    const std::vector<Ort::Value> &outputTensors,
+    const float *rawOutput,
+    const std::vector<int64_t> &outputShape,
     float confThreshold,
-    float iouThreshold
+    float iouThreshold,
+    size_t batchIndex
 ) {
     // Start timing the postprocessing step
-    ScopedTimer timer("Postprocessing");
+    ScopedTimer timer("detection.postprocess");
     std::vector<Detection> detections;
-    // Retrieve raw output data from the first output tensor
-    auto *rawOutput = outputTensors[0].GetTensorData<float>();
-    std::vector<int64_t> outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
-    size_t count = outputTensors[0].GetTensorTypeAndShapeInfo().GetElementCount();
-
-    std::vector<Detection> detectionVector;
 
     // Assume the second dimension represents the number of detections
     int num_detections = outputShape[0];
@@ -1046,10 +999,12 @@ std::vector<Detection> YOLODetector::postprocess_yolo7(
     confs.reserve(num_detections);
     std::vector<int> classIds;
     classIds.reserve(num_detections);
-    std::vector<BoundingBox> nms_boxes;
-    nms_boxes.reserve(num_detections);
     // Iterate through each detection and filter based on confidence threshold
     for (int i = 0; i < num_detections; i++) {
+        // With 7 columns the first one holds the batch index of the row
+        if (outputShape[1] > 6 && static_cast<size_t>(rawOutput[i * outputShape[1] + 0]) != batchIndex)
+            continue;
+
         float x1 = rawOutput[i * outputShape[1] + 1];
         float y1 = rawOutput[i * outputShape[1] + 2];
         float x2 = rawOutput[i * outputShape[1] + 3];
@@ -1075,22 +1030,16 @@ std::vector<Detection> YOLODetector::postprocess_yolo7(
             roundedBox.width = std::round(scaledBox.width);
             roundedBox.height = std::round(scaledBox.height);
 
-            // Adjust NMS box coordinates to prevent overlap between classes
-            BoundingBox nmsBox = roundedBox;
-            nmsBox.x += classId * 7680; // Arbitrary offset to differentiate classes
-            nmsBox.y += classId * 7680;
-
             // Add to respective containers
-            nms_boxes.emplace_back(nmsBox);
             boxes.emplace_back(roundedBox);
             confs.emplace_back(confidence);
             classIds.emplace_back(classId);
         }
     }
 
-    // Apply Non-Maximum Suppression (NMS) to eliminate redundant detections
+    // Apply per-class Non-Maximum Suppression (NMS) to eliminate redundant detections
     std::vector<int> indices;
-    utils::NMSBoxes(nms_boxes, confs, confThreshold, iouThreshold, indices);
+    nmsEngine.run(boxes, confs, &classIds, nmsOptionsFor(confThreshold, iouThreshold), indices);
 
     // Collect filtered detections into the result vector
     detections.reserve(indices.size());
@@ -1110,64 +1059,119 @@ std::vector<Detection> YOLODetector::postprocess_yolo7(
 
 // Detect function implementation
 std::vector<Detection> YOLODetector::detect(const cv::Mat& image, float confThreshold, float iouThreshold) {
-    ScopedTimer timer("Overall detection");
+    ScopedTimer timer("detection.detect");
 
-    float* blobPtr = nullptr; // Pointer to hold preprocessed image data
-    // Define the shape of the input tensor (batch size, channels, height, width)
-    std::vector<int64_t> inputTensorShape = {1, 3, inputImageShape.height, inputImageShape.width};
+#ifdef YOLOS_WITH_CUDA
+    if (cudaPipeline.active()) {
+        // Only the frame goes up and only the surviving candidates come back
+        return detectWithPipeline(image.size(), confThreshold, iouThreshold, [&](const yolos::LetterboxParams &params) {
+            return cudaPipeline.run(core.session(), image, params, confThreshold);
+        });
+    }
+#endif
 
-    // Preprocess the image and obtain a pointer to the blob
-    cv::Mat preprocessedImage = preprocess(image, blobPtr, inputTensorShape);
+    return withDecoder(confThreshold, iouThreshold, [&](auto &&decoder) { return core.run(image, decoder); });
+}
 
-    // Compute the total number of elements in the input tensor
-    size_t inputTensorSize = utils::MathUtils::vectorProduct(inputTensorShape);
+#ifdef YOLOS_WITH_CUDA
+// Device frame detect function implementation
+std::vector<Detection> YOLODetector::detect(const cv::cuda::GpuMat &frame, float confThreshold, float iouThreshold) {
+    ScopedTimer timer("detection.detect_device");
 
-    // Create a vector from the blob data for ONNX Runtime input
-    std::vector<float> inputTensorValues(blobPtr, blobPtr + inputTensorSize);
+    if (frame.empty() || frame.depth() != CV_8U || (frame.channels() != 3 && frame.channels() != 4)) {
+        throw std::invalid_argument("YOLODetector: device frames must be non-empty 8-bit BGR or BGRA images.");
+    }
+    if (!cudaPipeline.active()) {
+        // Layouts the device decoder does not handle go through the host path
+        frame.download(downloadedFrame);
+        return detect(downloadedFrame, confThreshold, iouThreshold);
+    }
 
-    delete[] blobPtr; // Free the allocated memory for the blob
+    // Nothing crosses PCIe but the surviving candidates
+    return detectWithPipeline(frame.size(), confThreshold, iouThreshold, [&](const yolos::LetterboxParams &params) {
+        return cudaPipeline.runDevice(core.session(), frame.ptr<uint8_t>(), frame.step, frame.channels(), params, confThreshold);
+    });
+}
+#endif
 
-    // Create an Ort memory info object (can be cached if used repeatedly)
-    static Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+// Batch detect function implementation
+std::vector<std::vector<Detection>> YOLODetector::detectBatch(const std::vector<cv::Mat> &images, float confThreshold, float iouThreshold) {
+    ScopedTimer timer("detection.detect_batch");
 
-    // Create input tensor object using the preprocessed data
-    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-        memoryInfo,
-        inputTensorValues.data(),
-        inputTensorSize,
-        inputTensorShape.data(),
-        inputTensorShape.size()
-    );
+    // All images share one letterbox shape (640x640 for dynamic-shape models)
+    return withDecoder(confThreshold, iouThreshold, [&](auto &&decoder) { return core.runBatch(images, decoder); });
+}
 
-    // Run the inference session with the input tensor and retrieve output tensors
-    std::vector<Ort::Value> outputTensors = session.Run(
-        Ort::RunOptions{nullptr},
-        inputNames.data(),
-        &inputTensor,
-        numInputNodes,
-        outputNames.data(),
-        numOutputNodes
-    );
+// Tiled detect function implementation
+std::vector<Detection> YOLODetector::detectTiled(const cv::Mat &image, const yolos::TilingOptions &tiling, float confThreshold, float iouThreshold) {
+    ScopedTimer timer("detection.detect_tiled");
 
-    // Determine the resized image shape based on input tensor shape
-    cv::Size resizedImageShape(static_cast<int>(inputTensorShape[3]), static_cast<int>(inputTensorShape[2]));
+    const yolos::TilePlan plan = yolos::planTiles(image, tiling, core.inputImageShape());
+    return detectCrops(plan.views, plan.rects, confThreshold, iouThreshold, tiling.maxBatch);
+}
 
-    // Postprocess the output tensors to obtain detections
-    std::vector<Detection> detections;
-    const std::vector<int64_t> outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
-    // std::cout << "out shape 0 "<< outputShape[0] << " 1 " << outputShape[1] << " 2 " << outputShape[2] << std::endl;
-    if(outputShape[2] == 6){
-        // std::cout << "yolo 10 detected" << std::endl;
-        detections = postprocess_yolo10(image.size(), resizedImageShape, outputTensors, confThreshold, iouThreshold);
-    }else if(outputShape[1] == 7){
-        // std::cout << "yolo 7 detected" << std::endl;
-        detections = postprocess_yolo7(image.size(), resizedImageShape, outputTensors, confThreshold, iouThreshold);
+// Region-of-interest detect function implementation
+std::vector<Detection> YOLODetector::detectRegions(const cv::Mat &image, const std::vector<cv::Rect> &regions,
+                                                   float confThreshold, float iouThreshold, int maxBatch) {
+    ScopedTimer timer("detection.detect_regions");
+
+    const cv::Rect bounds(0, 0, image.cols, image.rows);
+    std::vector<cv::Rect> rects;
+    std::vector<cv::Mat> views;
+    rects.reserve(regions.size());
+    views.reserve(regions.size());
+    for (const cv::Rect &region : regions) {
+        const cv::Rect rect = region & bounds;
+        if (rect.area() > 0) {
+            rects.push_back(rect);
+            views.push_back(image(rect));
+        }
     }
-    else{
-        // std::cout << "yolo not 10 detected" << std::endl;
-        detections = postprocess(image.size(), resizedImageShape, outputTensors, confThreshold, iouThreshold);
+    return detectCrops(views, rects, confThreshold, iouThreshold, maxBatch);
+}
+
+// Batched detection on crops, merged in image coordinates
+std::vector<Detection> YOLODetector::detectCrops(const std::vector<cv::Mat> &views, const std::vector<cv::Rect> &rects,
+                                                 float confThreshold, float iouThreshold, int maxBatch) {
+    const size_t chunkSize = yolos::tileChunkSize(maxBatch, core.batchSize(), views.size());
+
+    // Per-crop detections, shifted back into image coordinates
+    std::vector<BoundingBox> boxes;
+    std::vector<float> scores;
+    std::vector<int> classIds;
+    StageTimings totals;
+    for (size_t begin = 0; begin < views.size(); begin += chunkSize) {
+        const size_t end = std::min(views.size(), begin + chunkSize);
+        const std::vector<cv::Mat> chunk(views.begin() + begin, views.begin() + end);
+        const std::vector<std::vector<Detection>> results = detectBatch(chunk, confThreshold, iouThreshold);
+
+        for (size_t t = 0; t < results.size(); ++t) {
+            const cv::Point origin = rects[begin + t].tl();
+            for (const Detection &det : results[t]) {
+                BoundingBox box = det.box;
+                box.x += origin.x;
+                box.y += origin.y;
+                boxes.push_back(box);
+                scores.push_back(det.conf);
+                classIds.push_back(det.classId);
+            }
+        }
+
+        const StageTimings &timings = core.lastTimings();
+        totals.preprocessMs += timings.preprocessMs;
+        totals.inferenceMs += timings.inferenceMs;
+        totals.postprocessMs += timings.postprocessMs;
     }
-    
 
-    return detections; // Return the vector of detections
-}
\ No newline at end of file
+    // Objects on a crop seam are found by both neighbours; the merge keeps the best of each cluster
+    std::vector<int> indices;
+    nmsEngine.run(boxes, scores, &classIds, nmsOptionsFor(confThreshold, iouThreshold), indices);
+
+    std::vector<Detection> detections;
+    detections.reserve(indices.size());
+    for (const int idx : indices) {
+        detections.emplace_back(Detection{boxes[idx], scores[idx], classIds[idx]});
+    }
+    core.setLastTimings(totals);
+    return detections;
+}
@@ -43,6 +43,10 @@
 // Include debug and custom ScopedTimer tools for performance measurement
 #include "tools/Debug.hpp"
 #include "tools/ScopedTimer.hpp"
+#include "tools/YoloCore.hpp"
+#include "tools/RotatedNMS.hpp"
+#include "tools/Tiling.hpp"
+#include "tools/DetectorOptions.hpp"
 
 
 
@@ -77,194 +81,6 @@ struct Detection {
         : box(box_), conf(conf_), classId(classId_) {}
 };
 
-
-/**
- * @namespace OBB_NMS
- * @brief Namespace containing NMS functions for the OBB format.
- */
-namespace OBB_NMS {
-
-    static constexpr float EPS = 1e-7f;
-
-    /**
-     * @brief Computes covariance matrix components for a single OBB.
-     * @param box Input oriented bounding box.
-     * @param out1 First component (a).
-     * @param out2 Second component (b).
-     * @param out3 Third component (c).
-     */
-    void getCovarianceComponents(const OrientedBoundingBox& box, float& out1, float& out2, float& out3) {
-        float a = (box.width * box.width) / 12.0f;
-        float b = (box.height * box.height) / 12.0f;
-        float angle = box.angle;
-
-        float cos_theta = std::cos(angle);
-        float sin_theta = std::sin(angle);
-        float cos_sq = cos_theta * cos_theta;
-        float sin_sq = sin_theta * sin_theta;
-
-        out1 = a * cos_sq + b * sin_sq;
-        out2 = a * sin_sq + b * cos_sq;
-        out3 = (a - b) * cos_theta * sin_theta;
-    }
-
-    /**
-     * @brief Computes IoU matrix between two sets of OBBs.
-     * @param obb1 First set of OBBs.
-     * @param obb2 Second set of OBBs.
-     * @param eps Small constant for numerical stability.
-     * @return 2D vector of IoU values.
-     */
-    std::vector<std::vector<float>> batchProbiou(const std::vector<OrientedBoundingBox>& obb1, const std::vector<OrientedBoundingBox>& obb2, float eps = EPS) {
-        size_t N = obb1.size();
-        size_t M = obb2.size();
-        std::vector<std::vector<float>> iou_matrix(N, std::vector<float>(M, 0.0f));
-
-        for (size_t i = 0; i < N; ++i) {
-            const OrientedBoundingBox& box1 = obb1[i];
-            float x1 = box1.x, y1 = box1.y;
-            float a1, b1, c1;
-            getCovarianceComponents(box1, a1, b1, c1);
-
-            for (size_t j = 0; j < M; ++j) {
-                const OrientedBoundingBox& box2 = obb2[j];
-                float x2 = box2.x, y2 = box2.y;
-                float a2, b2, c2;
-                getCovarianceComponents(box2, a2, b2, c2);
-
-                // Compute denominator
-                float denom = (a1 + a2) * (b1 + b2) - std::pow(c1 + c2, 2) + eps;
-
-                // Terms t1 and t2
-                float dx = x1 - x2;
-                float dy = y1 - y2;
-                float t1 = ((a1 + a2) * dy * dy + (b1 + b2) * dx * dx) * 0.25f / denom;
-                float t2 = ((c1 + c2) * (x2 - x1) * dy) * 0.5f / denom;
-
-                // Term t3
-                float term1 = a1 * b1 - c1 * c1;
-                term1 = std::max(term1, 0.0f);
-                float term2 = a2 * b2 - c2 * c2;
-                term2 = std::max(term2, 0.0f);
-                float sqrt_term = std::sqrt(term1 * term2);
-
-                float numerator = (a1 + a2) * (b1 + b2) - std::pow(c1 + c2, 2);
-                float denominator_t3 = 4.0f * sqrt_term + eps;
-                float t3 = 0.5f * std::log(numerator / denominator_t3 + eps);
-
-                // Compute final IoU
-                float bd = t1 + t2 + t3;
-                bd = std::clamp(bd, eps, 100.0f);
-                float hd = std::sqrt(1.0f - std::exp(-bd) + eps);
-                iou_matrix[i][j] = 1.0f - hd;
-            }
-        }
-        return iou_matrix;
-    }
-
-    /**
-     * @brief Performs rotated NMS on sorted OBBs.
-     * @param sorted_boxes Boxes sorted by confidence.
-     * @param iou_thres Threshold for IoU suppression.
-     * @return Indices of boxes to keep.
-     */
-    std::vector<int> nmsRotatedImpl(const std::vector<OrientedBoundingBox>& sorted_boxes, float iou_thres) {
-        auto ious = batchProbiou(sorted_boxes, sorted_boxes);
-        std::vector<int> keep;
-        const int n = sorted_boxes.size();
-
-        for (int j = 0; j < n; ++j) {
-            bool keep_j = true;
-            for (int i = 0; i < j; ++i) {
-                if (ious[i][j] >= iou_thres) {
-                    keep_j = false;
-                    break;
-                }
-            }
-            if (keep_j) keep.push_back(j);
-        }
-        return keep;
-    }
-
-    /**
-     * @brief Main NMS function for rotated boxes.
-     * @param boxes Input boxes.
-     * @param scores Confidence scores.
-     * @param threshold IoU threshold.
-     * @return Indices of boxes to keep.
-     */
-    std::vector<int> nmsRotated(const std::vector<OrientedBoundingBox>& boxes, const std::vector<float>& scores, float threshold = 0.75f) {
-        // Sort indices based on scores
-        std::vector<int> indices(boxes.size());
-        std::iota(indices.begin(), indices.end(), 0);
-        std::sort(indices.begin(), indices.end(), [&scores](int a, int b) {
-            return scores[a] > scores[b];
-        });
-
-        // Create sorted boxes list
-        std::vector<OrientedBoundingBox> sorted_boxes;
-        for (int idx : indices) {
-            sorted_boxes.push_back(boxes[idx]);
-        }
-
-        // Perform NMS
-        std::vector<int> keep = nmsRotatedImpl(sorted_boxes, threshold);
-
-        // Map back to original indices
-        std::vector<int> keep_indices;
-        for (int k : keep) {
-            keep_indices.push_back(indices[k]);
-        }
-        return keep_indices;
-    }
-
-    /**
-     * @brief Applies NMS to detections and returns filtered results.
-     * @param input_detections Input detections.
-     * @param conf_thres Confidence threshold.
-     * @param iou_thres IoU threshold.
-     * @param max_det Maximum detections to keep.
-     * @return Filtered detections after NMS.
-     */
-    std::vector<Detection> nonMaxSuppression(
-        const std::vector<Detection>& input_detections,
-        float conf_thres = 0.25f,
-        float iou_thres = 0.75f,
-        int max_det = 1000) {
-
-        // Filter by confidence
-        std::vector<Detection> candidates;
-        for (const auto& det : input_detections) {
-            if (det.conf > conf_thres) {
-                candidates.push_back(det);
-            }
-        }
-        if (candidates.empty()) return {};
-
-        // Extract boxes and scores
-        std::vector<OrientedBoundingBox> boxes;
-        std::vector<float> scores;
-        for (const auto& det : candidates) {
-            boxes.push_back(det.box);
-            scores.push_back(det.conf);
-        }
-
-        // Run NMS
-        std::vector<int> keep_indices = nmsRotated(boxes, scores, iou_thres);
-
-        // Collect results
-        std::vector<Detection> results;
-        for (int idx : keep_indices) {
-            if (results.size() >= max_det) break;
-            results.push_back(candidates[idx]);
-        }
-        return results;
-    }
-
-}
-
-
-
 /**
  * @namespace utils
  * @brief Namespace containing utility functions for the YOLO11OBBDetector.
@@ -337,93 +153,6 @@ namespace utils {
     }
 
 
-    /**
-     * @brief Resizes an image with letterboxing to maintain aspect ratio.
-     * 
-     * @param image Input image.
-     * @param outImage Output resized and padded image.
-     * @param newShape Desired output size.
-     * @param color Padding color (default is gray).
-     * @param auto_ Automatically adjust padding to be multiple of stride.
-     * @param scaleFill Whether to scale to fill the new shape without keeping aspect ratio.
-     * @param scaleUp Whether to allow scaling up of the image.
-     * @param stride Stride size for padding alignment.
-     */
-    inline void letterBox(const cv::Mat& image, cv::Mat& outImage,
-                        const cv::Size& newShape,
-                        const cv::Scalar& color = cv::Scalar(114, 114, 114),
-                        bool auto_ = true,
-                        bool scaleFill = false,
-                        bool scaleUp = true,
-                        int stride = 32) {
-        // Calculate the scaling ratio to fit the image within the new shape
-        float ratio = std::min(static_cast<float>(newShape.height) / image.rows,
-                            static_cast<float>(newShape.width) / image.cols);
-
-        // Prevent scaling up if not allowed
-        if (!scaleUp) {
-            ratio = std::min(ratio, 1.0f);
-        }
-
-        // Calculate new dimensions after scaling
-        int newUnpadW = static_cast<int>(std::round(image.cols * ratio));
-        int newUnpadH = static_cast<int>(std::round(image.rows * ratio));
-
-        // Calculate padding needed to reach the desired shape
-        int dw = newShape.width - newUnpadW;
-        int dh = newShape.height - newUnpadH;
-
-        if (auto_) {
-            // Ensure padding is a multiple of stride for model compatibility
-            dw = (dw % stride) / 2;
-            dh = (dh % stride) / 2;
-        } else if (scaleFill) {
-            // Scale to fill without maintaining aspect ratio
-            newUnpadW = newShape.width;
-            newUnpadH = newShape.height;
-            ratio = std::min(static_cast<float>(newShape.width) / image.cols,
-                            static_cast<float>(newShape.height) / image.rows);
-            dw = 0;
-            dh = 0;
-        } else {
-            // Evenly distribute padding on both sides
-            // Calculate separate padding for left/right and top/bottom to handle odd padding
-            int padLeft = dw / 2;
-            int padRight = dw - padLeft;
-            int padTop = dh / 2;
-            int padBottom = dh - padTop;
-
-            // Resize the image if the new dimensions differ
-            if (image.cols != newUnpadW || image.rows != newUnpadH) {
-                cv::resize(image, outImage, cv::Size(newUnpadW, newUnpadH), 0, 0, cv::INTER_LINEAR);
-            } else {
-                // Avoid unnecessary copying if dimensions are the same
-                outImage = image;
-            }
-
-            // Apply padding to reach the desired shape
-            cv::copyMakeBorder(outImage, outImage, padTop, padBottom, padLeft, padRight, cv::BORDER_CONSTANT, color);
-            return; // Exit early since padding is already applied
-        }
-
-        // Resize the image if the new dimensions differ
-        if (image.cols != newUnpadW || image.rows != newUnpadH) {
-            cv::resize(image, outImage, cv::Size(newUnpadW, newUnpadH), 0, 0, cv::INTER_LINEAR);
-        } else {
-            // Avoid unnecessary copying if dimensions are the same
-            outImage = image;
-        }
-
-        // Calculate separate padding for left/right and top/bottom to handle odd padding
-        int padLeft = dw / 2;
-        int padRight = dw - padLeft;
-        int padTop = dh / 2;
-        int padBottom = dh - padTop;
-
-        // Apply padding to reach the desired shape
-        cv::copyMakeBorder(outImage, outImage, padTop, padBottom, padLeft, padRight, cv::BORDER_CONSTANT, color);
-    }
-
     /**
     * @brief Draws oriented bounding boxes with rotation and labels on the image based on detections
     * 
@@ -532,6 +261,16 @@ namespace utils {
 
 };
 
+/**
+ * @brief YoloCore policy: letterboxed input, one [1, 4 + nc + 1, num_detections] output.
+ */
+struct OBBTaskPolicy {
+    static constexpr yolos::InputTransform transform = yolos::InputTransform::Letterbox;
+    static constexpr size_t outputs = 1;
+    static constexpr const char *preprocessStage = "obb.preprocess";
+    static constexpr const char *preprocessBatchStage = "obb.preprocess_batch";
+};
+
 /**
  * @brief YOLO11-OBB-Detector class handles loading the YOLO model, preprocessing images, running inference, and postprocessing results.
  */
@@ -545,6 +284,15 @@ public:
      * @param useGPU Whether to use GPU for inference (default is false).
      */
     YOLO11OBBDetector(const std::string &modelPath, const std::string &labelsPath, bool useGPU = false);
+
+    /**
+     * @brief Constructor with explicit execution-provider and threading options.
+     *
+     * @param modelPath Path to the ONNX model file.
+     * @param labelsPath Path to the file containing class labels.
+     * @param options Execution providers (in order of preference) and threading.
+     */
+    YOLO11OBBDetector(const std::string &modelPath, const std::string &labelsPath, const yolos::DetectorOptions &options);
     
     /**
      * @brief Runs detection on the provided image.
@@ -555,6 +303,35 @@ public:
      * @return std::vector<Detection> Vector of detections.
      */
     std::vector<Detection> detect(const cv::Mat &image, float confThreshold = 0.25f, float iouThreshold = 0.25);
+
+    /**
+     * @brief Runs detection on a batch of images with a single session run per model batch.
+     *
+     * Dynamic-batch models consume the whole request in one run; fixed-batch models are fed in
+     * chunks of their exported batch size with the unused slots of the last chunk zero-filled.
+     *
+     * @param images Input images for detection.
+     * @param confThreshold Confidence threshold to filter detections (default is 0.25).
+     * @param iouThreshold IoU threshold for Non-Maximum Suppression (default is 0.25).
+     * @return std::vector<std::vector<Detection>> Detections for each input image, in input order.
+     */
+    std::vector<std::vector<Detection>> detectBatch(const std::vector<cv::Mat> &images, float confThreshold = 0.25f, float iouThreshold = 0.25f);
+
+    /**
+     * @brief Runs sliced inference for images much larger than the model input (4K, aerial).
+     *
+     * The image is cut into overlapping tiles (yolos::TilingOptions), tiles ruled out by the
+     * optional mask or texture test are skipped, the rest go through detectBatch() as ROI views
+     * and the per-tile detections are merged with NMS in image coordinates.
+     *
+     * @param image Input image for detection.
+     * @param tiling Tile size, overlap, batching and tile filtering.
+     * @param confThreshold Confidence threshold to filter detections (default is 0.25).
+     * @param iouThreshold IoU threshold for the per-tile and merging NMS (default is 0.25).
+     * @return std::vector<Detection> Detections in image coordinates.
+     */
+    std::vector<Detection> detectTiled(const cv::Mat &image, const yolos::TilingOptions &tiling,
+                                       float confThreshold = 0.25f, float iouThreshold = 0.25f);
     
     /**
      * @brief Draws bounding boxes on the image based on detections.
@@ -565,166 +342,83 @@ public:
     void drawBoundingBox(cv::Mat &image, const std::vector<Detection> &detections) const {
         utils::drawBoundingBox(image, detections, classNames, classColors);
     }
-    
 
-private:
-    Ort::Env env{nullptr};                         // ONNX Runtime environment
-    Ort::SessionOptions sessionOptions{nullptr};   // Session options for ONNX Runtime
-    Ort::Session session{nullptr};                 // ONNX Runtime session for running inference
-    bool isDynamicInputShape{};                    // Flag indicating if input shape is dynamic
-    cv::Size inputImageShape;                      // Expected input image shape for the model
+    /**
+     * @brief Gets the numeric precision of the model: "fp32", "fp16" or "int8".
+     */
+    const std::string &getPrecision() const { return core.precision(); }
+    
 
-    // Vectors to hold allocated input and output node names
-    std::vector<Ort::AllocatedStringPtr> inputNodeNameAllocatedStrings;
-    std::vector<const char *> inputNames;
-    std::vector<Ort::AllocatedStringPtr> outputNodeNameAllocatedStrings;
-    std::vector<const char *> outputNames;
+    /**
+     * @brief Runs dummy inferences so that lazy initialization (memory arenas, kernel and
+     *        algorithm selection, TensorRT engine builds) happens before the first real frame.
+     *
+     * @param imageSizes Frame sizes to expect; they matter for dynamic-shape models, whose
+     *                   letterbox follows the aspect ratio (default: every input bucket, or
+     *                   the model input size).
+     * @param iterations Runs per size.
+     */
+    void warmup(const std::vector<cv::Size> &imageSizes = {}, int iterations = 2) {
+        const std::vector<cv::Size> sizes = imageSizes.empty() ? core.warmupSizes() : imageSizes;
+        for (const cv::Size &size : sizes) {
+            const cv::Mat frame(size, CV_8UC3, cv::Scalar(114, 114, 114));
+            for (int i = 0; i < iterations; ++i) {
+                detect(frame);
+            }
+        }
+    }
 
-    size_t numInputNodes, numOutputNodes;          // Number of input and output nodes in the model
+private:
+    yolos::YoloCore<OBBTaskPolicy> core;           // Session, bound tensors, preprocessing and batching
+    yolos::RotatedNMSEngine rotatedNms;            // Streaming ProbIoU NMS with reusable buffers
 
     std::vector<std::string> classNames;            // Vector of class names loaded from file
     std::vector<cv::Scalar> classColors;            // Vector of colors for each class
-
-    /**
-     * @brief Preprocesses the input image for model inference.
-     * 
-     * @param image Input image.
-     * @param blob Reference to pointer where preprocessed data will be stored.
-     * @param inputTensorShape Reference to vector representing input tensor shape.
-     * @return cv::Mat Resized image after preprocessing.
-     */
-    cv::Mat preprocess(const cv::Mat &image, float *&blob, std::vector<int64_t> &inputTensorShape);
     
 /**
  * @brief Postprocesses the model output to extract detections with oriented bounding boxes.
  * 
  * @param originalImageSize Size of the original input image.
  * @param resizedImageShape Size of the image after preprocessing.
- * @param outputTensors Vector of output tensors from the model.
+ * @param rawOutput Raw output data of a single image.
+ * @param outputShape Output shape of a single image ([1, num_features, num_detections]).
  * @param confThreshold Confidence threshold to filter detections.
  * @param iouThreshold IoU threshold for Non-Maximum Suppression (using ProbIoU for rotated boxes).
  * @return std::vector<Detection> Vector of detections with oriented bounding boxes.
  */
     std::vector<Detection> postprocess(const cv::Size &originalImageSize,
         const cv::Size &resizedImageShape,
-        const std::vector<Ort::Value> &outputTensors,
+        const float *rawOutput, const std::vector<int64_t> &outputShape,
         float confThreshold, float iouThreshold,
         int topk = 500); // Default argument here
 };
 
 // Implementation of YOLO11OBBDetector constructor
-YOLO11OBBDetector::YOLO11OBBDetector(const std::string &modelPath, const std::string &labelsPath, bool useGPU) {
-    // Initialize ONNX Runtime environment with warning level
-    env = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "ONNX_DETECTION");
-    sessionOptions = Ort::SessionOptions();
-
-    // Set number of intra-op threads for parallelism
-    sessionOptions.SetIntraOpNumThreads(std::min(6, static_cast<int>(std::thread::hardware_concurrency())));
-    sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-
-    // Retrieve available execution providers (e.g., CPU, CUDA)
-    std::vector<std::string> availableProviders = Ort::GetAvailableProviders();
-    auto cudaAvailable = std::find(availableProviders.begin(), availableProviders.end(), "CUDAExecutionProvider");
-    OrtCUDAProviderOptions cudaOption;
-
-    // Configure session options based on whether GPU is to be used and available
-    if (useGPU && cudaAvailable != availableProviders.end()) {
-        std::cout << "Inference device: GPU" << std::endl;
-        sessionOptions.AppendExecutionProvider_CUDA(cudaOption); // Append CUDA execution provider
-    } else {
-        if (useGPU) {
-            std::cout << "GPU is not supported by your ONNXRuntime build. Fallback to CPU." << std::endl;
-        }
-        std::cout << "Inference device: CPU" << std::endl;
-    }
-
-    // Load the ONNX model into the session
-#ifdef _WIN32
-    std::wstring w_modelPath(modelPath.begin(), modelPath.end());
-    session = Ort::Session(env, w_modelPath.c_str(), sessionOptions);
-#else
-    session = Ort::Session(env, modelPath.c_str(), sessionOptions);
-#endif
-
-    Ort::AllocatorWithDefaultOptions allocator;
-
-    // Retrieve input tensor shape information
-    Ort::TypeInfo inputTypeInfo = session.GetInputTypeInfo(0);
-    std::vector<int64_t> inputTensorShapeVec = inputTypeInfo.GetTensorTypeAndShapeInfo().GetShape();
-    isDynamicInputShape = (inputTensorShapeVec.size() >= 4) && (inputTensorShapeVec[2] == -1 && inputTensorShapeVec[3] == -1); // Check for dynamic dimensions
-
-    // Allocate and store input node names
-    auto input_name = session.GetInputNameAllocated(0, allocator);
-    inputNodeNameAllocatedStrings.push_back(std::move(input_name));
-    inputNames.push_back(inputNodeNameAllocatedStrings.back().get());
-
-    // Allocate and store output node names
-    auto output_name = session.GetOutputNameAllocated(0, allocator);
-    outputNodeNameAllocatedStrings.push_back(std::move(output_name));
-    outputNames.push_back(outputNodeNameAllocatedStrings.back().get());
-
-    // Set the expected input image shape based on the model's input tensor
-    if (inputTensorShapeVec.size() >= 4) {
-        inputImageShape = cv::Size(static_cast<int>(inputTensorShapeVec[3]), static_cast<int>(inputTensorShapeVec[2]));
-    } else {
-        throw std::runtime_error("Invalid input tensor shape.");
-    }
-
-    // Get the number of input and output nodes
-    numInputNodes = session.GetInputCount();
-    numOutputNodes = session.GetOutputCount();
+YOLO11OBBDetector::YOLO11OBBDetector(const std::string &modelPath, const std::string &labelsPath, bool useGPU)
+    : YOLO11OBBDetector(modelPath, labelsPath, yolos::DetectorOptions::fromUseGPU(useGPU)) {}
 
+YOLO11OBBDetector::YOLO11OBBDetector(const std::string &modelPath, const std::string &labelsPath, const yolos::DetectorOptions &options)
+    : core(modelPath, options) {
     // Load class names and generate corresponding colors
     classNames = utils::getClassNames(labelsPath);
     classColors = utils::generateColors(classNames);
 
-    std::cout << "Model loaded successfully with " << numInputNodes << " input nodes and " << numOutputNodes << " output nodes." << std::endl;
-}
-
-// Preprocess function implementation
-cv::Mat YOLO11OBBDetector::preprocess(const cv::Mat &image, float *&blob, std::vector<int64_t> &inputTensorShape) {
-    ScopedTimer timer("preprocessing");
-
-    cv::Mat resizedImage;
-    // Resize and pad the image using letterBox utility
-    utils::letterBox(image, resizedImage, inputImageShape, cv::Scalar(114, 114, 114), isDynamicInputShape, false, true, 32);
-
-    // Update input tensor shape based on resized image dimensions
-    inputTensorShape[2] = resizedImage.rows;
-    inputTensorShape[3] = resizedImage.cols;
-
-    // Convert image to float and normalize to [0, 1]
-    resizedImage.convertTo(resizedImage, CV_32FC3, 1 / 255.0f);
-
-    // Allocate memory for the image blob in CHW format
-    blob = new float[resizedImage.cols * resizedImage.rows * resizedImage.channels()];
-
-    // Split the image into separate channels and store in the blob
-    std::vector<cv::Mat> chw(resizedImage.channels());
-    for (int i = 0; i < resizedImage.channels(); ++i) {
-        chw[i] = cv::Mat(resizedImage.rows, resizedImage.cols, CV_32FC1, blob + i * resizedImage.cols * resizedImage.rows);
-    }
-    cv::split(resizedImage, chw); // Split channels into the blob
-
-    DEBUG_PRINT("Preprocessing completed")
-
-    return resizedImage;
+    std::cout << "Model loaded successfully with " << core.numInputNodes() << " input nodes and " << core.numOutputNodes() << " output nodes." << std::endl;
 }
 
 std::vector<Detection> YOLO11OBBDetector::postprocess(
     const cv::Size &originalImageSize,
     const cv::Size &resizedImageShape,
-    const std::vector<Ort::Value> &outputTensors,
+    const float *rawOutput,
+    const std::vector<int64_t> &outputShape,
     float confThreshold,
     float iouThreshold,
     int topk)
 {
-    ScopedTimer timer("postprocessing");
+    ScopedTimer timer("obb.postprocess");
     std::vector<Detection> detections;
 
-    // Get raw output data and shape (assumed [1, num_features, num_detections])
-    const float* rawOutput = outputTensors[0].GetTensorData<float>();
-    const std::vector<int64_t> outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
+    // Output shape is assumed [1, num_features, num_detections]
     int num_features   = static_cast<int>(outputShape[1]);
     int num_detections = static_cast<int>(outputShape[2]);
     if (num_detections == 0) {
@@ -796,23 +490,28 @@ std::vector<Detection> YOLO11OBBDetector::postprocess(
         }
     }
 
-    // Combine detections into a vector<Detection> for NMS.
-    std::vector<Detection> detectionsForNMS;
-    for (size_t i = 0; i < obbs.size(); i++) {
-        detectionsForNMS.emplace_back(Detection{ obbs[i], scores[i], labels[i] });
+    for (auto &obb : obbs) {
+        obb.x      = std::min(std::max(obb.x, 0.f), orig_w);
+        obb.y      = std::min(std::max(obb.y, 0.f), orig_h);
+        obb.width  = std::min(std::max(obb.width, 0.f), orig_w);
+        obb.height = std::min(std::max(obb.height, 0.f), orig_h);
     }
 
-    for (auto &det : detectionsForNMS) {
-        det.box.x    = std::min(std::max(det.box.x, 0.f), orig_w);
-        det.box.y    = std::min(std::max(det.box.y, 0.f), orig_h);
-        det.box.width = std::min(std::max(det.box.width, 0.f), orig_w);
-        det.box.height= std::min(std::max(det.box.height, 0.f), orig_h);
+    // Perform class-agnostic rotated NMS, keeping at most topk boxes.
+    yolos::NMSOptions nmsOptions;
+    nmsOptions.scoreThreshold = confThreshold;
+    nmsOptions.iouThreshold = iouThreshold;
+    nmsOptions.agnostic = true;
+    nmsOptions.maxDetections = topk;
+    std::vector<int> keep;
+    rotatedNms.run(obbs, scores, nullptr, nmsOptions, keep);
+
+    std::vector<Detection> post_nms_detections;
+    post_nms_detections.reserve(keep.size());
+    for (int idx : keep) {
+        post_nms_detections.emplace_back(Detection{ obbs[idx], scores[idx], labels[idx] });
     }
 
-    // Perform rotated NMS.
-    std::vector<Detection> post_nms_detections = OBB_NMS::nonMaxSuppression(
-        detectionsForNMS, confThreshold, iouThreshold, topk);
-
  
 
     DEBUG_PRINT("Postprocessing completed");
@@ -823,50 +522,64 @@ std::vector<Detection> YOLO11OBBDetector::postprocess(
 
 // Detect function implementation
 std::vector<Detection> YOLO11OBBDetector::detect(const cv::Mat& image, float confThreshold, float iouThreshold) {
-    ScopedTimer timer("Overall detection");
-
-    float* blobPtr = nullptr; // Pointer to hold preprocessed image data
-    // Define the shape of the input tensor (batch size, channels, height, width)
-    std::vector<int64_t> inputTensorShape = {1, 3, inputImageShape.height, inputImageShape.width};
-
-    // Preprocess the image and obtain a pointer to the blob
-    cv::Mat preprocessedImage = preprocess(image, blobPtr, inputTensorShape);
-
-    // Compute the total number of elements in the input tensor
-    size_t inputTensorSize = utils::vectorProduct(inputTensorShape);
+    ScopedTimer timer("obb.detect");
 
-    // Create a vector from the blob data for ONNX Runtime input
-    std::vector<float> inputTensorValues(blobPtr, blobPtr + inputTensorSize);
+    return core.run(image, [&](const cv::Size &originalSize, const cv::Size &resizedShape, const yolos::ImageOutputs &outputs) {
+        return postprocess(originalSize, resizedShape, outputs.data(), outputs.shape(), confThreshold, iouThreshold, 100);
+    });
+}
 
-    delete[] blobPtr; // Free the allocated memory for the blob
+// Batch detect function implementation
+std::vector<std::vector<Detection>> YOLO11OBBDetector::detectBatch(const std::vector<cv::Mat> &images, float confThreshold, float iouThreshold) {
+    ScopedTimer timer("obb.detect_batch");
 
-    // Create an Ort memory info object (can be cached if used repeatedly)
-    static Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    // Every image is decoded from its [1, num_features, num_detections] slice of the batched output
+    return core.runBatch(images, [&](const cv::Size &originalSize, const cv::Size &resizedShape, const yolos::ImageOutputs &outputs) {
+        return postprocess(originalSize, resizedShape, outputs.data(), outputs.shape(), confThreshold, iouThreshold, 100);
+    });
+}
 
-    // Create input tensor object using the preprocessed data
-    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-        memoryInfo,
-        inputTensorValues.data(),
-        inputTensorSize,
-        inputTensorShape.data(),
-        inputTensorShape.size()
-    );
+// Tiled detect function implementation
+std::vector<Detection> YOLO11OBBDetector::detectTiled(const cv::Mat &image, const yolos::TilingOptions &tiling, float confThreshold, float iouThreshold) {
+    ScopedTimer timer("obb.detect_tiled");
 
-    // Run the inference session with the input tensor and retrieve output tensors
-    std::vector<Ort::Value> outputTensors = session.Run(
-        Ort::RunOptions{nullptr},
-        inputNames.data(),
-        &inputTensor,
-        numInputNodes,
-        outputNames.data(),
-        numOutputNodes
-    );
+    const yolos::TilePlan plan = yolos::planTiles(image, tiling, core.inputImageShape());
+    const size_t chunkSize = yolos::tileChunkSize(tiling.maxBatch, core.batchSize(), plan.views.size());
 
-    // Determine the resized image shape based on input tensor shape
-    cv::Size resizedImageShape(static_cast<int>(inputTensorShape[3]), static_cast<int>(inputTensorShape[2]));
+    // Per-tile detections, shifted back into image coordinates
+    std::vector<OrientedBoundingBox> obbs;
+    std::vector<float> scores;
+    std::vector<int> labels;
+    for (size_t begin = 0; begin < plan.views.size(); begin += chunkSize) {
+        const size_t end = std::min(plan.views.size(), begin + chunkSize);
+        const std::vector<cv::Mat> chunk(plan.views.begin() + begin, plan.views.begin() + end);
+        const std::vector<std::vector<Detection>> results = detectBatch(chunk, confThreshold, iouThreshold);
+
+        for (size_t t = 0; t < results.size(); ++t) {
+            const cv::Point origin = plan.rects[begin + t].tl();
+            for (const Detection &det : results[t]) {
+                OrientedBoundingBox obb = det.box;
+                obb.x += static_cast<float>(origin.x);
+                obb.y += static_cast<float>(origin.y);
+                obbs.push_back(obb);
+                scores.push_back(det.conf);
+                labels.push_back(det.classId);
+            }
+        }
+    }
 
-    std::vector<Detection> detections = postprocess(image.size(), resizedImageShape, outputTensors, confThreshold, iouThreshold, 100);
+    // Class-agnostic rotated NMS across tiles, as within one image
+    yolos::NMSOptions nmsOptions;
+    nmsOptions.scoreThreshold = confThreshold;
+    nmsOptions.iouThreshold = iouThreshold;
+    nmsOptions.agnostic = true;
+    std::vector<int> keep;
+    rotatedNms.run(obbs, scores, nullptr, nmsOptions, keep);
 
-    return detections; // Return the vector of detections
+    std::vector<Detection> detections;
+    detections.reserve(keep.size());
+    for (int idx : keep) {
+        detections.emplace_back(Detection{obbs[idx], scores[idx], labels[idx]});
+    }
+    return detections;
 }
-
@@ -41,6 +41,10 @@
 // Include debug and custom ScopedTimer tools for performance measurement
 #include "tools/Debug.hpp"
 #include "tools/ScopedTimer.hpp"
+#include "tools/YoloCore.hpp"
+#include "tools/NMS.hpp"
+#include "tools/DetectorOptions.hpp"
+#include "tools/Overlay.hpp"
 
 
 
@@ -175,232 +179,34 @@ namespace utils {
         return std::accumulate(vector.begin(), vector.end(), 1ull, std::multiplies<size_t>());
     }
 
-
-    /**
-     * @brief Resizes an image with letterboxing to maintain aspect ratio.
-     * 
-     * @param image Input image.
-     * @param outImage Output resized and padded image.
-     * @param newShape Desired output size.
-     * @param color Padding color (default is gray).
-     * @param auto_ Automatically adjust padding to be multiple of stride.
-     * @param scaleFill Whether to scale to fill the new shape without keeping aspect ratio.
-     * @param scaleUp Whether to allow scaling up of the image.
-     * @param stride Stride size for padding alignment.
-     */
-    inline void letterBox(const cv::Mat& image, cv::Mat& outImage,
-                        const cv::Size& newShape,
-                        const cv::Scalar& color = cv::Scalar(114, 114, 114),
-                        bool auto_ = true,
-                        bool scaleFill = false,
-                        bool scaleUp = true,
-                        int stride = 32) {
-        // Calculate the scaling ratio to fit the image within the new shape
-        float ratio = std::min(static_cast<float>(newShape.height) / image.rows,
-                            static_cast<float>(newShape.width) / image.cols);
-
-        // Prevent scaling up if not allowed
-        if (!scaleUp) {
-            ratio = std::min(ratio, 1.0f);
-        }
-
-        // Calculate new dimensions after scaling
-        int newUnpadW = static_cast<int>(std::round(image.cols * ratio));
-        int newUnpadH = static_cast<int>(std::round(image.rows * ratio));
-
-        // Calculate padding needed to reach the desired shape
-        int dw = newShape.width - newUnpadW;
-        int dh = newShape.height - newUnpadH;
-
-        if (auto_) {
-            // Ensure padding is a multiple of stride for model compatibility
-            dw = (dw % stride) / 2;
-            dh = (dh % stride) / 2;
-        } else if (scaleFill) {
-            // Scale to fill without maintaining aspect ratio
-            newUnpadW = newShape.width;
-            newUnpadH = newShape.height;
-            ratio = std::min(static_cast<float>(newShape.width) / image.cols,
-                            static_cast<float>(newShape.height) / image.rows);
-            dw = 0;
-            dh = 0;
-        } else {
-            // Evenly distribute padding on both sides
-            // Calculate separate padding for left/right and top/bottom to handle odd padding
-            int padLeft = dw / 2;
-            int padRight = dw - padLeft;
-            int padTop = dh / 2;
-            int padBottom = dh - padTop;
-
-            // Resize the image if the new dimensions differ
-            if (image.cols != newUnpadW || image.rows != newUnpadH) {
-                cv::resize(image, outImage, cv::Size(newUnpadW, newUnpadH), 0, 0, cv::INTER_LINEAR);
-            } else {
-                // Avoid unnecessary copying if dimensions are the same
-                outImage = image;
-            }
-
-            // Apply padding to reach the desired shape
-            cv::copyMakeBorder(outImage, outImage, padTop, padBottom, padLeft, padRight, cv::BORDER_CONSTANT, color);
-            return; // Exit early since padding is already applied
-        }
-
-        // Resize the image if the new dimensions differ
-        if (image.cols != newUnpadW || image.rows != newUnpadH) {
-            cv::resize(image, outImage, cv::Size(newUnpadW, newUnpadH), 0, 0, cv::INTER_LINEAR);
-        } else {
-            // Avoid unnecessary copying if dimensions are the same
-            outImage = image;
-        }
-
-        // Calculate separate padding for left/right and top/bottom to handle odd padding
-        int padLeft = dw / 2;
-        int padRight = dw - padLeft;
-        int padTop = dh / 2;
-        int padBottom = dh - padTop;
-
-        // Apply padding to reach the desired shape
-        cv::copyMakeBorder(outImage, outImage, padTop, padBottom, padLeft, padRight, cv::BORDER_CONSTANT, color);
-    }
-
-
+    
     /**
-     * @brief Performs Non-Maximum Suppression (NMS) on the bounding boxes.
-     * 
-     * @param boundingBoxes Vector of bounding boxes.
-     * @param scores Vector of confidence scores corresponding to each bounding box.
-     * @param scoreThreshold Confidence threshold to filter boxes.
-     * @param nmsThreshold IoU threshold for NMS.
-     * @param indices Output vector of indices that survive NMS.
+     * @brief Renderer of drawPoseEstimation() calls that do not pass their own.
      */
-    // Optimized Non-Maximum Suppression Function
-    void NMSBoxes(const std::vector<BoundingBox>& boundingBoxes,
-                const std::vector<float>& scores,
-                float scoreThreshold,
-                float nmsThreshold,
-                std::vector<int>& indices)
-    {
-        indices.clear();
-
-        const size_t numBoxes = boundingBoxes.size();
-        if (numBoxes == 0) {
-            DEBUG_PRINT("No bounding boxes to process in NMS");
-            return;
-        }
-
-        // Step 1: Filter out boxes with scores below the threshold
-        // and create a list of indices sorted by descending scores
-        std::vector<int> sortedIndices;
-        sortedIndices.reserve(numBoxes);
-        for (size_t i = 0; i < numBoxes; ++i) {
-            if (scores[i] >= scoreThreshold) {
-                sortedIndices.push_back(static_cast<int>(i));
-            }
-        }
-
-        // If no boxes remain after thresholding
-        if (sortedIndices.empty()) {
-            DEBUG_PRINT("No bounding boxes above score threshold");
-            return;
-        }
-
-        // Sort the indices based on scores in descending order
-        std::sort(sortedIndices.begin(), sortedIndices.end(),
-                [&scores](int idx1, int idx2) {
-                    return scores[idx1] > scores[idx2];
-                });
-
-        // Step 2: Precompute the areas of all boxes
-        std::vector<float> areas(numBoxes, 0.0f);
-        for (size_t i = 0; i < numBoxes; ++i) {
-            areas[i] = boundingBoxes[i].width * boundingBoxes[i].height;
-        }
-
-        // Step 3: Suppression mask to mark boxes that are suppressed
-        std::vector<bool> suppressed(numBoxes, false);
-
-        // Step 4: Iterate through the sorted list and suppress boxes with high IoU
-        for (size_t i = 0; i < sortedIndices.size(); ++i) {
-            int currentIdx = sortedIndices[i];
-            if (suppressed[currentIdx]) {
-                continue;
-            }
-
-            // Select the current box as a valid detection
-            indices.push_back(currentIdx);
-
-            const BoundingBox& currentBox = boundingBoxes[currentIdx];
-            const float x1_max = currentBox.x;
-            const float y1_max = currentBox.y;
-            const float x2_max = currentBox.x + currentBox.width;
-            const float y2_max = currentBox.y + currentBox.height;
-            const float area_current = areas[currentIdx];
-
-            // Compare IoU of the current box with the rest
-            for (size_t j = i + 1; j < sortedIndices.size(); ++j) {
-                int compareIdx = sortedIndices[j];
-                if (suppressed[compareIdx]) {
-                    continue;
-                }
-
-                const BoundingBox& compareBox = boundingBoxes[compareIdx];
-                const float x1 = std::max(x1_max, static_cast<float>(compareBox.x));
-                const float y1 = std::max(y1_max, static_cast<float>(compareBox.y));
-                const float x2 = std::min(x2_max, static_cast<float>(compareBox.x + compareBox.width));
-                const float y2 = std::min(y2_max, static_cast<float>(compareBox.y + compareBox.height));
-
-                const float interWidth = x2 - x1;
-                const float interHeight = y2 - y1;
-
-                if (interWidth <= 0 || interHeight <= 0) {
-                    continue;
-                }
-
-                const float intersection = interWidth * interHeight;
-                const float unionArea = area_current + areas[compareIdx] - intersection;
-                const float iou = (unionArea > 0.0f) ? (intersection / unionArea) : 0.0f;
-
-                if (iou > nmsThreshold) {
-                    suppressed[compareIdx] = true;
-                }
-            }
-        }
-
-        DEBUG_PRINT("NMS completed with " + std::to_string(indices.size()) + " indices remaining");
+    inline const yolos::OverlayRenderer &sharedPoseRenderer() {
+        static const yolos::OverlayRenderer renderer;
+        return renderer;
     }
 
-    
     /**
      * @brief Draws pose estimations including bounding boxes, keypoints, and skeleton
      * 
-     * @param image Input/output image
+     * @param image Input/output image (replaced by the preview if the renderer draws one)
      * @param detections Vector of pose detections
      * @param confidenceThreshold Minimum confidence to visualize
-     * @param kptRadius Radius of keypoint circles
      * @param kptThreshold Minimum keypoint confidence to draw
+     * @param renderer Renderer drawing the overlay (preview and headless options)
      */
     inline void drawPoseEstimation(cv::Mat &image,
         const std::vector<Detection> &detections,
         float confidenceThreshold = 0.5,
-        float kptThreshold = 0.5)
+        float kptThreshold = 0.5,
+        const yolos::OverlayRenderer &renderer = sharedPoseRenderer())
     {
-        // Calculate dynamic sizes based on image dimensions
-        const int min_dim = std::min(image.rows, image.cols);
-        const float scale_factor = min_dim / 1280.0f;  // Reference 1280px size
-    
-        // Dynamic sizing parameters
-        const int line_thickness = std::max(1, static_cast<int>(2 * scale_factor));
-        const int kpt_radius = std::max(2, static_cast<int>(4 * scale_factor));
-        const float font_scale = 0.5f * scale_factor;
-        const int text_thickness = std::max(1, static_cast<int>(1 * scale_factor));
-        const int text_offset = static_cast<int>(10 * scale_factor);
-    
-        // Define the Ultralytics pose palette (BGR format)
-        // Original RGB values: [255,128,0], [255,153,51], [255,178,102], [230,230,0], [255,153,255],
-        // [153,204,255], [255,102,255], [255,51,255], [102,178,255], [51,153,255],
-        // [255,153,153], [255,102,102], [255,51,51], [153,255,153], [102,255,102],
-        // [51,255,51], [0,255,0], [0,0,255], [255,0,0], [255,255,255]
-        // Converted to BGR:
+        // Ultralytics pose palette (BGR). Original RGB values: [255,128,0], [255,153,51], [255,178,102],
+        // [230,230,0], [255,153,255], [153,204,255], [255,102,255], [255,51,255], [102,178,255], [51,153,255],
+        // [255,153,153], [255,102,102], [255,51,51], [153,255,153], [102,255,102], [51,255,51], [0,255,0],
+        // [0,0,255], [255,0,0], [255,255,255]
         static const std::vector<cv::Scalar> pose_palette = {
             cv::Scalar(0,128,255),    // 0
             cv::Scalar(51,153,255),   // 1
@@ -423,62 +229,56 @@ namespace utils {
             cv::Scalar(0,0,255),      // 18
             cv::Scalar(255,255,255)   // 19
         };
-    
-        // Define per-keypoint color indices (for keypoints 0 to 16)
+
+        // Per-keypoint (0 to 16) and per-limb (one per POSE_SKELETON pair) palette indices
         static const std::vector<int> kpt_color_indices = {16,16,16,16,16,0,0,0,0,0,0,9,9,9,9,9,9};
-        // Define per-limb color indices for each skeleton connection.
-        // Make sure the number of entries here matches the number of pairs in POSE_SKELETON.
         static const std::vector<int> limb_color_indices = {9,9,9,9,7,7,7,0,0,0,0,0,16,16,16,16,16,16,16};
-    
-        // Loop through each detection
+
+        auto paletteStyle = []() {
+            yolos::OverlayStyle style;
+            for (int index : kpt_color_indices) style.keypointColors.push_back(pose_palette[index]);
+            for (int index : limb_color_indices) style.limbColors.push_back(pose_palette[index]);
+            style.skeleton = &POSE_SKELETON;
+            return style;
+        };
+        static const yolos::OverlayStyle paletteOnly = paletteStyle();
+
+        // Box outline as thick as the limbs (2 px at 1280)
+        yolos::OverlayStyle style = paletteOnly;
+        style.keypointThreshold = kptThreshold;
+        style.boxThickness = std::max(1, static_cast<int>(2 * std::min(image.rows, image.cols) / 1280.0f));
+
+        std::vector<yolos::OverlayItem> items;
+        items.reserve(detections.size());
         for (const auto& detection : detections) {
             if (detection.conf < confidenceThreshold)
                 continue;
-    
-            // Draw bounding box (optional – remove if you prefer only pose visualization)
-            const auto& box = detection.box;
-            cv::rectangle(image,
-                cv::Point(box.x, box.y),
-                cv::Point(box.x + box.width, box.y + box.height),
-                cv::Scalar(0, 255, 0), // You can change the box color if desired
-                line_thickness);
-    
-            // Prepare a vector to hold keypoint positions and validity flags.
-            const size_t numKpts = detection.keypoints.size();
-            std::vector<cv::Point> kpt_points(numKpts, cv::Point(-1, -1));
-            std::vector<bool> valid(numKpts, false);
-    
-            // Draw keypoints using the corresponding palette colors
-            for (size_t i = 0; i < numKpts; i++) {
-                if (detection.keypoints[i].confidence >= kptThreshold) {
-                    int x = std::round(detection.keypoints[i].x);
-                    int y = std::round(detection.keypoints[i].y);
-                    kpt_points[i] = cv::Point(x, y);
-                    valid[i] = true;
-                    int color_index = (i < kpt_color_indices.size()) ? kpt_color_indices[i] : 0;
-                    cv::circle(image, cv::Point(x, y), kpt_radius, pose_palette[color_index], -1, cv::LINE_AA);
-                }
-            }
-    
-            // Draw skeleton connections based on a predefined POSE_SKELETON (vector of pairs)
-            // Make sure that POSE_SKELETON is defined with 0-indexed keypoint indices.
-            for (size_t j = 0; j < POSE_SKELETON.size(); j++) {
-                auto [src, dst] = POSE_SKELETON[j];
-                if (src < numKpts && dst < numKpts && valid[src] && valid[dst]) {
-                    // Use the corresponding limb color from the palette
-                    int limb_color_index = (j < limb_color_indices.size()) ? limb_color_indices[j] : 0;
-                    cv::line(image, kpt_points[src], kpt_points[dst],
-                             pose_palette[limb_color_index],
-                             line_thickness, cv::LINE_AA);
-                }
+
+            yolos::OverlayItem item;
+            item.box = cv::Rect(detection.box.x, detection.box.y, detection.box.width, detection.box.height);
+            item.confidence = detection.conf;
+            item.color = cv::Scalar(0, 255, 0);
+            item.keypoints.reserve(detection.keypoints.size());
+            for (const KeyPoint &kp : detection.keypoints) {
+                item.keypoints.emplace_back(kp.x, kp.y, kp.confidence);
             }
-    
-            // (Optional) Add text labels such as confidence scores here if desired.
+            items.push_back(std::move(item));
         }
-    }  
+        renderer.render(image, items, style);
+    }
 }
 
 
+/**
+ * @brief YoloCore policy: letterboxed input, one [1, 56, num_detections] output.
+ */
+struct PoseTaskPolicy {
+    static constexpr yolos::InputTransform transform = yolos::InputTransform::Letterbox;
+    static constexpr size_t outputs = 1;
+    static constexpr const char *preprocessStage = "pose.preprocess";
+    static constexpr const char *preprocessBatchStage = "pose.preprocess_batch";
+};
+
 /**
  * @brief YOLO11POSEDetector class handles loading the YOLO model, preprocessing images, running inference, and postprocessing results.
  */
@@ -492,6 +292,15 @@ public:
      * @param useGPU Whether to use GPU for inference (default is false).
      */
     YOLO11POSEDetector(const std::string &modelPath, const std::string &labelsPath, bool useGPU = false);
+
+    /**
+     * @brief Constructor with explicit execution-provider and threading options.
+     *
+     * @param modelPath Path to the ONNX model file.
+     * @param labelsPath Path to the file containing class labels.
+     * @param options Execution providers (in order of preference) and threading.
+     */
+    YOLO11POSEDetector(const std::string &modelPath, const std::string &labelsPath, const yolos::DetectorOptions &options);
     
     /**
      * @brief Runs detection on the provided image.
@@ -502,6 +311,19 @@ public:
      * @return std::vector<Detection> Vector of detections.
      */
     std::vector<Detection> detect(const cv::Mat &image, float confThreshold = 0.4f, float iouThreshold = 0.5f);
+
+    /**
+     * @brief Runs pose estimation on a batch of images with a single session run per model batch.
+     *
+     * Dynamic-batch models consume the whole request in one run; fixed-batch models are fed in
+     * chunks of their exported batch size with the unused slots of the last chunk zero-filled.
+     *
+     * @param images Input images for detection.
+     * @param confThreshold Confidence threshold to filter detections (default is 0.4).
+     * @param iouThreshold IoU threshold for Non-Maximum Suppression (default is 0.5).
+     * @return std::vector<std::vector<Detection>> Detections for each input image, in input order.
+     */
+    std::vector<std::vector<Detection>> detectBatch(const std::vector<cv::Mat> &images, float confThreshold = 0.4f, float iouThreshold = 0.5f);
  
     /**
      * @brief Draws bounding boxes and keypoints (if available) on the provided image.
@@ -511,142 +333,66 @@ public:
      */
     void drawBoundingBox(cv::Mat &image, const std::vector<Detection> &detections) const;
 
-private:
-    Ort::Env env{nullptr};                         // ONNX Runtime environment
-    Ort::SessionOptions sessionOptions{nullptr};   // Session options for ONNX Runtime
-    Ort::Session session{nullptr};                 // ONNX Runtime session for running inference
-    bool isDynamicInputShape{};                    // Flag indicating if input shape is dynamic
-    cv::Size inputImageShape;                      // Expected input image shape for the model
-
-    // Vectors to hold allocated input and output node names
-    std::vector<Ort::AllocatedStringPtr> inputNodeNameAllocatedStrings;
-    std::vector<const char *> inputNames;
-    std::vector<Ort::AllocatedStringPtr> outputNodeNameAllocatedStrings;
-    std::vector<const char *> outputNames;
+    /**
+     * @brief Sets how drawBoundingBox() draws: on a downscaled preview that replaces the image,
+     *        or not at all (headless).
+     */
+    void setRenderOptions(const yolos::RenderOptions &options) { overlay.setOptions(options); }
 
-    size_t numInputNodes, numOutputNodes;          // Number of input and output nodes in the model
+    /**
+     * @brief Gets the numeric precision of the model: "fp32", "fp16" or "int8".
+     */
+    const std::string &getPrecision() const { return core.precision(); }
 
     /**
-     * @brief Preprocesses the input image for model inference.
-     * 
-     * @param image Input image.
-     * @param blob Reference to pointer where preprocessed data will be stored.
-     * @param inputTensorShape Reference to vector representing input tensor shape.
-     * @return cv::Mat Resized image after preprocessing.
+     * @brief Runs dummy inferences so that lazy initialization (memory arenas, kernel and
+     *        algorithm selection, TensorRT engine builds) happens before the first real frame.
+     *
+     * @param imageSizes Frame sizes to expect; they matter for dynamic-shape models, whose
+     *                   letterbox follows the aspect ratio (default: every input bucket, or
+     *                   the model input size).
+     * @param iterations Runs per size.
      */
-    cv::Mat preprocess(const cv::Mat &image, float *&blob, std::vector<int64_t> &inputTensorShape);
+    void warmup(const std::vector<cv::Size> &imageSizes = {}, int iterations = 2) {
+        const std::vector<cv::Size> sizes = imageSizes.empty() ? core.warmupSizes() : imageSizes;
+        for (const cv::Size &size : sizes) {
+            const cv::Mat frame(size, CV_8UC3, cv::Scalar(114, 114, 114));
+            for (int i = 0; i < iterations; ++i) {
+                detect(frame);
+            }
+        }
+    }
+
+private:
+    yolos::YoloCore<PoseTaskPolicy> core;          // Session, bound tensors, preprocessing and batching
+    yolos::OverlayRenderer overlay;                // Draws the overlays (preview, headless)
+    yolos::NMSEngine nmsEngine;                    // Bucketed NMS with reusable buffers
     
     /**
      * @brief Postprocesses the model output to extract detections.
      * 
      * @param originalImageSize Size of the original input image.
      * @param resizedImageShape Size of the image after preprocessing.
-     * @param outputTensors Vector of output tensors from the model.
+     * @param rawOutput Raw output data of a single image.
+     * @param outputShape Output shape of a single image ([1, 56, num_detections]).
      * @param confThreshold Confidence threshold to filter detections.
      * @param iouThreshold IoU threshold for Non-Maximum Suppression.
      * @return std::vector<Detection> Vector of detections.
      */
     std::vector<Detection> postprocess(const cv::Size &originalImageSize, const cv::Size &resizedImageShape,
-                                      const std::vector<Ort::Value> &outputTensors,
+                                      const float *rawOutput, const std::vector<int64_t> &outputShape,
                                       float confThreshold, float iouThreshold);
     
 };
 
 
 // Implementation of YOLO11POSEDetector constructor
-YOLO11POSEDetector::YOLO11POSEDetector(const std::string &modelPath, const std::string &labelsPath, bool useGPU) {
-    // Initialize ONNX Runtime environment with warning level
-    env = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "ONNX_DETECTION");
-    sessionOptions = Ort::SessionOptions();
-
-    // Set number of intra-op threads for parallelism
-    sessionOptions.SetIntraOpNumThreads(std::min(6, static_cast<int>(std::thread::hardware_concurrency())));
-    sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-
-    // Retrieve available execution providers (e.g., CPU, CUDA)
-    std::vector<std::string> availableProviders = Ort::GetAvailableProviders();
-    auto cudaAvailable = std::find(availableProviders.begin(), availableProviders.end(), "CUDAExecutionProvider");
-    OrtCUDAProviderOptions cudaOption;
-
-    // Configure session options based on whether GPU is to be used and available
-    if (useGPU && cudaAvailable != availableProviders.end()) {
-        std::cout << "Inference device: GPU" << std::endl;
-        sessionOptions.AppendExecutionProvider_CUDA(cudaOption); // Append CUDA execution provider
-    } else {
-        if (useGPU) {
-            std::cout << "GPU is not supported by your ONNXRuntime build. Fallback to CPU." << std::endl;
-        }
-        std::cout << "Inference device: CPU" << std::endl;
-    }
-
-    // Load the ONNX model into the session
-#ifdef _WIN32
-    std::wstring w_modelPath(modelPath.begin(), modelPath.end());
-    session = Ort::Session(env, w_modelPath.c_str(), sessionOptions);
-#else
-    session = Ort::Session(env, modelPath.c_str(), sessionOptions);
-#endif
-
-    Ort::AllocatorWithDefaultOptions allocator;
-
-    // Retrieve input tensor shape information
-    Ort::TypeInfo inputTypeInfo = session.GetInputTypeInfo(0);
-    std::vector<int64_t> inputTensorShapeVec = inputTypeInfo.GetTensorTypeAndShapeInfo().GetShape();
-    isDynamicInputShape = (inputTensorShapeVec.size() >= 4) && (inputTensorShapeVec[2] == -1 && inputTensorShapeVec[3] == -1); // Check for dynamic dimensions
-
-    // Allocate and store input node names
-    auto input_name = session.GetInputNameAllocated(0, allocator);
-    inputNodeNameAllocatedStrings.push_back(std::move(input_name));
-    inputNames.push_back(inputNodeNameAllocatedStrings.back().get());
-
-    // Allocate and store output node names
-    auto output_name = session.GetOutputNameAllocated(0, allocator);
-    outputNodeNameAllocatedStrings.push_back(std::move(output_name));
-    outputNames.push_back(outputNodeNameAllocatedStrings.back().get());
-
-    // Set the expected input image shape based on the model's input tensor
-    if (inputTensorShapeVec.size() >= 4) {
-        inputImageShape = cv::Size(static_cast<int>(inputTensorShapeVec[3]), static_cast<int>(inputTensorShapeVec[2]));
-    } else {
-        throw std::runtime_error("Invalid input tensor shape.");
-    }
+YOLO11POSEDetector::YOLO11POSEDetector(const std::string &modelPath, const std::string &labelsPath, bool useGPU)
+    : YOLO11POSEDetector(modelPath, labelsPath, yolos::DetectorOptions::fromUseGPU(useGPU)) {}
 
-    // Get the number of input and output nodes
-    numInputNodes = session.GetInputCount();
-    numOutputNodes = session.GetOutputCount();
-
-
-    std::cout << "Model loaded successfully with " << numInputNodes << " input nodes and " << numOutputNodes << " output nodes." << std::endl;
-}
-
-// Preprocess function implementation
-cv::Mat YOLO11POSEDetector::preprocess(const cv::Mat &image, float *&blob, std::vector<int64_t> &inputTensorShape) {
-    ScopedTimer timer("preprocessing");
-
-    cv::Mat resizedImage;
-    // Resize and pad the image using letterBox utility
-    utils::letterBox(image, resizedImage, inputImageShape, cv::Scalar(114, 114, 114), isDynamicInputShape, false, true, 32);
-
-    // Update input tensor shape based on resized image dimensions
-    inputTensorShape[2] = resizedImage.rows;
-    inputTensorShape[3] = resizedImage.cols;
-
-    // Convert image to float and normalize to [0, 1]
-    resizedImage.convertTo(resizedImage, CV_32FC3, 1 / 255.0f);
-
-    // Allocate memory for the image blob in CHW format
-    blob = new float[resizedImage.cols * resizedImage.rows * resizedImage.channels()];
-
-    // Split the image into separate channels and store in the blob
-    std::vector<cv::Mat> chw(resizedImage.channels());
-    for (int i = 0; i < resizedImage.channels(); ++i) {
-        chw[i] = cv::Mat(resizedImage.rows, resizedImage.cols, CV_32FC1, blob + i * resizedImage.cols * resizedImage.rows);
-    }
-    cv::split(resizedImage, chw); // Split channels into the blob
-
-    DEBUG_PRINT("Preprocessing completed")
-
-    return resizedImage;
+YOLO11POSEDetector::YOLO11POSEDetector(const std::string &modelPath, const std::string &labelsPath, const yolos::DetectorOptions &options)
+    : core(modelPath, options) {
+    std::cout << "Model loaded successfully with " << core.numInputNodes() << " input nodes and " << core.numOutputNodes() << " output nodes." << std::endl;
 }
 
 
@@ -659,7 +405,7 @@ cv::Mat YOLO11POSEDetector::preprocess(const cv::Mat &image, float *&blob, std::
  * @note Uses `utils::drawPoseEstimation()` for visualization.
  */
 void YOLO11POSEDetector::drawBoundingBox(cv::Mat &image, const std::vector<Detection> &detections) const {
-    utils::drawPoseEstimation(image, detections);
+    utils::drawPoseEstimation(image, detections, 0.5f, 0.5f, overlay);
 }
 
 
@@ -668,7 +414,8 @@ void YOLO11POSEDetector::drawBoundingBox(cv::Mat &image, const std::vector<Detec
  *
  * @param originalImageSize The original size of the input image before resizing.
  * @param resizedImageShape The resized image dimensions used during inference.
- * @param outputTensors The output tensors obtained from the model inference.
+ * @param rawOutput Raw output data of a single image of the batch.
+ * @param outputShape Output shape of a single image ([1, 56, num_detections]).
  * @param confThreshold Confidence threshold to filter weak detections (default is 0.4).
  * @param iouThreshold IoU threshold for Non-Maximum Suppression (NMS) to remove redundant detections (default is 0.5).
  * @return std::vector<Detection> A vector of final detections after processing.
@@ -679,15 +426,13 @@ void YOLO11POSEDetector::drawBoundingBox(cv::Mat &image, const std::vector<Detec
 std::vector<Detection> YOLO11POSEDetector::postprocess(
     const cv::Size &originalImageSize,
     const cv::Size &resizedImageShape,
-    const std::vector<Ort::Value> &outputTensors,
+    const float *rawOutput,
+    const std::vector<int64_t> &outputShape,
     float confThreshold,
     float iouThreshold
 ) {
-    ScopedTimer timer("postprocessing");
+    ScopedTimer timer("pose.postprocess");
     std::vector<Detection> detections;
-    
-    const float* rawOutput = outputTensors[0].GetTensorData<float>();
-    const std::vector<int64_t> outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
 
     // Validate output dimensions
     const size_t numFeatures = outputShape[1];
@@ -757,9 +502,13 @@ std::vector<Detection> YOLO11POSEDetector::postprocess(
         allKeypoints.emplace_back(keypoints);
     }
 
-    // Apply Non-Maximum Suppression
+    // Apply Non-Maximum Suppression (single class, so class-agnostic)
+    yolos::NMSOptions nmsOptions;
+    nmsOptions.scoreThreshold = confThreshold;
+    nmsOptions.iouThreshold = iouThreshold;
+    nmsOptions.agnostic = true;
     std::vector<int> indices;
-    utils::NMSBoxes(boxes, confidences, confThreshold, iouThreshold, indices);
+    nmsEngine.run(boxes, confidences, nullptr, nmsOptions, indices);
 
     // Create final detections
     for (int idx : indices) {
@@ -780,50 +529,19 @@ std::vector<Detection> YOLO11POSEDetector::postprocess(
 
 // Detect function implementation
 std::vector<Detection> YOLO11POSEDetector::detect(const cv::Mat& image, float confThreshold, float iouThreshold) {
-    ScopedTimer timer("Overall detection");
-
-    float* blobPtr = nullptr; // Pointer to hold preprocessed image data
-    // Define the shape of the input tensor (batch size, channels, height, width)
-    std::vector<int64_t> inputTensorShape = {1, 3, inputImageShape.height, inputImageShape.width};
-
-    // Preprocess the image and obtain a pointer to the blob
-    cv::Mat preprocessedImage = preprocess(image, blobPtr, inputTensorShape);
-
-    // Compute the total number of elements in the input tensor
-    size_t inputTensorSize = utils::vectorProduct(inputTensorShape);
-
-    // Create a vector from the blob data for ONNX Runtime input
-    std::vector<float> inputTensorValues(blobPtr, blobPtr + inputTensorSize);
+    ScopedTimer timer("pose.detect");
 
-    delete[] blobPtr; // Free the allocated memory for the blob
-
-    // Create an Ort memory info object (can be cached if used repeatedly)
-    static Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-
-    // Create input tensor object using the preprocessed data
-    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-        memoryInfo,
-        inputTensorValues.data(),
-        inputTensorSize,
-        inputTensorShape.data(),
-        inputTensorShape.size()
-    );
-
-    // Run the inference session with the input tensor and retrieve output tensors
-    std::vector<Ort::Value> outputTensors = session.Run(
-        Ort::RunOptions{nullptr},
-        inputNames.data(),
-        &inputTensor,
-        numInputNodes,
-        outputNames.data(),
-        numOutputNodes
-    );
-
-    // Determine the resized image shape based on input tensor shape
-    cv::Size resizedImageShape(static_cast<int>(inputTensorShape[3]), static_cast<int>(inputTensorShape[2]));
+    return core.run(image, [&](const cv::Size &originalSize, const cv::Size &resizedShape, const yolos::ImageOutputs &outputs) {
+        return postprocess(originalSize, resizedShape, outputs.data(), outputs.shape(), confThreshold, iouThreshold);
+    });
+}
 
-    // Postprocess the output tensors to obtain detections
-    std::vector<Detection> detections = postprocess(image.size(), resizedImageShape, outputTensors, confThreshold, iouThreshold);
+// Batch detect function implementation
+std::vector<std::vector<Detection>> YOLO11POSEDetector::detectBatch(const std::vector<cv::Mat> &images, float confThreshold, float iouThreshold) {
+    ScopedTimer timer("pose.detect_batch");
 
-    return detections; // Return the vector of detections
-}
\ No newline at end of file
+    // Every image is decoded from its [1, num_features, num_detections] slice of the batched output
+    return core.runBatch(images, [&](const cv::Size &originalSize, const cv::Size &resizedShape, const yolos::ImageOutputs &outputs) {
+        return postprocess(originalSize, resizedShape, outputs.data(), outputs.shape(), confThreshold, iouThreshold);
+    });
+}
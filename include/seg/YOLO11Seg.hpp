@@ -30,8 +30,15 @@
 #include <unordered_map>
 #include <vector>
 
+#include "tools/ScopedTimer.hpp"
+#include "tools/YoloCore.hpp"
+#include "tools/NMS.hpp"
+#include "tools/InstanceMask.hpp"
+#include "tools/Overlay.hpp"
+#include "tools/DetectorOptions.hpp"
+
 // ============================================================================
-// Debug/Timer Utilities (Optional)
+// Debug Utilities (Optional)
 // ============================================================================
 #ifdef DEBUG
     #define DEBUG_PRINT(msg) std::cout << "[DEBUG] " << msg << std::endl
@@ -39,23 +46,6 @@
     #define DEBUG_PRINT(msg) /* no-op */
 #endif
 
-// Simple scoped timer (optional)
-class ScopedTimer {
-public:
-    explicit ScopedTimer(const std::string &name_)
-        : name(name_), start(std::chrono::high_resolution_clock::now()) {}
-    ~ScopedTimer() {
-#ifdef DEBUG
-        auto end = std::chrono::high_resolution_clock::now();
-        double ms = std::chrono::duration<double, std::milli>(end - start).count();
-        std::cout << "[TIMER] " << name << ": " << ms << " ms" << std::endl;
-#endif
-    }
-private:
-    std::string name;
-    std::chrono::time_point<std::chrono::high_resolution_clock> start;
-};
-
 // ============================================================================
 // Constants / Thresholds
 // ============================================================================
@@ -93,7 +83,27 @@ struct Segmentation {
     BoundingBox box;
     float       conf{0.f};
     int         classId{0};
-    cv::Mat     mask;  // Single-channel (8UC1) mask in full resolution
+    cv::Mat     mask;        // Single-channel (8UC1, 0/255) mask covering box clipped to the image
+    cv::Point   maskOffset;  // Position of the mask's top-left pixel in the original image
+    yolos::DeferredMask deferredMask;  // Set instead of mask when masks are deferred
+
+    // Renders a deferred mask into mask (no-op if it is already there)
+    void materializeMask() {
+        if (mask.empty() && !deferredMask.empty()) {
+            mask = deferredMask.render();
+        }
+    }
+
+    // The mask pasted into a zero image of the original size
+    cv::Mat fullMask(const cv::Size &imageSize) const {
+        cv::Mat full = cv::Mat::zeros(imageSize, CV_8U);
+        const cv::Mat local = mask.empty() ? deferredMask.render() : mask;
+        const cv::Rect roi = cv::Rect(maskOffset, local.size()) & cv::Rect(0, 0, imageSize.width, imageSize.height);
+        if (roi.area() > 0) {
+            local(roi - maskOffset).copyTo(full(roi));
+        }
+        return full;
+    }
 };
 
 // ============================================================================
@@ -128,47 +138,6 @@ namespace utils {
         return std::accumulate(shape.begin(), shape.end(), 1ull, std::multiplies<size_t>());
     }
 
-    inline void letterBox(const cv::Mat &image,
-                          cv::Mat &outImage,
-                          const cv::Size &newShape,
-                          const cv::Scalar &color     = cv::Scalar(114, 114, 114),
-                          bool auto_       = true,
-                          bool scaleFill   = false,
-                          bool scaleUp     = true,
-                          int stride       = 32) {
-        float r = std::min((float)newShape.height / (float)image.rows,
-                           (float)newShape.width  / (float)image.cols);
-        if (!scaleUp) {
-            r = std::min(r, 1.0f);
-        }
-
-        int newW = static_cast<int>(std::round(image.cols * r));
-        int newH = static_cast<int>(std::round(image.rows * r));
-
-        int dw = newShape.width  - newW;
-        int dh = newShape.height - newH;
-
-        if (auto_) {
-            dw = dw % stride;
-            dh = dh % stride;
-        }
-        else if (scaleFill) {
-            newW = newShape.width;
-            newH = newShape.height;
-            dw = 0;
-            dh = 0;
-        }
-
-        cv::Mat resized;
-        cv::resize(image, resized, cv::Size(newW, newH), 0, 0, cv::INTER_LINEAR);
-
-        int top = dh / 2;
-        int bottom = dh - top;
-        int left = dw / 2;
-        int right = dw - left;
-        cv::copyMakeBorder(resized, outImage, top, bottom, left, right, cv::BORDER_CONSTANT, color);
-    }
-
     inline BoundingBox scaleCoords(const cv::Size &letterboxShape,
                                    const BoundingBox &coords,
                                    const cv::Size &originalShape,
@@ -225,83 +194,42 @@ namespace utils {
         dst = 1.0 / (1.0 + dst);
         return dst;
     }
-        inline void NMSBoxes(const std::vector<BoundingBox> &boxes,
-                         const std::vector<float> &scores,
-                         float scoreThreshold,
-                         float nmsThreshold,
-                         std::vector<int> &indices) {
-        indices.clear();
-        if (boxes.empty()) {
-            return;
-        }
-
-        std::vector<int> order;
-        order.reserve(boxes.size());
-        for (size_t i = 0; i < boxes.size(); ++i) {
-            if (scores[i] >= scoreThreshold) {
-                order.push_back((int)i);
-            }
-        }
-        if (order.empty()) return;
-
-        std::sort(order.begin(), order.end(),
-                  [&scores](int a, int b) {
-                      return scores[a] > scores[b];
-                  });
-
-        std::vector<float> areas(boxes.size());
-        for (size_t i = 0; i < boxes.size(); ++i) {
-            areas[i] = (float)(boxes[i].width * boxes[i].height);
-        }
-
-        std::vector<bool> suppressed(boxes.size(), false);
-        for (size_t i = 0; i < order.size(); ++i) {
-            int idx = order[i];
-            if (suppressed[idx]) continue;
-
-            indices.push_back(idx);
-
-            for (size_t j = i + 1; j < order.size(); ++j) {
-                int idx2 = order[j];
-                if (suppressed[idx2]) continue;
-
-                const BoundingBox &a = boxes[idx];
-                const BoundingBox &b = boxes[idx2];
-                int interX1 = std::max(a.x, b.x);
-                int interY1 = std::max(a.y, b.y);
-                int interX2 = std::min(a.x + a.width,  b.x + b.width);
-                int interY2 = std::min(a.y + a.height, b.y + b.height);
-
-                int w = interX2 - interX1;
-                int h = interY2 - interY1;
-                if (w > 0 && h > 0) {
-                    float interArea = (float)(w * h);
-                    float unionArea = areas[idx] + areas[idx2] - interArea;
-                    float iou = (unionArea > 0.f)? (interArea / unionArea) : 0.f;
-                    if (iou > nmsThreshold) {
-                        suppressed[idx2] = true;
-                    }
-                }
-            }
-        }
-    }
 
 } // namespace utils
 
 // ============================================================================
 // YOLOv11SegDetector Class
 // ============================================================================
+
+// YoloCore policy: letterboxed input, detections [1, 4 + nc + 32, N] and prototypes [1, 32, maskH, maskW]
+struct SegmentationTaskPolicy {
+    static constexpr yolos::InputTransform transform = yolos::InputTransform::Letterbox;
+    static constexpr size_t outputs = 2;
+    static constexpr const char *preprocessStage = "segmentation.preprocess";
+    static constexpr const char *preprocessBatchStage = "segmentation.preprocess_batch";
+};
+
 class YOLOv11SegDetector {
 public:
     YOLOv11SegDetector(const std::string &modelPath,
                       const std::string &labelsPath,
                       bool useGPU = false);
 
+    // Explicit execution providers (in order of preference) and threading
+    YOLOv11SegDetector(const std::string &modelPath,
+                      const std::string &labelsPath,
+                      const yolos::DetectorOptions &options);
+
     // Main API
     std::vector<Segmentation> segment(const cv::Mat &image,
                                       float confThreshold = CONFIDENCE_THRESHOLD,
                                       float iouThreshold  = IOU_THRESHOLD);
 
+    // Batched API: one session run per model batch, results in input order
+    std::vector<std::vector<Segmentation>> segmentBatch(const std::vector<cv::Mat> &images,
+                                                        float confThreshold = CONFIDENCE_THRESHOLD,
+                                                        float iouThreshold  = IOU_THRESHOLD);
+
     // Draw results
     void drawSegmentationsAndBoxes(cv::Mat &image,
                            const std::vector<Segmentation> &results,
@@ -310,168 +238,97 @@ public:
     void drawSegmentations(cv::Mat &image,
                            const std::vector<Segmentation> &results,
                            float maskAlpha = 0.5f) const;
+
+    // Draw on a downscaled preview that replaces the image, or not at all (headless)
+    void setRenderOptions(const yolos::RenderOptions &options) { overlay.setOptions(options); }
     // Accessors
     const std::vector<std::string> &getClassNames()  const { return classNames;  }
     const std::vector<cv::Scalar>  &getClassColors() const { return classColors; }
+    const std::string              &getPrecision()   const { return core.precision(); }
+
+    // NMS mode and caps; the thresholds still come from the segment() arguments
+    void setNMSOptions(const yolos::NMSOptions &options) { nmsOptions = options; }
+
+    // Defer mask rendering: results carry a deferredMask and an empty mask until
+    // Segmentation::materializeMask() (or drawing) needs it
+    void setDeferredMasks(bool deferred) { deferMasks = deferred; }
+
+    // Dummy inferences at the expected frame sizes (default: every input bucket, or the model input size), so that
+    // lazy initialization happens before the first real frame
+    void warmup(const std::vector<cv::Size> &imageSizes = {}, int iterations = 2) {
+        const std::vector<cv::Size> sizes = imageSizes.empty() ? core.warmupSizes() : imageSizes;
+        for (const cv::Size &size : sizes) {
+            const cv::Mat frame(size, CV_8UC3, cv::Scalar(114, 114, 114));
+            for (int i = 0; i < iterations; ++i) {
+                segment(frame);
+            }
+        }
+    }
 
 private:
-    Ort::Env           env;
-    Ort::SessionOptions sessionOptions;
-    Ort::Session       session{nullptr};
-
-    bool     isDynamicInputShape{false};
-    cv::Size inputImageShape; 
-
-    std::vector<Ort::AllocatedStringPtr> inputNameAllocs;
-    std::vector<const char*>             inputNames;
-    std::vector<Ort::AllocatedStringPtr> outputNameAllocs;
-    std::vector<const char*>             outputNames;
-
-    size_t numInputNodes  = 0;
-    size_t numOutputNodes = 0;
+    yolos::YoloCore<SegmentationTaskPolicy> core;  // Session, bound tensors, preprocessing and batching
+    yolos::NMSEngine nmsEngine;              // Bucketed NMS with reusable buffers
+    yolos::NMSOptions nmsOptions;            // Per-class by default, no caps
+    yolos::InstanceMaskRenderer maskRenderer;  // Box-local mask assembly
+    bool deferMasks{false};                  // Leave mask rendering to the caller
 
     std::vector<std::string> classNames;
     std::vector<cv::Scalar>  classColors;
+    yolos::OverlayRenderer   overlay;        // Draws the overlays (ROI-only blending, label cache, preview, headless)
 
     // Helpers
-    cv::Mat preprocess(const cv::Mat &image,
-                       float *&blobPtr,
-                       std::vector<int64_t> &inputTensorShape);
-
+    // output0/output1 point at a single image's slice of the batched outputs
     std::vector<Segmentation> postprocess(const cv::Size &origSize,
                                           const cv::Size &letterboxSize,
-                                          const std::vector<Ort::Value> &outputs,
+                                          const float *output0_ptr,
+                                          const std::vector<int64_t> &shape0,
+                                          const float *output1_ptr,
+                                          const std::vector<int64_t> &shape1,
                                           float confThreshold,
                                           float iouThreshold);
+    // Drawable instances above CONFIDENCE_THRESHOLD
+    std::vector<yolos::OverlayItem> overlayItems(const std::vector<Segmentation> &results, bool labels) const;
 };
 
 inline YOLOv11SegDetector::YOLOv11SegDetector(const std::string &modelPath,
                                             const std::string &labelsPath,
                                             bool useGPU)
-    : env(ORT_LOGGING_LEVEL_WARNING, "YOLOv11Seg") 
-{
-    ScopedTimer timer("YOLOv11SegDetector Constructor");
-
-    sessionOptions.SetIntraOpNumThreads(std::min(6, static_cast<int>(std::thread::hardware_concurrency())));
-    sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-
-    std::vector<std::string> providers = Ort::GetAvailableProviders();
-    if (useGPU && std::find(providers.begin(), providers.end(), "CUDAExecutionProvider") != providers.end()) {
-        OrtCUDAProviderOptions cudaOptions;
-        sessionOptions.AppendExecutionProvider_CUDA(cudaOptions);
-        std::cout << "[INFO] Using GPU (CUDA) for YOLOv11 Seg inference.\n";
-    } else {
-        std::cout << "[INFO] Using CPU for YOLOv11 Seg inference.\n";
-    }
-
-#ifdef _WIN32
-    std::wstring w_modelPath(modelPath.begin(), modelPath.end());
-    session = Ort::Session(env, w_modelPath.c_str(), sessionOptions);
-#else
-    session = Ort::Session(env, modelPath.c_str(), sessionOptions);
-#endif
-
-    numInputNodes  = session.GetInputCount();
-    numOutputNodes = session.GetOutputCount();
-
-    Ort::AllocatorWithDefaultOptions allocator;
-
-    // Input
-    {
-        auto inNameAlloc = session.GetInputNameAllocated(0, allocator);
-        inputNameAllocs.emplace_back(std::move(inNameAlloc));
-        inputNames.push_back(inputNameAllocs.back().get());
-
-        auto inTypeInfo = session.GetInputTypeInfo(0);
-        auto inShape    = inTypeInfo.GetTensorTypeAndShapeInfo().GetShape();
-
-        if (inShape.size() == 4) {
-            if (inShape[2] == -1 || inShape[3] == -1) {
-                isDynamicInputShape = true;
-                inputImageShape = cv::Size(640, 640); // Fallback if dynamic
-            } else {
-                inputImageShape = cv::Size(static_cast<int>(inShape[3]), static_cast<int>(inShape[2]));
-            }
-        } else {
-            throw std::runtime_error("Model input is not 4D! Expect [N, C, H, W].");
-        }
-    }
+    : YOLOv11SegDetector(modelPath, labelsPath, yolos::DetectorOptions::fromUseGPU(useGPU)) {}
 
+inline YOLOv11SegDetector::YOLOv11SegDetector(const std::string &modelPath,
+                                            const std::string &labelsPath,
+                                            const yolos::DetectorOptions &options)
+    : core(modelPath, options)
+{
     // Outputs
-    if (numOutputNodes != 2) {
+    if (core.numOutputNodes() != 2) {
         throw std::runtime_error("Expected exactly 2 output nodes: output0 and output1.");
     }
 
-    for (size_t i = 0; i < numOutputNodes; ++i) {
-        auto outNameAlloc = session.GetOutputNameAllocated(i, allocator);
-        outputNameAllocs.emplace_back(std::move(outNameAlloc));
-        outputNames.push_back(outputNameAllocs.back().get());
-    }
-
     classNames  = utils::getClassNames(labelsPath);
     classColors = utils::generateColors(classNames);
 
-    std::cout << "[INFO] YOLOv11Seg loaded: " << modelPath << std::endl
-              << "      Input shape: " << inputImageShape 
-              << (isDynamicInputShape ? " (dynamic)" : "") << std::endl
-              << "      #Outputs   : " << numOutputNodes << std::endl
+    std::cout << "[INFO] Segmentation model loaded: " << modelPath << std::endl
+              << "      Input shape: " << core.inputImageShape()
+              << (core.isDynamicInputShape() ? " (dynamic)" : "") << std::endl
+              << "      #Outputs   : " << core.numOutputNodes() << std::endl
               << "      #Classes   : " << classNames.size() << std::endl;
 }
 
-inline cv::Mat YOLOv11SegDetector::preprocess(const cv::Mat &image,
-                                             float *&blobPtr,
-                                             std::vector<int64_t> &inputTensorShape) 
-{
-    ScopedTimer timer("Preprocess");
-
-    cv::Mat letterboxImage;
-    utils::letterBox(image, letterboxImage, inputImageShape,
-                     cv::Scalar(114,114,114), /*auto_=*/isDynamicInputShape,
-                     /*scaleFill=*/false, /*scaleUp=*/true, /*stride=*/32);
-
-    // Update if dynamic
-    inputTensorShape[2] = static_cast<int64_t>(letterboxImage.rows);
-    inputTensorShape[3] = static_cast<int64_t>(letterboxImage.cols);
-
-    letterboxImage.convertTo(letterboxImage, CV_32FC3, 1.0f/255.0f);
-
-    size_t size = static_cast<size_t>(letterboxImage.rows) * static_cast<size_t>(letterboxImage.cols) * 3;
-    blobPtr = new float[size];
-
-    std::vector<cv::Mat> channels(3);
-    for (int c = 0; c < 3; ++c) {
-        channels[c] = cv::Mat(letterboxImage.rows, letterboxImage.cols, CV_32FC1,
-                              blobPtr + c * (letterboxImage.rows * letterboxImage.cols));
-    }
-    cv::split(letterboxImage, channels);
-
-    return letterboxImage;
-}
-
 std::vector<Segmentation> YOLOv11SegDetector::postprocess(
     const cv::Size &origSize,
     const cv::Size &letterboxSize,
-    const std::vector<Ort::Value> &outputs,
+    const float *output0_ptr,
+    const std::vector<int64_t> &shape0, // [1, 116, num_detections]
+    const float *output1_ptr,
+    const std::vector<int64_t> &shape1, // [1, 32, maskH, maskW]
     float confThreshold,
     float iouThreshold) 
 {
-    ScopedTimer timer("PostprocessSeg"); 
+    ScopedTimer timer("segmentation.postprocess"); 
 
     std::vector<Segmentation> results;
 
-    // Validate outputs size
-    if (outputs.size() < 2) {
-        throw std::runtime_error("Insufficient outputs from the model. Expected at least 2 outputs.");
-    }
-
-    // Extract outputs
-    const float* output0_ptr = outputs[0].GetTensorData<float>();
-    const float* output1_ptr = outputs[1].GetTensorData<float>();
-
-    // Get shapes
-    auto shape0 = outputs[0].GetTensorTypeAndShapeInfo().GetShape(); // [1, 116, num_detections]
-    auto shape1 = outputs[1].GetTensorTypeAndShapeInfo().GetShape(); // [1, 32, maskH, maskW]
-
     if (shape1.size() != 4 || shape1[0] != 1 || shape1[1] != 32)
         throw std::runtime_error("Unexpected output1 shape. Expected [1, 32, maskH, maskW].");
 
@@ -501,25 +358,15 @@ std::vector<Segmentation> YOLOv11SegDetector::postprocess(
     constexpr int CLASS_CONF_OFFSET = 4;
     const int MASK_COEFF_OFFSET = numClasses + CLASS_CONF_OFFSET;
 
-    // 1. Process prototype masks
-    // Store all prototype masks in a vector for easy access
-    std::vector<cv::Mat> prototypeMasks;
-    prototypeMasks.reserve(32);
-    for (int m = 0; m < 32; ++m) {
-        // Each mask is maskH x maskW
-        cv::Mat proto(maskH, maskW, CV_32F, const_cast<float*>(output1_ptr + m * maskH * maskW));
-        prototypeMasks.emplace_back(proto.clone()); // Clone to ensure data integrity
-    }
-
-    // 2. Process detections
+    // 1. Process detections (prototypes are only read for the kept boxes)
     std::vector<BoundingBox> boxes;
     boxes.reserve(numBoxes);
     std::vector<float> confidences;
     confidences.reserve(numBoxes);
     std::vector<int> classIds;
     classIds.reserve(numBoxes);
-    std::vector<std::vector<float>> maskCoefficientsList;
-    maskCoefficientsList.reserve(numBoxes);
+    std::vector<int> anchorIndices;
+    anchorIndices.reserve(numBoxes);
 
     for (int i = 0; i < numBoxes; ++i) {
         // Extract box coordinates
@@ -553,13 +400,7 @@ std::vector<Segmentation> YOLOv11SegDetector::postprocess(
         boxes.push_back(box);
         confidences.push_back(maxConf);
         classIds.push_back(classId);
-
-        // Store mask coefficients
-        std::vector<float> maskCoeffs(32);
-        for (int m = 0; m < 32; ++m) {
-            maskCoeffs[m] = output0_ptr[(MASK_COEFF_OFFSET + m) * numBoxes + i];
-        }
-        maskCoefficientsList.emplace_back(std::move(maskCoeffs));
+        anchorIndices.push_back(i);
     }
 
     // Early exit if no boxes after confidence threshold
@@ -567,230 +408,136 @@ std::vector<Segmentation> YOLOv11SegDetector::postprocess(
         return results;
     }
 
-    // 3. Apply NMS
+    // 2. Apply per-class NMS
+    yolos::NMSOptions options = nmsOptions;
+    options.scoreThreshold = confThreshold;
+    options.iouThreshold = iouThreshold;
     std::vector<int> nmsIndices;
-    utils::NMSBoxes(boxes, confidences, confThreshold, iouThreshold, nmsIndices);
+    nmsEngine.run(boxes, confidences, &classIds, options, nmsIndices);
 
     if (nmsIndices.empty()) {
         return results;
     }
 
-    // 4. Prepare final results
+    // 3. Prepare final results
     results.reserve(nmsIndices.size());
 
-    // Calculate letterbox parameters
-    const float gain = std::min(static_cast<float>(letterboxSize.height) / origSize.height,
-                               static_cast<float>(letterboxSize.width) / origSize.width);
-    const int scaledW = static_cast<int>(origSize.width * gain);
-    const int scaledH = static_cast<int>(origSize.height * gain);
-    const float padW = (letterboxSize.width - scaledW) / 2.0f;
-    const float padH = (letterboxSize.height - scaledH) / 2.0f;
+    const yolos::MaskGeometry geometry = yolos::MaskGeometry::fromLetterbox(letterboxSize, origSize, maskW, maskH);
+    if (!geometry.valid()) {
+        // The letterboxed content does not cover any prototype cell
+        return results;
+    }
 
-    // Precompute mask scaling factors
-    const float maskScaleX = static_cast<float>(maskW) / letterboxSize.width;
-    const float maskScaleY = static_cast<float>(maskH) / letterboxSize.height;
+    // Deferred masks share one copy of this frame's prototypes, since the output buffer is reused by the next run
+    std::shared_ptr<yolos::MaskPrototypes> prototypes;
+    if (deferMasks) {
+        prototypes = std::make_shared<yolos::MaskPrototypes>();
+        prototypes->data.assign(output1_ptr, output1_ptr + static_cast<size_t>(32) * maskH * maskW);
+        prototypes->numProtos = 32;
+        prototypes->geometry = geometry;
+    }
 
+    float maskCoeffs[32];
     for (const int idx : nmsIndices) {
         Segmentation seg;
         seg.box = boxes[idx];
         seg.conf = confidences[idx];
         seg.classId = classIds[idx];
 
-        // 5. Scale box to original image
+        // 4. Scale box to original image
         seg.box = utils::scaleCoords(letterboxSize, seg.box, origSize, true);
 
-        // 6. Process mask
-        const auto& maskCoeffs = maskCoefficientsList[idx];
-
-        // Linear combination of prototype masks
-        cv::Mat finalMask = cv::Mat::zeros(maskH, maskW, CV_32F);
+        // 5. Gather the mask coefficients of this anchor
+        const int anchor = anchorIndices[idx];
         for (int m = 0; m < 32; ++m) {
-            finalMask += maskCoeffs[m] * prototypeMasks[m];
-        }
-
-        // Apply sigmoid activation
-        finalMask = utils::sigmoid(finalMask);
-
-        // Crop mask to letterbox area with a slight padding to avoid border issues
-        int x1 = static_cast<int>(std::round((padW - 0.1f) * maskScaleX));
-        int y1 = static_cast<int>(std::round((padH - 0.1f) * maskScaleY));
-        int x2 = static_cast<int>(std::round((letterboxSize.width - padW + 0.1f) * maskScaleX));
-        int y2 = static_cast<int>(std::round((letterboxSize.height - padH + 0.1f) * maskScaleY));
-
-        // Ensure coordinates are within mask bounds
-        x1 = std::max(0, std::min(x1, maskW - 1));
-        y1 = std::max(0, std::min(y1, maskH - 1));
-        x2 = std::max(x1, std::min(x2, maskW));
-        y2 = std::max(y1, std::min(y2, maskH));
-
-        // Handle cases where cropping might result in zero area
-        if (x2 <= x1 || y2 <= y1) {
-            // Skip this mask as cropping is invalid
-            continue;
+            maskCoeffs[m] = output0_ptr[(MASK_COEFF_OFFSET + m) * numBoxes + anchor];
         }
 
-        cv::Rect cropRect(x1, y1, x2 - x1, y2 - y1);
-        cv::Mat croppedMask = finalMask(cropRect).clone(); // Clone to ensure data integrity
-
-        // Resize to original dimensions
-        cv::Mat resizedMask;
-        cv::resize(croppedMask, resizedMask, origSize, 0, 0, cv::INTER_LINEAR);
-
-        // Threshold and convert to binary
-        cv::Mat binaryMask;
-        cv::threshold(resizedMask, binaryMask, 0.5, 255.0, cv::THRESH_BINARY);
-        binaryMask.convertTo(binaryMask, CV_8U);
-
-        // Crop to bounding box
-        cv::Mat finalBinaryMask = cv::Mat::zeros(origSize, CV_8U);
-        cv::Rect roi(seg.box.x, seg.box.y, seg.box.width, seg.box.height);
-        roi &= cv::Rect(0, 0, binaryMask.cols, binaryMask.rows); // Ensure ROI is within mask
-        if (roi.area() > 0) {
-            binaryMask(roi).copyTo(finalBinaryMask(roi));
+        // 6. Box-local mask: prototypes are combined, resized and thresholded inside the box only
+        const cv::Rect roi = cv::Rect(seg.box.x, seg.box.y, seg.box.width, seg.box.height) &
+                             cv::Rect(0, 0, origSize.width, origSize.height);
+        seg.maskOffset = roi.tl();
+        if (prototypes) {
+            seg.deferredMask = yolos::DeferredMask(prototypes, maskCoeffs, roi);
+        } else {
+            maskRenderer.render(output1_ptr, 32, geometry, maskCoeffs, roi, seg.mask);
         }
-
-        seg.mask = finalBinaryMask;
         results.push_back(seg);
     }
 
     return results;
 }
 
-inline void YOLOv11SegDetector::drawSegmentationsAndBoxes(cv::Mat &image,
-                                                 const std::vector<Segmentation> &results,
-                                                 float maskAlpha) const 
+inline std::vector<yolos::OverlayItem> YOLOv11SegDetector::overlayItems(const std::vector<Segmentation> &results,
+                                                                         bool labels) const
 {
+    std::vector<yolos::OverlayItem> items;
+    items.reserve(results.size());
     for (const auto &seg : results) {
         if (seg.conf < CONFIDENCE_THRESHOLD) {
             continue;
         }
-        cv::Scalar color = classColors[seg.classId % classColors.size()];
-
-        // -----------------------------
-        // 1. Draw Bounding Box
-        // -----------------------------
-        cv::rectangle(image,
-                      cv::Point(seg.box.x, seg.box.y),
-                      cv::Point(seg.box.x + seg.box.width, seg.box.y + seg.box.height),
-                      color, 2);
-
-        // -----------------------------
-        // 2. Draw Label
-        // -----------------------------
-        std::string label = classNames[seg.classId] + " " + std::to_string(static_cast<int>(seg.conf * 100)) + "%";
-        int baseLine = 0;
-        double fontScale = 0.5;
-        int thickness = 1;
-        cv::Size labelSize = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, fontScale, thickness, &baseLine);
-        int top = std::max(seg.box.y, labelSize.height + 5);
-        cv::rectangle(image,
-                      cv::Point(seg.box.x, top - labelSize.height - 5),
-                      cv::Point(seg.box.x + labelSize.width + 5, top),
-                      color, cv::FILLED);
-        cv::putText(image, label,
-                    cv::Point(seg.box.x + 2, top - 2),
-                    cv::FONT_HERSHEY_SIMPLEX,
-                    fontScale,
-                    cv::Scalar(255, 255, 255),
-                    thickness);
-
-        // -----------------------------
-        // 3. Apply Segmentation Mask
-        // -----------------------------
-        if (!seg.mask.empty()) {
-            // Ensure the mask is single-channel
-            cv::Mat mask_gray;
-            if (seg.mask.channels() == 3) {
-                cv::cvtColor(seg.mask, mask_gray, cv::COLOR_BGR2GRAY);
-            } else {
-                mask_gray = seg.mask.clone();
-            }
-
-            // Threshold the mask to binary (object: 255, background: 0)
-            cv::Mat mask_binary;
-            cv::threshold(mask_gray, mask_binary, 127, 255, cv::THRESH_BINARY);
-
-            // Create a colored version of the mask
-            cv::Mat colored_mask;
-            cv::cvtColor(mask_binary, colored_mask, cv::COLOR_GRAY2BGR);
-            colored_mask.setTo(color, mask_binary); // Apply color where mask is present
-
-            // Blend the colored mask with the original image
-            cv::addWeighted(image, 1.0, colored_mask, maskAlpha, 0, image);
+        yolos::OverlayItem item;
+        item.box = cv::Rect(seg.box.x, seg.box.y, seg.box.width, seg.box.height);
+        item.confidence = seg.conf;
+        item.color = classColors[seg.classId % classColors.size()];
+        if (labels && seg.classId >= 0 && static_cast<size_t>(seg.classId) < classNames.size()) {
+            item.name = &classNames[seg.classId];
         }
+        // Deferred masks are rendered by the renderer, in parallel across instances
+        item.mask = &seg.mask;
+        item.deferredMask = &seg.deferredMask;
+        item.maskOffset = seg.maskOffset;
+        items.push_back(std::move(item));
     }
+    return items;
 }
 
-
-inline void YOLOv11SegDetector::drawSegmentations(cv::Mat &image,
+inline void YOLOv11SegDetector::drawSegmentationsAndBoxes(cv::Mat &image,
                                                  const std::vector<Segmentation> &results,
                                                  float maskAlpha) const 
 {
-    for (const auto &seg : results) {
-        if (seg.conf < CONFIDENCE_THRESHOLD) {
-            continue;
-        }
-        cv::Scalar color = classColors[seg.classId % classColors.size()];
-
-        // -----------------------------
-        // Draw Segmentation Mask Only
-        // -----------------------------
-        if (!seg.mask.empty()) {
-            // Ensure the mask is single-channel
-            cv::Mat mask_gray;
-            if (seg.mask.channels() == 3) {
-                cv::cvtColor(seg.mask, mask_gray, cv::COLOR_BGR2GRAY);
-            } else {
-                mask_gray = seg.mask.clone();
-            }
-
-            // Threshold the mask to binary (object: 255, background: 0)
-            cv::Mat mask_binary;
-            cv::threshold(mask_gray, mask_binary, 127, 255, cv::THRESH_BINARY);
+    yolos::OverlayStyle style;
+    style.maskAlpha = maskAlpha;
+    overlay.render(image, overlayItems(results, true), style);
+}
 
-            // Create a colored version of the mask
-            cv::Mat colored_mask;
-            cv::cvtColor(mask_binary, colored_mask, cv::COLOR_GRAY2BGR);
-            colored_mask.setTo(color, mask_binary); // Apply color where mask is present
 
-            // Blend the colored mask with the original image
-            cv::addWeighted(image, 1.0, colored_mask, maskAlpha, 0, image);
-        }
-    }
+inline void YOLOv11SegDetector::drawSegmentations(cv::Mat &image,
+                                                 const std::vector<Segmentation> &results,
+                                                 float maskAlpha) const 
+{
+    yolos::OverlayStyle style;
+    style.maskAlpha = maskAlpha;
+    style.boxThickness = 0;
+    overlay.render(image, overlayItems(results, false), style);
 }
 
 inline std::vector<Segmentation> YOLOv11SegDetector::segment(const cv::Mat &image,
                                                             float confThreshold,
                                                             float iouThreshold) 
 {
-    ScopedTimer timer("YOLOv11Seg: segment()");
-
-    float *blobPtr = nullptr;
-    std::vector<int64_t> inputShape = {1, 3, inputImageShape.height, inputImageShape.width};
-    cv::Mat letterboxImg = preprocess(image, blobPtr, inputShape);
-
-    size_t inputSize = utils::vectorProduct(inputShape);
-    std::vector<float> inputVals(blobPtr, blobPtr + inputSize);
-    delete[] blobPtr;
-
-    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-        memInfo,
-        inputVals.data(),
-        inputSize,
-        inputShape.data(),
-        inputShape.size()
-    );
-
-    std::vector<Ort::Value> outputs = session.Run(
-        Ort::RunOptions{nullptr},
-        inputNames.data(),
-        &inputTensor,
-        numInputNodes,
-        outputNames.data(),
-        numOutputNodes);
-
-    cv::Size letterboxSize(static_cast<int>(inputShape[3]), static_cast<int>(inputShape[2]));
-    return postprocess(image.size(), letterboxSize, outputs, confThreshold, iouThreshold);
+    ScopedTimer timer("segmentation.segment");
+
+    return core.run(image, [&](const cv::Size &origSize, const cv::Size &letterboxSize, const yolos::ImageOutputs &outputs) {
+        return postprocess(origSize, letterboxSize,
+                           outputs.data(0), outputs.shape(0),
+                           outputs.data(1), outputs.shape(1),
+                           confThreshold, iouThreshold);
+    });
 }
 
+inline std::vector<std::vector<Segmentation>> YOLOv11SegDetector::segmentBatch(const std::vector<cv::Mat> &images,
+                                                                              float confThreshold,
+                                                                              float iouThreshold)
+{
+    ScopedTimer timer("segmentation.segment_batch");
+
+    // Per-image views of the batched detections and prototypes
+    return core.runBatch(images, [&](const cv::Size &origSize, const cv::Size &letterboxSize, const yolos::ImageOutputs &outputs) {
+        return postprocess(origSize, letterboxSize,
+                           outputs.data(0), outputs.shape(0),
+                           outputs.data(1), outputs.shape(1),
+                           confThreshold, iouThreshold);
+    });
+}
@@ -48,6 +48,22 @@ public:
         return true;
     }
 
+    // Non-blocking dequeue: returns false right away if the queue is empty
+    bool try_dequeue(T& item) {
+        std::unique_lock<std::mutex> lock(m);
+        if (q.empty()) return false;
+        item = std::move(q.front());
+        q.pop();
+        DEBUG_PRINT("Dequeued item, current queue size: " << q.size());
+        cv_not_full.notify_one();
+        return true;
+    }
+
+    size_t size() const {
+        std::unique_lock<std::mutex> lock(m);
+        return q.size();
+    }
+
     void set_finished() {
         std::unique_lock<std::mutex> lock(m);
         finished = true;
@@ -59,7 +75,7 @@ public:
 private:
     std::queue<T> q;
     size_t max_size_;
-    std::mutex m;
+    mutable std::mutex m;
     std::condition_variable cv_not_empty;
     std::condition_variable cv_not_full;
     bool finished;
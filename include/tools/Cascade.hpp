@@ -0,0 +1,294 @@
+// Cascade.hpp
+#ifndef CASCADE_HPP
+#define CASCADE_HPP
+
+/**
+ * @file Cascade.hpp
+ * @brief Two-stage cascade: detect objects in a frame, then refine every object's region
+ *        (classify, pose, segment) with a second model, in one merged result per frame.
+ *
+ * Stage two never works on copied crops: the regions of the stage-one objects (padded by a
+ * context margin and clipped to the frame) are handed over as rectangles of the source frame,
+ * and the second model reads them as cv::Mat views while batching them into one tensor
+ * (YOLO11Classifier::classifyBatch(frame, rois), or detectBatch() / segmentBatch() on views).
+ *
+ * process() runs both stages on the calling thread. run() streams frames through a
+ * yolos::Pipeline with one worker per stage: stage two of frame t runs while stage one works
+ * on frame t + 1, and the bounded queue between them blocks stage one when stage two falls
+ * behind. Each model is only ever used by its own stage thread, so neither needs to be
+ * thread-safe. Results reach the sink in frame order.
+ *
+ * The task headers define conflicting global names (Detection, BoundingBox, utils), so a
+ * translation unit combining two of them includes each inside its own namespace, as
+ * benchmark/BenchTaskHeaders.hpp does; this header does not include any of them.
+ */
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tools/Pipeline.hpp"
+
+namespace yolos {
+
+/**
+ * @brief Configuration of a Cascade.
+ */
+struct CascadeOptions {
+    float roiPadding = 0.1f;       // Context added on every side of a region, as a fraction of its size
+    int minRoiSize = 8;            // Regions narrower or shorter than this (after clipping) are not refined
+    size_t maxRois = 0;            // Regions refined per frame, in stage-one order (0 = all)
+    size_t queueCapacity = 2;      // Frames waiting in front of each stage of run()
+};
+
+/**
+ * @brief One stage-one object with its stage-two result.
+ */
+template <typename Primary, typename Secondary>
+struct CascadeObject {
+    Primary primary;               // Stage-one result (e.g. a Detection), frame coordinates
+    cv::Rect roi;                  // Frame region handed to stage two
+    Secondary secondary{};         // Stage-two result for roi (frame coordinates for the adapters below)
+    bool refined = false;          // False if the region was too small or over maxRois
+};
+
+/**
+ * @brief Merged result of one frame.
+ */
+template <typename Primary, typename Secondary>
+struct CascadeResult {
+    uint64_t frameIndex = 0;
+    cv::Mat frame;                 // Source frame (shared with the caller, not copied)
+    std::vector<CascadeObject<Primary, Secondary>> objects;
+    double detectMs = 0.0;         // Stage one
+    double refineMs = 0.0;         // Stage two (every region in one call)
+};
+
+template <typename Primary, typename Secondary>
+class Cascade {
+public:
+    using Result = CascadeResult<Primary, Secondary>;
+    using Detect = std::function<std::vector<Primary>(const cv::Mat &)>;
+    using Region = std::function<cv::Rect(const Primary &)>;
+    /// Refines the regions of one frame; returns one result per region, in order
+    using Refine = std::function<std::vector<Secondary>(const cv::Mat &, const std::vector<cv::Rect> &)>;
+    /// Fills the next frame; false at the end of the stream. Every frame needs its own buffer
+    /// (e.g. a fresh cv::Mat or a FramePool lease), since earlier frames are still in flight.
+    using Source = std::function<bool(cv::Mat &)>;
+    using Sink = std::function<void(Result &)>;
+
+    /**
+     * @param detect Stage one: objects of a frame.
+     * @param region Frame region of a stage-one object.
+     * @param refine Stage two: results for a list of frame regions.
+     */
+    Cascade(Detect detect, Region region, Refine refine, const CascadeOptions &options = CascadeOptions())
+        : detect_(std::move(detect)), region_(std::move(region)), refine_(std::move(refine)), options_(options) {}
+
+    /**
+     * @brief Runs both stages on one frame, on the calling thread.
+     */
+    Result process(const cv::Mat &frame) {
+        Result result;
+        result.frame = frame;
+        runDetect(result);
+        runRefine(result);
+        return result;
+    }
+
+    /**
+     * @brief Streams frames through both stages, overlapping stage two of a frame with stage one
+     *        of the next; blocks until the sink got the last frame. The sink runs on the calling
+     *        thread. An exception in the source, a stage or the sink stops the stream and is rethrown.
+     */
+    void run(Source source, Sink sink) {
+        Pipeline<Result> pipeline("source", "sink", options_.queueCapacity);
+        pipeline.addStage("detect", 1, [this](Result &result, size_t) { runDetect(result); }, options_.queueCapacity);
+        pipeline.addStage("refine", 1, [this](Result &result, size_t) { runRefine(result); }, options_.queueCapacity);
+
+        uint64_t next = 0;
+        pipeline.run(
+            [&](Result &result) {
+                result = Result{};
+                if (!source(result.frame) || result.frame.empty()) {
+                    return false;
+                }
+                result.frameIndex = next++;
+                return true;
+            },
+            [&](Result &result) { sink(result); });
+    }
+
+    const CascadeOptions &options() const { return options_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static double elapsedMs(Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    // Pads the object's region for context and clips it to the frame
+    cv::Rect expand(const cv::Rect &box, const cv::Size &frameSize) const {
+        const int padX = static_cast<int>(box.width * options_.roiPadding + 0.5f);
+        const int padY = static_cast<int>(box.height * options_.roiPadding + 0.5f);
+        const cv::Rect padded(box.x - padX, box.y - padY, box.width + 2 * padX, box.height + 2 * padY);
+        return padded & cv::Rect(0, 0, frameSize.width, frameSize.height);
+    }
+
+    void runDetect(Result &result) {
+        const Clock::time_point t0 = Clock::now();
+        std::vector<Primary> primaries = detect_(result.frame);
+        result.objects.clear();
+        result.objects.reserve(primaries.size());
+        for (Primary &primary : primaries) {
+            const cv::Rect roi = expand(region_(primary), result.frame.size());
+            result.objects.push_back(CascadeObject<Primary, Secondary>{std::move(primary), roi, Secondary{}, false});
+        }
+        result.detectMs = elapsedMs(t0, Clock::now());
+    }
+
+    void runRefine(Result &result) {
+        const Clock::time_point t0 = Clock::now();
+        std::vector<cv::Rect> rois;
+        std::vector<size_t> owners;
+        for (size_t i = 0; i < result.objects.size(); ++i) {
+            if (options_.maxRois && rois.size() >= options_.maxRois) {
+                break;
+            }
+            const cv::Rect &roi = result.objects[i].roi;
+            if (roi.width >= options_.minRoiSize && roi.height >= options_.minRoiSize) {
+                rois.push_back(roi);
+                owners.push_back(i);
+            }
+        }
+
+        if (!rois.empty()) {
+            std::vector<Secondary> secondaries = refine_(result.frame, rois);
+            if (secondaries.size() != rois.size()) {
+                throw std::runtime_error("Cascade: stage two returned " + std::to_string(secondaries.size()) +
+                                         " results for " + std::to_string(rois.size()) + " regions.");
+            }
+            for (size_t r = 0; r < rois.size(); ++r) {
+                CascadeObject<Primary, Secondary> &object = result.objects[owners[r]];
+                object.secondary = std::move(secondaries[r]);
+                object.refined = true;
+            }
+        }
+        result.refineMs = elapsedMs(t0, Clock::now());
+    }
+
+    Detect detect_;
+    Region region_;
+    Refine refine_;
+    CascadeOptions options_;
+};
+
+/**
+ * @brief Builds a Cascade, deducing the result types from the stage functions.
+ */
+template <typename DetectFn, typename RegionFn, typename RefineFn>
+auto makeCascade(DetectFn detect, RegionFn region, RefineFn refine, const CascadeOptions &options = CascadeOptions()) {
+    using Primaries = typename std::decay<decltype(detect(std::declval<const cv::Mat &>()))>::type;
+    using Secondaries = typename std::decay<decltype(
+        refine(std::declval<const cv::Mat &>(), std::declval<const std::vector<cv::Rect> &>()))>::type;
+    return Cascade<typename Primaries::value_type, typename Secondaries::value_type>(
+        std::move(detect), std::move(region), std::move(refine), options);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Stage adapters for the task classes (duck-typed, so this header needs none of them)
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @brief Stage one from any detector with detect(image, conf, iou).
+ */
+template <typename Detector>
+auto detectStage(Detector &detector, float confThreshold, float iouThreshold) {
+    return [&detector, confThreshold, iouThreshold](const cv::Mat &frame) {
+        return detector.detect(frame, confThreshold, iouThreshold);
+    };
+}
+
+/**
+ * @brief Region of a result with an axis-aligned box member (x, y, width, height).
+ */
+inline auto boxRegion() {
+    return [](const auto &object) { return cv::Rect(object.box.x, object.box.y, object.box.width, object.box.height); };
+}
+
+/**
+ * @brief Stage two from a YOLO11Classifier: top-k classes of every region, read in place.
+ */
+template <typename Classifier>
+auto classifyStage(Classifier &classifier, int topK = 1, bool probabilities = true) {
+    return [&classifier, topK, probabilities](const cv::Mat &frame, const std::vector<cv::Rect> &rois) {
+        return classifier.classifyBatch(frame, rois, topK, probabilities);
+    };
+}
+
+namespace detail {
+
+inline std::vector<cv::Mat> regionViews(const cv::Mat &frame, const std::vector<cv::Rect> &rois) {
+    std::vector<cv::Mat> views;
+    views.reserve(rois.size());
+    for (const cv::Rect &roi : rois) {
+        views.emplace_back(frame, roi);
+    }
+    return views;
+}
+
+} // namespace detail
+
+/**
+ * @brief Stage two from a pose model: keypoints of every region in one detectBatch() over
+ *        views of the frame, shifted back to frame coordinates.
+ */
+template <typename PoseDetector>
+auto poseStage(PoseDetector &detector, float confThreshold, float iouThreshold) {
+    return [&detector, confThreshold, iouThreshold](const cv::Mat &frame, const std::vector<cv::Rect> &rois) {
+        auto results = detector.detectBatch(detail::regionViews(frame, rois), confThreshold, iouThreshold);
+        for (size_t r = 0; r < results.size(); ++r) {
+            for (auto &pose : results[r]) {
+                pose.box.x += rois[r].x;
+                pose.box.y += rois[r].y;
+                for (auto &keypoint : pose.keypoints) {
+                    keypoint.x += static_cast<float>(rois[r].x);
+                    keypoint.y += static_cast<float>(rois[r].y);
+                }
+            }
+        }
+        return results;
+    };
+}
+
+/**
+ * @brief Stage two from a segmentation model: instances of every region in one segmentBatch()
+ *        over views of the frame, with boxes and mask offsets in frame coordinates.
+ */
+template <typename Segmentor>
+auto segmentStage(Segmentor &segmentor, float confThreshold, float iouThreshold) {
+    return [&segmentor, confThreshold, iouThreshold](const cv::Mat &frame, const std::vector<cv::Rect> &rois) {
+        auto results = segmentor.segmentBatch(detail::regionViews(frame, rois), confThreshold, iouThreshold);
+        for (size_t r = 0; r < results.size(); ++r) {
+            for (auto &instance : results[r]) {
+                instance.box.x += rois[r].x;
+                instance.box.y += rois[r].y;
+                instance.maskOffset += rois[r].tl();
+            }
+        }
+        return results;
+    };
+}
+
+} // namespace yolos
+
+#endif // CASCADE_HPP
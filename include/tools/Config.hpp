@@ -8,6 +8,8 @@
  * 
  * Uncomment the following lines to enable debugging and timing modes
  * for enhanced performance monitoring and debugging capabilities.
+ * TIMING_MODE only makes stage instrumentation start enabled; it can also be
+ * switched at runtime (see tools/Instrumentation.hpp).
  */
 
 // Uncomment the following lines to enable debugging and timing
@@ -0,0 +1,143 @@
+// CudaKernels.hpp
+#ifndef CUDA_KERNELS_HPP
+#define CUDA_KERNELS_HPP
+
+/**
+ * @file CudaKernels.hpp
+ * @brief Device-side preprocessing and decoding kernels used by the CUDA pipeline.
+ *
+ * The kernels are implemented in src/cuda/YoloKernels.cu and are only available when
+ * the project is configured with -DYOLOS_ENABLE_CUDA=ON, which also defines
+ * YOLOS_WITH_CUDA for every target linking against yolos_cuda. This header has no
+ * OpenCV or ONNX Runtime dependency so it can be included from .cu files.
+ */
+
+#include <cuda_runtime_api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace yolos {
+namespace cuda {
+
+/**
+ * @brief Letterbox geometry passed to the device kernel (mirrors yolos::LetterboxParams).
+ */
+struct LetterboxGeometry {
+    int srcW = 0, srcH = 0;        // Source image size
+    int outW = 0, outH = 0;        // Padded tensor plane size
+    int unpadW = 0, unpadH = 0;    // Resized image size inside the plane
+    int padLeft = 0, padTop = 0;   // Offset of the resized image inside the plane
+    int srcChannels = 3;           // Bytes per source pixel: 3 (BGR) or 4 (BGRA, as decoded by NVDEC)
+};
+
+/**
+ * @brief A detection candidate that passed the confidence threshold on the device.
+ *        Coordinates are in letterboxed tensor space (center x/y, width, height).
+ */
+struct Candidate {
+    float cx, cy, w, h;
+    float score;
+    int classId;
+    int anchor;                    // Anchor index, used to restore the CPU decode order
+};
+
+/**
+ * @brief Throws std::runtime_error when a CUDA call failed.
+ */
+inline void check(cudaError_t status, const char *what) {
+    if (status != cudaSuccess) {
+        throw std::runtime_error(std::string(what) + ": " + cudaGetErrorString(status));
+    }
+}
+
+/**
+ * @brief Owning wrapper around a non-blocking cudaStream_t.
+ */
+class Stream {
+public:
+    Stream() = default;
+    ~Stream() {
+        if (stream_) cudaStreamDestroy(stream_);
+    }
+
+    Stream(const Stream &) = delete;
+    Stream &operator=(const Stream &) = delete;
+
+    /**
+     * @brief Returns the stream, creating it on first use.
+     */
+    cudaStream_t get() {
+        if (!stream_) {
+            check(cudaStreamCreateWithFlags(&stream_, cudaStreamNonBlocking), "cudaStreamCreate");
+        }
+        return stream_;
+    }
+
+private:
+    cudaStream_t stream_ = nullptr;
+};
+
+/**
+ * @brief Letterboxes an interleaved 8-bit BGR or BGRA image into a planar float CHW tensor.
+ *
+ * @param src Device pointer to the source image (geometry.srcChannels bytes per pixel, row pitch srcStep bytes).
+ * @param srcStep Row pitch of the source image in bytes.
+ * @param geometry Letterbox geometry.
+ * @param dst Device pointer to 3 * outW * outH floats.
+ * @param swapRB Write the channels in RGB order.
+ * @param padValue Padding value before scaling (114 for YOLO).
+ * @param scale Multiplier applied to every value (1/255 for YOLO).
+ * @param stream Stream to launch on.
+ */
+void launchLetterbox(const uint8_t *src, size_t srcStep, const LetterboxGeometry &geometry, float *dst,
+                     bool swapRB, float padValue, float scale, cudaStream_t stream);
+
+/**
+ * @brief Runs the confidence threshold and class argmax over a [4 + numClasses, numAnchors] output
+ *        and compacts the surviving anchors into a candidate list.
+ *
+ * @param output Device pointer to one image's output (channel-major, as exported by Ultralytics).
+ * @param numClasses Number of class score rows.
+ * @param numAnchors Number of anchors (columns).
+ * @param confThreshold Candidates need a best class score strictly above this value.
+ * @param candidates Device buffer receiving at most maxCandidates entries, in arbitrary order.
+ * @param count Device counter; reset by the launcher, holds the number of survivors afterwards
+ *              (it may exceed maxCandidates, in which case the extra survivors were dropped).
+ * @param maxCandidates Capacity of the candidates buffer.
+ * @param stream Stream to launch on.
+ */
+void launchDecode(const float *output, int numClasses, int numAnchors, float confThreshold,
+                  Candidate *candidates, int *count, int maxCandidates, cudaStream_t stream);
+
+/**
+ * @brief A box outline to draw into a device frame.
+ */
+struct DeviceBox {
+    int x = 0, y = 0, width = 0, height = 0;  // Box in frame pixels (clipped by the kernel)
+    uint8_t color[3] = {0, 0, 0};              // B, G, R
+};
+
+/**
+ * @brief Draws box outlines into an interleaved 8-bit BGR or BGRA device frame, in place.
+ *
+ * @param image Device pointer to the frame (row pitch step bytes).
+ * @param step Row pitch of the frame in bytes.
+ * @param width Frame width.
+ * @param height Frame height.
+ * @param channels Bytes per pixel: 3 or 4 (alpha is left untouched).
+ * @param boxes Device array of count boxes.
+ * @param count Number of boxes.
+ * @param maxPerimeter Largest 2 * (width + height) of the boxes, which sizes the launch grid.
+ * @param thickness Line thickness in pixels, drawn inwards.
+ * @param stream Stream to launch on.
+ */
+void launchDrawBoxes(uint8_t *image, size_t step, int width, int height, int channels,
+                     const DeviceBox *boxes, int count, int maxPerimeter, int thickness, cudaStream_t stream);
+
+} // namespace cuda
+} // namespace yolos
+
+#endif // CUDA_KERNELS_HPP
@@ -0,0 +1,316 @@
+// CudaPipeline.hpp
+#ifndef CUDA_PIPELINE_HPP
+#define CUDA_PIPELINE_HPP
+
+/**
+ * @file CudaPipeline.hpp
+ * @brief GPU-resident letterbox, inference and candidate decoding for the CUDA execution provider.
+ *
+ * With the plain CUDA path every frame is letterboxed on the host, the float tensor is
+ * uploaded, and the whole [1, 4 + nc, anchors] output is copied back so the host can scan
+ * every class score. CudaDetectionPipeline instead uploads the 8-bit frame, letterboxes it
+ * into a device input tensor, binds the model output to device memory, and runs the
+ * confidence threshold + class argmax on the device. Only the surviving candidates come
+ * back over PCIe; NMS and coordinate scaling stay on the host.
+ *
+ * The pre/post kernels and ONNX Runtime share one CUDA stream (passed to the execution
+ * provider through user_compute_stream), so no host synchronisation is needed between
+ * the stages. The owner keeps that stream in a yolos::cuda::Stream declared before the
+ * session, so it is destroyed after the session; the pipeline itself must be destroyed
+ * before the session because it holds an IoBinding.
+ *
+ * Frames that are already in device memory (e.g. decoded by NVDEC through cv::cudacodec)
+ * go through runDevice() and are letterboxed in place, without any host round-trip;
+ * CudaBoxRenderer draws the resulting boxes back into such a frame before NVENC encodes it.
+ *
+ * Only available when built with -DYOLOS_ENABLE_CUDA=ON.
+ *
+ * A pipeline (and therefore the detector owning it) must not be used from several threads at once.
+ */
+
+#ifdef YOLOS_WITH_CUDA
+
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/cuda.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "tools/CudaKernels.hpp"
+#include "tools/Preprocessing.hpp"
+#include "tools/ScopedTimer.hpp"
+
+class CudaDetectionPipeline {
+public:
+    CudaDetectionPipeline() = default;
+    ~CudaDetectionPipeline() { release(); }
+
+    CudaDetectionPipeline(const CudaDetectionPipeline &) = delete;
+    CudaDetectionPipeline &operator=(const CudaDetectionPipeline &) = delete;
+
+    /**
+     * @brief Allocates the device buffers and binds them to the session.
+     *
+     * @param session Session created with the CUDA execution provider on stream.
+     * @param inputName Name of the image input.
+     * @param outputName Name of the [1, 4 + nc, anchors] output.
+     * @param inputShape Static input shape [1, 3, H, W].
+     * @param outputShape Output shape from the model metadata.
+     * @param stream Stream passed to the execution provider as user_compute_stream; it must outlive the session.
+     * @param deviceId CUDA device the session runs on.
+     * @return true if the model layout is supported and the pipeline is active.
+     */
+    bool init(Ort::Session &session, const char *inputName, const char *outputName,
+              const std::vector<int64_t> &inputShape, const std::vector<int64_t> &outputShape,
+              cudaStream_t stream, int deviceId = 0) {
+        release();
+
+        // Only the Ultralytics [batch, 4 + nc, anchors] layout with static sizes is decoded on the device
+        if (inputShape.size() != 4 || inputShape[0] != 1 || inputShape[2] <= 0 || inputShape[3] <= 0 ||
+            outputShape.size() != 3 || outputShape[0] > 1 || outputShape[1] <= 4 || outputShape[2] <= 0 ||
+            outputShape[2] == 6) {
+            return false;
+        }
+
+        yolos::cuda::check(cudaSetDevice(deviceId), "cudaSetDevice");
+        stream_ = stream;
+
+        inputShape_ = inputShape;
+        outputShape_ = {1, outputShape[1], outputShape[2]};
+        numClasses_ = static_cast<int>(outputShape[1]) - 4;
+        numAnchors_ = static_cast<int>(outputShape[2]);
+
+        const size_t inputSize = static_cast<size_t>(3) * inputShape[2] * inputShape[3];
+        const size_t outputSize = static_cast<size_t>(outputShape_[1]) * outputShape_[2];
+        yolos::cuda::check(cudaMalloc(reinterpret_cast<void **>(&dInput_), inputSize * sizeof(float)), "cudaMalloc input");
+        yolos::cuda::check(cudaMalloc(reinterpret_cast<void **>(&dOutput_), outputSize * sizeof(float)), "cudaMalloc output");
+        yolos::cuda::check(cudaMalloc(reinterpret_cast<void **>(&dCandidates_), numAnchors_ * sizeof(yolos::cuda::Candidate)),
+                           "cudaMalloc candidates");
+        yolos::cuda::check(cudaMalloc(reinterpret_cast<void **>(&dCount_), sizeof(int)), "cudaMalloc counter");
+        yolos::cuda::check(cudaMallocHost(reinterpret_cast<void **>(&hCandidates_), numAnchors_ * sizeof(yolos::cuda::Candidate)),
+                           "cudaMallocHost candidates");
+        yolos::cuda::check(cudaMallocHost(reinterpret_cast<void **>(&hCount_), sizeof(int)), "cudaMallocHost counter");
+
+        memoryInfo_ = Ort::MemoryInfo("Cuda", OrtDeviceAllocator, deviceId, OrtMemTypeDefault);
+        inputValue_ = Ort::Value::CreateTensor<float>(memoryInfo_, dInput_, inputSize, inputShape_.data(), inputShape_.size());
+        outputValue_ = Ort::Value::CreateTensor<float>(memoryInfo_, dOutput_, outputSize, outputShape_.data(), outputShape_.size());
+        binding_ = Ort::IoBinding(session);
+        binding_.BindInput(inputName, inputValue_);
+        binding_.BindOutput(outputName, outputValue_);
+
+        candidates_.reserve(numAnchors_);
+        active_ = true;
+        return true;
+    }
+
+    bool active() const { return active_; }
+
+    /**
+     * @brief Letterboxes image on the device, runs the session and returns the candidates above confThreshold.
+     *
+     * @param session Session passed to init().
+     * @param image Source image (8-bit BGR; gray and BGRA are converted on the host first).
+     * @param params Letterbox geometry; params.outShape must match the bound input shape.
+     * @param confThreshold Confidence threshold.
+     * @return Candidates in letterboxed coordinates, ordered by anchor index like the host decoder.
+     */
+    const std::vector<yolos::cuda::Candidate> &run(Ort::Session &session, const cv::Mat &image,
+                                                   const yolos::LetterboxParams &params, float confThreshold) {
+        const cv::Mat *src = &image;
+        if (image.channels() == 1) {
+            cv::cvtColor(image, converted_, cv::COLOR_GRAY2BGR);
+            src = &converted_;
+        } else if (image.channels() == 4) {
+            cv::cvtColor(image, converted_, cv::COLOR_BGRA2BGR);
+            src = &converted_;
+        }
+        if (src->depth() != CV_8U || src->channels() != 3) {
+            throw std::runtime_error("CudaDetectionPipeline: only 8-bit images are supported.");
+        }
+
+        // Upload the 8-bit frame (3 bytes per pixel instead of 12 for the float tensor)
+        const size_t rowBytes = static_cast<size_t>(src->cols) * 3;
+        const size_t frameBytes = rowBytes * src->rows;
+        if (frameBytes > sourceCapacity_) {
+            if (dSource_) cudaFree(dSource_);
+            dSource_ = nullptr;
+            yolos::cuda::check(cudaMalloc(reinterpret_cast<void **>(&dSource_), frameBytes), "cudaMalloc frame");
+            sourceCapacity_ = frameBytes;
+        }
+        yolos::cuda::check(cudaMemcpy2DAsync(dSource_, rowBytes, src->data, src->step, rowBytes, src->rows,
+                                             cudaMemcpyHostToDevice, stream_), "upload frame");
+
+        return inferAndDecode(session, dSource_, rowBytes, 3, params, confThreshold);
+    }
+
+    /**
+     * @brief Same as run(), for a frame that already lives in device memory.
+     *
+     * Whatever produced the frame (a decoder, another stream) must have finished writing it,
+     * e.g. by synchronizing its stream, before this call.
+     *
+     * @param session Session passed to init().
+     * @param frame Device pointer to an interleaved 8-bit BGR or BGRA frame.
+     * @param step Row pitch of the frame in bytes.
+     * @param channels 3 (BGR) or 4 (BGRA).
+     * @param params Letterbox geometry for the frame size; params.outShape must match the bound input shape.
+     * @param confThreshold Confidence threshold.
+     */
+    const std::vector<yolos::cuda::Candidate> &runDevice(Ort::Session &session, const uint8_t *frame, size_t step, int channels,
+                                                         const yolos::LetterboxParams &params, float confThreshold) {
+        if (channels != 3 && channels != 4) {
+            throw std::runtime_error("CudaDetectionPipeline: device frames must be 8-bit BGR or BGRA.");
+        }
+        return inferAndDecode(session, frame, step, channels, params, confThreshold);
+    }
+
+private:
+    const std::vector<yolos::cuda::Candidate> &inferAndDecode(Ort::Session &session, const uint8_t *source, size_t step, int channels,
+                                                              const yolos::LetterboxParams &params, float confThreshold) {
+        yolos::cuda::LetterboxGeometry geometry;
+        geometry.srcW = params.srcSize.width;
+        geometry.srcH = params.srcSize.height;
+        geometry.outW = params.outShape.width;
+        geometry.outH = params.outShape.height;
+        geometry.unpadW = params.unpadW;
+        geometry.unpadH = params.unpadH;
+        geometry.padLeft = params.padLeft;
+        geometry.padTop = params.padTop;
+        geometry.srcChannels = channels;
+        yolos::cuda::launchLetterbox(source, step, geometry, dInput_, true, 114.0f, 1.0f / 255.0f, stream_);
+
+        // ONNX Runtime runs on the same stream, so the input is complete before the first layer
+        {
+            ScopedTimer timer("inference");
+            session.Run(Ort::RunOptions{nullptr}, binding_);
+        }
+
+        // Threshold + argmax on the device, then fetch only the survivors
+        yolos::cuda::launchDecode(dOutput_, numClasses_, numAnchors_, confThreshold, dCandidates_, dCount_, numAnchors_, stream_);
+        yolos::cuda::check(cudaMemcpyAsync(hCount_, dCount_, sizeof(int), cudaMemcpyDeviceToHost, stream_), "download count");
+        yolos::cuda::check(cudaStreamSynchronize(stream_), "cudaStreamSynchronize");
+
+        const int count = std::min(*hCount_, numAnchors_);
+        candidates_.clear();
+        if (count > 0) {
+            yolos::cuda::check(cudaMemcpyAsync(hCandidates_, dCandidates_, count * sizeof(yolos::cuda::Candidate),
+                                               cudaMemcpyDeviceToHost, stream_), "download candidates");
+            yolos::cuda::check(cudaStreamSynchronize(stream_), "cudaStreamSynchronize");
+            candidates_.assign(hCandidates_, hCandidates_ + count);
+
+            // atomicAdd compaction is unordered; restore anchor order so NMS ties resolve like on the host
+            std::sort(candidates_.begin(), candidates_.end(),
+                      [](const yolos::cuda::Candidate &a, const yolos::cuda::Candidate &b) { return a.anchor < b.anchor; });
+        }
+        return candidates_;
+    }
+
+    void release() {
+        active_ = false;
+        binding_ = Ort::IoBinding{nullptr};
+        inputValue_ = Ort::Value{nullptr};
+        outputValue_ = Ort::Value{nullptr};
+        if (dInput_) cudaFree(dInput_);
+        if (dOutput_) cudaFree(dOutput_);
+        if (dCandidates_) cudaFree(dCandidates_);
+        if (dCount_) cudaFree(dCount_);
+        if (dSource_) cudaFree(dSource_);
+        if (hCandidates_) cudaFreeHost(hCandidates_);
+        if (hCount_) cudaFreeHost(hCount_);
+        dInput_ = dOutput_ = nullptr;
+        dCandidates_ = nullptr;
+        dCount_ = nullptr;
+        dSource_ = nullptr;
+        hCandidates_ = nullptr;
+        hCount_ = nullptr;
+        sourceCapacity_ = 0;
+    }
+
+    cudaStream_t stream_ = nullptr;                      // Not owned
+    bool active_ = false;
+
+    std::vector<int64_t> inputShape_;
+    std::vector<int64_t> outputShape_;
+    int numClasses_ = 0;
+    int numAnchors_ = 0;
+
+    float *dInput_ = nullptr;                            // Letterboxed CHW input tensor
+    float *dOutput_ = nullptr;                           // Raw model output
+    yolos::cuda::Candidate *dCandidates_ = nullptr;      // Compacted survivors
+    int *dCount_ = nullptr;
+    uint8_t *dSource_ = nullptr;                         // Uploaded 8-bit frame
+    size_t sourceCapacity_ = 0;
+    yolos::cuda::Candidate *hCandidates_ = nullptr;      // Pinned download buffers
+    int *hCount_ = nullptr;
+
+    Ort::MemoryInfo memoryInfo_{nullptr};
+    Ort::Value inputValue_{nullptr};
+    Ort::Value outputValue_{nullptr};
+    Ort::IoBinding binding_{nullptr};
+
+    cv::Mat converted_;
+    std::vector<yolos::cuda::Candidate> candidates_;
+};
+
+/**
+ * @brief Draws box outlines into device frames (the GPU counterpart of DrawingUtils::drawBoundingBox,
+ *        without labels), so decoded frames can be annotated and re-encoded without leaving the device.
+ *
+ * One renderer per thread; it owns its stream and box buffer.
+ */
+class CudaBoxRenderer {
+public:
+    CudaBoxRenderer() = default;
+    ~CudaBoxRenderer() {
+        if (dBoxes_) cudaFree(dBoxes_);
+    }
+
+    CudaBoxRenderer(const CudaBoxRenderer &) = delete;
+    CudaBoxRenderer &operator=(const CudaBoxRenderer &) = delete;
+
+    /**
+     * @brief Draws the boxes into the frame and waits until the frame is updated.
+     *
+     * @param frame Device pointer to an interleaved 8-bit BGR or BGRA frame.
+     * @param step Row pitch of the frame in bytes.
+     * @param size Frame size.
+     * @param channels 3 (BGR) or 4 (BGRA).
+     * @param boxes Boxes with their colors, in frame coordinates.
+     * @param thickness Line thickness in pixels.
+     */
+    void draw(uint8_t *frame, size_t step, const cv::Size &size, int channels,
+              const std::vector<yolos::cuda::DeviceBox> &boxes, int thickness = 2) {
+        if (boxes.empty()) {
+            return;
+        }
+        if (boxes.size() > capacity_) {
+            if (dBoxes_) cudaFree(dBoxes_);
+            dBoxes_ = nullptr;
+            yolos::cuda::check(cudaMalloc(reinterpret_cast<void **>(&dBoxes_), boxes.size() * sizeof(yolos::cuda::DeviceBox)),
+                               "cudaMalloc boxes");
+            capacity_ = boxes.size();
+        }
+
+        int maxPerimeter = 0;
+        for (const yolos::cuda::DeviceBox &box : boxes) {
+            maxPerimeter = std::max(maxPerimeter, 2 * (std::max(box.width, 0) + std::max(box.height, 0)));
+        }
+        cudaStream_t stream = stream_.get();
+        yolos::cuda::check(cudaMemcpyAsync(dBoxes_, boxes.data(), boxes.size() * sizeof(yolos::cuda::DeviceBox),
+                                           cudaMemcpyHostToDevice, stream), "upload boxes");
+        yolos::cuda::launchDrawBoxes(frame, step, size.width, size.height, channels, dBoxes_,
+                                     static_cast<int>(boxes.size()), maxPerimeter, thickness, stream);
+        yolos::cuda::check(cudaStreamSynchronize(stream), "cudaStreamSynchronize");
+    }
+
+private:
+    yolos::cuda::Stream stream_;
+    yolos::cuda::DeviceBox *dBoxes_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+#endif // YOLOS_WITH_CUDA
+
+#endif // CUDA_PIPELINE_HPP
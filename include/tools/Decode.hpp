@@ -0,0 +1,278 @@
+// Decode.hpp
+#ifndef DECODE_HPP
+#define DECODE_HPP
+
+/**
+ * @file Decode.hpp
+ * @brief Cache-friendly confidence threshold + class argmax over channel-major YOLO outputs.
+ *
+ * Ultralytics detection heads export [4 + nc, anchors]: every class is one contiguous row.
+ * Scanning it anchor by anchor reads one float from each of the nc rows per anchor, which
+ * the hardware prefetchers cannot follow. decodeChannelMajor() instead works on tiles of
+ * anchors that stay in L1: it sweeps each class row of the tile contiguously and keeps a
+ * running max/argmax per anchor in SIMD registers (AVX2 runtime-dispatched, SSE2 or NEON,
+ * scalar fallback). Tiles in which no anchor passes the threshold are dropped with one
+ * vector compare, and box rows are only read for surviving anchors, which are appended to
+ * a struct-of-arrays buffer in anchor order.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define YOLOS_DECODE_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define YOLOS_DECODE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace yolos {
+
+/**
+ * @brief Output layouts of the detection heads, each with its own decoder.
+ */
+enum class DetectionLayout {
+    ChannelMajor,  ///< [batch, 4 + nc, anchors]: cx, cy, w, h then one row per class (YOLOv5u/v8/v11/v12)
+    EndToEnd,      ///< [batch, max_detections, 6]: x1, y1, x2, y2, score, class (YOLOv10)
+    FlatTable      ///< [num_detections, 7]: batch, x1, y1, x2, y2, class, score (YOLOv7 end-to-end)
+};
+
+/**
+ * @brief Recognises the layout from the output shape of the model metadata.
+ */
+inline DetectionLayout detectionLayoutOf(const std::vector<int64_t> &outputShape) {
+    if (outputShape.size() == 2) {
+        return DetectionLayout::FlatTable;
+    }
+    if (outputShape.size() >= 3 && outputShape[2] == 6) {
+        return DetectionLayout::EndToEnd;
+    }
+    return DetectionLayout::ChannelMajor;
+}
+
+/**
+ * @brief Struct-of-arrays list of decoded candidates (letterboxed coordinates).
+ *        Reused across frames; clear() keeps the capacity.
+ */
+struct CandidateBuffer {
+    std::vector<float> cx, cy, w, h;  // Box center and size
+    std::vector<float> score;         // Best class score
+    std::vector<int> classId;         // Argmax class
+
+    void clear() {
+        cx.clear(); cy.clear(); w.clear(); h.clear();
+        score.clear(); classId.clear();
+    }
+
+    void reserve(size_t n) {
+        cx.reserve(n); cy.reserve(n); w.reserve(n); h.reserve(n);
+        score.reserve(n); classId.reserve(n);
+    }
+
+    void push(float x, float y, float width, float height, float s, int c) {
+        cx.push_back(x); cy.push_back(y); w.push_back(width); h.push_back(height);
+        score.push_back(s); classId.push_back(c);
+    }
+
+    size_t size() const { return score.size(); }
+};
+
+namespace detail {
+
+// Anchors per tile: running max + argmax = 2 * 4 KB, well inside L1
+constexpr int kDecodeTile = 512;
+
+// For i in [0, n): if (row[i] > maxScore[i]) { maxScore[i] = row[i]; argmax[i] = classIndex; }
+using UpdateMaxFn = void (*)(float *maxScore, float *argmax, const float *row, float classIndex, int n);
+// Returns true if any maxScore[i] > threshold for i in [0, n)
+using AnyAboveFn = bool (*)(const float *maxScore, float threshold, int n);
+
+inline void updateMaxScalar(float *maxScore, float *argmax, const float *row, float classIndex, int n) {
+    for (int i = 0; i < n; ++i) {
+        if (row[i] > maxScore[i]) {
+            maxScore[i] = row[i];
+            argmax[i] = classIndex;
+        }
+    }
+}
+
+inline bool anyAboveScalar(const float *maxScore, float threshold, int n) {
+    for (int i = 0; i < n; ++i) {
+        if (maxScore[i] > threshold) return true;
+    }
+    return false;
+}
+
+#if defined(YOLOS_DECODE_X86)
+inline void updateMaxSSE2(float *maxScore, float *argmax, const float *row, float classIndex, int n) {
+    const __m128 vc = _mm_set1_ps(classIndex);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 v = _mm_loadu_ps(row + i);
+        const __m128 m = _mm_loadu_ps(maxScore + i);
+        const __m128 gt = _mm_cmpgt_ps(v, m);
+        _mm_storeu_ps(maxScore + i, _mm_max_ps(v, m));
+        const __m128 a = _mm_loadu_ps(argmax + i);
+        _mm_storeu_ps(argmax + i, _mm_or_ps(_mm_and_ps(gt, vc), _mm_andnot_ps(gt, a)));
+    }
+    updateMaxScalar(maxScore + i, argmax + i, row + i, classIndex, n - i);
+}
+
+inline bool anyAboveSSE2(const float *maxScore, float threshold, int n) {
+    const __m128 vt = _mm_set1_ps(threshold);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(maxScore + i), vt))) return true;
+    }
+    return anyAboveScalar(maxScore + i, threshold, n - i);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define YOLOS_DECODE_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define YOLOS_DECODE_AVX2_TARGET
+#endif
+
+#if defined(__GNUC__) || defined(__clang__) || defined(__AVX2__)
+YOLOS_DECODE_AVX2_TARGET
+inline void updateMaxAVX2(float *maxScore, float *argmax, const float *row, float classIndex, int n) {
+    const __m256 vc = _mm256_set1_ps(classIndex);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 v = _mm256_loadu_ps(row + i);
+        const __m256 m = _mm256_loadu_ps(maxScore + i);
+        const __m256 gt = _mm256_cmp_ps(v, m, _CMP_GT_OQ);
+        _mm256_storeu_ps(maxScore + i, _mm256_blendv_ps(m, v, gt));
+        _mm256_storeu_ps(argmax + i, _mm256_blendv_ps(_mm256_loadu_ps(argmax + i), vc, gt));
+    }
+    updateMaxSSE2(maxScore + i, argmax + i, row + i, classIndex, n - i);
+}
+
+YOLOS_DECODE_AVX2_TARGET
+inline bool anyAboveAVX2(const float *maxScore, float threshold, int n) {
+    const __m256 vt = _mm256_set1_ps(threshold);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(maxScore + i), vt, _CMP_GT_OQ))) return true;
+    }
+    return anyAboveSSE2(maxScore + i, threshold, n - i);
+}
+#define YOLOS_DECODE_HAS_AVX2 1
+#endif
+#endif // YOLOS_DECODE_X86
+
+#if defined(YOLOS_DECODE_NEON)
+inline void updateMaxNEON(float *maxScore, float *argmax, const float *row, float classIndex, int n) {
+    const float32x4_t vc = vdupq_n_f32(classIndex);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t v = vld1q_f32(row + i);
+        const float32x4_t m = vld1q_f32(maxScore + i);
+        const uint32x4_t gt = vcgtq_f32(v, m);
+        vst1q_f32(maxScore + i, vbslq_f32(gt, v, m));
+        vst1q_f32(argmax + i, vbslq_f32(gt, vc, vld1q_f32(argmax + i)));
+    }
+    updateMaxScalar(maxScore + i, argmax + i, row + i, classIndex, n - i);
+}
+
+inline bool anyAboveNEON(const float *maxScore, float threshold, int n) {
+    const float32x4_t vt = vdupq_n_f32(threshold);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const uint32x4_t gt = vcgtq_f32(vld1q_f32(maxScore + i), vt);
+        if (vgetq_lane_u64(vreinterpretq_u64_u32(gt), 0) | vgetq_lane_u64(vreinterpretq_u64_u32(gt), 1)) return true;
+    }
+    return anyAboveScalar(maxScore + i, threshold, n - i);
+}
+#endif
+
+struct DecodeKernels {
+    UpdateMaxFn updateMax;
+    AnyAboveFn anyAbove;
+};
+
+/**
+ * @brief Picks the widest kernels supported by the running CPU (resolved once).
+ */
+inline DecodeKernels selectDecodeKernels() {
+#if defined(YOLOS_DECODE_X86)
+#if defined(YOLOS_DECODE_HAS_AVX2)
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {updateMaxAVX2, anyAboveAVX2};
+    }
+#else
+    return {updateMaxAVX2, anyAboveAVX2};
+#endif
+#endif
+    return {updateMaxSSE2, anyAboveSSE2};
+#elif defined(YOLOS_DECODE_NEON)
+    return {updateMaxNEON, anyAboveNEON};
+#else
+    return {updateMaxScalar, anyAboveScalar};
+#endif
+}
+
+inline const DecodeKernels &decodeKernels() {
+    static const DecodeKernels kernels = selectDecodeKernels();
+    return kernels;
+}
+
+} // namespace detail
+
+/**
+ * @brief Appends every anchor whose best class score is strictly above confThreshold to out.
+ *
+ * @param output One image's output, channel-major [4 + numClasses, numAnchors]
+ *               (rows: cx, cy, w, h, class scores).
+ * @param numClasses Number of class rows.
+ * @param numAnchors Number of anchors (row length).
+ * @param confThreshold Confidence threshold.
+ * @param out Candidate buffer; not cleared, so several outputs can be accumulated.
+ */
+inline void decodeChannelMajor(const float *output, int numClasses, int numAnchors, float confThreshold,
+                               CandidateBuffer &out) {
+    if (numClasses <= 0 || numAnchors <= 0) {
+        return;
+    }
+
+    const detail::DecodeKernels &kernels = detail::decodeKernels();
+    const size_t stride = static_cast<size_t>(numAnchors);
+    const float *scores = output + 4 * stride;
+
+    alignas(32) float maxScore[detail::kDecodeTile];
+    alignas(32) float argmax[detail::kDecodeTile];
+
+    for (int a0 = 0; a0 < numAnchors; a0 += detail::kDecodeTile) {
+        const int n = std::min(detail::kDecodeTile, numAnchors - a0);
+
+        // Class 0 seeds the running max; every further class row is one contiguous sweep
+        std::copy_n(scores + a0, n, maxScore);
+        std::fill_n(argmax, n, 0.0f);
+        for (int c = 1; c < numClasses; ++c) {
+            kernels.updateMax(maxScore, argmax, scores + c * stride + a0, static_cast<float>(c), n);
+        }
+
+        // Most tiles are background: reject them without touching the box rows
+        if (!kernels.anyAbove(maxScore, confThreshold, n)) {
+            continue;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            if (maxScore[i] > confThreshold) {
+                const size_t d = static_cast<size_t>(a0 + i);
+                out.push(output[d], output[stride + d], output[2 * stride + d], output[3 * stride + d],
+                         maxScore[i], static_cast<int>(argmax[i]));
+            }
+        }
+    }
+}
+
+} // namespace yolos
+
+#endif // DECODE_HPP
@@ -0,0 +1,137 @@
+// DetectionScheduler.hpp
+#ifndef DETECTION_SCHEDULER_HPP
+#define DETECTION_SCHEDULER_HPP
+
+/**
+ * @file DetectionScheduler.hpp
+ * @brief Decides on which frames of a video stream the detector has to run.
+ *
+ * On fixed cameras most frames look like the previous one, and a tracker can carry the
+ * boxes forward for a few frames at a fraction of the cost of a network run. The scheduler
+ * asks for a detection:
+ *
+ *  - on the first frame and at least every detectEvery frames;
+ *  - when the frame differs from the last detected (key) frame by more than
+ *    motionThreshold, measured on a small grey thumbnail;
+ *  - when the caller's tracker reports an uncertainty above maxUncertainty.
+ *
+ * The comparison is against the key frame rather than the previous frame, so slow changes
+ * still add up to a detection instead of creeping under the threshold.
+ */
+
+#include <opencv2/opencv.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+namespace yolos {
+
+/**
+ * @brief Parameters of a DetectionScheduler.
+ */
+struct SchedulerOptions {
+    int detectEvery = 5;                  ///< Longest run of frames between two detections (1 = every frame)
+    float motionThreshold = 0.02f;        ///< Fraction of thumbnail pixels that changed; <= 0 disables the test
+    int pixelThreshold = 25;              ///< Grey-level difference for a thumbnail pixel to count as changed
+    float maxUncertainty = 0.25f;         ///< Tracker uncertainty forcing a detection; <= 0 disables the test
+    cv::Size thumbnailSize{160, 90};      ///< Resolution of the frame-difference test
+};
+
+/**
+ * @brief Why a frame was (or was not) sent to the detector.
+ */
+enum class ScheduleReason {
+    Skip,             ///< Tracks are propagated without running the detector
+    KeyFrame,         ///< First frame, or detectEvery frames since the last detection
+    Motion,           ///< The frame changed too much since the last detection
+    Uncertainty       ///< The tracker is no longer confident about its tracks
+};
+
+class DetectionScheduler {
+public:
+    explicit DetectionScheduler(const SchedulerOptions &options = SchedulerOptions())
+        : options(options) {
+        if (options.detectEvery < 1) {
+            throw std::invalid_argument("DetectionScheduler: detectEvery must be at least 1.");
+        }
+        if (options.thumbnailSize.width <= 0 || options.thumbnailSize.height <= 0) {
+            throw std::invalid_argument("DetectionScheduler: thumbnailSize must be positive.");
+        }
+    }
+
+    /**
+     * @brief Decides whether the detector must run on this frame.
+     *
+     * @param frame The current frame (8-bit, 1, 3 or 4 channels).
+     * @param trackerUncertainty Largest uncertainty of the tracks predicted for this frame.
+     * @return ScheduleReason Skip, or the reason a detection is needed. A detection makes
+     *         this frame the new key frame.
+     */
+    ScheduleReason schedule(const cv::Mat &frame, float trackerUncertainty = 0.0f) {
+        const bool needThumbnail = options.motionThreshold > 0.0f;
+        if (needThumbnail) {
+            makeThumbnail(frame, thumbnail);
+        }
+
+        ScheduleReason reason = ScheduleReason::Skip;
+        if (keyThumbnailEmpty || sinceDetection + 1 >= options.detectEvery) {
+            reason = ScheduleReason::KeyFrame;
+        } else if (needThumbnail && changedFraction() > options.motionThreshold) {
+            reason = ScheduleReason::Motion;
+        } else if (options.maxUncertainty > 0.0f && trackerUncertainty > options.maxUncertainty) {
+            reason = ScheduleReason::Uncertainty;
+        }
+
+        if (reason == ScheduleReason::Skip) {
+            ++sinceDetection;
+            ++skippedFrames;
+        } else {
+            sinceDetection = 0;
+            ++detectedFrames;
+            keyThumbnailEmpty = false;
+            if (needThumbnail) {
+                std::swap(thumbnail, keyThumbnail);
+            }
+        }
+        return reason;
+    }
+
+    /// Forgets the key frame, so the next frame is detected (e.g. after a scene cut or seek)
+    void reset() {
+        keyThumbnailEmpty = true;
+        sinceDetection = 0;
+    }
+
+    uint64_t detected() const { return detectedFrames; }
+    uint64_t skipped() const { return skippedFrames; }
+
+private:
+    void makeThumbnail(const cv::Mat &frame, cv::Mat &dst) {
+        cv::resize(frame, scratch, options.thumbnailSize, 0, 0, cv::INTER_AREA);
+        if (scratch.channels() == 3) {
+            cv::cvtColor(scratch, dst, cv::COLOR_BGR2GRAY);
+        } else if (scratch.channels() == 4) {
+            cv::cvtColor(scratch, dst, cv::COLOR_BGRA2GRAY);
+        } else {
+            scratch.copyTo(dst);
+        }
+    }
+
+    float changedFraction() {
+        cv::absdiff(thumbnail, keyThumbnail, difference);
+        cv::threshold(difference, difference, options.pixelThreshold, 255, cv::THRESH_BINARY);
+        return static_cast<float>(cv::countNonZero(difference)) / static_cast<float>(difference.total());
+    }
+
+    SchedulerOptions options;
+    cv::Mat thumbnail, keyThumbnail, scratch, difference;   // Reused between frames
+    bool keyThumbnailEmpty = true;
+    int sinceDetection = 0;                                 // Frames since the last detection
+    uint64_t detectedFrames = 0;
+    uint64_t skippedFrames = 0;
+};
+
+} // namespace yolos
+
+#endif // DETECTION_SCHEDULER_HPP
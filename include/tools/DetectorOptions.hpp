@@ -0,0 +1,273 @@
+// DetectorOptions.hpp
+#ifndef DETECTOR_OPTIONS_HPP
+#define DETECTOR_OPTIONS_HPP
+
+/**
+ * @file DetectorOptions.hpp
+ * @brief Execution-provider and threading configuration shared by every detector class.
+ *
+ * configureSession() turns a DetectorOptions into Ort::SessionOptions: thread counts,
+ * execution mode, spinning and affinity, graph optimization level, and the execution
+ * providers. Providers are tried in the order given; the ones missing from the ONNX
+ * Runtime build, or failing to register, are skipped with a message. ONNX Runtime
+ * assigns every node to the first registered provider that supports it, so the later
+ * entries act as fallbacks for unsupported nodes, and the CPU provider always remains
+ * as the last one.
+ *
+ * With cacheDir set, the TensorRT engine and timing caches and the OpenVINO model cache
+ * are kept there; createSession() (tools/ModelCache.hpp) adds the optimized ONNX graph
+ * when no compiling provider (TensorRT, OpenVINO, CoreML) is registered.
+ *
+ * inputBuckets restricts dynamic-shape models to a few input shapes (see YoloCore.hpp); with
+ * TensorRT they also become the engine's optimization profile, so no bucket triggers a rebuild.
+ *
+ * DetectorOptions::fromUseGPU() reproduces the settings of the bool useGPU constructors.
+ */
+
+#include <onnxruntime_cxx_api.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace yolos {
+
+enum class ExecutionProvider { CPU, CUDA, TensorRT, OpenVINO, CoreML };
+
+// Name of the provider in Ort::GetAvailableProviders()
+inline const char *providerName(ExecutionProvider provider) {
+    switch (provider) {
+        case ExecutionProvider::CUDA: return "CUDAExecutionProvider";
+        case ExecutionProvider::TensorRT: return "TensorrtExecutionProvider";
+        case ExecutionProvider::OpenVINO: return "OpenVINOExecutionProvider";
+        case ExecutionProvider::CoreML: return "CoreMLExecutionProvider";
+        case ExecutionProvider::CPU: break;
+    }
+    return "CPUExecutionProvider";
+}
+
+// True for providers whose tensors live in CUDA device memory
+inline bool isCudaProvider(ExecutionProvider provider) {
+    return provider == ExecutionProvider::CUDA || provider == ExecutionProvider::TensorRT;
+}
+
+// True for providers that compile the nodes they take into engine nodes, which ONNX Runtime
+// cannot save in an optimized model; they keep engine caches of their own instead
+inline bool isCompilingProvider(ExecutionProvider provider) {
+    return provider == ExecutionProvider::TensorRT || provider == ExecutionProvider::OpenVINO ||
+           provider == ExecutionProvider::CoreML;
+}
+
+/**
+ * @brief One input shape of a dynamic-shape model, in pixels.
+ */
+struct InputBucket {
+    int height = 0;
+    int width = 0;
+};
+
+struct DetectorOptions {
+    // Execution providers in order of preference; CPU is always appended as the last fallback
+    std::vector<ExecutionProvider> providers{ExecutionProvider::CPU};
+
+    // Threading (CPU provider)
+    int intraOpThreads = 0;                    // 0 = ONNX Runtime default (one per physical core)
+    int interOpThreads = 0;                    // Only used with parallelExecution
+    bool parallelExecution = false;            // ORT_PARALLEL: run independent graph branches concurrently
+    bool allowSpinning = true;                 // Busy-wait between ops; disable on shared hosts
+    std::string intraOpAffinity;               // "session.intra_op_thread_affinities" syntax, e.g. "1,2;3,4" (empty = none)
+    GraphOptimizationLevel optimizationLevel = GraphOptimizationLevel::ORT_ENABLE_ALL;
+
+    // GPU providers
+    int deviceId = 0;                          // CUDA / TensorRT device
+    OrtCudnnConvAlgoSearch cudnnConvAlgoSearch = OrtCudnnConvAlgoSearchExhaustive;  // cuDNN conv algorithm search
+    bool arenaGrowPowerOfTwo = true;           // CUDA arena growth: next power of two (true) or as requested (false)
+    size_t gpuMemLimit = 0;                    // CUDA arena limit in bytes (0 = no limit)
+    bool tensorrtFp16 = false;                 // Allow FP16 TensorRT kernels
+
+    // OpenVINO
+    std::string openvinoDevice = "CPU";        // "CPU", "GPU", "NPU", ...
+
+    // On-disk cache of optimized graphs and provider engines, reused across restarts (empty = off)
+    std::string cacheDir;
+
+    // Build the session from a read-only mapping of the model instead of a heap copy;
+    // ORT-format models then share their weights across processes (see ModelCache.hpp)
+    bool mapModel = false;
+
+    // Input shapes of dynamic-shape models: each frame goes to the smallest bucket holding it at
+    // full resolution (empty = the stride-32 minimal shape of every frame); ignored by static models
+    std::vector<InputBucket> inputBuckets;
+    std::string tensorrtInputName = "images";  // Input named in the TensorRT profile (the Ultralytics export name)
+    int tensorrtProfileMaxBatch = 1;           // Largest batch the TensorRT profile covers
+
+    /**
+     * @brief Buckets for the common frame shapes at a given long side: square, 4:3 and 16:9, both orientations.
+     */
+    static std::vector<InputBucket> aspectBuckets(int size = 640) {
+        auto strideUp = [](int v) { return (v + 31) / 32 * 32; };
+        const int h43 = strideUp(size * 3 / 4), h169 = strideUp(size * 9 / 16);
+        return {{size, size}, {h43, size}, {size, h43}, {h169, size}, {size, h169}};
+    }
+
+    /**
+     * @brief The settings of the bool useGPU constructors: CUDA when requested, and at most maxThreads intra-op threads.
+     */
+    static DetectorOptions fromUseGPU(bool useGPU, int maxThreads = 6) {
+        DetectorOptions options;
+        if (useGPU) {
+            options.providers = {ExecutionProvider::CUDA, ExecutionProvider::CPU};
+        }
+        options.intraOpThreads = std::min(maxThreads, static_cast<int>(std::thread::hardware_concurrency()));
+        return options;
+    }
+};
+
+namespace detail {
+
+// Registers TensorRT through the V2 options, which also cover the engine and timing caches
+inline void appendTensorRT(const DetectorOptions &options, Ort::SessionOptions &sessionOptions) {
+    std::vector<std::string> keys = {"device_id", "trt_max_partition_iterations", "trt_min_subgraph_size",
+                                     "trt_max_workspace_size", "trt_fp16_enable"};
+    std::vector<std::string> values = {std::to_string(options.deviceId), "1000", "1",
+                                       std::to_string(static_cast<size_t>(1) << 30), options.tensorrtFp16 ? "1" : "0"};
+    if (!options.cacheDir.empty()) {
+        // TensorRT names its engine files after the model and the input profile itself
+        const std::string trtCache = options.cacheDir + "/tensorrt";
+        std::error_code ec;
+        std::filesystem::create_directories(trtCache, ec);
+        keys.insert(keys.end(), {"trt_engine_cache_enable", "trt_engine_cache_path", "trt_timing_cache_enable", "trt_timing_cache_path"});
+        values.insert(values.end(), {"1", trtCache, "1", trtCache});
+    }
+    if (!options.inputBuckets.empty()) {
+        // One explicit profile spanning every bucket, tuned for the largest one
+        int minH = options.inputBuckets.front().height, minW = options.inputBuckets.front().width;
+        int maxH = minH, maxW = minW;
+        for (const InputBucket &bucket : options.inputBuckets) {
+            minH = std::min(minH, bucket.height);
+            minW = std::min(minW, bucket.width);
+            maxH = std::max(maxH, bucket.height);
+            maxW = std::max(maxW, bucket.width);
+        }
+        auto shape = [&options](int batch, int h, int w) {
+            return options.tensorrtInputName + ":" + std::to_string(batch) + "x3x" + std::to_string(h) + "x" + std::to_string(w);
+        };
+        keys.insert(keys.end(), {"trt_profile_min_shapes", "trt_profile_opt_shapes", "trt_profile_max_shapes"});
+        values.insert(values.end(), {shape(1, minH, minW), shape(1, maxH, maxW),
+                                     shape(std::max(1, options.tensorrtProfileMaxBatch), maxH, maxW)});
+    }
+    std::vector<const char *> keyPtrs, valuePtrs;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keyPtrs.push_back(keys[i].c_str());
+        valuePtrs.push_back(values[i].c_str());
+    }
+
+    const OrtApi &api = Ort::GetApi();
+    OrtTensorRTProviderOptionsV2 *trtOptions = nullptr;
+    Ort::ThrowOnError(api.CreateTensorRTProviderOptions(&trtOptions));
+    std::unique_ptr<OrtTensorRTProviderOptionsV2, decltype(api.ReleaseTensorRTProviderOptions)> holder(
+        trtOptions, api.ReleaseTensorRTProviderOptions);
+    Ort::ThrowOnError(api.UpdateTensorRTProviderOptions(trtOptions, keyPtrs.data(), valuePtrs.data(), keys.size()));
+    sessionOptions.AppendExecutionProvider_TensorRT_V2(*trtOptions);
+}
+
+} // namespace detail
+
+/**
+ * @brief Applies options to sessionOptions and registers the execution providers.
+ *
+ * @param options Detector options.
+ * @param sessionOptions Session options to configure.
+ * @param cudaStream Stream for the CUDA provider's user_compute_stream (nullptr = its own stream).
+ * @param perSessionThreads False when the session runs on a global thread pool of its Env.
+ * @return ExecutionProvider The primary (first registered) provider.
+ */
+inline ExecutionProvider configureSession(const DetectorOptions &options, Ort::SessionOptions &sessionOptions,
+                                          void *cudaStream = nullptr, bool perSessionThreads = true) {
+    if (perSessionThreads) {
+        sessionOptions.SetIntraOpNumThreads(options.intraOpThreads);
+        sessionOptions.SetInterOpNumThreads(options.interOpThreads);
+        sessionOptions.AddConfigEntry("session.intra_op.allow_spinning", options.allowSpinning ? "1" : "0");
+        sessionOptions.AddConfigEntry("session.inter_op.allow_spinning", options.allowSpinning ? "1" : "0");
+        if (!options.intraOpAffinity.empty()) {
+            sessionOptions.AddConfigEntry("session.intra_op_thread_affinities", options.intraOpAffinity.c_str());
+        }
+    } else {
+        sessionOptions.DisablePerSessionThreads();
+    }
+    sessionOptions.SetExecutionMode(options.parallelExecution ? ExecutionMode::ORT_PARALLEL : ExecutionMode::ORT_SEQUENTIAL);
+    sessionOptions.SetGraphOptimizationLevel(options.optimizationLevel);
+
+    const std::vector<std::string> available = Ort::GetAvailableProviders();
+    auto isAvailable = [&available](ExecutionProvider provider) {
+        return std::find(available.begin(), available.end(), providerName(provider)) != available.end();
+    };
+
+    ExecutionProvider primary = ExecutionProvider::CPU;
+    bool registered = false;
+    for (const ExecutionProvider provider : options.providers) {
+        if (provider == ExecutionProvider::CPU) {
+            break; // Always registered last by ONNX Runtime itself
+        }
+        if (!isAvailable(provider)) {
+            std::cout << providerName(provider) << " is not supported by your ONNXRuntime build, skipping it." << std::endl;
+            continue;
+        }
+        try {
+            switch (provider) {
+                case ExecutionProvider::TensorRT:
+                    detail::appendTensorRT(options, sessionOptions);
+                    break;
+                case ExecutionProvider::CUDA: {
+                    OrtCUDAProviderOptions cudaOptions;
+                    cudaOptions.device_id = options.deviceId;
+                    cudaOptions.cudnn_conv_algo_search = options.cudnnConvAlgoSearch;
+                    cudaOptions.arena_extend_strategy = options.arenaGrowPowerOfTwo ? 0 : 1;
+                    if (options.gpuMemLimit > 0) {
+                        cudaOptions.gpu_mem_limit = options.gpuMemLimit;
+                    }
+                    if (cudaStream) {
+                        cudaOptions.has_user_compute_stream = 1;
+                        cudaOptions.user_compute_stream = cudaStream;
+                    }
+                    sessionOptions.AppendExecutionProvider_CUDA(cudaOptions);
+                    break;
+                }
+                case ExecutionProvider::OpenVINO: {
+                    OrtOpenVINOProviderOptions openvinoOptions{};
+                    openvinoOptions.device_type = options.openvinoDevice.c_str();
+                    if (!options.cacheDir.empty()) {
+                        openvinoOptions.cache_dir = options.cacheDir.c_str();
+                    }
+                    sessionOptions.AppendExecutionProvider_OpenVINO(openvinoOptions);
+                    break;
+                }
+                case ExecutionProvider::CoreML:
+                    sessionOptions.AppendExecutionProvider("CoreML");
+                    break;
+                case ExecutionProvider::CPU:
+                    break;
+            }
+        } catch (const Ort::Exception &e) {
+            std::cout << "Failed to register " << providerName(provider) << ": " << e.what() << ", skipping it." << std::endl;
+            continue;
+        }
+        if (!registered) {
+            primary = provider;
+            registered = true;
+        }
+    }
+
+    std::cout << "Inference device: " << (primary == ExecutionProvider::CPU ? "CPU" : isCudaProvider(primary) ? "GPU" : providerName(primary))
+              << " (" << providerName(primary) << ")" << std::endl;
+    return primary;
+}
+
+} // namespace yolos
+
+#endif // DETECTOR_OPTIONS_HPP
@@ -0,0 +1,198 @@
+// FramePool.hpp
+#ifndef FRAME_POOL_HPP
+#define FRAME_POOL_HPP
+
+/**
+ * @file FramePool.hpp
+ * @brief Recycling pool of fixed-size, aligned image buffers leased through RAII handles.
+ *
+ * Capturing into a fresh cv::Mat (or clone()-ing every frame) costs an allocation, and
+ * for large frames the page faults of touching new memory, at every frame. A FramePool
+ * owns up to `capacity` 64-byte aligned buffers of one size and type. acquire() hands
+ * one out as a FrameLease whose mat() is a header over the pooled memory; destroying
+ * or reset()-ing the lease returns the buffer. Queues then only move leases, and once
+ * every buffer has been created a steady-state run allocates no frame memory at all.
+ *
+ * When all buffers are leased, acquire() blocks until one comes back, so the pool also
+ * bounds the number of frames alive at once. If a consumer creates mat() with another
+ * size or type (e.g. the camera changed resolution), OpenCV allocates that Mat itself
+ * and the pooled buffer is just returned unused.
+ *
+ * cv::Mat copies of mat() do not keep the buffer alive: do not use them after the lease
+ * is gone. The pool is thread-safe, and leases may outlive the FramePool handle.
+ */
+
+#include <opencv2/opencv.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "tools/TensorBinding.hpp"
+
+namespace yolos {
+
+namespace detail {
+
+struct FramePoolState {
+    cv::Size size;
+    int type;
+    size_t capacity;
+    size_t bytes;
+
+    std::mutex mutex;
+    std::condition_variable returned;
+    std::vector<std::unique_ptr<AlignedBuffer<unsigned char>>> buffers;   // Every buffer created so far
+    std::vector<AlignedBuffer<unsigned char> *> free;                     // Buffers not leased
+
+    FramePoolState(cv::Size size, int type, size_t capacity)
+        : size(size), type(type), capacity(capacity),
+          bytes(static_cast<size_t>(size.area()) * CV_ELEM_SIZE(type)) {
+        buffers.reserve(capacity);
+        free.reserve(capacity);
+    }
+
+    void release(AlignedBuffer<unsigned char> *buffer) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            free.push_back(buffer);
+        }
+        returned.notify_one();
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief A pooled buffer; move-only, it returns the buffer to its pool when destroyed.
+ */
+class FrameLease {
+public:
+    FrameLease() = default;
+    ~FrameLease() { reset(); }
+
+    FrameLease(const FrameLease &) = delete;
+    FrameLease &operator=(const FrameLease &) = delete;
+
+    FrameLease(FrameLease &&other) noexcept
+        : pool_(std::move(other.pool_)), buffer_(other.buffer_), mat_(std::move(other.mat_)) {
+        other.buffer_ = nullptr;
+    }
+
+    FrameLease &operator=(FrameLease &&other) noexcept {
+        if (this != &other) {
+            reset();
+            pool_ = std::move(other.pool_);
+            buffer_ = other.buffer_;
+            mat_ = std::move(other.mat_);
+            other.buffer_ = nullptr;
+        }
+        return *this;
+    }
+
+    // The image; a header over the pooled buffer
+    cv::Mat &mat() { return mat_; }
+    const cv::Mat &mat() const { return mat_; }
+
+    // False for an empty lease (default-constructed, moved from or reset)
+    explicit operator bool() const { return buffer_ != nullptr; }
+
+    /**
+     * @brief Returns the buffer to the pool now.
+     */
+    void reset() {
+        mat_.release();
+        if (buffer_) {
+            pool_->release(buffer_);
+            buffer_ = nullptr;
+        }
+        pool_.reset();
+    }
+
+private:
+    friend class FramePool;
+
+    FrameLease(std::shared_ptr<detail::FramePoolState> pool, AlignedBuffer<unsigned char> *buffer)
+        : pool_(std::move(pool)), buffer_(buffer), mat_(pool_->size, pool_->type, buffer->data()) {}
+
+    std::shared_ptr<detail::FramePoolState> pool_;
+    AlignedBuffer<unsigned char> *buffer_ = nullptr;
+    cv::Mat mat_;
+};
+
+class FramePool {
+public:
+    /**
+     * @brief Creates a pool; buffers are allocated on first use.
+     *
+     * @param size Image size of the buffers.
+     * @param type OpenCV type of the buffers (e.g. CV_8UC3 for captured frames).
+     * @param capacity Maximum number of buffers, i.e. of leases alive at once.
+     */
+    FramePool(cv::Size size, int type, size_t capacity)
+        : state(std::make_shared<detail::FramePoolState>(size, type, capacity)) {
+        if (size.empty() || capacity == 0) {
+            throw std::invalid_argument("FramePool: size and capacity must be positive.");
+        }
+    }
+
+    /**
+     * @brief Leases a buffer, blocking while all of them are leased.
+     */
+    FrameLease acquire() {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->returned.wait(lock, [this]() { return !state->free.empty() || state->buffers.size() < state->capacity; });
+        return leaseLocked();
+    }
+
+    /**
+     * @brief Leases a buffer if one is available; returns an empty lease otherwise.
+     */
+    FrameLease tryAcquire() {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        if (state->free.empty() && state->buffers.size() >= state->capacity) {
+            return FrameLease();
+        }
+        return leaseLocked();
+    }
+
+    cv::Size size() const { return state->size; }
+    int type() const { return state->type; }
+    size_t capacity() const { return state->capacity; }
+
+    // Buffers created so far; it stops growing once the pool is warm
+    size_t allocations() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->buffers.size();
+    }
+
+    // Buffers that can be leased without blocking
+    size_t available() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->free.size() + (state->capacity - state->buffers.size());
+    }
+
+private:
+    std::shared_ptr<detail::FramePoolState> state;
+
+    FrameLease leaseLocked() {
+        AlignedBuffer<unsigned char> *buffer;
+        if (!state->free.empty()) {
+            buffer = state->free.back();
+            state->free.pop_back();
+        } else {
+            state->buffers.emplace_back(new AlignedBuffer<unsigned char>());
+            buffer = state->buffers.back().get();
+            buffer->resize(state->bytes);
+        }
+        return FrameLease(state, buffer);
+    }
+};
+
+} // namespace yolos
+
+#endif // FRAME_POOL_HPP
@@ -0,0 +1,208 @@
+// Half.hpp
+#ifndef HALF_HPP
+#define HALF_HPP
+
+/**
+ * @file Half.hpp
+ * @brief IEEE 754 binary16 <-> float conversion for FP16 model inputs and outputs.
+ *
+ * Half values are stored as raw uint16_t bit patterns, which is what ONNX Runtime expects
+ * behind an ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16 tensor. The row converters use F16C
+ * (runtime-dispatched on x86) or the AArch64 NEON conversions, with a scalar fallback;
+ * all of them round to nearest even, so every path produces the same bits.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define YOLOS_HALF_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define YOLOS_HALF_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace yolos {
+
+/**
+ * @brief Converts a float to binary16 (round to nearest even; overflow gives infinity).
+ */
+inline uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t magnitude = bits & 0x7fffffffu;
+
+    if (magnitude >= 0x7f800000u) {
+        // Infinity stays infinity, NaN stays a (quiet) NaN
+        return static_cast<uint16_t>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x0200u | ((magnitude >> 13) & 0x03ffu) : 0u));
+    }
+    if (magnitude >= 0x477ff000u) {
+        // 65520 and above round to infinity
+        return static_cast<uint16_t>(sign | 0x7c00u);
+    }
+    if (magnitude < 0x38800000u) {
+        // Subnormal half (below 2^-14): adding 0.5 lets the FPU round the mantissa at 2^-24
+        float f;
+        std::memcpy(&f, &magnitude, sizeof f);
+        f += 0.5f;
+        std::memcpy(&magnitude, &f, sizeof f);
+        return static_cast<uint16_t>(sign | (magnitude - 0x3f000000u));
+    }
+    // Normal: rebias the exponent (127 -> 15) and round the 13 dropped mantissa bits to nearest even
+    const uint32_t odd = (magnitude >> 13) & 1u;
+    magnitude += 0xc8000fffu + odd;
+    return static_cast<uint16_t>(sign | (magnitude >> 13));
+}
+
+/**
+ * @brief Converts a binary16 value to float (exact).
+ */
+inline float halfToFloat(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1fu;
+    const uint32_t mantissa = half & 0x03ffu;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Subnormal: mantissa * 2^-24 is exact in float
+            const float f = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+            std::memcpy(&bits, &f, sizeof bits);
+            bits |= sign;
+        }
+    } else if (exponent == 0x1f) {
+        bits = sign | 0x7f800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof value);
+    return value;
+}
+
+namespace detail {
+
+using FloatToHalfRowFn = void (*)(const float *src, uint16_t *dst, size_t n);
+using HalfToFloatRowFn = void (*)(const uint16_t *src, float *dst, size_t n);
+
+inline void floatToHalfRowScalar(const float *src, uint16_t *dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = floatToHalf(src[i]);
+    }
+}
+
+inline void halfToFloatRowScalar(const uint16_t *src, float *dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = halfToFloat(src[i]);
+    }
+}
+
+#if defined(YOLOS_HALF_X86) && (defined(__GNUC__) || defined(__clang__) || defined(__F16C__) || defined(__AVX2__))
+#define YOLOS_HALF_F16C 1
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx,f16c")))
+#endif
+inline void floatToHalfRowF16C(const float *src, uint16_t *dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), h);
+    }
+    floatToHalfRowScalar(src + i, dst + i, n - i);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx,f16c")))
+#endif
+inline void halfToFloatRowF16C(const uint16_t *src, float *dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+    halfToFloatRowScalar(src + i, dst + i, n - i);
+}
+#endif
+
+#if defined(YOLOS_HALF_NEON)
+inline void floatToHalfRowNEON(const float *src, uint16_t *dst, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+    }
+    floatToHalfRowScalar(src + i, dst + i, n - i);
+}
+
+inline void halfToFloatRowNEON(const uint16_t *src, float *dst, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+    }
+    halfToFloatRowScalar(src + i, dst + i, n - i);
+}
+#endif
+
+/**
+ * @brief Picks the hardware conversion supported by the running CPU (resolved once).
+ */
+inline bool hasHardwareHalf() {
+#if defined(YOLOS_HALF_F16C)
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#else
+    return true;
+#endif
+#elif defined(YOLOS_HALF_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline FloatToHalfRowFn floatToHalfRow() {
+#if defined(YOLOS_HALF_F16C)
+    static const FloatToHalfRowFn fn = hasHardwareHalf() ? floatToHalfRowF16C : floatToHalfRowScalar;
+#elif defined(YOLOS_HALF_NEON)
+    static const FloatToHalfRowFn fn = floatToHalfRowNEON;
+#else
+    static const FloatToHalfRowFn fn = floatToHalfRowScalar;
+#endif
+    return fn;
+}
+
+inline HalfToFloatRowFn halfToFloatRow() {
+#if defined(YOLOS_HALF_F16C)
+    static const HalfToFloatRowFn fn = hasHardwareHalf() ? halfToFloatRowF16C : halfToFloatRowScalar;
+#elif defined(YOLOS_HALF_NEON)
+    static const HalfToFloatRowFn fn = halfToFloatRowNEON;
+#else
+    static const HalfToFloatRowFn fn = halfToFloatRowScalar;
+#endif
+    return fn;
+}
+
+} // namespace detail
+
+/**
+ * @brief Converts n floats to binary16.
+ */
+inline void floatToHalf(const float *src, uint16_t *dst, size_t n) {
+    detail::floatToHalfRow()(src, dst, n);
+}
+
+/**
+ * @brief Converts n binary16 values to floats.
+ */
+inline void halfToFloat(const uint16_t *src, float *dst, size_t n) {
+    detail::halfToFloatRow()(src, dst, n);
+}
+
+} // namespace yolos
+
+#endif // HALF_HPP
@@ -0,0 +1,395 @@
+// Instrumentation.hpp
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+/**
+ * @file Instrumentation.hpp
+ * @brief Runtime-toggleable stage metrics, Chrome trace events and a Prometheus text exporter.
+ *
+ * Every ScopedTimer (tools/ScopedTimer.hpp) in the detectors reports here. While
+ * instrumentation is disabled, a timer is one relaxed atomic load and a branch: no clock
+ * read, no allocation and no output. Once enabled, each scope adds its duration to a
+ * histogram owned by the calling thread: count, sum, max and fixed buckets from 50 us to
+ * 10 s, stored in atomics that only the owner writes (plain loads and stores, no locked
+ * instructions). Exporters add up the per-thread values by stage name. The first scope a
+ * thread records, and its first scope of each stage name, take the registry mutex to claim
+ * a thread state or look up the stage id (which exporters also hold while they read); after
+ * that the thread's hot path is lock-free, so a steady-state detector is never blocked by
+ * exporting from another thread.
+ *
+ * While a trace is running (startTrace() .. stopTrace()), each scope is also appended as
+ * a complete event to a fixed-size per-thread buffer; writeChromeTrace() emits them in the
+ * Chrome trace event format, which chrome://tracing and ui.perfetto.dev open directly.
+ * Events that do not fit in a thread's buffer are dropped and counted.
+ *
+ * Instrumentation starts enabled when TIMING_MODE is defined (tools/Config.hpp) or when
+ * the YOLOS_INSTRUMENTATION environment variable is set to anything but "0"; setEnabled()
+ * switches it at any time.
+ *
+ * Stage names must be string literals or otherwise outlive the process's use of them;
+ * at most kMaxStages distinct names are kept, later ones are counted under "other".
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "tools/Config.hpp"
+
+namespace yolos {
+namespace instrumentation {
+
+constexpr size_t kMaxStages = 64;
+constexpr size_t kTraceCapacity = size_t(1) << 16;    // Trace events per thread and trace
+
+// Upper bounds of the histogram buckets in nanoseconds; a last bucket takes everything above
+constexpr uint64_t kBucketBoundsNs[] = {
+    50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000, 25000000,
+    50000000, 100000000, 250000000, 500000000, 1000000000, 2500000000, 5000000000, 10000000000};
+constexpr size_t kBucketCount = sizeof(kBucketBoundsNs) / sizeof(kBucketBoundsNs[0]) + 1;
+
+/**
+ * @brief Totals of one stage over all threads.
+ */
+struct StageStats {
+    std::string name;
+    uint64_t count = 0;
+    double sumMs = 0.0;
+    double maxMs = 0.0;
+    uint64_t buckets[kBucketCount] = {};   // Non-cumulative counts per bucket
+
+    double meanMs() const { return count ? sumMs / static_cast<double>(count) : 0.0; }
+};
+
+namespace detail {
+
+inline uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Single-writer increment: only the owning thread updates its counters
+inline void bump(std::atomic<uint64_t> &value, uint64_t by = 1) {
+    value.store(value.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+struct StageCounters {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sumNs{0};
+    std::atomic<uint64_t> maxNs{0};
+    std::atomic<uint64_t> buckets[kBucketCount] = {};
+};
+
+struct TraceEvent {
+    uint64_t startNs;
+    uint64_t durationNs;
+    uint32_t stage;
+};
+
+struct ThreadState {
+    uint32_t tid = 0;
+    std::atomic<bool> inUse{true};
+    StageCounters stages[kMaxStages];
+
+    // Owner-only cache from name pointers to stage ids (the same literal may have several addresses)
+    std::vector<std::pair<const char *, uint32_t>> stageCache;
+
+    // Trace buffer of the current trace; traceEpoch is published after the buffer is reset
+    std::unique_ptr<TraceEvent[]> trace;
+    std::atomic<size_t> traceSize{0};
+    std::atomic<uint64_t> traceEpoch{0};
+    std::atomic<uint64_t> traceDropped{0};
+};
+
+// 0 = not initialized yet, 1 = disabled, 2 = enabled
+inline std::atomic<int> &enabledState() {
+    static std::atomic<int> state{0};    // Constant-initialized: no guard on access
+    return state;
+}
+
+class Registry {
+public:
+    std::mutex mutex;
+    std::vector<std::string> stageNames;                  // Indexed by stage id
+    std::vector<std::unique_ptr<ThreadState>> threads;    // Never shrinks; states are reused
+    std::atomic<bool> tracing{false};
+    std::atomic<uint64_t> traceEpoch{0};                  // Incremented by every startTrace()
+    std::atomic<uint64_t> traceOriginNs{0};
+
+    uint32_t stageId(const char *name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < stageNames.size(); ++i) {
+            if (stageNames[i] == name) return static_cast<uint32_t>(i);
+        }
+        if (stageNames.size() + 1 < kMaxStages) {
+            stageNames.emplace_back(name);
+            return static_cast<uint32_t>(stageNames.size() - 1);
+        }
+        if (stageNames.size() + 1 == kMaxStages) {
+            stageNames.emplace_back("other");
+        }
+        return static_cast<uint32_t>(kMaxStages - 1);
+    }
+
+    ThreadState *acquireThread() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto &state : threads) {
+            bool idle = false;
+            if (state->inUse.compare_exchange_strong(idle, true, std::memory_order_acquire)) return state.get();
+        }
+        threads.emplace_back(new ThreadState());
+        threads.back()->tid = static_cast<uint32_t>(threads.size());
+        return threads.back().get();
+    }
+};
+
+inline Registry &registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Hands the thread's state back to the registry when the thread exits; the counts stay
+struct ThreadHandle {
+    ThreadState *state = nullptr;
+    ~ThreadHandle() {
+        if (state) state->inUse.store(false, std::memory_order_release);
+    }
+};
+
+inline ThreadState &threadState() {
+    thread_local ThreadHandle handle;
+    if (!handle.state) handle.state = registry().acquireThread();
+    return *handle.state;
+}
+
+inline int initEnabledState() {
+#ifdef TIMING_MODE
+    bool enable = true;
+#else
+    bool enable = false;
+#endif
+    if (const char *env = std::getenv("YOLOS_INSTRUMENTATION")) {
+        enable = std::strcmp(env, "0") != 0;
+    }
+    int expected = 0;
+    enabledState().compare_exchange_strong(expected, enable ? 2 : 1, std::memory_order_relaxed);
+    return enabledState().load(std::memory_order_relaxed);
+}
+
+inline void appendTraceEvent(ThreadState &state, uint32_t stage, uint64_t startNs, uint64_t durationNs) {
+    Registry &reg = registry();
+    const uint64_t epoch = reg.traceEpoch.load(std::memory_order_acquire);
+    if (state.traceEpoch.load(std::memory_order_relaxed) != epoch) {
+        // First event of this thread in a new trace
+        if (!state.trace) state.trace.reset(new TraceEvent[kTraceCapacity]);
+        state.traceSize.store(0, std::memory_order_relaxed);
+        state.traceDropped.store(0, std::memory_order_relaxed);
+        state.traceEpoch.store(epoch, std::memory_order_release);
+    }
+    const size_t size = state.traceSize.load(std::memory_order_relaxed);
+    if (size >= kTraceCapacity) {
+        bump(state.traceDropped);
+        return;
+    }
+    state.trace[size] = TraceEvent{startNs, durationNs, stage};
+    state.traceSize.store(size + 1, std::memory_order_release);
+}
+
+inline void record(const char *name, uint64_t startNs, uint64_t endNs) {
+    ThreadState &state = threadState();
+    uint32_t stage = kMaxStages;
+    for (const auto &entry : state.stageCache) {
+        if (entry.first == name) {
+            stage = entry.second;
+            break;
+        }
+    }
+    if (stage == kMaxStages) {
+        stage = registry().stageId(name);
+        state.stageCache.emplace_back(name, stage);
+    }
+
+    const uint64_t duration = endNs > startNs ? endNs - startNs : 0;
+    StageCounters &counters = state.stages[stage];
+    bump(counters.count);
+    bump(counters.sumNs, duration);
+    if (duration > counters.maxNs.load(std::memory_order_relaxed)) {
+        counters.maxNs.store(duration, std::memory_order_relaxed);
+    }
+    size_t bucket = 0;
+    while (bucket + 1 < kBucketCount && duration > kBucketBoundsNs[bucket]) ++bucket;
+    bump(counters.buckets[bucket]);
+
+    if (registry().tracing.load(std::memory_order_relaxed)) {
+        appendTraceEvent(state, stage, startNs, duration);
+    }
+}
+
+inline std::string escapeLabel(const std::string &text, bool json) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else if (json && static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof escaped, "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+} // namespace detail
+
+/**
+ * @brief True while stage timers record; the only cost of a timer when false.
+ */
+inline bool enabled() {
+    int state = detail::enabledState().load(std::memory_order_relaxed);
+    if (state == 0) state = detail::initEnabledState();
+    return state == 2;
+}
+
+inline void setEnabled(bool enable) {
+    detail::enabledState().store(enable ? 2 : 1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Adds one measured scope to the calling thread's counters (and to the trace, if running).
+ *        ScopedTimer calls this; use it directly for spans that are not a C++ scope.
+ */
+inline void recordScope(const char *name, uint64_t startNs, uint64_t endNs) {
+    detail::record(name, startNs, endNs);
+}
+
+// Timestamp for recordScope(), in steady-clock nanoseconds
+inline uint64_t now() { return detail::nowNs(); }
+
+/**
+ * @brief Totals of every stage seen so far, summed over all threads.
+ *        Values are read without stopping the recording threads.
+ */
+inline std::vector<StageStats> snapshot() {
+    detail::Registry &reg = detail::registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::vector<StageStats> stats(reg.stageNames.size());
+    for (size_t s = 0; s < stats.size(); ++s) {
+        stats[s].name = reg.stageNames[s];
+        uint64_t sumNs = 0, maxNs = 0;
+        for (const auto &thread : reg.threads) {
+            const detail::StageCounters &counters = thread->stages[s];
+            stats[s].count += counters.count.load(std::memory_order_relaxed);
+            sumNs += counters.sumNs.load(std::memory_order_relaxed);
+            maxNs = std::max(maxNs, counters.maxNs.load(std::memory_order_relaxed));
+            for (size_t b = 0; b < kBucketCount; ++b) {
+                stats[s].buckets[b] += counters.buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+        stats[s].sumMs = static_cast<double>(sumNs) / 1e6;
+        stats[s].maxMs = static_cast<double>(maxNs) / 1e6;
+    }
+    return stats;
+}
+
+/**
+ * @brief Writes every stage as a Prometheus histogram (text exposition format, seconds).
+ *
+ * @param prefix Metric name prefix; the histogram is <prefix>_stage_duration_seconds.
+ */
+inline void writePrometheus(std::ostream &out, const std::string &prefix = "yolos") {
+    const std::string metric = prefix + "_stage_duration_seconds";
+    out << "# HELP " << metric << " Wall-clock time of instrumented detector stages.\n"
+        << "# TYPE " << metric << " histogram\n";
+    for (const StageStats &stage : snapshot()) {
+        const std::string label = "stage=\"" + detail::escapeLabel(stage.name, false) + "\"";
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b < kBucketCount; ++b) {
+            cumulative += stage.buckets[b];
+            out << metric << "_bucket{" << label << ",le=\"";
+            if (b + 1 < kBucketCount) out << static_cast<double>(kBucketBoundsNs[b]) / 1e9;
+            else out << "+Inf";
+            out << "\"} " << cumulative << "\n";
+        }
+        out << metric << "_sum{" << label << "} " << std::setprecision(9) << stage.sumMs / 1e3 << "\n"
+            << metric << "_count{" << label << "} " << stage.count << "\n";
+    }
+}
+
+/**
+ * @brief Starts a new trace (and enables instrumentation); events of a previous trace are discarded.
+ */
+inline void startTrace() {
+    detail::Registry &reg = detail::registry();
+    reg.traceOriginNs.store(detail::nowNs(), std::memory_order_relaxed);
+    reg.traceEpoch.fetch_add(1, std::memory_order_release);
+    reg.tracing.store(true, std::memory_order_relaxed);
+    setEnabled(true);
+}
+
+// Stops adding events; the trace can still be written
+inline void stopTrace() {
+    detail::registry().tracing.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Writes the events of the current trace in the Chrome trace event format (JSON).
+ *        Call it after stopTrace(), and not concurrently with startTrace().
+ *
+ * @return Number of events that were dropped because a thread's buffer was full.
+ */
+inline uint64_t writeChromeTrace(std::ostream &out) {
+    detail::Registry &reg = detail::registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    const uint64_t epoch = reg.traceEpoch.load(std::memory_order_acquire);
+    const uint64_t origin = reg.traceOriginNs.load(std::memory_order_relaxed);
+    uint64_t dropped = 0;
+    bool first = true;
+
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n" << std::fixed << std::setprecision(3);
+    for (const auto &thread : reg.threads) {
+        if (epoch == 0 || thread->traceEpoch.load(std::memory_order_acquire) != epoch) continue;
+        const size_t size = thread->traceSize.load(std::memory_order_acquire);
+        dropped += thread->traceDropped.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < size; ++i) {
+            const detail::TraceEvent &event = thread->trace[i];
+            const double ts = event.startNs > origin ? static_cast<double>(event.startNs - origin) / 1e3 : 0.0;
+            out << (first ? "" : ",\n") << "{\"name\": \"" << detail::escapeLabel(reg.stageNames[event.stage], true)
+                << "\", \"cat\": \"yolos\", \"ph\": \"X\", \"ts\": " << ts
+                << ", \"dur\": " << static_cast<double>(event.durationNs) / 1e3
+                << ", \"pid\": 1, \"tid\": " << thread->tid << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return dropped;
+}
+
+inline uint64_t writeChromeTrace(const std::string &path) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open trace file: " + path);
+    }
+    return writeChromeTrace(out);
+}
+
+} // namespace instrumentation
+} // namespace yolos
+
+#endif // INSTRUMENTATION_HPP
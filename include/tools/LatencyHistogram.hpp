@@ -0,0 +1,176 @@
+// LatencyHistogram.hpp
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+/**
+ * @file LatencyHistogram.hpp
+ * @brief High-dynamic-range latency histogram with bounded relative error.
+ *
+ * Averages and min/max hide the tail that latency budgets are about, and keeping every
+ * sample to sort it later grows without bound on long runs. LatencyHistogram uses the
+ * HdrHistogram bucket layout: values are kept in microseconds, in buckets whose width
+ * doubles every power of two, each split into enough linear sub-buckets that any value
+ * is reported within 10^-significantDigits of its true value. Recording is a couple of
+ * shifts and an increment, memory is fixed (under 200 KB for 1 us .. 1 h at 3 digits),
+ * and histograms of several runs or threads merge by adding their counts.
+ *
+ * A histogram is not thread-safe; record into one per thread and merge() them.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace yolos {
+
+class LatencyHistogram {
+public:
+    /**
+     * @param highestUs Largest trackable value in microseconds; larger values are clamped.
+     * @param significantDigits Decimal digits of precision (1 to 5).
+     */
+    explicit LatencyHistogram(int64_t highestUs = 3600LL * 1000 * 1000, int significantDigits = 3) : highest(highestUs) {
+        if (significantDigits < 1 || significantDigits > 5 || highestUs < 2) {
+            throw std::invalid_argument("LatencyHistogram: need 1 to 5 significant digits and a highest value >= 2.");
+        }
+        const int64_t singleUnitRange = 2 * static_cast<int64_t>(std::pow(10.0, significantDigits));
+        const int subBucketCountMagnitude = static_cast<int>(std::ceil(std::log2(static_cast<double>(singleUnitRange))));
+        subBucketHalfCountMagnitude = std::max(subBucketCountMagnitude, 1) - 1;
+        subBucketCount = int64_t(1) << (subBucketHalfCountMagnitude + 1);
+        subBucketHalfCount = subBucketCount / 2;
+        subBucketMask = subBucketCount - 1;
+
+        int64_t smallestUntrackable = subBucketCount;
+        int bucketCount = 1;
+        while (smallestUntrackable <= highestUs) {
+            if (smallestUntrackable > std::numeric_limits<int64_t>::max() / 2) {
+                ++bucketCount;
+                break;
+            }
+            smallestUntrackable <<= 1;
+            ++bucketCount;
+        }
+        counts.assign(static_cast<size_t>(bucketCount + 1) * static_cast<size_t>(subBucketHalfCount), 0);
+    }
+
+    // Records a value in microseconds (negative values count as 0)
+    void record(int64_t valueUs) {
+        const int64_t value = std::min(std::max<int64_t>(valueUs, 0), highest);
+        ++counts[countsIndex(value)];
+        ++total;
+        sum += static_cast<double>(value);
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+
+    // Records a value in milliseconds
+    void recordMs(double ms) { record(static_cast<int64_t>(std::llround(ms * 1000.0))); }
+
+    /**
+     * @brief Adds the counts of another histogram with the same layout.
+     */
+    void merge(const LatencyHistogram &other) {
+        if (other.counts.size() != counts.size() || other.subBucketCount != subBucketCount) {
+            throw std::invalid_argument("LatencyHistogram: cannot merge histograms with different layouts.");
+        }
+        for (size_t i = 0; i < counts.size(); ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sum += other.sum;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+
+    void reset() {
+        std::fill(counts.begin(), counts.end(), 0);
+        total = 0;
+        sum = 0.0;
+        minValue = std::numeric_limits<int64_t>::max();
+        maxValue = 0;
+    }
+
+    int64_t count() const { return total; }
+    double meanMs() const { return total ? sum / static_cast<double>(total) / 1000.0 : 0.0; }
+    double minMs() const { return total ? static_cast<double>(minValue) / 1000.0 : 0.0; }
+    double maxMs() const { return static_cast<double>(maxValue) / 1000.0; }
+
+    /**
+     * @brief Value at a percentile (0-100) in milliseconds: the highest value equivalent to
+     *        the sample of that rank, as in HdrHistogram.
+     */
+    double percentileMs(double percentile) const {
+        if (total == 0) {
+            return 0.0;
+        }
+        const double p = std::min(std::max(percentile, 0.0), 100.0);
+        const int64_t rank = std::max<int64_t>(1, static_cast<int64_t>(p / 100.0 * static_cast<double>(total) + 0.5));
+        int64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                const int64_t value = std::min(highestEquivalentValue(valueFromIndex(static_cast<int64_t>(i))), maxValue);
+                return static_cast<double>(value) / 1000.0;
+            }
+        }
+        return maxMs();
+    }
+
+private:
+    int64_t highest;
+    int subBucketHalfCountMagnitude = 0;
+    int64_t subBucketCount = 0;
+    int64_t subBucketHalfCount = 0;
+    int64_t subBucketMask = 0;
+    std::vector<int64_t> counts;
+
+    int64_t total = 0;
+    double sum = 0.0;
+    int64_t minValue = std::numeric_limits<int64_t>::max();
+    int64_t maxValue = 0;
+
+    // Position of the highest set bit plus one (0 for 0)
+    static int bitLength(uint64_t value) {
+        int bits = 0;
+        while (value) {
+            value >>= 1;
+            ++bits;
+        }
+        return bits;
+    }
+
+    int bucketIndex(int64_t value) const {
+        return bitLength(static_cast<uint64_t>(value | subBucketMask)) - (subBucketHalfCountMagnitude + 1);
+    }
+
+    size_t countsIndex(int64_t value) const {
+        const int bucket = bucketIndex(value);
+        const int64_t subBucket = value >> bucket;
+        return static_cast<size_t>(((static_cast<int64_t>(bucket) + 1) << subBucketHalfCountMagnitude) + (subBucket - subBucketHalfCount));
+    }
+
+    int64_t valueFromIndex(int64_t index) const {
+        int64_t bucket = (index >> subBucketHalfCountMagnitude) - 1;
+        int64_t subBucket = (index & (subBucketHalfCount - 1)) + subBucketHalfCount;
+        if (bucket < 0) {
+            subBucket -= subBucketHalfCount;
+            bucket = 0;
+        }
+        return subBucket << bucket;
+    }
+
+    int64_t highestEquivalentValue(int64_t value) const {
+        const int bucket = bucketIndex(value);
+        const int64_t subBucket = value >> bucket;
+        const int adjustedBucket = subBucket >= subBucketCount ? bucket + 1 : bucket;
+        const int64_t lowest = subBucket << bucket;
+        return lowest + (int64_t(1) << adjustedBucket) - 1;
+    }
+};
+
+} // namespace yolos
+
+#endif // LATENCY_HISTOGRAM_HPP
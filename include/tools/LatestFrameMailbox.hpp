@@ -0,0 +1,115 @@
+// LatestFrameMailbox.hpp
+#ifndef LATEST_FRAME_MAILBOX_HPP
+#define LATEST_FRAME_MAILBOX_HPP
+
+/**
+ * @file LatestFrameMailbox.hpp
+ * @brief Single-producer, single-consumer "latest value wins" mailbox.
+ *
+ * A bounded queue between a camera and a slower detector fills up, and from then on
+ * every frame waits behind the whole queue before it is processed. The mailbox keeps
+ * only the newest item instead: publishing overwrites an item the consumer has not
+ * taken yet (counted as dropped), so the consumer always gets the freshest frame and
+ * the capture thread never blocks.
+ *
+ * It is a triple buffer: the producer fills its own slot and swaps it with the shared
+ * middle slot in one atomic exchange, and the consumer swaps the middle slot with its
+ * own, so the hand-off is lock-free and moves items without copying or allocating.
+ * A condition variable is only used to let an idle consumer sleep until the next item.
+ *
+ * Exactly one thread may publish and one thread may consume.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+template <typename T>
+class LatestFrameMailbox {
+public:
+    LatestFrameMailbox() = default;
+
+    LatestFrameMailbox(const LatestFrameMailbox &) = delete;
+    LatestFrameMailbox &operator=(const LatestFrameMailbox &) = delete;
+
+    /**
+     * @brief Publishes an item, replacing the previous one if it was not consumed yet. Never blocks.
+     */
+    void publish(T item) {
+        slots[back] = std::move(item);
+        const uint8_t previous = middle.exchange(static_cast<uint8_t>(back | kFresh), std::memory_order_acq_rel);
+        back = previous & kIndexMask;
+        ++publishedCount;
+        if (previous & kFresh) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        wake();
+    }
+
+    /**
+     * @brief Takes the newest item, waiting for one to be published.
+     *
+     * @return false once the mailbox is closed and the last item has been taken.
+     */
+    bool consume(T &item) {
+        if (!(middle.load(std::memory_order_acquire) & kFresh)) {
+            std::unique_lock<std::mutex> lock(waitMutex);
+            itemAvailable.wait(lock, [this]() { return (middle.load(std::memory_order_acquire) & kFresh) || closed.load(); });
+        }
+        return tryConsume(item);
+    }
+
+    /**
+     * @brief Takes the newest item if one was published since the last call; never blocks.
+     */
+    bool tryConsume(T &item) {
+        if (!(middle.load(std::memory_order_acquire) & kFresh)) {
+            return false;
+        }
+        const uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & kIndexMask;
+        item = std::move(slots[front]);
+        return true;
+    }
+
+    /**
+     * @brief Wakes the consumer for good; an item published before is still delivered.
+     */
+    void close() {
+        closed = true;
+        wake();
+    }
+
+    // Items published so far
+    uint64_t published() const { return publishedCount.load(std::memory_order_relaxed); }
+
+    // Items overwritten before the consumer took them
+    uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;         // The middle slot holds an item not consumed yet
+
+    T slots[3];
+    uint8_t back = 0;                              // Producer's slot
+    std::atomic<uint8_t> middle{1};                // Shared slot index, with the kFresh flag
+    uint8_t front = 2;                             // Consumer's slot
+
+    std::atomic<uint64_t> publishedCount{0};
+    std::atomic<uint64_t> droppedCount{0};
+    std::atomic<bool> closed{false};
+
+    std::mutex waitMutex;
+    std::condition_variable itemAvailable;
+
+    void wake() {
+        {
+            std::lock_guard<std::mutex> lock(waitMutex); // Orders the update with a consumer about to sleep
+        }
+        itemAvailable.notify_one();
+    }
+};
+
+#endif // LATEST_FRAME_MAILBOX_HPP
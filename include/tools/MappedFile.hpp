@@ -0,0 +1,104 @@
+// MappedFile.hpp
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+/**
+ * @file MappedFile.hpp
+ * @brief Read-only memory mapping of a file.
+ *
+ * The mapping is shared (MAP_SHARED / a file-backed section), so every process mapping the
+ * same model reads the same page-cache pages instead of holding a private heap copy.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace yolos {
+
+class MappedFile {
+public:
+    /**
+     * @brief Maps path read-only; throws std::runtime_error on failure.
+     */
+    explicit MappedFile(const std::string &path) {
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open file for mapping: " + path);
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+            CloseHandle(file_);
+            throw std::runtime_error("Cannot map empty or unreadable file: " + path);
+        }
+        size_ = static_cast<size_t>(size.QuadPart);
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        data_ = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!data_) {
+            if (mapping_) CloseHandle(mapping_);
+            CloseHandle(file_);
+            throw std::runtime_error("Cannot map file: " + path);
+        }
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file for mapping: " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map empty or unreadable file: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void *data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // The mapping keeps the file referenced
+        if (data == MAP_FAILED) {
+            throw std::runtime_error("Cannot map file: " + path);
+        }
+        data_ = data;
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        CloseHandle(file_);
+#else
+        ::munmap(data_, size_);
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const void *data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void *data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+} // namespace yolos
+
+#endif // MAPPED_FILE_HPP
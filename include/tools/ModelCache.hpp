@@ -0,0 +1,214 @@
+// ModelCache.hpp
+#ifndef MODEL_CACHE_HPP
+#define MODEL_CACHE_HPP
+
+/**
+ * @file ModelCache.hpp
+ * @brief Session creation with an on-disk cache of the optimized graph.
+ *
+ * Creating a session parses the model and runs every graph optimization (constant
+ * folding, fusions, layout transforms) before the first inference, on every start.
+ * With DetectorOptions::cacheDir set, createSession() saves the optimized graph on the
+ * first run and later loads it with optimizations disabled, skipping that work.
+ *
+ * Cache entries are keyed by a hash of the model bytes (which covers static input shapes),
+ * the primary execution provider, the optimization level and the ONNX Runtime API version,
+ * since ORT_ENABLE_ALL graphs contain provider- and host-specific nodes. They are written
+ * under a temporary name and renamed into place, so a crash never leaves a truncated entry,
+ * and an entry that fails to load is deleted and rebuilt.
+ *
+ * Sessions with a compiling provider registered anywhere in DetectorOptions::providers
+ * (TensorRT, OpenVINO, CoreML) are not saved this way, since ONNX Runtime refuses to save a
+ * graph with compiled nodes; the TensorRT engine and OpenVINO model caches are configured by
+ * configureSession() instead.
+ *
+ * With DetectorOptions::mapModel the model is memory-mapped read-only and the session is
+ * built from the mapped bytes instead of a private heap copy of the file. For ORT-format
+ * models (.ort) the session also keeps its initializers in the mapping, so processes
+ * serving the same model share one copy of the weights through the page cache; with the
+ * cache enabled, the optimized graph is then saved in ORT format to get there. The
+ * mapping is returned through a ModelMapping that must outlive the session.
+ */
+
+#include <onnxruntime_cxx_api.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "tools/DetectorOptions.hpp"
+#include "tools/MappedFile.hpp"
+
+namespace yolos {
+
+// Keeps a memory-mapped model alive; declare it before the session that uses it
+using ModelMapping = std::shared_ptr<const MappedFile>;
+
+namespace detail {
+
+// 64-bit content hash of a file, word at a time (identifies the model, not a security measure)
+inline uint64_t hashFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open model file: " + path);
+    }
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    std::vector<char> buffer(1 << 20);
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const size_t n = static_cast<size_t>(file.gcount());
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, buffer.data() + i, 8);
+            hash = (hash ^ word) * 0x100000001b3ULL;
+            hash ^= hash >> 29;
+        }
+        for (; i < n; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(buffer[i])) * 0x100000001b3ULL;
+        }
+    }
+    return hash;
+}
+
+// ORT-format models are flatbuffers with the "ORTM" file identifier
+inline bool isOrtFormat(const MappedFile &file) {
+    return file.size() >= 8 && std::memcmp(static_cast<const char *>(file.data()) + 4, "ORTM", 4) == 0;
+}
+
+inline Ort::Session openSession(const Ort::Env &env, const std::string &modelPath, Ort::SessionOptions &sessionOptions,
+                                OrtPrepackedWeightsContainer *prepackedWeights, bool mapModel, ModelMapping *mapping) {
+    if (mapModel) {
+        auto file = std::make_shared<const MappedFile>(modelPath);
+        if (isOrtFormat(*file)) {
+            // Run straight from the mapping: no copy of the graph or of the initializers
+            sessionOptions.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+            sessionOptions.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+        }
+        Ort::Session session = prepackedWeights
+            ? Ort::Session(env, file->data(), file->size(), sessionOptions, prepackedWeights)
+            : Ort::Session(env, file->data(), file->size(), sessionOptions);
+        if (mapping) {
+            *mapping = std::move(file);
+        }
+        return session;
+    }
+
+#ifdef _WIN32
+    const std::wstring path(modelPath.begin(), modelPath.end());
+#else
+    const std::string &path = modelPath;
+#endif
+    if (prepackedWeights) {
+        return Ort::Session(env, path.c_str(), sessionOptions, prepackedWeights);
+    }
+    return Ort::Session(env, path.c_str(), sessionOptions);
+}
+
+// True if configureSession() registers a provider compiling its nodes, primary or fallback
+inline bool hasCompilingProvider(const DetectorOptions &options) {
+    const std::vector<std::string> available = Ort::GetAvailableProviders();
+    for (const ExecutionProvider provider : options.providers) {
+        if (provider == ExecutionProvider::CPU) {
+            break;
+        }
+        if (isCompilingProvider(provider) &&
+            std::find(available.begin(), available.end(), providerName(provider)) != available.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace detail
+
+/**
+ * @brief Cache file name for a model, provider and optimization level.
+ */
+inline std::string modelCacheKey(const std::string &modelPath, ExecutionProvider provider, GraphOptimizationLevel level,
+                                 bool ortFormat = false) {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(detail::hashFile(modelPath)));
+    return std::filesystem::path(modelPath).stem().string() + "-" + hash + "-" + providerName(provider) + "-O" +
+           std::to_string(static_cast<int>(level)) + "-ort" + std::to_string(ORT_API_VERSION) + (ortFormat ? ".ort" : ".onnx");
+}
+
+/**
+ * @brief Creates the session of modelPath, through the optimized-graph cache when options.cacheDir is set.
+ *
+ * @param env Environment of the session.
+ * @param modelPath Path to the ONNX model file.
+ * @param options Detector options (cacheDir, optimizationLevel).
+ * @param sessionOptions Session options already set up by configureSession(); the cache adjusts them.
+ * @param provider Primary provider returned by configureSession().
+ * @param prepackedWeights Container shared with other sessions of the model, or nullptr.
+ * @param mapping Receives the model mapping with options.mapModel; it must outlive the session.
+ */
+inline Ort::Session createSession(const Ort::Env &env, const std::string &modelPath, const DetectorOptions &options,
+                                  Ort::SessionOptions &sessionOptions, ExecutionProvider provider,
+                                  OrtPrepackedWeightsContainer *prepackedWeights = nullptr,
+                                  ModelMapping *mapping = nullptr) {
+    if (options.mapModel && !mapping) {
+        throw std::invalid_argument("createSession: mapModel needs a ModelMapping to keep the mapping alive.");
+    }
+    if (options.cacheDir.empty() || options.optimizationLevel == GraphOptimizationLevel::ORT_DISABLE_ALL ||
+        detail::hasCompilingProvider(options)) {
+        return detail::openSession(env, modelPath, sessionOptions, prepackedWeights, options.mapModel, mapping);
+    }
+
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(options.cacheDir, ec);
+    // Mapped models are cached in ORT format, whose initializers can be used from the mapping
+    const fs::path cached = fs::path(options.cacheDir) /
+                            modelCacheKey(modelPath, provider, options.optimizationLevel, options.mapModel);
+
+    if (fs::exists(cached, ec)) {
+        // The graph is already optimized
+        sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+        try {
+            Ort::Session session = detail::openSession(env, cached.string(), sessionOptions, prepackedWeights,
+                                                       options.mapModel, mapping);
+            std::cout << "Loaded optimized model from cache: " << cached.string() << std::endl;
+            return session;
+        } catch (const Ort::Exception &e) {
+            std::cout << "Discarding unreadable model cache " << cached.string() << ": " << e.what() << std::endl;
+            fs::remove(cached, ec);
+            sessionOptions.SetGraphOptimizationLevel(options.optimizationLevel);
+        }
+    }
+
+    // Optimize once and keep the result; the unique temporary name keeps concurrent starts apart
+    const fs::path partial = cached.string() + ".partial-" + std::to_string(std::random_device{}());
+#ifdef _WIN32
+    sessionOptions.SetOptimizedModelFilePath(partial.wstring().c_str());
+#else
+    sessionOptions.SetOptimizedModelFilePath(partial.c_str());
+#endif
+    if (options.mapModel) {
+        sessionOptions.AddConfigEntry("session.save_model_format", "ORT");
+    }
+    try {
+        Ort::Session session = detail::openSession(env, modelPath, sessionOptions, prepackedWeights, options.mapModel, mapping);
+        fs::rename(partial, cached, ec);
+        if (ec) {
+            fs::remove(partial, ec);
+        }
+        return session;
+    } catch (...) {
+        fs::remove(partial, ec);
+        throw;
+    }
+}
+
+} // namespace yolos
+
+#endif // MODEL_CACHE_HPP
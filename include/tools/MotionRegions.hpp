@@ -0,0 +1,152 @@
+// MotionRegions.hpp
+#ifndef MOTION_REGIONS_HPP
+#define MOTION_REGIONS_HPP
+
+/**
+ * @file MotionRegions.hpp
+ * @brief Changed regions of a fixed-camera stream from a cheap background model.
+ *
+ * Every frame is shrunk to a small grey image, compared with a running-average background
+ * of the same size, and the pixels that differ by more than pixelThreshold are grown with a
+ * dilation and grouped into connected components. Their bounding boxes, scaled back to the
+ * frame, padded by margin and merged where they overlap, are the regions worth detecting
+ * on. The background follows the scene at learningRate, so objects that stop moving fade
+ * into it and parked cars or lighting drift do not keep regions alive.
+ *
+ * All work happens at the background resolution (320x180 by default), so the cost per frame
+ * is a resize and a few passes over ~60k pixels, whatever the camera resolution.
+ */
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace yolos {
+
+/**
+ * @brief Parameters of the background model.
+ */
+struct MotionOptions {
+    cv::Size modelSize{320, 180};     ///< Resolution of the background model
+    double learningRate = 0.05;       ///< Weight of the current frame in the running average
+    int pixelThreshold = 25;          ///< Grey-level difference for a pixel to count as changed
+    int dilateIterations = 2;         ///< 3x3 dilations joining the fragments of one object
+    float minArea = 0.0005f;          ///< Smallest component kept, as a fraction of the model area
+    int margin = 16;                  ///< Padding added around every region, in frame pixels
+};
+
+/**
+ * @brief Merges overlapping or touching rectangles (sharing an edge or a corner, as 8-connected
+ *        pixels do) until no two of them overlap or touch.
+ */
+inline void mergeRects(std::vector<cv::Rect> &rects) {
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < rects.size() && !merged; ++i) {
+            for (size_t j = i + 1; j < rects.size(); ++j) {
+                // Growing one side by a pixel makes rectangles that only touch intersect
+                const cv::Rect grown(rects[i].x - 1, rects[i].y - 1, rects[i].width + 2, rects[i].height + 2);
+                if ((grown & rects[j]).area() > 0) {
+                    rects[i] |= rects[j];
+                    rects.erase(rects.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+class MotionRegions {
+public:
+    explicit MotionRegions(const MotionOptions &options = MotionOptions()) : options(options) {
+        if (options.modelSize.width <= 0 || options.modelSize.height <= 0) {
+            throw std::invalid_argument("MotionRegions: modelSize must be positive.");
+        }
+        if (!(options.learningRate > 0.0 && options.learningRate <= 1.0)) {
+            throw std::invalid_argument("MotionRegions: learningRate must be in (0, 1].");
+        }
+    }
+
+    /**
+     * @brief Compares a frame with the background and folds it into the model.
+     *
+     * @param frame The current frame (8-bit, 1, 3 or 4 channels).
+     * @return const std::vector<cv::Rect>& Disjoint changed regions in frame coordinates;
+     *         empty on the first frame, which only initializes the model.
+     */
+    const std::vector<cv::Rect> &update(const cv::Mat &frame) {
+        if (frame.empty()) {
+            throw std::invalid_argument("MotionRegions: frame is empty.");
+        }
+        regions.clear();
+
+        cv::resize(frame, small, options.modelSize, 0, 0, cv::INTER_AREA);
+        if (small.channels() == 3) {
+            cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+        } else if (small.channels() == 4) {
+            cv::cvtColor(small, gray, cv::COLOR_BGRA2GRAY);
+        } else {
+            small.copyTo(gray);
+        }
+        cv::GaussianBlur(gray, gray, cv::Size(3, 3), 0);
+
+        if (background.empty() || frame.size() != frameSize) {
+            // First frame (or a resolution change): nothing to compare against yet
+            gray.convertTo(background, CV_32F);
+            frameSize = frame.size();
+            return regions;
+        }
+
+        background.convertTo(background8u, CV_8U);
+        cv::absdiff(gray, background8u, mask);
+        cv::threshold(mask, mask, options.pixelThreshold, 255, cv::THRESH_BINARY);
+        if (options.dilateIterations > 0) {
+            cv::dilate(mask, mask, cv::Mat(), cv::Point(-1, -1), options.dilateIterations);
+        }
+        cv::accumulateWeighted(gray, background, options.learningRate);
+
+        const int count = cv::connectedComponentsWithStats(mask, labels, stats, centroids, 8, CV_32S);
+        const double minPixels = options.minArea * static_cast<double>(options.modelSize.area());
+        const double sx = static_cast<double>(frameSize.width) / options.modelSize.width;
+        const double sy = static_cast<double>(frameSize.height) / options.modelSize.height;
+        const cv::Rect bounds(0, 0, frameSize.width, frameSize.height);
+        for (int label = 1; label < count; ++label) {   // Label 0 is the unchanged background
+            if (stats.at<int>(label, cv::CC_STAT_AREA) < minPixels) {
+                continue;
+            }
+            const int x0 = static_cast<int>(std::floor(stats.at<int>(label, cv::CC_STAT_LEFT) * sx)) - options.margin;
+            const int y0 = static_cast<int>(std::floor(stats.at<int>(label, cv::CC_STAT_TOP) * sy)) - options.margin;
+            const int x1 = static_cast<int>(std::ceil((stats.at<int>(label, cv::CC_STAT_LEFT) + stats.at<int>(label, cv::CC_STAT_WIDTH)) * sx)) + options.margin;
+            const int y1 = static_cast<int>(std::ceil((stats.at<int>(label, cv::CC_STAT_TOP) + stats.at<int>(label, cv::CC_STAT_HEIGHT)) * sy)) + options.margin;
+            const cv::Rect region = cv::Rect(x0, y0, x1 - x0, y1 - y0) & bounds;
+            if (region.area() > 0) {
+                regions.push_back(region);
+            }
+        }
+        mergeRects(regions);
+        return regions;
+    }
+
+    /// Forgets the background; the next frame re-initializes it
+    void reset() {
+        background.release();
+        regions.clear();
+    }
+
+private:
+    MotionOptions options;
+    cv::Size frameSize;
+    cv::Mat background;                                     // CV_32F running average
+    std::vector<cv::Rect> regions;
+    // Scratch images reused between frames
+    cv::Mat small, gray, background8u, mask, labels, stats, centroids;
+};
+
+} // namespace yolos
+
+#endif // MOTION_REGIONS_HPP
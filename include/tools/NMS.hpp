@@ -0,0 +1,404 @@
+// NMS.hpp
+#ifndef NMS_HPP
+#define NMS_HPP
+
+/**
+ * @file NMS.hpp
+ * @brief Greedy non-maximum suppression shared by the detection, segmentation and pose headers.
+ *
+ * A plain NMS compares every pair of candidates (O(n^2)) and emulates per-class NMS by
+ * shifting each box by classId * a large offset. NMSEngine keeps the greedy Ultralytics
+ * semantics (highest score first, suppress every remaining box with IoU > threshold) but
+ * organises the work so that crowded frames stay close to linear:
+ *
+ *  - Candidates are bucketed by class (one bucket in class-agnostic mode) and, inside a
+ *    bucket, by columns of x1 at least as wide as the widest box, with one counting sort.
+ *    A kept box can only overlap boxes in its own bucket and in the 2-3 columns around it.
+ *  - Boxes are visited in score order through a binary heap instead of a full sort, so
+ *    the work stops as soon as maxDetections boxes are kept or no live box is left.
+ *    maxCandidates optionally restricts NMS to the top-k scores (nth_element).
+ *  - Live boxes are tracked in a 64-bit word bitmask laid out in bucket/column order;
+ *    the IoU test runs on 64 boxes at a time (AVX2 runtime-dispatched, SSE2 or NEON,
+ *    scalar fallback) and fully suppressed words are skipped without touching the boxes.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define YOLOS_NMS_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define YOLOS_NMS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace yolos {
+
+/**
+ * @brief Parameters of one NMS call.
+ */
+struct NMSOptions {
+    float scoreThreshold = 0.0f;  // Boxes need a score >= this to take part
+    float iouThreshold = 0.45f;   // A box is suppressed by a kept box when IoU > this
+    bool agnostic = false;        // Ignore class ids (one bucket for all boxes)
+    int maxDetections = 0;        // Stop once this many boxes are kept (0 = no limit)
+    int maxCandidates = 0;        // Only the top-k scores enter NMS (0 = all)
+};
+
+namespace detail {
+
+// Boxes tested per kernel call; matches one word of the live bitmask
+constexpr int kNmsLanes = 64;
+// Upper bound on x1 columns per bucket
+constexpr int kNmsMaxColumns = 64;
+
+/**
+ * @brief The kept box every candidate of a block is compared against.
+ */
+struct NmsReference {
+    float x1, y1, x2, y2, area;
+};
+
+// Bit i is set if box i of the block overlaps ref with IoU > threshold
+using OverlapMaskFn = uint64_t (*)(const float *x1, const float *y1, const float *x2, const float *y2,
+                                   const float *area, const NmsReference &ref, float threshold);
+
+// IoU > t  <=>  inter > t * (areaA + areaB - inter), which avoids the division
+inline uint64_t overlapMaskScalar(const float *x1, const float *y1, const float *x2, const float *y2,
+                                  const float *area, const NmsReference &ref, float threshold) {
+    uint64_t mask = 0;
+    for (int i = 0; i < kNmsLanes; ++i) {
+        const float iw = std::min(x2[i], ref.x2) - std::max(x1[i], ref.x1);
+        const float ih = std::min(y2[i], ref.y2) - std::max(y1[i], ref.y1);
+        if (iw > 0.0f && ih > 0.0f) {
+            const float inter = iw * ih;
+            if (inter > threshold * (area[i] + ref.area - inter)) {
+                mask |= uint64_t(1) << i;
+            }
+        }
+    }
+    return mask;
+}
+
+#if defined(YOLOS_NMS_X86)
+inline uint64_t overlapMaskSSE2(const float *x1, const float *y1, const float *x2, const float *y2,
+                                const float *area, const NmsReference &ref, float threshold) {
+    const __m128 rx1 = _mm_set1_ps(ref.x1), ry1 = _mm_set1_ps(ref.y1);
+    const __m128 rx2 = _mm_set1_ps(ref.x2), ry2 = _mm_set1_ps(ref.y2);
+    const __m128 ra = _mm_set1_ps(ref.area), vt = _mm_set1_ps(threshold);
+    const __m128 zero = _mm_setzero_ps();
+    uint64_t mask = 0;
+    for (int i = 0; i < kNmsLanes; i += 4) {
+        const __m128 iw = _mm_sub_ps(_mm_min_ps(_mm_loadu_ps(x2 + i), rx2), _mm_max_ps(_mm_loadu_ps(x1 + i), rx1));
+        const __m128 ih = _mm_sub_ps(_mm_min_ps(_mm_loadu_ps(y2 + i), ry2), _mm_max_ps(_mm_loadu_ps(y1 + i), ry1));
+        const __m128 inter = _mm_mul_ps(iw, ih);
+        const __m128 uni = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(area + i), ra), inter);
+        __m128 hit = _mm_and_ps(_mm_cmpgt_ps(iw, zero), _mm_cmpgt_ps(ih, zero));
+        hit = _mm_and_ps(hit, _mm_cmpgt_ps(inter, _mm_mul_ps(vt, uni)));
+        mask |= static_cast<uint64_t>(_mm_movemask_ps(hit)) << i;
+    }
+    return mask;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define YOLOS_NMS_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define YOLOS_NMS_AVX2_TARGET
+#endif
+
+#if defined(__GNUC__) || defined(__clang__) || defined(__AVX2__)
+YOLOS_NMS_AVX2_TARGET
+inline uint64_t overlapMaskAVX2(const float *x1, const float *y1, const float *x2, const float *y2,
+                                const float *area, const NmsReference &ref, float threshold) {
+    const __m256 rx1 = _mm256_set1_ps(ref.x1), ry1 = _mm256_set1_ps(ref.y1);
+    const __m256 rx2 = _mm256_set1_ps(ref.x2), ry2 = _mm256_set1_ps(ref.y2);
+    const __m256 ra = _mm256_set1_ps(ref.area), vt = _mm256_set1_ps(threshold);
+    const __m256 zero = _mm256_setzero_ps();
+    uint64_t mask = 0;
+    for (int i = 0; i < kNmsLanes; i += 8) {
+        const __m256 iw = _mm256_sub_ps(_mm256_min_ps(_mm256_loadu_ps(x2 + i), rx2),
+                                        _mm256_max_ps(_mm256_loadu_ps(x1 + i), rx1));
+        const __m256 ih = _mm256_sub_ps(_mm256_min_ps(_mm256_loadu_ps(y2 + i), ry2),
+                                        _mm256_max_ps(_mm256_loadu_ps(y1 + i), ry1));
+        const __m256 inter = _mm256_mul_ps(iw, ih);
+        const __m256 uni = _mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(area + i), ra), inter);
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(iw, zero, _CMP_GT_OQ), _mm256_cmp_ps(ih, zero, _CMP_GT_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(inter, _mm256_mul_ps(vt, uni), _CMP_GT_OQ));
+        mask |= static_cast<uint64_t>(_mm256_movemask_ps(hit)) << i;
+    }
+    return mask;
+}
+#define YOLOS_NMS_HAS_AVX2 1
+#endif
+#endif // YOLOS_NMS_X86
+
+#if defined(YOLOS_NMS_NEON)
+inline uint64_t overlapMaskNEON(const float *x1, const float *y1, const float *x2, const float *y2,
+                                const float *area, const NmsReference &ref, float threshold) {
+    const float32x4_t rx1 = vdupq_n_f32(ref.x1), ry1 = vdupq_n_f32(ref.y1);
+    const float32x4_t rx2 = vdupq_n_f32(ref.x2), ry2 = vdupq_n_f32(ref.y2);
+    const float32x4_t ra = vdupq_n_f32(ref.area), vt = vdupq_n_f32(threshold);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    static const uint32_t laneBits[4] = {1, 2, 4, 8};
+    const uint32x4_t vbits = vld1q_u32(laneBits);
+    uint64_t mask = 0;
+    for (int i = 0; i < kNmsLanes; i += 4) {
+        const float32x4_t iw = vsubq_f32(vminq_f32(vld1q_f32(x2 + i), rx2), vmaxq_f32(vld1q_f32(x1 + i), rx1));
+        const float32x4_t ih = vsubq_f32(vminq_f32(vld1q_f32(y2 + i), ry2), vmaxq_f32(vld1q_f32(y1 + i), ry1));
+        const float32x4_t inter = vmulq_f32(iw, ih);
+        const float32x4_t uni = vsubq_f32(vaddq_f32(vld1q_f32(area + i), ra), inter);
+        uint32x4_t hit = vandq_u32(vcgtq_f32(iw, zero), vcgtq_f32(ih, zero));
+        hit = vandq_u32(hit, vcgtq_f32(inter, vmulq_f32(vt, uni)));
+        const uint32x4_t b = vandq_u32(hit, vbits);
+        const uint32_t bits = vgetq_lane_u32(b, 0) | vgetq_lane_u32(b, 1) | vgetq_lane_u32(b, 2) | vgetq_lane_u32(b, 3);
+        mask |= static_cast<uint64_t>(bits) << i;
+    }
+    return mask;
+}
+#endif
+
+/**
+ * @brief Picks the widest overlap kernel supported by the running CPU.
+ */
+inline OverlapMaskFn selectOverlapMask() {
+#if defined(YOLOS_NMS_X86)
+#if defined(YOLOS_NMS_HAS_AVX2)
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return overlapMaskAVX2;
+    }
+#else
+    return overlapMaskAVX2;
+#endif
+#endif
+    return overlapMaskSSE2;
+#elif defined(YOLOS_NMS_NEON)
+    return overlapMaskNEON;
+#else
+    return overlapMaskScalar;
+#endif
+}
+
+inline OverlapMaskFn overlapMask() {
+    static const OverlapMaskFn kernel = selectOverlapMask();
+    return kernel;
+}
+
+inline int popcount64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(v);
+#else
+    int n = 0;
+    for (; v; v &= v - 1) ++n;
+    return n;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief Reusable NMS workspace; keeps its buffers between calls.
+ *
+ * Not thread-safe: use one engine per detector (or per thread).
+ */
+class NMSEngine {
+public:
+    /**
+     * @brief Runs greedy NMS and writes the kept indices in descending score order.
+     *
+     * @tparam Box Any type with x, y, width and height members (top-left + size).
+     * @param boxes Candidate boxes.
+     * @param scores Confidence score of each box.
+     * @param classIds Class of each box; may be nullptr, which implies class-agnostic NMS.
+     * @param options Thresholds, mode and caps.
+     * @param indices Output indices into boxes.
+     */
+    template <typename Box>
+    void run(const std::vector<Box> &boxes, const std::vector<float> &scores, const std::vector<int> *classIds,
+             const NMSOptions &options, std::vector<int> &indices) {
+        indices.clear();
+        candidates_.clear();
+        const size_t count = std::min(boxes.size(), scores.size());
+        for (size_t i = 0; i < count; ++i) {
+            if (scores[i] >= options.scoreThreshold) {
+                candidates_.push_back(static_cast<int>(i));
+            }
+        }
+        if (candidates_.empty()) {
+            return;
+        }
+
+        // Top-k pre-selection without ordering the rest
+        if (options.maxCandidates > 0 && candidates_.size() > static_cast<size_t>(options.maxCandidates)) {
+            std::nth_element(candidates_.begin(), candidates_.begin() + options.maxCandidates, candidates_.end(),
+                             [&scores](int a, int b) { return scores[a] > scores[b] || (scores[a] == scores[b] && a < b); });
+            candidates_.resize(options.maxCandidates);
+        }
+
+        const size_t m = candidates_.size();
+        cx1_.resize(m); cy1_.resize(m); cx2_.resize(m); cy2_.resize(m);
+        cscore_.resize(m); cclass_.resize(m);
+        const bool agnostic = options.agnostic || classIds == nullptr;
+        for (size_t k = 0; k < m; ++k) {
+            const Box &b = boxes[candidates_[k]];
+            cx1_[k] = static_cast<float>(b.x);
+            cy1_[k] = static_cast<float>(b.y);
+            cx2_[k] = static_cast<float>(b.x + b.width);
+            cy2_[k] = static_cast<float>(b.y + b.height);
+            cscore_[k] = scores[candidates_[k]];
+            cclass_[k] = agnostic ? 0 : (*classIds)[candidates_[k]];
+        }
+
+        suppress(options, indices);
+    }
+
+private:
+    // Buckets the gathered candidates, then runs the greedy loop
+    void suppress(const NMSOptions &options, std::vector<int> &indices) {
+        const int m = static_cast<int>(candidates_.size());
+
+        // Dense bucket ids; fall back to a sorted lookup when class ids are sparse
+        int minClass = cclass_[0], maxClass = cclass_[0];
+        for (int k = 1; k < m; ++k) {
+            minClass = std::min(minClass, cclass_[k]);
+            maxClass = std::max(maxClass, cclass_[k]);
+        }
+        int numBuckets = maxClass - minClass + 1;
+        if (numBuckets > m) {
+            classLookup_.assign(cclass_.begin(), cclass_.end());
+            std::sort(classLookup_.begin(), classLookup_.end());
+            classLookup_.erase(std::unique(classLookup_.begin(), classLookup_.end()), classLookup_.end());
+            for (int k = 0; k < m; ++k) {
+                cclass_[k] = static_cast<int>(std::lower_bound(classLookup_.begin(), classLookup_.end(), cclass_[k]) -
+                                              classLookup_.begin());
+            }
+            numBuckets = static_cast<int>(classLookup_.size());
+        } else {
+            for (int k = 0; k < m; ++k) {
+                cclass_[k] -= minClass;
+            }
+        }
+
+        // Columns of x1 at least as wide as the widest box: overlaps only reach the neighbouring column
+        float minX = cx1_[0], maxX = cx1_[0], maxW = 0.0f;
+        for (int k = 0; k < m; ++k) {
+            minX = std::min(minX, cx1_[k]);
+            maxX = std::max(maxX, cx1_[k]);
+            maxW = std::max(maxW, cx2_[k] - cx1_[k]);
+        }
+        const float columnWidth = std::max({maxW, (maxX - minX) / detail::kNmsMaxColumns, 1.0f});
+        const int numColumns = static_cast<int>((maxX - minX) / columnWidth) + 1;
+        auto columnOf = [&](float x) {
+            return std::min(std::max(static_cast<int>((x - minX) / columnWidth), 0), numColumns - 1);
+        };
+
+        // Counting sort by (bucket, column)
+        const int numKeys = numBuckets * numColumns;
+        offsets_.assign(numKeys + 1, 0);
+        keys_.resize(m);
+        for (int k = 0; k < m; ++k) {
+            keys_[k] = cclass_[k] * numColumns + columnOf(cx1_[k]);
+            ++offsets_[keys_[k] + 1];
+        }
+        for (int key = 0; key < numKeys; ++key) {
+            offsets_[key + 1] += offsets_[key];
+        }
+
+        // Slot arrays padded to whole words so the kernel never reads past the end
+        const int words = (m + detail::kNmsLanes - 1) / detail::kNmsLanes;
+        const size_t padded = static_cast<size_t>(words) * detail::kNmsLanes;
+        x1_.assign(padded, 0.0f); y1_.assign(padded, 0.0f);
+        x2_.assign(padded, 0.0f); y2_.assign(padded, 0.0f);
+        area_.assign(padded, 0.0f);
+        score_.resize(m); original_.resize(m); slotKey_.resize(m);
+        cursor_.assign(offsets_.begin(), offsets_.end() - 1);
+        for (int k = 0; k < m; ++k) {
+            const int s = cursor_[keys_[k]]++;
+            x1_[s] = cx1_[k]; y1_[s] = cy1_[k];
+            x2_[s] = cx2_[k]; y2_[s] = cy2_[k];
+            area_[s] = (cx2_[k] - cx1_[k]) * (cy2_[k] - cy1_[k]);
+            score_[s] = cscore_[k];
+            original_[s] = candidates_[k];
+            slotKey_[s] = keys_[k];
+        }
+
+        live_.assign(words, ~uint64_t(0));
+        if (m % detail::kNmsLanes) {
+            live_.back() = (uint64_t(1) << (m % detail::kNmsLanes)) - 1;
+        }
+        int liveCount = m;
+
+        // Score order via a heap: only the boxes actually reached get popped
+        heap_.resize(m);
+        for (int s = 0; s < m; ++s) heap_[s] = s;
+        auto lowerPriority = [this](int a, int b) {
+            return score_[a] < score_[b] || (score_[a] == score_[b] && original_[a] > original_[b]);
+        };
+        std::make_heap(heap_.begin(), heap_.end(), lowerPriority);
+
+        const detail::OverlapMaskFn overlapMask = detail::overlapMask();
+        const size_t maxKeep = options.maxDetections > 0 ? static_cast<size_t>(options.maxDetections) : static_cast<size_t>(m);
+        indices.reserve(std::min(maxKeep, static_cast<size_t>(m)));
+
+        while (!heap_.empty() && liveCount > 0 && indices.size() < maxKeep) {
+            std::pop_heap(heap_.begin(), heap_.end(), lowerPriority);
+            const int s = heap_.back();
+            heap_.pop_back();
+
+            uint64_t &word = live_[s / detail::kNmsLanes];
+            const uint64_t bit = uint64_t(1) << (s % detail::kNmsLanes);
+            if (!(word & bit)) {
+                continue;  // Suppressed by a higher-scoring box
+            }
+            word &= ~bit;
+            --liveCount;
+            indices.push_back(original_[s]);
+
+            // Candidates overlapping s lie in its bucket, in the columns from x1 - maxW to x2
+            const int bucketKey = slotKey_[s] - slotKey_[s] % numColumns;
+            const int begin = offsets_[bucketKey + columnOf(x1_[s] - maxW)];
+            const int end = offsets_[bucketKey + columnOf(x2_[s]) + 1];
+            if (begin >= end) {
+                continue;
+            }
+
+            const detail::NmsReference ref{x1_[s], y1_[s], x2_[s], y2_[s], area_[s]};
+            const int firstWord = begin / detail::kNmsLanes;
+            const int lastWord = (end - 1) / detail::kNmsLanes;
+            for (int w = firstWord; w <= lastWord; ++w) {
+                uint64_t range = ~uint64_t(0);
+                if (w == firstWord) range &= ~uint64_t(0) << (begin % detail::kNmsLanes);
+                if (w == lastWord && end % detail::kNmsLanes) range &= (uint64_t(1) << (end % detail::kNmsLanes)) - 1;
+                const uint64_t alive = live_[w] & range;
+                if (!alive) {
+                    continue;
+                }
+                const size_t o = static_cast<size_t>(w) * detail::kNmsLanes;
+                const uint64_t hit = overlapMask(x1_.data() + o, y1_.data() + o, x2_.data() + o, y2_.data() + o,
+                                                 area_.data() + o, ref, options.iouThreshold) & alive;
+                live_[w] &= ~hit;
+                liveCount -= detail::popcount64(hit);
+            }
+        }
+    }
+
+    // Gathered candidates (input order)
+    std::vector<int> candidates_;
+    std::vector<float> cx1_, cy1_, cx2_, cy2_, cscore_;
+    std::vector<int> cclass_, classLookup_, keys_;
+
+    // Bucketed slots
+    std::vector<int> offsets_, cursor_;
+    std::vector<float> x1_, y1_, x2_, y2_, area_, score_;
+    std::vector<int> original_, slotKey_;
+    std::vector<uint64_t> live_;
+    std::vector<int> heap_;
+};
+
+} // namespace yolos
+
+#endif // NMS_HPP
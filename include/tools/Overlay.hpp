@@ -0,0 +1,361 @@
+// Overlay.hpp
+#ifndef OVERLAY_HPP
+#define OVERLAY_HPP
+
+/**
+ * @file Overlay.hpp
+ * @brief Annotation renderer for boxes, instance masks and keypoints that only touches the
+ *        pixels it changes.
+ *
+ * - Translucent fills (box tints, instance masks) are added inside each box or mask ROI with
+ *   one saturating add, instead of compositing a full-frame overlay image.
+ * - Labels ("name: 87%") are rasterized once per class name, confidence bucket, font size and
+ *   color into a small patch that later frames copy; steady-state frames build no strings and
+ *   measure no text.
+ * - Per-instance work (rendering deferred masks, rasterizing new labels, scaling to the
+ *   preview) runs in parallel across instances. The frame is then composited in horizontal
+ *   bands in parallel, each band drawing, in order, the instances that reach into it, so the
+ *   result does not depend on the number of threads.
+ * - RenderOptions::previewScale draws on a downscaled copy of the frame instead, and
+ *   RenderOptions::enabled = false turns drawing into a no-op for headless runs.
+ *
+ * One OverlayRenderer can be used by several threads drawing different frames.
+ */
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "tools/InstanceMask.hpp"
+
+namespace yolos {
+
+/**
+ * @brief Where and whether annotations are drawn.
+ */
+struct RenderOptions {
+    bool enabled = true;            // false: headless, drawing calls return at once
+    double previewScale = 1.0;      // < 1: the frame is replaced by an annotated copy downscaled by this factor
+    int confidenceBucket = 1;       // Label percentages are floored to multiples of this (label cache granularity)
+    size_t maxCachedLabels = 4096;  // The label cache is flushed when it grows past this
+};
+
+/**
+ * @brief One instance to draw, in frame coordinates.
+ */
+struct OverlayItem {
+    cv::Rect box;
+    float confidence = 0.f;
+    cv::Scalar color;
+    const std::string *name = nullptr;               // Class name of the label; null draws no label
+    const cv::Mat *mask = nullptr;                   // Box-local 8UC1 mask placed at maskOffset
+    const DeferredMask *deferredMask = nullptr;      // Rendered (in parallel) when there is no mask
+    cv::Point maskOffset;
+    std::vector<cv::Point3f> keypoints;              // x, y, confidence
+};
+
+/**
+ * @brief Look of the overlay. Sizes given per pixel of the smaller side of the drawn image
+ *        follow the preview scale.
+ */
+struct OverlayStyle {
+    float boxAlpha = 0.f;                            // Tint inside the box (0 = none)
+    float maskAlpha = 0.5f;                          // Weight of the mask color
+    int boxThickness = 2;                            // Outline width in pixels (0 = no outline)
+    int lineType = cv::LINE_AA;
+    double fontSize = 0.0006;                        // Font scale per pixel of the smaller side (at least 0.35)
+    double fontWeight = 0.001;                       // Text thickness per pixel of the smaller side (at least 1)
+    cv::Scalar textColor{255, 255, 255};
+
+    const std::vector<std::pair<int, int>> *skeleton = nullptr;  // Keypoint pairs joined by limbs
+    std::vector<cv::Scalar> keypointColors;          // Per keypoint index (empty = the item color)
+    std::vector<cv::Scalar> limbColors;              // Per skeleton pair (empty = the item color)
+    float keypointThreshold = 0.5f;                  // Keypoints below this confidence are not drawn
+    double keypointRadius = 4.0 / 1280.0;            // Per pixel of the smaller side (at least 2 px)
+    double limbWidth = 2.0 / 1280.0;                 // Per pixel of the smaller side (at least 1 px)
+};
+
+class OverlayRenderer {
+public:
+    explicit OverlayRenderer(const RenderOptions &options = RenderOptions()) : options_(options) {}
+
+    OverlayRenderer(const OverlayRenderer &) = delete;
+    OverlayRenderer &operator=(const OverlayRenderer &) = delete;
+
+    void setOptions(const RenderOptions &options) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (options.confidenceBucket != options_.confidenceBucket) {
+            labels_.clear();
+        }
+        options_ = options;
+    }
+
+    RenderOptions options() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return options_;
+    }
+
+    /**
+     * @brief Draws items on frame (8-bit BGR).
+     *
+     * With RenderOptions::previewScale < 1, frame is replaced by the annotated downscaled copy
+     * and the pixels of the original frame are left untouched. Disabled renderers return at once.
+     */
+    void render(cv::Mat &frame, const std::vector<OverlayItem> &items, const OverlayStyle &style) const {
+        const RenderOptions options = this->options();
+        if (!options.enabled || frame.empty() || frame.type() != CV_8UC3) {
+            return;
+        }
+
+        double scale = 1.0;
+        cv::Mat target = frame;
+        if (options.previewScale > 0.0 && options.previewScale < 1.0) {
+            scale = options.previewScale;
+            const cv::Size size(std::max(1, cvRound(frame.cols * scale)), std::max(1, cvRound(frame.rows * scale)));
+            // Bilinear is enough for a preview and several times cheaper than INTER_AREA
+            cv::resize(frame, target, size, 0, 0, cv::INTER_LINEAR);
+        }
+        if (!items.empty()) {
+            renderInto(target, items, style, scale, options);
+        }
+        frame = target;
+    }
+
+    /// Number of cached label patches
+    size_t cachedLabels() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return labels_.size();
+    }
+
+private:
+    struct LabelKey {
+        size_t nameHash;
+        int percent;
+        int fontKey;
+        int thickness;
+        uint32_t color;
+        uint32_t textColor;
+
+        bool operator==(const LabelKey &other) const {
+            return nameHash == other.nameHash && percent == other.percent && fontKey == other.fontKey &&
+                   thickness == other.thickness && color == other.color && textColor == other.textColor;
+        }
+    };
+
+    struct LabelKeyHash {
+        size_t operator()(const LabelKey &key) const {
+            size_t h = key.nameHash;
+            for (const size_t v : {static_cast<size_t>(key.percent), static_cast<size_t>(key.fontKey),
+                                   static_cast<size_t>(key.thickness), static_cast<size_t>(key.color),
+                                   static_cast<size_t>(key.textColor)}) {
+                h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2);
+            }
+            return h;
+        }
+    };
+
+    // An item scaled to the drawn image, with its mask and label ready to composite
+    struct Prepared {
+        cv::Rect box;
+        cv::Mat mask;
+        cv::Point maskOffset;
+        LabelKey labelKey{};
+        bool hasLabel = false;
+        bool newLabel = false;                       // Rasterized by this call, to be cached
+        cv::Mat label;
+        cv::Point labelAt;
+        std::vector<cv::Point> keypoints;
+        std::vector<uchar> visible;
+    };
+
+    static uint32_t packColor(const cv::Scalar &color) {
+        return static_cast<uint32_t>(cv::saturate_cast<uchar>(color[0])) |
+               static_cast<uint32_t>(cv::saturate_cast<uchar>(color[1])) << 8 |
+               static_cast<uint32_t>(cv::saturate_cast<uchar>(color[2])) << 16;
+    }
+
+    static cv::Mat rasterizeLabel(const std::string &name, int percent, const cv::Scalar &color, const cv::Scalar &textColor,
+                                  double fontScale, int thickness) {
+        const std::string text = name + ": " + std::to_string(percent) + "%";
+        int baseline = 0;
+        const cv::Size size = cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, fontScale, thickness, &baseline);
+        cv::Mat patch(size.height + baseline + 5, size.width + 5, CV_8UC3, color);
+        cv::putText(patch, text, cv::Point(2, size.height + 3), cv::FONT_HERSHEY_SIMPLEX, fontScale, textColor, thickness,
+                    cv::LINE_AA);
+        return patch;
+    }
+
+    void renderInto(cv::Mat &target, const std::vector<OverlayItem> &items, const OverlayStyle &style, double scale,
+                    const RenderOptions &options) const {
+        const int minSide = std::min(target.rows, target.cols);
+        const double fontScale = std::max(0.35, minSide * style.fontSize);
+        const int fontThickness = std::max(1, static_cast<int>(minSide * style.fontWeight));
+        const int keypointRadius = std::max(2, static_cast<int>(minSide * style.keypointRadius));
+        const int limbWidth = std::max(1, static_cast<int>(minSide * style.limbWidth));
+        const int bucket = std::max(1, options.confidenceBucket);
+        const int fontKey = cvRound(fontScale * 1000.0);
+        const uint32_t textColor = packColor(style.textColor);
+
+        // Label patches of earlier frames
+        std::vector<Prepared> prepared(items.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < items.size(); ++i) {
+                if (!items[i].name) {
+                    continue;
+                }
+                const int percent = std::min(100, std::max(0, static_cast<int>(items[i].confidence * 100.0f)) / bucket * bucket);
+                Prepared &p = prepared[i];
+                p.hasLabel = true;
+                p.labelKey = {std::hash<std::string>{}(*items[i].name), percent, fontKey, fontThickness,
+                              packColor(items[i].color), textColor};
+                const auto it = labels_.find(p.labelKey);
+                if (it != labels_.end()) {
+                    p.label = it->second;
+                } else {
+                    p.newLabel = true;
+                }
+            }
+        }
+
+        // Geometry, masks and new labels, in parallel across instances
+        auto prepare = [&](size_t i) {
+            const OverlayItem &item = items[i];
+            Prepared &p = prepared[i];
+            p.box = scale == 1.0 ? item.box
+                                 : cv::Rect(cvRound(item.box.x * scale), cvRound(item.box.y * scale),
+                                            cvRound(item.box.width * scale), cvRound(item.box.height * scale));
+
+            cv::Mat mask = item.mask && !item.mask->empty() ? *item.mask
+                         : item.deferredMask && !item.deferredMask->empty() ? item.deferredMask->render() : cv::Mat();
+            if (!mask.empty() && style.maskAlpha > 0.f) {
+                if (scale == 1.0) {
+                    p.mask = mask;
+                    p.maskOffset = item.maskOffset;
+                } else {
+                    p.maskOffset = cv::Point(cvRound(item.maskOffset.x * scale), cvRound(item.maskOffset.y * scale));
+                    const cv::Size size(std::max(1, cvRound(mask.cols * scale)), std::max(1, cvRound(mask.rows * scale)));
+                    cv::resize(mask, p.mask, size, 0, 0, cv::INTER_NEAREST);
+                }
+            }
+
+            if (p.newLabel) {
+                p.label = rasterizeLabel(*item.name, p.labelKey.percent, item.color, style.textColor, fontScale, fontThickness);
+            }
+            if (p.hasLabel) {
+                p.labelAt = cv::Point(p.box.x, std::max(p.box.y - p.label.rows, 0));
+            }
+
+            p.keypoints.resize(item.keypoints.size());
+            p.visible.resize(item.keypoints.size());
+            for (size_t k = 0; k < item.keypoints.size(); ++k) {
+                const cv::Point3f &kp = item.keypoints[k];
+                p.keypoints[k] = cv::Point(cvRound(kp.x * scale), cvRound(kp.y * scale));
+                p.visible[k] = kp.z >= style.keypointThreshold;
+            }
+        };
+        if (items.size() < 4) {
+            for (size_t i = 0; i < items.size(); ++i) prepare(i);
+        } else {
+            cv::parallel_for_(cv::Range(0, static_cast<int>(items.size())), [&](const cv::Range &range) {
+                for (int i = range.start; i < range.end; ++i) prepare(static_cast<size_t>(i));
+            });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const Prepared &p : prepared) {
+                if (p.newLabel) {
+                    if (labels_.size() >= options.maxCachedLabels) {
+                        labels_.clear();
+                    }
+                    labels_.emplace(p.labelKey, p.label);
+                }
+            }
+        }
+
+        // Composite band by band: fills first, then outlines, keypoints and labels on top
+        auto drawBand = [&](const cv::Rect &bandRect) {
+            cv::Mat band = target(bandRect);
+            const cv::Point shift(0, -bandRect.y);
+            // Anti-aliased strokes reach a little past their geometry
+            const int margin = std::max(style.boxThickness, std::max(keypointRadius, limbWidth)) + 2;
+            const cv::Rect reach(bandRect.x, bandRect.y - margin, bandRect.width, bandRect.height + 2 * margin);
+
+            for (size_t i = 0; i < prepared.size(); ++i) {
+                const Prepared &p = prepared[i];
+                const cv::Scalar &color = items[i].color;
+                if (style.boxAlpha > 0.f) {
+                    const cv::Rect roi = p.box & bandRect;
+                    if (roi.area() > 0) {
+                        cv::Mat region = target(roi);
+                        cv::add(region, color * static_cast<double>(style.boxAlpha), region);
+                    }
+                }
+                if (!p.mask.empty()) {
+                    blendMask(band, p.mask, p.maskOffset + shift, color, style.maskAlpha);
+                }
+            }
+
+            for (size_t i = 0; i < prepared.size(); ++i) {
+                const Prepared &p = prepared[i];
+                const cv::Scalar &color = items[i].color;
+                if (style.boxThickness > 0 && (p.box & reach).area() > 0) {
+                    cv::rectangle(band, p.box + shift, color, style.boxThickness, style.lineType);
+                }
+
+                for (size_t k = 0; k < p.keypoints.size(); ++k) {
+                    if (p.visible[k]) {
+                        const cv::Scalar &kc = style.keypointColors.empty() ? color : style.keypointColors[k % style.keypointColors.size()];
+                        cv::circle(band, p.keypoints[k] + shift, keypointRadius, kc, cv::FILLED, style.lineType);
+                    }
+                }
+                if (style.skeleton && !p.keypoints.empty()) {
+                    for (size_t j = 0; j < style.skeleton->size(); ++j) {
+                        const size_t a = static_cast<size_t>((*style.skeleton)[j].first);
+                        const size_t b = static_cast<size_t>((*style.skeleton)[j].second);
+                        if (a < p.keypoints.size() && b < p.keypoints.size() && p.visible[a] && p.visible[b]) {
+                            const cv::Scalar &lc = style.limbColors.empty() ? color : style.limbColors[j % style.limbColors.size()];
+                            cv::line(band, p.keypoints[a] + shift, p.keypoints[b] + shift, lc, limbWidth, style.lineType);
+                        }
+                    }
+                }
+
+                if (p.hasLabel && !p.label.empty()) {
+                    const cv::Rect roi = cv::Rect(p.labelAt, p.label.size()) & bandRect;
+                    if (roi.area() > 0) {
+                        p.label(roi - p.labelAt).copyTo(target(roi));
+                    }
+                }
+            }
+        };
+
+        const int bands = items.size() < 4 ? 1 : std::max(1, std::min(cv::getNumThreads(), target.rows / 64));
+        if (bands == 1) {
+            drawBand(cv::Rect(0, 0, target.cols, target.rows));
+        } else {
+            cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range &range) {
+                for (int b = range.start; b < range.end; ++b) {
+                    const int y0 = target.rows * b / bands;
+                    const int y1 = target.rows * (b + 1) / bands;
+                    drawBand(cv::Rect(0, y0, target.cols, y1 - y0));
+                }
+            });
+        }
+    }
+
+    mutable std::mutex mutex_;                       // Guards options_ and labels_
+    RenderOptions options_;
+    mutable std::unordered_map<LabelKey, cv::Mat, LabelKeyHash> labels_;
+};
+
+} // namespace yolos
+
+#endif // OVERLAY_HPP
@@ -0,0 +1,350 @@
+// Pipeline.hpp
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+/**
+ * @file Pipeline.hpp
+ * @brief Multi-stage, multi-worker pipeline with bounded queues and in-order output.
+ *
+ * A Pipeline<T> moves items from a source (e.g. a decoder) through a chain of stages
+ * (e.g. preprocess, infer, postprocess, draw) to a sink (e.g. an encoder). Each stage has
+ * its own worker threads and a BoundedThreadSafeQueue in front of it, so a slow stage
+ * blocks the ones before it instead of letting memory grow. The source tags every item
+ * with a sequence number; since workers of a stage finish out of order, the sink reorders
+ * by that number and sees the items exactly in source order.
+ *
+ * The number of items in flight (queued, being processed or waiting to be reordered) is
+ * capped, so a single slow item cannot make the reorder buffer grow without bound.
+ *
+ * Stage functions get the index of the worker running them, so per-worker state (such as
+ * one detector per worker, since detectors are not thread-safe) can be indexed by it.
+ * An exception thrown by the source, a stage or the sink stops the pipeline and is
+ * rethrown by run().
+ *
+ * stats() can be called from any thread while the pipeline runs; it reports the queue
+ * depth, throughput and utilization of every stage.
+ *
+ * The queue type is a template parameter: BoundedThreadSafeQueue by default, or
+ * MpmcRingQueue (tools/RingQueue.hpp) to hand items over without locks.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tools/BoundedThreadSafeQueue.hpp"
+
+namespace yolos {
+
+/**
+ * @brief Counters of one pipeline stage (the source and the sink included).
+ */
+struct PipelineStageStats {
+    std::string name;
+    size_t workers = 0;
+    size_t queueDepth = 0;         // Items waiting in front of the stage (the sink counts its reorder buffer too)
+    size_t queueCapacity = 0;      // 0 for the source, which has no input queue
+    uint64_t processed = 0;        // Items the stage has finished
+    double itemsPerSecond = 0.0;   // processed / elapsed time of the run
+    double utilization = 0.0;      // Busy time / (elapsed time * workers), in [0, 1]
+};
+
+template <typename T, template <typename> class Queue = BoundedThreadSafeQueue>
+class Pipeline {
+public:
+    using Source = std::function<bool(T &)>;              // Fills the next item; false at the end of the stream
+    using Stage = std::function<void(T &, size_t)>;       // Processes an item on the given worker
+    using Sink = std::function<void(T &)>;                // Consumes the items in source order
+
+    /**
+     * @brief Creates a pipeline.
+     *
+     * @param sourceName Stats name of the source.
+     * @param sinkName Stats name of the sink.
+     * @param sinkCapacity Capacity of the queue in front of the sink.
+     */
+    explicit Pipeline(std::string sourceName = "decode", std::string sinkName = "encode", size_t sinkCapacity = 8)
+        : sourceState(std::move(sourceName), 1, 0), sinkState(std::move(sinkName), 1, sinkCapacity) {}
+
+    Pipeline(const Pipeline &) = delete;
+    Pipeline &operator=(const Pipeline &) = delete;
+
+    /**
+     * @brief Appends a stage; stages run in the order they were added.
+     *
+     * @param name Stats name of the stage.
+     * @param workers Worker threads of the stage.
+     * @param fn Stage function, called concurrently by the workers.
+     * @param capacity Capacity of the queue in front of the stage (0 = twice the workers).
+     */
+    Pipeline &addStage(std::string name, size_t workers, Stage fn, size_t capacity = 0) {
+        if (workers == 0) {
+            throw std::invalid_argument("Pipeline: a stage needs at least one worker.");
+        }
+        std::unique_ptr<StageState> stage(new StageState(std::move(name), workers, capacity ? capacity : 2 * workers));
+        stage->fn = std::move(fn);
+        stages.push_back(std::move(stage));
+        return *this;
+    }
+
+    /**
+     * @brief Caps the items in flight between the source and the sink (0 = the sum of all
+     *        queue capacities and workers, i.e. just enough to keep every stage busy).
+     */
+    Pipeline &setMaxInFlight(size_t maxItems) {
+        maxInFlight = maxItems;
+        return *this;
+    }
+
+    /**
+     * @brief Runs the whole stream through the pipeline; blocks until the sink got the last item.
+     *        The sink runs on the calling thread. A pipeline can run only once.
+     */
+    void run(Source source, Sink sink) {
+        if (started.exchange(true)) {
+            throw std::logic_error("Pipeline: run() can only be called once.");
+        }
+
+        size_t window = maxInFlight;
+        if (window == 0) {
+            window = sinkState.capacity + 2;
+            for (const auto &stage : stages) {
+                window += stage->capacity + stage->workers;
+            }
+        }
+
+        startTime = std::chrono::steady_clock::now();
+        running = true;
+
+        std::vector<std::thread> threads;
+        threads.emplace_back(&Pipeline::sourceLoop, this, std::move(source), window);
+        for (size_t s = 0; s < stages.size(); ++s) {
+            stages[s]->active = stages[s]->workers;
+            for (size_t w = 0; w < stages[s]->workers; ++w) {
+                threads.emplace_back(&Pipeline::workerLoop, this, s, w);
+            }
+        }
+        sinkLoop(sink);
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        endTime = std::chrono::steady_clock::now();
+        finished = true;
+        running = false;
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief Snapshot of the stage counters: the source first, then the stages, then the sink.
+     */
+    std::vector<PipelineStageStats> stats() const {
+        double elapsed = 0.0;
+        if (running) {
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        } else if (finished) {
+            elapsed = std::chrono::duration<double>(endTime - startTime).count();
+        }
+
+        std::vector<PipelineStageStats> result;
+        result.push_back(sourceState.snapshot(elapsed, 0));
+        for (const auto &stage : stages) {
+            result.push_back(stage->snapshot(elapsed, stage->input.size()));
+        }
+        result.push_back(sinkState.snapshot(elapsed, sinkState.input.size() + reorderDepth.load()));
+        return result;
+    }
+
+    /**
+     * @brief Prints stats() as a table.
+     */
+    void printStats(std::ostream &os = std::cout) const {
+        os << std::left << std::setw(14) << "stage" << std::right << std::setw(8) << "workers" << std::setw(10) << "queue"
+           << std::setw(10) << "items" << std::setw(10) << "items/s" << std::setw(8) << "busy" << "\n";
+        for (const PipelineStageStats &stage : stats()) {
+            const std::string depth = stage.queueCapacity
+                ? std::to_string(stage.queueDepth) + "/" + std::to_string(stage.queueCapacity) : "-";
+            os << std::left << std::setw(14) << stage.name << std::right << std::setw(8) << stage.workers << std::setw(10)
+               << depth << std::setw(10) << stage.processed << std::setw(10) << std::fixed << std::setprecision(1)
+               << stage.itemsPerSecond << std::setw(7) << std::setprecision(0) << stage.utilization * 100.0 << "%\n";
+        }
+        os << std::flush;
+    }
+
+private:
+    struct Item {
+        uint64_t seq = 0;
+        T value;
+    };
+
+    struct StageState {
+        std::string name;
+        size_t workers;
+        size_t capacity;
+        Queue<Item> input;
+        Stage fn;
+        std::atomic<size_t> active{0};             // Workers still running; the last one closes the next queue
+        std::atomic<uint64_t> processed{0};
+        std::atomic<int64_t> busyNanos{0};
+
+        StageState(std::string name, size_t workers, size_t capacity)
+            : name(std::move(name)), workers(workers), capacity(capacity), input(capacity ? capacity : 1) {}
+
+        void record(std::chrono::steady_clock::time_point begin) {
+            busyNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            ++processed;
+        }
+
+        PipelineStageStats snapshot(double elapsed, size_t depth) const {
+            PipelineStageStats stats;
+            stats.name = name;
+            stats.workers = workers;
+            stats.queueDepth = depth;
+            stats.queueCapacity = capacity;
+            stats.processed = processed.load();
+            if (elapsed > 0.0) {
+                stats.itemsPerSecond = static_cast<double>(stats.processed) / elapsed;
+                stats.utilization = std::min(1.0, static_cast<double>(busyNanos.load()) * 1e-9 / (elapsed * workers));
+            }
+            return stats;
+        }
+    };
+
+    StageState sourceState;
+    StageState sinkState;
+    std::vector<std::unique_ptr<StageState>> stages;
+    size_t maxInFlight = 0;
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> running{false};              // Published after startTime
+    std::atomic<bool> finished{false};             // Published after endTime
+    std::atomic<bool> aborted{false};
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point endTime;
+    std::atomic<size_t> reorderDepth{0};
+
+    std::mutex windowMutex;                        // Guards inFlight
+    std::condition_variable windowAvailable;
+    size_t inFlight = 0;
+
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    Queue<Item> &outputOf(size_t stage) {
+        return stage + 1 < stages.size() ? stages[stage + 1]->input : sinkState.input;
+    }
+
+    // Records the first error and unblocks every thread
+    void abort() {
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        aborted = true;
+        for (auto &stage : stages) {
+            stage->input.set_finished();
+        }
+        sinkState.input.set_finished();
+        {
+            std::lock_guard<std::mutex> lock(windowMutex); // Orders the flag with a source checking the window
+        }
+        windowAvailable.notify_all();
+    }
+
+    void sourceLoop(Source source, size_t window) {
+        Queue<Item> &first = stages.empty() ? sinkState.input : stages.front()->input;
+        try {
+            for (uint64_t seq = 0;; ++seq) {
+                {
+                    std::unique_lock<std::mutex> lock(windowMutex);
+                    windowAvailable.wait(lock, [&]() { return inFlight < window || aborted; });
+                    if (aborted) {
+                        break;
+                    }
+                    ++inFlight;
+                }
+                Item item;
+                item.seq = seq;
+                const auto begin = std::chrono::steady_clock::now();
+                if (!source(item.value)) {
+                    break;
+                }
+                sourceState.record(begin);
+                if (!first.enqueue(std::move(item))) {
+                    break;
+                }
+            }
+        } catch (...) {
+            abort();
+        }
+        first.set_finished();
+    }
+
+    void workerLoop(size_t s, size_t worker) {
+        StageState &stage = *stages[s];
+        Queue<Item> &output = outputOf(s);
+        try {
+            Item item;
+            while (!aborted && stage.input.dequeue(item)) {
+                const auto begin = std::chrono::steady_clock::now();
+                stage.fn(item.value, worker);
+                stage.record(begin);
+                if (!output.enqueue(std::move(item))) {
+                    break;
+                }
+            }
+        } catch (...) {
+            abort();
+        }
+        if (--stage.active == 0) {
+            output.set_finished();
+        }
+    }
+
+    void sinkLoop(Sink &sink) {
+        std::map<uint64_t, T> reorder;         // Items that arrived ahead of their turn
+        uint64_t next = 0;
+        try {
+            Item item;
+            while (!aborted && sinkState.input.dequeue(item)) {
+                reorder.emplace(item.seq, std::move(item.value));
+                for (auto it = reorder.begin(); it != reorder.end() && it->first == next; it = reorder.begin()) {
+                    const auto begin = std::chrono::steady_clock::now();
+                    sink(it->second);
+                    sinkState.record(begin);
+                    reorder.erase(it);
+                    ++next;
+                    {
+                        std::lock_guard<std::mutex> lock(windowMutex);
+                        --inFlight;
+                    }
+                    windowAvailable.notify_one();
+                }
+                reorderDepth = reorder.size();
+            }
+        } catch (...) {
+            abort();
+        }
+    }
+};
+
+} // namespace yolos
+
+#endif // PIPELINE_HPP
@@ -0,0 +1,566 @@
+// Preprocessing.hpp
+#ifndef PREPROCESSING_HPP
+#define PREPROCESSING_HPP
+
+/**
+ * @file Preprocessing.hpp
+ * @brief Fused letterbox + normalize + HWC->CHW preprocessing shared by all detectors.
+ *
+ * The original per-task preprocessing ran letterBox (cv::resize + cv::copyMakeBorder),
+ * convertTo(CV_32FC3, 1/255) and cv::split, i.e. three passes over the frame and two
+ * intermediate Mats. LetterboxKernel produces the planar float tensor in one pass:
+ * every destination row is bilinearly resampled from two cached horizontal source
+ * rows, channel-swapped, scaled and written straight into its CHW plane, while the
+ * padding area is filled with a constant instead of going through float math.
+ *
+ * Both passes are vectorised with AVX2/FMA (runtime-dispatched), SSE2 or NEON, with a
+ * scalar fallback on other targets. The horizontal pass loads every tap pixel as one 32-bit
+ * word (a hardware gather on AVX2), splits the channels in the swapped order with shifts and
+ * interpolates them into the three planar rows; the vertical pass blends two such rows. The resampling follows cv::resize
+ * INTER_LINEAR pixel-centre alignment; results can differ from the 8-bit OpenCV
+ * path by less than one grey level since interpolation is done in float.
+ *
+ * FP16 models get the same kernel with a uint16_t destination: each blended row is
+ * converted to binary16 (see Half.hpp) from a band-local scratch row on its way into the
+ * plane, so no float tensor is materialized.
+ */
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "tools/Half.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define YOLOS_PREPROCESS_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define YOLOS_PREPROCESS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace yolos {
+
+/**
+ * @brief Geometry of a letterbox transform: where the resized image lands in the padded tensor.
+ */
+struct LetterboxParams {
+    cv::Size srcSize;   // Size of the source image
+    cv::Size outShape;  // Size of the padded tensor plane (W x H)
+    int unpadW = 0;     // Width of the resized image inside the tensor
+    int unpadH = 0;     // Height of the resized image inside the tensor
+    int padLeft = 0;    // Columns of padding on the left
+    int padTop = 0;     // Rows of padding on the top
+    float ratio = 1.f;  // Resize ratio (source -> tensor)
+
+    bool operator==(const LetterboxParams &o) const {
+        return srcSize == o.srcSize && outShape == o.outShape && unpadW == o.unpadW && unpadH == o.unpadH &&
+               padLeft == o.padLeft && padTop == o.padTop;
+    }
+    bool operator!=(const LetterboxParams &o) const { return !(*this == o); }
+};
+
+/**
+ * @brief Computes the letterbox geometry (Ultralytics semantics).
+ *
+ * @param srcSize Size of the source image.
+ * @param newShape Target tensor size.
+ * @param auto_ Pad only up to the next multiple of stride (dynamic-shape models).
+ * @param scaleFill Stretch to newShape without keeping the aspect ratio and without padding.
+ * @param scaleUp Allow upscaling of small images.
+ * @param stride Stride used when auto_ is set.
+ * @return LetterboxParams Geometry of the transform.
+ */
+inline LetterboxParams computeLetterbox(const cv::Size &srcSize, const cv::Size &newShape,
+                                        bool auto_ = false, bool scaleFill = false,
+                                        bool scaleUp = true, int stride = 32) {
+    if (srcSize.width <= 0 || srcSize.height <= 0 || newShape.width <= 0 || newShape.height <= 0) {
+        throw std::invalid_argument("computeLetterbox: source and target sizes must be positive.");
+    }
+
+    LetterboxParams p;
+    p.srcSize = srcSize;
+
+    float ratio = std::min(static_cast<float>(newShape.height) / srcSize.height,
+                           static_cast<float>(newShape.width) / srcSize.width);
+    if (!scaleUp) {
+        ratio = std::min(ratio, 1.0f);
+    }
+
+    int unpadW = std::max(1, static_cast<int>(std::round(srcSize.width * ratio)));
+    int unpadH = std::max(1, static_cast<int>(std::round(srcSize.height * ratio)));
+    int dw = newShape.width - unpadW;
+    int dh = newShape.height - unpadH;
+
+    if (auto_) {
+        // Minimum rectangle: only pad up to the next stride multiple
+        dw %= stride;
+        dh %= stride;
+    } else if (scaleFill) {
+        unpadW = newShape.width;
+        unpadH = newShape.height;
+        dw = 0;
+        dh = 0;
+    }
+
+    p.ratio = ratio;
+    p.unpadW = unpadW;
+    p.unpadH = unpadH;
+    p.padLeft = dw / 2;
+    p.padTop = dh / 2;
+    p.outShape = cv::Size(p.unpadW + dw, p.unpadH + dh);
+    return p;
+}
+
+namespace detail {
+
+// dst[i] = r0[i] * w0 + r1[i] * w1
+using BlendRowFn = void (*)(float *dst, const float *r0, const float *r1, float w0, float w1, int n);
+
+inline void blendRowScalar(float *dst, const float *r0, const float *r1, float w0, float w1, int n) {
+    for (int i = 0; i < n; ++i) {
+        dst[i] = r0[i] * w0 + r1[i] * w1;
+    }
+}
+
+#if defined(YOLOS_PREPROCESS_X86)
+inline void blendRowSSE2(float *dst, const float *r0, const float *r1, float w0, float w1, int n) {
+    const __m128 vw0 = _mm_set1_ps(w0);
+    const __m128 vw1 = _mm_set1_ps(w1);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(r0 + i), vw0);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(r1 + i), vw1);
+        _mm_storeu_ps(dst + i, _mm_add_ps(a, b));
+    }
+    blendRowScalar(dst + i, r0 + i, r1 + i, w0, w1, n - i);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2,fma")))
+inline void blendRowAVX2(float *dst, const float *r0, const float *r1, float w0, float w1, int n) {
+    const __m256 vw0 = _mm256_set1_ps(w0);
+    const __m256 vw1 = _mm256_set1_ps(w1);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(r0 + i), vw0);
+        _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_loadu_ps(r1 + i), vw1, a));
+    }
+    blendRowSSE2(dst + i, r0 + i, r1 + i, w0, w1, n - i);
+}
+#elif defined(__AVX2__)
+inline void blendRowAVX2(float *dst, const float *r0, const float *r1, float w0, float w1, int n) {
+    const __m256 vw0 = _mm256_set1_ps(w0);
+    const __m256 vw1 = _mm256_set1_ps(w1);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(r0 + i), vw0);
+        _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_loadu_ps(r1 + i), vw1, a));
+    }
+    blendRowSSE2(dst + i, r0 + i, r1 + i, w0, w1, n - i);
+}
+#endif
+#endif // YOLOS_PREPROCESS_X86
+
+#if defined(YOLOS_PREPROCESS_NEON)
+inline void blendRowNEON(float *dst, const float *r0, const float *r1, float w0, float w1, int n) {
+    const float32x4_t vw0 = vdupq_n_f32(w0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t a = vmulq_f32(vld1q_f32(r0 + i), vw0);
+        vst1q_f32(dst + i, vmlaq_n_f32(a, vld1q_f32(r1 + i), w1));
+    }
+    blendRowScalar(dst + i, r0 + i, r1 + i, w0, w1, n - i);
+}
+#endif
+
+/**
+ * @brief Picks the widest row blend supported by the running CPU (resolved once).
+ */
+inline BlendRowFn selectBlendRow() {
+#if defined(YOLOS_PREPROCESS_X86)
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return blendRowAVX2;
+    }
+#elif defined(__AVX2__)
+    return blendRowAVX2;
+#endif
+    return blendRowSSE2;
+#elif defined(YOLOS_PREPROCESS_NEON)
+    return blendRowNEON;
+#else
+    return blendRowScalar;
+#endif
+}
+
+inline BlendRowFn blendRow() {
+    static const BlendRowFn fn = selectBlendRow();
+    return fn;
+}
+
+// Horizontal pass of one source row: for x in [begin, end), planes[p][x] interpolates channel
+// order[p] of the pixels at byte offsets xofs0[x] and xofs1[x] of src with weight alpha[x]
+using ResampleRowFn = void (*)(float *const planes[3], const uchar *src, const int *xofs0, const int *xofs1,
+                               const float *alpha, const int order[3], int begin, int end);
+
+inline void resampleRowScalar(float *const planes[3], const uchar *src, const int *xofs0, const int *xofs1,
+                              const float *alpha, const int order[3], int begin, int end) {
+    const int c0 = order[0], c1 = order[1], c2 = order[2];
+    for (int x = begin; x < end; ++x) {
+        const uchar *a = src + xofs0[x];
+        const uchar *b = src + xofs1[x];
+        const float t = alpha[x];
+        planes[0][x] = static_cast<float>(a[c0]) + t * (static_cast<float>(b[c0]) - static_cast<float>(a[c0]));
+        planes[1][x] = static_cast<float>(a[c1]) + t * (static_cast<float>(b[c1]) - static_cast<float>(a[c1]));
+        planes[2][x] = static_cast<float>(a[c2]) + t * (static_cast<float>(b[c2]) - static_cast<float>(a[c2]));
+    }
+}
+
+// The vector versions load each BGR pixel as one 32-bit word (the pixel and the next byte) and
+// split the channels with shifts, so every pixel in [begin, end) needs a byte after it in the row
+
+#if defined(YOLOS_PREPROCESS_X86)
+inline __m128i loadPixelsSSE2(const uchar *src, const int *ofs) {
+    int32_t words[4];
+    for (int k = 0; k < 4; ++k) {
+        std::memcpy(&words[k], src + ofs[k], sizeof(int32_t));
+    }
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(words));
+}
+
+inline void resampleRowSSE2(float *const planes[3], const uchar *src, const int *xofs0, const int *xofs1,
+                            const float *alpha, const int order[3], int begin, int end) {
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    const __m128i shifts[3] = {_mm_cvtsi32_si128(8 * order[0]), _mm_cvtsi32_si128(8 * order[1]),
+                               _mm_cvtsi32_si128(8 * order[2])};
+    int x = begin;
+    for (; x + 4 <= end; x += 4) {
+        const __m128i a = loadPixelsSSE2(src, xofs0 + x);
+        const __m128i b = loadPixelsSSE2(src, xofs1 + x);
+        const __m128 t = _mm_loadu_ps(alpha + x);
+        for (int p = 0; p < 3; ++p) {
+            const __m128 fa = _mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(a, shifts[p]), byteMask));
+            const __m128 fb = _mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(b, shifts[p]), byteMask));
+            _mm_storeu_ps(planes[p] + x, _mm_add_ps(fa, _mm_mul_ps(t, _mm_sub_ps(fb, fa))));
+        }
+    }
+    resampleRowScalar(planes, src, xofs0, xofs1, alpha, order, x, end);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define YOLOS_PREPROCESS_AVX2_TARGET __attribute__((target("avx2,fma")))
+#else
+#define YOLOS_PREPROCESS_AVX2_TARGET
+#endif
+
+#if defined(__GNUC__) || defined(__clang__) || defined(__AVX2__)
+YOLOS_PREPROCESS_AVX2_TARGET
+inline void resampleRowAVX2(float *const planes[3], const uchar *src, const int *xofs0, const int *xofs1,
+                            const float *alpha, const int order[3], int begin, int end) {
+    const int *base = reinterpret_cast<const int *>(src);
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m128i shifts[3] = {_mm_cvtsi32_si128(8 * order[0]), _mm_cvtsi32_si128(8 * order[1]),
+                               _mm_cvtsi32_si128(8 * order[2])};
+    int x = begin;
+    for (; x + 8 <= end; x += 8) {
+        const __m256i a = _mm256_i32gather_epi32(base, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(xofs0 + x)), 1);
+        const __m256i b = _mm256_i32gather_epi32(base, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(xofs1 + x)), 1);
+        const __m256 t = _mm256_loadu_ps(alpha + x);
+        for (int p = 0; p < 3; ++p) {
+            const __m256 fa = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(a, shifts[p]), byteMask));
+            const __m256 fb = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(b, shifts[p]), byteMask));
+            _mm256_storeu_ps(planes[p] + x, _mm256_fmadd_ps(t, _mm256_sub_ps(fb, fa), fa));
+        }
+    }
+    resampleRowSSE2(planes, src, xofs0, xofs1, alpha, order, x, end);
+}
+#define YOLOS_PREPROCESS_HAS_AVX2 1
+#endif
+#endif // YOLOS_PREPROCESS_X86
+
+#if defined(YOLOS_PREPROCESS_NEON)
+inline uint32x4_t loadPixelsNEON(const uchar *src, const int *ofs) {
+    uint32_t words[4];
+    for (int k = 0; k < 4; ++k) {
+        std::memcpy(&words[k], src + ofs[k], sizeof(uint32_t));
+    }
+    return vld1q_u32(words);
+}
+
+inline void resampleRowNEON(float *const planes[3], const uchar *src, const int *xofs0, const int *xofs1,
+                            const float *alpha, const int order[3], int begin, int end) {
+    const uint32x4_t byteMask = vdupq_n_u32(0xFF);
+    const int32x4_t shifts[3] = {vdupq_n_s32(-8 * order[0]), vdupq_n_s32(-8 * order[1]), vdupq_n_s32(-8 * order[2])};
+    int x = begin;
+    for (; x + 4 <= end; x += 4) {
+        const uint32x4_t a = loadPixelsNEON(src, xofs0 + x);
+        const uint32x4_t b = loadPixelsNEON(src, xofs1 + x);
+        const float32x4_t t = vld1q_f32(alpha + x);
+        for (int p = 0; p < 3; ++p) {
+            const float32x4_t fa = vcvtq_f32_u32(vandq_u32(vshlq_u32(a, shifts[p]), byteMask));
+            const float32x4_t fb = vcvtq_f32_u32(vandq_u32(vshlq_u32(b, shifts[p]), byteMask));
+            vst1q_f32(planes[p] + x, vmlaq_f32(fa, t, vsubq_f32(fb, fa)));
+        }
+    }
+    resampleRowScalar(planes, src, xofs0, xofs1, alpha, order, x, end);
+}
+#endif
+
+/**
+ * @brief Picks the widest horizontal resampler supported by the running CPU (resolved once).
+ */
+inline ResampleRowFn selectResampleRow() {
+#if defined(YOLOS_PREPROCESS_X86)
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return resampleRowAVX2;
+    }
+#elif defined(YOLOS_PREPROCESS_HAS_AVX2)
+    return resampleRowAVX2;
+#endif
+    return resampleRowSSE2;
+#elif defined(YOLOS_PREPROCESS_NEON)
+    return resampleRowNEON;
+#else
+    return resampleRowScalar;
+#endif
+}
+
+inline ResampleRowFn resampleRow() {
+    static const ResampleRowFn fn = selectResampleRow();
+    return fn;
+}
+
+} // namespace detail
+
+/**
+ * @brief Single-pass letterbox kernel writing a planar float (or binary16) tensor.
+ *
+ * Interpolation tables and the row caches are kept between calls and only rebuilt
+ * when the geometry changes, so steady-state calls do not allocate. Interior rows are
+ * processed in bands through cv::parallel_for_. One instance must not be used from
+ * several threads at once.
+ */
+class LetterboxKernel {
+public:
+    /**
+     * @brief Letterboxes image into dst (3 planes of params.outShape).
+     *
+     * @param image Source image (8-bit BGR; gray and BGRA inputs are converted first).
+     * @param params Geometry from computeLetterbox() for this image size.
+     * @param dst Destination holding 3 * outShape.area() floats.
+     * @param swapRB Write channels in RGB order (what Ultralytics models are trained on).
+     * @param padValue Pixel value of the padding, before scaling.
+     * @param scale Multiplier applied to every pixel (1/255 maps to [0, 1]).
+     */
+    void run(const cv::Mat &image, const LetterboxParams &params, float *dst,
+             bool swapRB = true, float padValue = 114.0f, float scale = 1.0f / 255.0f) {
+        runInto(image, params, dst, swapRB, padValue, scale);
+    }
+
+    /**
+     * @brief Letterboxes image into a binary16 tensor (3 planes of params.outShape), for FP16 models.
+     *
+     * Same arguments as the float overload; dst holds 3 * outShape.area() half values.
+     */
+    void run(const cv::Mat &image, const LetterboxParams &params, uint16_t *dst,
+             bool swapRB = true, float padValue = 114.0f, float scale = 1.0f / 255.0f) {
+        runInto(image, params, dst, swapRB, padValue, scale);
+    }
+
+private:
+    template <typename T>
+    void runInto(const cv::Mat &image, const LetterboxParams &params, T *dst,
+                 bool swapRB, float padValue, float scale) {
+        constexpr bool half = std::is_same<T, uint16_t>::value;
+        if (image.empty()) {
+            throw std::runtime_error("LetterboxKernel: input image is empty.");
+        }
+        if (image.depth() != CV_8U) {
+            throw std::runtime_error("LetterboxKernel: only 8-bit images are supported.");
+        }
+        if (image.size() != params.srcSize) {
+            throw std::runtime_error("LetterboxKernel: params were computed for a different image size.");
+        }
+
+        const cv::Mat *src = &image;
+        if (image.channels() == 1) {
+            cv::cvtColor(image, converted_, cv::COLOR_GRAY2BGR);
+            src = &converted_;
+        } else if (image.channels() == 4) {
+            cv::cvtColor(image, converted_, cv::COLOR_BGRA2BGR);
+            src = &converted_;
+        }
+
+        if (params != params_) {
+            buildTables(params);
+        }
+
+        const int outW = params.outShape.width;
+        const int outH = params.outShape.height;
+        const int unpadW = params.unpadW;
+        const size_t plane = static_cast<size_t>(outW) * static_cast<size_t>(outH);
+        const float padF = padValue * scale;
+        const T pad = toElement<T>(padF);
+        T *planes[3] = {dst, dst + plane, dst + 2 * plane};
+
+        // Top and bottom padding bands
+        const int padBottom = outH - params.padTop - params.unpadH;
+        for (T *p : planes) {
+            std::fill_n(p, static_cast<size_t>(params.padTop) * outW, pad);
+            std::fill_n(p + static_cast<size_t>(params.padTop + params.unpadH) * outW,
+                        static_cast<size_t>(padBottom) * outW, pad);
+        }
+
+        // Interior rows are split into bands; each band owns a two-row cache (plus a blend row for
+        // half output) so bands run in parallel
+        const int minRowsPerBand = 16;
+        const int numBands = std::max(1, std::min(cv::getNumThreads(), params.unpadH / minRowsPerBand));
+        const size_t slotSize = static_cast<size_t>(3) * unpadW;
+        const size_t bandSize = 2 * slotSize + (half ? static_cast<size_t>(unpadW) : 0);
+        if (rowCache_.size() < numBands * bandSize) {
+            rowCache_.resize(numBands * bandSize);
+        }
+
+        const int channelOrder[3] = {swapRB ? 2 : 0, 1, swapRB ? 0 : 2};
+        const detail::BlendRowFn blend = detail::blendRow();
+        const detail::FloatToHalfRowFn toHalf = detail::floatToHalfRow();
+        const int srcRows = src->rows;
+        const float scaleY = static_cast<float>(srcRows) / static_cast<float>(params.unpadH);
+        const int padRight = outW - params.padLeft - unpadW;
+
+        auto processBand = [&](int band) {
+            const int yBegin = static_cast<int>(static_cast<int64_t>(params.unpadH) * band / numBands);
+            const int yEnd = static_cast<int>(static_cast<int64_t>(params.unpadH) * (band + 1) / numBands);
+            RowCache cache{rowCache_.data() + band * bandSize, {-1, -1}};
+            float *blended = cache.slots + 2 * slotSize;
+
+            for (int y = yBegin; y < yEnd; ++y) {
+                // Same pixel-centre mapping as cv::resize INTER_LINEAR
+                float sy = (static_cast<float>(y) + 0.5f) * scaleY - 0.5f;
+                if (sy < 0.f) sy = 0.f;
+                int y0 = static_cast<int>(sy);
+                float fy = sy - static_cast<float>(y0);
+                if (y0 >= srcRows - 1) {
+                    y0 = srcRows - 1;
+                    fy = 0.f;
+                }
+                const int y1 = std::min(y0 + 1, srcRows - 1);
+
+                const float *h0 = horizontalRow(*src, cache, y0, y1, channelOrder);
+                const float *h1 = horizontalRow(*src, cache, y1, y0, channelOrder);
+
+                const float w0 = (1.f - fy) * scale;
+                const float w1 = fy * scale;
+                for (int c = 0; c < 3; ++c) {
+                    T *out = planes[c] + static_cast<size_t>(params.padTop + y) * outW;
+                    std::fill_n(out, params.padLeft, pad);
+                    if constexpr (half) {
+                        blend(blended, h0 + c * unpadW, h1 + c * unpadW, w0, w1, unpadW);
+                        toHalf(blended, out + params.padLeft, static_cast<size_t>(unpadW));
+                    } else {
+                        blend(out + params.padLeft, h0 + c * unpadW, h1 + c * unpadW, w0, w1, unpadW);
+                    }
+                    std::fill_n(out + params.padLeft + unpadW, padRight, pad);
+                }
+            }
+        };
+
+        if (numBands == 1) {
+            processBand(0);
+        } else {
+            cv::parallel_for_(cv::Range(0, numBands), [&](const cv::Range &range) {
+                for (int band = range.start; band < range.end; ++band) {
+                    processBand(band);
+                }
+            });
+        }
+    }
+
+    template <typename T>
+    static T toElement(float value) {
+        if constexpr (std::is_same<T, uint16_t>::value) {
+            return floatToHalf(value);
+        } else {
+            return value;
+        }
+    }
+
+    void buildTables(const LetterboxParams &params) {
+        params_ = params;
+        const int srcCols = params.srcSize.width;
+        const float scaleX = static_cast<float>(srcCols) / static_cast<float>(params.unpadW);
+
+        xofs0_.resize(params.unpadW);
+        xofs1_.resize(params.unpadW);
+        alpha_.resize(params.unpadW);
+        for (int x = 0; x < params.unpadW; ++x) {
+            float sx = (static_cast<float>(x) + 0.5f) * scaleX - 0.5f;
+            if (sx < 0.f) sx = 0.f;
+            int x0 = static_cast<int>(sx);
+            float fx = sx - static_cast<float>(x0);
+            if (x0 >= srcCols - 1) {
+                x0 = srcCols - 1;
+                fx = 0.f;
+            }
+            xofs0_[x] = x0 * 3;
+            xofs1_[x] = std::min(x0 + 1, srcCols - 1) * 3;
+            alpha_[x] = fx;
+        }
+
+        // The vector resamplers read one byte past each tap pixel; the last pixels of a row
+        // (whose right tap is the final pixel) go through the scalar path
+        vectorEnd_ = 0;
+        while (vectorEnd_ < params.unpadW && xofs1_[vectorEnd_] + 3 < srcCols * 3) {
+            ++vectorEnd_;
+        }
+    }
+
+    struct RowCache {
+        float *slots;    // Two planar rows of 3 * unpadW floats
+        int rows[2];     // Source row held by each slot (-1 when empty)
+    };
+
+    /**
+     * @brief Returns the horizontally resampled planar row for source row `row`, computing it
+     *        into a cache slot that does not hold `keep` when it is not cached yet.
+     */
+    const float *horizontalRow(const cv::Mat &src, RowCache &cache, int row, int keep, const int channelOrder[3]) const {
+        const size_t slotSize = static_cast<size_t>(3) * params_.unpadW;
+        for (int s = 0; s < 2; ++s) {
+            if (cache.rows[s] == row) {
+                return cache.slots + s * slotSize;
+            }
+        }
+        const int slot = (cache.rows[0] == keep) ? 1 : 0;
+        float *h = cache.slots + slot * slotSize;
+        float *hc[3] = {h, h + params_.unpadW, h + 2 * params_.unpadW};
+
+        const uchar *s = src.ptr<uchar>(row);
+        detail::resampleRow()(hc, s, xofs0_.data(), xofs1_.data(), alpha_.data(), channelOrder, 0, vectorEnd_);
+        detail::resampleRowScalar(hc, s, xofs0_.data(), xofs1_.data(), alpha_.data(), channelOrder, vectorEnd_,
+                                  params_.unpadW);
+        cache.rows[slot] = row;
+        return h;
+    }
+
+    LetterboxParams params_{};
+    std::vector<int> xofs0_, xofs1_;  // Byte offsets of the left/right source pixels
+    std::vector<float> alpha_;        // Horizontal interpolation weights
+    int vectorEnd_ = 0;               // Columns before this one are safe for the vector resamplers
+    std::vector<float> rowCache_;     // Two planar horizontally-resampled rows (and a blend row) per band
+    cv::Mat converted_;               // Scratch for non-BGR inputs
+};
+
+} // namespace yolos
+
+#endif // PREPROCESSING_HPP
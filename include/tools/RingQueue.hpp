@@ -0,0 +1,296 @@
+// RingQueue.hpp
+#ifndef RING_QUEUE_HPP
+#define RING_QUEUE_HPP
+
+/**
+ * @file RingQueue.hpp
+ * @brief Fixed-capacity lock-free ring queues with the interface of BoundedThreadSafeQueue.
+ *
+ * BoundedThreadSafeQueue takes a mutex and signals a condition variable on every
+ * operation, and its std::queue allocates deque blocks as it goes. The queues here
+ * preallocate their slots and hand items over with atomics only:
+ *
+ *  - SpscRingQueue: one producer thread and one consumer thread. Each side owns its
+ *    index and keeps a cached copy of the other one, so the fast path is a plain store
+ *    and, most of the time, no load of the other core's cache line.
+ *  - MpmcRingQueue: any number of producers and consumers (Dmitry Vyukov's bounded
+ *    queue: each slot carries a sequence number that tells whose turn it is).
+ *
+ * A blocked enqueue() or dequeue() spins for a while (spinCount) and then parks on a
+ * condition variable. Wake-ups only touch the mutex when a thread is actually parked,
+ * so a busy queue never makes a system call. Indices, sequence numbers and slots are
+ * padded to their own cache lines to avoid false sharing between the two sides.
+ *
+ * enqueue(), dequeue(), try_dequeue(), size() and set_finished() behave as in
+ * BoundedThreadSafeQueue, so a queue type can be swapped for another one through a
+ * single template argument (see Pipeline). An item enqueued concurrently with
+ * set_finished() may be discarded; finish the queue after the producers are done.
+ * Items are moved into and out of preallocated slots, so T must be default-constructible.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace yolos {
+namespace detail {
+
+constexpr size_t kCacheLineSize = 64;
+
+// Tells the core we are spinning (lower power, no memory-order speculation on exit)
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * @brief Spin-then-park waiting; notify() is free unless a thread is parked.
+ */
+class SpinThenPark {
+public:
+    // Spinning only helps when the other side runs on another core
+    explicit SpinThenPark(unsigned spinCount) : spinCount(std::thread::hardware_concurrency() > 1 ? spinCount : 0) {}
+
+    template <typename Ready>
+    void wait(Ready ready) {
+        for (unsigned i = 0; i < spinCount; ++i) {
+            if (ready()) {
+                return;
+            }
+            cpuRelax();
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        condition.wait(lock, ready);
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notifyOne() {
+        // Pairs with the increment in wait(): either we see the sleeper or it sees our update
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            condition.notify_one();
+        }
+    }
+
+    void notifyAll() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            condition.notify_all();
+        }
+    }
+
+private:
+    unsigned spinCount;
+    std::atomic<int> sleepers{0};
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+} // namespace detail
+} // namespace yolos
+
+/**
+ * @brief Single-producer, single-consumer bounded ring queue.
+ */
+template <typename T>
+class SpscRingQueue {
+public:
+    SpscRingQueue(size_t max_size, unsigned spinCount = 256)
+        : capacity_(max_size), slots_(new Slot[max_size]), notEmpty_(spinCount), notFull_(spinCount) {
+        if (max_size == 0) {
+            throw std::invalid_argument("SpscRingQueue: capacity must be positive.");
+        }
+    }
+
+    bool enqueue(T item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - headCache_ >= capacity_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail - headCache_ >= capacity_) {
+                notFull_.wait([&]() { return finished_.load(std::memory_order_acquire) || tail - head_.load(std::memory_order_acquire) < capacity_; });
+                headCache_ = head_.load(std::memory_order_acquire);
+            }
+        }
+        if (finished_.load(std::memory_order_acquire)) return false;
+        slots_[tail % capacity_].value = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        notEmpty_.notifyOne();
+        return true;
+    }
+
+    bool dequeue(T& item) {
+        if (try_dequeue(item)) return true;
+        notEmpty_.wait([&]() { return finished_.load(std::memory_order_acquire) || head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_acquire); });
+        return try_dequeue(item);
+    }
+
+    // Non-blocking dequeue: returns false right away if the queue is empty
+    bool try_dequeue(T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head == tailCache_) return false;
+        }
+        item = std::move(slots_[head % capacity_].value);
+        head_.store(head + 1, std::memory_order_release);
+        notFull_.notifyOne();
+        return true;
+    }
+
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    void set_finished() {
+        finished_.store(true, std::memory_order_release);
+        notEmpty_.notifyAll();
+        notFull_.notifyAll();
+    }
+
+private:
+    struct alignas(yolos::detail::kCacheLineSize) Slot {
+        T value;
+    };
+
+    const size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(yolos::detail::kCacheLineSize) std::atomic<size_t> tail_{0};   // Written by the producer
+    size_t headCache_ = 0;                                                  // Producer's view of head_
+    alignas(yolos::detail::kCacheLineSize) std::atomic<size_t> head_{0};   // Written by the consumer
+    size_t tailCache_ = 0;                                                  // Consumer's view of tail_
+    alignas(yolos::detail::kCacheLineSize) std::atomic<bool> finished_{false};
+
+    yolos::detail::SpinThenPark notEmpty_;
+    yolos::detail::SpinThenPark notFull_;
+};
+
+/**
+ * @brief Multi-producer, multi-consumer bounded ring queue.
+ */
+template <typename T>
+class MpmcRingQueue {
+public:
+    MpmcRingQueue(size_t max_size, unsigned spinCount = 256)
+        : capacity_(max_size), cells_(new Cell[max_size]), notEmpty_(spinCount), notFull_(spinCount) {
+        if (max_size == 0) {
+            throw std::invalid_argument("MpmcRingQueue: capacity must be positive.");
+        }
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool enqueue(T item) {
+        for (;;) {
+            if (finished_.load(std::memory_order_acquire)) return false;
+            if (try_enqueue(item)) {
+                notEmpty_.notifyOne();
+                return true;
+            }
+            notFull_.wait([this]() { return finished_.load(std::memory_order_acquire) || size() < capacity_; });
+        }
+    }
+
+    bool dequeue(T& item) {
+        for (;;) {
+            if (try_dequeue(item)) return true;
+            if (finished_.load(std::memory_order_acquire)) {
+                return try_dequeue(item); // Drain what was published before the queue finished
+            }
+            notEmpty_.wait([this]() { return finished_.load(std::memory_order_acquire) || size() > 0; });
+        }
+    }
+
+    // Non-blocking dequeue: returns false right away if the queue is empty
+    bool try_dequeue(T& item) {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &cells_[pos % capacity_];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // Empty
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        item = std::move(cell->value);
+        cell->sequence.store(pos + capacity_, std::memory_order_release);
+        notFull_.notifyOne();
+        return true;
+    }
+
+    // Approximate while other threads are enqueueing or dequeueing
+    size_t size() const {
+        const size_t enqueued = enqueuePos_.load(std::memory_order_acquire);
+        const size_t dequeued = dequeuePos_.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    void set_finished() {
+        finished_.store(true, std::memory_order_release);
+        notEmpty_.notifyAll();
+        notFull_.notifyAll();
+    }
+
+private:
+    struct alignas(yolos::detail::kCacheLineSize) Cell {
+        std::atomic<size_t> sequence{0};   // == position: free for that enqueue; == position + 1: holds its item
+        T value;
+    };
+
+    bool try_enqueue(T& item) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &cells_[pos % capacity_];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    const size_t capacity_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(yolos::detail::kCacheLineSize) std::atomic<size_t> enqueuePos_{0};
+    alignas(yolos::detail::kCacheLineSize) std::atomic<size_t> dequeuePos_{0};
+    alignas(yolos::detail::kCacheLineSize) std::atomic<bool> finished_{false};
+
+    yolos::detail::SpinThenPark notEmpty_;
+    yolos::detail::SpinThenPark notFull_;
+};
+
+#endif // RING_QUEUE_HPP
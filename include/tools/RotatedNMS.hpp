@@ -0,0 +1,376 @@
+// RotatedNMS.hpp
+#ifndef ROTATED_NMS_HPP
+#define ROTATED_NMS_HPP
+
+/**
+ * @file RotatedNMS.hpp
+ * @brief Streaming ProbIoU non-maximum suppression for oriented boxes (xywhr).
+ *
+ * ProbIoU compares the Gaussian approximations of two rotated boxes (covariance
+ * [a c; c b] with a, b, c derived from w, h and the angle) through their Bhattacharyya
+ * distance. Building the full N x N ProbIoU matrix first costs O(N^2) memory and
+ * transcendental calls for every pair. RotatedNMSEngine instead:
+ *
+ *  - computes the covariance of every candidate once, into struct-of-arrays buffers;
+ *  - visits candidates in score order (binary heap, stops at maxDetections) and tests
+ *    each one only against the boxes kept so far, so memory is O(N);
+ *  - rejects most kept boxes without any log/exp/sqrt: the Bhattacharyya distance is
+ *    bounded below by its Mahalanobis part, which in turn is bounded by the distance of
+ *    the centres relative to the boxes' circumscribed circles. Both bounds are checked
+ *    for 8 kept boxes at a time (AVX2 runtime-dispatched, SSE2 or NEON, scalar fallback),
+ *    and the exact ProbIoU is only evaluated for boxes that pass them.
+ *
+ * A candidate is suppressed when its ProbIoU with a kept box (of the same class, unless
+ * agnostic) is >= iouThreshold.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "tools/NMS.hpp"
+
+namespace yolos {
+
+namespace detail {
+
+// Kept boxes tested per kernel call
+constexpr int kRotatedLanes = 8;
+// Stabiliser used by ProbIoU (as in Ultralytics)
+constexpr float kProbiouEps = 1e-7f;
+
+/**
+ * @brief A rotated box reduced to its centre and covariance terms.
+ */
+struct RotatedReference {
+    float x, y;     // Centre
+    float a, b, c;  // Covariance [a c; c b]
+};
+
+// Bit i is set unless a lower bound proves that the Bhattacharyya distance between kept
+// box i and ref exceeds limit. With S = S1 + S2, D = det(S) + eps and d the centre offset,
+// the Mahalanobis part of the distance is 0.25 * d^T adj(S) d / D, and since
+// lambda_min(S) >= det(S) / trace(S) it is at least 0.25 * |d|^2 * det(S) / (trace(S) * D):
+// the centre distance measured against the boxes' circumscribed circles (trace = r^2 / 3).
+// Both bounds only hold for det(S) > 0; degenerate boxes, whose determinant can round to zero
+// or below, and lanes where a comparison is NaN are kept for the exact test.
+using RotatedCandidateMaskFn = uint32_t (*)(const float *x, const float *y, const float *a, const float *b,
+                                            const float *c, const RotatedReference &ref, float limit);
+
+inline uint32_t rotatedCandidateMaskScalar(const float *x, const float *y, const float *a, const float *b,
+                                           const float *c, const RotatedReference &ref, float limit) {
+    uint32_t mask = 0;
+    for (int i = 0; i < kRotatedLanes; ++i) {
+        const float dx = x[i] - ref.x;
+        const float dy = y[i] - ref.y;
+        const float A = a[i] + ref.a;
+        const float B = b[i] + ref.b;
+        const float C = c[i] + ref.c;
+        const float det = A * B - C * C;
+        const float denom = det + kProbiouEps;
+        const bool circleReject = det > 0.0f && 0.25f * (dx * dx + dy * dy) * det > limit * (A + B) * denom;
+        const bool mahaReject = denom > 0.0f &&
+                                0.25f * (A * dy * dy + B * dx * dx - 2.0f * C * dx * dy) > limit * denom;
+        if (!circleReject && !mahaReject) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+#if defined(YOLOS_NMS_X86)
+inline uint32_t rotatedCandidateMaskSSE2(const float *x, const float *y, const float *a, const float *b,
+                                         const float *c, const RotatedReference &ref, float limit) {
+    const __m128 rx = _mm_set1_ps(ref.x), ry = _mm_set1_ps(ref.y);
+    const __m128 ra = _mm_set1_ps(ref.a), rb = _mm_set1_ps(ref.b), rc = _mm_set1_ps(ref.c);
+    const __m128 vl = _mm_set1_ps(limit), quarter = _mm_set1_ps(0.25f), two = _mm_set1_ps(2.0f);
+    const __m128 eps = _mm_set1_ps(kProbiouEps), zero = _mm_setzero_ps();
+    uint32_t mask = 0;
+    for (int i = 0; i < kRotatedLanes; i += 4) {
+        const __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), rx);
+        const __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), ry);
+        const __m128 A = _mm_add_ps(_mm_loadu_ps(a + i), ra);
+        const __m128 B = _mm_add_ps(_mm_loadu_ps(b + i), rb);
+        const __m128 C = _mm_add_ps(_mm_loadu_ps(c + i), rc);
+        const __m128 dx2 = _mm_mul_ps(dx, dx), dy2 = _mm_mul_ps(dy, dy);
+        const __m128 det = _mm_sub_ps(_mm_mul_ps(A, B), _mm_mul_ps(C, C));
+        const __m128 denom = _mm_add_ps(det, eps);
+        const __m128 circleReject = _mm_and_ps(_mm_cmpgt_ps(det, zero),
+                                               _mm_cmpgt_ps(_mm_mul_ps(_mm_mul_ps(quarter, _mm_add_ps(dx2, dy2)), det),
+                                                            _mm_mul_ps(_mm_mul_ps(vl, _mm_add_ps(A, B)), denom)));
+        if (_mm_movemask_ps(circleReject) == 0xF) {
+            continue;
+        }
+        const __m128 q = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(A, dy2), _mm_mul_ps(B, dx2)),
+                                    _mm_mul_ps(_mm_mul_ps(two, C), _mm_mul_ps(dx, dy)));
+        const __m128 mahaReject = _mm_and_ps(_mm_cmpgt_ps(denom, zero),
+                                             _mm_cmpgt_ps(_mm_mul_ps(quarter, q), _mm_mul_ps(vl, denom)));
+        mask |= static_cast<uint32_t>(~_mm_movemask_ps(_mm_or_ps(circleReject, mahaReject)) & 0xF) << i;
+    }
+    return mask;
+}
+
+#if defined(YOLOS_NMS_HAS_AVX2)
+YOLOS_NMS_AVX2_TARGET
+inline uint32_t rotatedCandidateMaskAVX2(const float *x, const float *y, const float *a, const float *b,
+                                         const float *c, const RotatedReference &ref, float limit) {
+    const __m256 rx = _mm256_set1_ps(ref.x), ry = _mm256_set1_ps(ref.y);
+    const __m256 ra = _mm256_set1_ps(ref.a), rb = _mm256_set1_ps(ref.b), rc = _mm256_set1_ps(ref.c);
+    const __m256 vl = _mm256_set1_ps(limit), quarter = _mm256_set1_ps(0.25f), two = _mm256_set1_ps(2.0f);
+    const __m256 eps = _mm256_set1_ps(kProbiouEps), zero = _mm256_setzero_ps();
+    const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x), rx);
+    const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y), ry);
+    const __m256 A = _mm256_add_ps(_mm256_loadu_ps(a), ra);
+    const __m256 B = _mm256_add_ps(_mm256_loadu_ps(b), rb);
+    const __m256 C = _mm256_add_ps(_mm256_loadu_ps(c), rc);
+    const __m256 dx2 = _mm256_mul_ps(dx, dx), dy2 = _mm256_mul_ps(dy, dy);
+    const __m256 det = _mm256_sub_ps(_mm256_mul_ps(A, B), _mm256_mul_ps(C, C));
+    const __m256 denom = _mm256_add_ps(det, eps);
+    const __m256 circleReject = _mm256_and_ps(
+        _mm256_cmp_ps(det, zero, _CMP_GT_OQ),
+        _mm256_cmp_ps(_mm256_mul_ps(_mm256_mul_ps(quarter, _mm256_add_ps(dx2, dy2)), det),
+                      _mm256_mul_ps(_mm256_mul_ps(vl, _mm256_add_ps(A, B)), denom), _CMP_GT_OQ));
+    if (_mm256_movemask_ps(circleReject) == 0xFF) {
+        return 0;
+    }
+    const __m256 q = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(A, dy2), _mm256_mul_ps(B, dx2)),
+                                   _mm256_mul_ps(_mm256_mul_ps(two, C), _mm256_mul_ps(dx, dy)));
+    const __m256 mahaReject = _mm256_and_ps(_mm256_cmp_ps(denom, zero, _CMP_GT_OQ),
+                                            _mm256_cmp_ps(_mm256_mul_ps(quarter, q), _mm256_mul_ps(vl, denom), _CMP_GT_OQ));
+    return static_cast<uint32_t>(~_mm256_movemask_ps(_mm256_or_ps(circleReject, mahaReject)) & 0xFF);
+}
+#endif
+#endif // YOLOS_NMS_X86
+
+#if defined(YOLOS_NMS_NEON)
+inline uint32_t rotatedCandidateMaskNEON(const float *x, const float *y, const float *a, const float *b,
+                                         const float *c, const RotatedReference &ref, float limit) {
+    const float32x4_t rx = vdupq_n_f32(ref.x), ry = vdupq_n_f32(ref.y);
+    const float32x4_t ra = vdupq_n_f32(ref.a), rb = vdupq_n_f32(ref.b), rc = vdupq_n_f32(ref.c);
+    const float32x4_t vl = vdupq_n_f32(limit), quarter = vdupq_n_f32(0.25f), two = vdupq_n_f32(2.0f);
+    const float32x4_t eps = vdupq_n_f32(kProbiouEps), zero = vdupq_n_f32(0.0f);
+    static const uint32_t laneBits[4] = {1, 2, 4, 8};
+    const uint32x4_t vbits = vld1q_u32(laneBits);
+    uint32_t mask = 0;
+    for (int i = 0; i < kRotatedLanes; i += 4) {
+        const float32x4_t dx = vsubq_f32(vld1q_f32(x + i), rx);
+        const float32x4_t dy = vsubq_f32(vld1q_f32(y + i), ry);
+        const float32x4_t A = vaddq_f32(vld1q_f32(a + i), ra);
+        const float32x4_t B = vaddq_f32(vld1q_f32(b + i), rb);
+        const float32x4_t C = vaddq_f32(vld1q_f32(c + i), rc);
+        const float32x4_t dx2 = vmulq_f32(dx, dx), dy2 = vmulq_f32(dy, dy);
+        const float32x4_t det = vsubq_f32(vmulq_f32(A, B), vmulq_f32(C, C));
+        const float32x4_t denom = vaddq_f32(det, eps);
+        const uint32x4_t circleReject = vandq_u32(vcgtq_f32(det, zero),
+                                                  vcgtq_f32(vmulq_f32(vmulq_f32(quarter, vaddq_f32(dx2, dy2)), det),
+                                                            vmulq_f32(vmulq_f32(vl, vaddq_f32(A, B)), denom)));
+        const float32x4_t q = vsubq_f32(vaddq_f32(vmulq_f32(A, dy2), vmulq_f32(B, dx2)),
+                                        vmulq_f32(vmulq_f32(two, C), vmulq_f32(dx, dy)));
+        const uint32x4_t mahaReject = vandq_u32(vcgtq_f32(denom, zero),
+                                                vcgtq_f32(vmulq_f32(quarter, q), vmulq_f32(vl, denom)));
+        const uint32x4_t hit = vandq_u32(vmvnq_u32(vorrq_u32(circleReject, mahaReject)), vbits);
+        const uint32_t bits = vgetq_lane_u32(hit, 0) | vgetq_lane_u32(hit, 1) | vgetq_lane_u32(hit, 2) | vgetq_lane_u32(hit, 3);
+        mask |= bits << i;
+    }
+    return mask;
+}
+#endif
+
+/**
+ * @brief Picks the widest prefilter kernel supported by the running CPU.
+ */
+inline RotatedCandidateMaskFn selectRotatedCandidateMask() {
+#if defined(YOLOS_NMS_X86)
+#if defined(YOLOS_NMS_HAS_AVX2)
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return rotatedCandidateMaskAVX2;
+    }
+#else
+    return rotatedCandidateMaskAVX2;
+#endif
+#endif
+    return rotatedCandidateMaskSSE2;
+#elif defined(YOLOS_NMS_NEON)
+    return rotatedCandidateMaskNEON;
+#else
+    return rotatedCandidateMaskScalar;
+#endif
+}
+
+inline RotatedCandidateMaskFn rotatedCandidateMask() {
+    static const RotatedCandidateMaskFn kernel = selectRotatedCandidateMask();
+    return kernel;
+}
+
+/**
+ * @brief Exact ProbIoU of two boxes given as centre + covariance (Ultralytics probiou).
+ */
+inline float probiou(float x1, float y1, float a1, float b1, float c1,
+                     float x2, float y2, float a2, float b2, float c2, float eps) {
+    const float A = a1 + a2, B = b1 + b2, C = c1 + c2;
+    const float det = A * B - C * C;
+    const float denom = det + eps;
+
+    const float dx = x1 - x2;
+    const float dy = y1 - y2;
+    const float t1 = (A * dy * dy + B * dx * dx) * 0.25f / denom;
+    const float t2 = (C * (x2 - x1) * dy) * 0.5f / denom;
+
+    const float term1 = std::max(a1 * b1 - c1 * c1, 0.0f);
+    const float term2 = std::max(a2 * b2 - c2 * c2, 0.0f);
+    const float t3 = 0.5f * std::log(det / (4.0f * std::sqrt(term1 * term2) + eps) + eps);
+
+    const float bd = std::min(std::max(t1 + t2 + t3, eps), 100.0f);
+    const float hd = std::sqrt(1.0f - std::exp(-bd) + eps);
+    return 1.0f - hd;
+}
+
+} // namespace detail
+
+/**
+ * @brief Reusable rotated NMS workspace; keeps its buffers between calls.
+ *
+ * Not thread-safe: use one engine per detector (or per thread).
+ */
+class RotatedNMSEngine {
+public:
+    /**
+     * @brief Runs greedy ProbIoU NMS and writes the kept indices in descending score order.
+     *
+     * @tparam Box Any type with x, y (centre), width, height and angle (radians) members.
+     * @param boxes Candidate boxes.
+     * @param scores Confidence score of each box.
+     * @param classIds Class of each box; may be nullptr, which implies class-agnostic NMS.
+     * @param options Thresholds, mode and caps (maxCandidates is honoured as a top-k pre-selection).
+     * @param indices Output indices into boxes.
+     */
+    template <typename Box>
+    void run(const std::vector<Box> &boxes, const std::vector<float> &scores, const std::vector<int> *classIds,
+             const NMSOptions &options, std::vector<int> &indices) {
+        indices.clear();
+        order_.clear();
+        const size_t count = std::min(boxes.size(), scores.size());
+        for (size_t i = 0; i < count; ++i) {
+            if (scores[i] >= options.scoreThreshold) {
+                order_.push_back(static_cast<int>(i));
+            }
+        }
+        if (order_.empty()) {
+            return;
+        }
+
+        auto higher = [&scores](int l, int r) { return scores[l] > scores[r] || (scores[l] == scores[r] && l < r); };
+        if (options.maxCandidates > 0 && order_.size() > static_cast<size_t>(options.maxCandidates)) {
+            std::nth_element(order_.begin(), order_.begin() + options.maxCandidates, order_.end(), higher);
+            order_.resize(options.maxCandidates);
+        }
+
+        // Covariance of every candidate, computed once
+        const size_t m = order_.size();
+        x_.resize(m); y_.resize(m); a_.resize(m); b_.resize(m); c_.resize(m);
+        for (size_t k = 0; k < m; ++k) {
+            const Box &box = boxes[order_[k]];
+            const float a = box.width * box.width / 12.0f;
+            const float b = box.height * box.height / 12.0f;
+            const float cosTheta = std::cos(box.angle);
+            const float sinTheta = std::sin(box.angle);
+            x_[k] = box.x;
+            y_[k] = box.y;
+            a_[k] = a * cosTheta * cosTheta + b * sinTheta * sinTheta;
+            b_[k] = a * sinTheta * sinTheta + b * cosTheta * cosTheta;
+            c_[k] = (a - b) * cosTheta * sinTheta;
+        }
+
+        // ProbIoU >= t  <=>  Bhattacharyya distance <= -ln(1 + eps - (1 - t)^2); the
+        // prefilter limit gets a relative margin for float rounding in the bounds
+        const float keep = 1.0f - options.iouThreshold;
+        const float expNeg = 1.0f + detail::kProbiouEps - keep * keep;
+        float limit = std::numeric_limits<float>::infinity();
+        if (expNeg > 0.0f && options.iouThreshold > 0.0f) {
+            const float bdMax = -std::log(expNeg);
+            if (bdMax < 99.0f) {
+                limit = bdMax * 1.01f + 1e-4f;
+            }
+        }
+
+        // Kept boxes, padded to whole kernel blocks with boxes far outside any image
+        const size_t maxKeep = options.maxDetections > 0 ? std::min(m, static_cast<size_t>(options.maxDetections)) : m;
+        const size_t capacity = (maxKeep + detail::kRotatedLanes - 1) / detail::kRotatedLanes * detail::kRotatedLanes;
+        keptX_.assign(capacity, 1e15f); keptY_.assign(capacity, 1e15f);
+        keptA_.assign(capacity, 0.0f); keptB_.assign(capacity, 0.0f); keptC_.assign(capacity, 0.0f);
+        keptClass_.resize(capacity);
+
+        const bool agnostic = options.agnostic || classIds == nullptr;
+        const detail::RotatedCandidateMaskFn candidateMask = detail::rotatedCandidateMask();
+        const bool prefilter = std::isfinite(limit);
+
+        // Score order via a heap over candidate slots
+        heap_.resize(m);
+        for (size_t k = 0; k < m; ++k) heap_[k] = static_cast<int>(k);
+        auto lowerPriority = [&](int l, int r) { return higher(order_[r], order_[l]); };
+        std::make_heap(heap_.begin(), heap_.end(), lowerPriority);
+
+        size_t kept = 0;
+        while (!heap_.empty() && kept < maxKeep) {
+            std::pop_heap(heap_.begin(), heap_.end(), lowerPriority);
+            const int k = heap_.back();
+            heap_.pop_back();
+
+            const int cls = agnostic ? 0 : (*classIds)[order_[k]];
+            const detail::RotatedReference ref{x_[k], y_[k], a_[k], b_[k], c_[k]};
+            bool suppressed = false;
+            for (size_t base = 0; base < kept && !suppressed; base += detail::kRotatedLanes) {
+                uint32_t mask = prefilter ? candidateMask(keptX_.data() + base, keptY_.data() + base,
+                                                          keptA_.data() + base, keptB_.data() + base,
+                                                          keptC_.data() + base, ref, limit)
+                                          : (1u << detail::kRotatedLanes) - 1;
+                while (mask) {
+                    const int lane = lowestBit(mask);
+                    mask &= mask - 1;
+                    const size_t j = base + lane;
+                    if (j >= kept || (!agnostic && keptClass_[j] != cls)) {
+                        continue;
+                    }
+                    if (detail::probiou(keptX_[j], keptY_[j], keptA_[j], keptB_[j], keptC_[j],
+                                        ref.x, ref.y, ref.a, ref.b, ref.c, detail::kProbiouEps) >= options.iouThreshold) {
+                        suppressed = true;
+                        break;
+                    }
+                }
+            }
+            if (suppressed) {
+                continue;
+            }
+
+            keptX_[kept] = ref.x; keptY_[kept] = ref.y;
+            keptA_[kept] = ref.a; keptB_[kept] = ref.b; keptC_[kept] = ref.c;
+            keptClass_[kept] = cls;
+            ++kept;
+            indices.push_back(order_[k]);
+        }
+    }
+
+private:
+    static int lowestBit(uint32_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(v);
+#else
+        int n = 0;
+        while (!(v & 1u)) { v >>= 1; ++n; }
+        return n;
+#endif
+    }
+
+    std::vector<int> order_, heap_;
+    std::vector<float> x_, y_, a_, b_, c_;
+    std::vector<float> keptX_, keptY_, keptA_, keptB_, keptC_;
+    std::vector<int> keptClass_;
+};
+
+} // namespace yolos
+
+#endif // ROTATED_NMS_HPP
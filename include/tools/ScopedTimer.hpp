@@ -5,47 +5,43 @@
 /**
  * @file ScopedTimer.hpp
  * @brief Header file for timing utilities.
- * 
- * This file defines the ScopedTimer class, which measures the duration of a 
- * code block for performance profiling. When TIMING_MODE is defined, it records
- * the time taken for execution and prints it to the standard output upon 
- * destruction; otherwise, it provides an empty implementation.
+ *
+ * This file defines the ScopedTimer class, which measures the duration of a
+ * code block for performance profiling. The duration is recorded into the
+ * per-thread stage histograms of tools/Instrumentation.hpp (and into the trace,
+ * when one is running) instead of being printed. While instrumentation is
+ * disabled, a timer costs a single relaxed atomic load.
+ *
+ * Stage names are "<task>.<stage>" string literals, e.g. "detection.preprocess".
  */
 
-#include <chrono>
-#include <iostream>
-#include <string>
-#include "tools/Config.hpp" // Include the config file to access the flags
+#include "tools/Instrumentation.hpp"
 
-#ifdef TIMING_MODE
 class ScopedTimer {
 public:
     /**
-     * @brief Constructs a ScopedTimer to measure the duration of a named code block.
-     * @param name The name of the code block being timed.
+     * @brief Starts timing a named code block.
+     * @param name The name of the stage; must be a string literal (it is kept by pointer).
      */
-    ScopedTimer(const std::string &name) 
-        : func_name(name), start(std::chrono::high_resolution_clock::now()) {}
-    
+    explicit ScopedTimer(const char *name)
+        : name_(yolos::instrumentation::enabled() ? name : nullptr),
+          start_(name_ ? yolos::instrumentation::now() : 0) {}
+
     /**
-     * @brief Destructor that calculates and prints the elapsed time.
+     * @brief Destructor that records the elapsed time.
      */
     ~ScopedTimer() {
-        auto stop = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double, std::milli> duration = stop - start;
-        std::cout << func_name << " took " << duration.count() << " milliseconds." << std::endl;
+        if (name_) {
+            yolos::instrumentation::recordScope(name_, start_, yolos::instrumentation::now());
+        }
     }
 
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
 private:
-    std::string func_name; ///< The name of the timed function.
-    std::chrono::time_point<std::chrono::high_resolution_clock> start; ///< Start time point.
-};
-#else
-class ScopedTimer {
-public:
-    ScopedTimer(const std::string &name) {}
-    ~ScopedTimer() {}
+    const char *name_;  ///< Stage name, or null when instrumentation was disabled at construction.
+    uint64_t start_;    ///< Start time in steady-clock nanoseconds.
 };
-#endif // TIMING_MODE
 
-#endif // SCOPEDTIMER_HPP
\ No newline at end of file
+#endif // SCOPEDTIMER_HPP
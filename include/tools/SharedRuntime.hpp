@@ -0,0 +1,57 @@
+// SharedRuntime.hpp
+#ifndef SHARED_RUNTIME_HPP
+#define SHARED_RUNTIME_HPP
+
+/**
+ * @file SharedRuntime.hpp
+ * @brief ONNX Runtime state that several sessions of the same process can share.
+ *
+ * Every detector used to create its own Ort::Env, and with it its own intra-op thread
+ * pool and its own copy of the prepacked weights. When one model serves many streams
+ * through several sessions, that multiplies the memory and oversubscribes the cores.
+ * A SharedRuntime holds one Env and one PrepackedWeightsContainer (the ONNX Runtime
+ * mechanism that lets sessions of the same model share their prepacked initializers);
+ * optionally the Env owns a global thread pool that all sessions run on instead of
+ * spawning their own.
+ *
+ * The runtime must outlive every session created from it; detectors keep it alive
+ * through a std::shared_ptr.
+ */
+
+#include <onnxruntime_cxx_api.h>
+
+#include <memory>
+
+namespace yolos {
+
+struct SharedRuntime {
+    Ort::Env env{nullptr};                                 // One environment for all sessions
+    Ort::PrepackedWeightsContainer prepackedWeights;       // Prepacked weights shared by sessions of a model
+    bool globalThreadPool = false;                         // Sessions run on the Env's thread pool
+
+    /**
+     * @brief Creates a runtime whose sessions keep their own intra-op thread pools.
+     */
+    SharedRuntime() : env(ORT_LOGGING_LEVEL_WARNING, "ONNX_DETECTION") {}
+
+    /**
+     * @brief Creates a runtime with one global intra-op pool shared by all of its sessions.
+     *
+     * @param intraOpThreads Threads of the global pool (0 lets ONNX Runtime decide).
+     * @param allowSpinning Whether idle pool threads busy-wait for work.
+     */
+    explicit SharedRuntime(int intraOpThreads, bool allowSpinning = true) : globalThreadPool(true) {
+        Ort::ThreadingOptions threading;
+        threading.SetGlobalIntraOpNumThreads(intraOpThreads);
+        threading.SetGlobalInterOpNumThreads(1);
+        threading.SetGlobalSpinControl(allowSpinning ? 1 : 0);
+        env = Ort::Env(threading, ORT_LOGGING_LEVEL_WARNING, "ONNX_DETECTION");
+    }
+
+    SharedRuntime(const SharedRuntime &) = delete;
+    SharedRuntime &operator=(const SharedRuntime &) = delete;
+};
+
+} // namespace yolos
+
+#endif // SHARED_RUNTIME_HPP
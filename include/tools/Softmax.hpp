@@ -0,0 +1,289 @@
+// Softmax.hpp
+#ifndef SOFTMAX_HPP
+#define SOFTMAX_HPP
+
+/**
+ * @file Softmax.hpp
+ * @brief Vectorized softmax normalisation and top-k selection over a row of class scores.
+ *
+ * Classification only needs the probabilities of the k classes it reports, so the full
+ * softmax is never materialised: the row max and the sum of exp(score - max) are reduced
+ * in SIMD registers (AVX2 runtime-dispatched, SSE2 or NEON, scalar fallback), and the
+ * k best scores are picked with a partial selection over the raw scores (softmax is
+ * monotonic, so the ranking does not depend on it).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define YOLOS_SOFTMAX_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define YOLOS_SOFTMAX_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace yolos {
+
+namespace detail {
+
+// max(row[0..n)) and sum(exp(row[i] - max)) for i in [0, n)
+using RowMaxFn = float (*)(const float *row, int n);
+using ExpSumFn = float (*)(const float *row, float max, int n);
+
+// exp() over [-87, 0] (Cephes polynomial, ~1 ulp); inputs are shifted by the row max so never positive
+constexpr float kExpLow = -87.0f;
+constexpr float kLog2e = 1.44269504088896341f;
+constexpr float kLn2Hi = 0.693359375f;
+constexpr float kLn2Lo = -2.12194440e-4f;
+constexpr float kExpP0 = 1.9875691500e-4f;
+constexpr float kExpP1 = 1.3981999507e-3f;
+constexpr float kExpP2 = 8.3334519073e-3f;
+constexpr float kExpP3 = 4.1665795894e-2f;
+constexpr float kExpP4 = 1.6666665459e-1f;
+constexpr float kExpP5 = 5.0000001201e-1f;
+
+inline float rowMaxScalar(const float *row, int n) {
+    float m = row[0];
+    for (int i = 1; i < n; ++i) m = std::max(m, row[i]);
+    return m;
+}
+
+inline float expSumScalar(const float *row, float max, int n) {
+    float sum = 0.f;
+    for (int i = 0; i < n; ++i) sum += std::exp(row[i] - max);
+    return sum;
+}
+
+#if defined(YOLOS_SOFTMAX_X86)
+inline float hsumSSE2(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+inline float hmaxSSE2(__m128 v) {
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+inline __m128 expSSE2(__m128 x) {
+    x = _mm_max_ps(x, _mm_set1_ps(kExpLow));
+    const __m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kLog2e)));
+    const __m128 fn = _mm_cvtepi32_ps(n);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(fn, _mm_set1_ps(kLn2Hi)));
+    r = _mm_sub_ps(r, _mm_mul_ps(fn, _mm_set1_ps(kLn2Lo)));
+    __m128 p = _mm_set1_ps(kExpP0);
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExpP1));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExpP2));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExpP3));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExpP4));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExpP5));
+    p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), r), _mm_set1_ps(1.f));
+    // Scale by 2^n through the exponent bits
+    const __m128i pow2n = _mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23);
+    return _mm_mul_ps(p, _mm_castsi128_ps(pow2n));
+}
+
+inline float rowMaxSSE2(const float *row, int n) {
+    if (n < 4) return rowMaxScalar(row, n);
+    __m128 m = _mm_loadu_ps(row);
+    int i = 4;
+    for (; i + 4 <= n; i += 4) m = _mm_max_ps(m, _mm_loadu_ps(row + i));
+    float result = hmaxSSE2(m);
+    for (; i < n; ++i) result = std::max(result, row[i]);
+    return result;
+}
+
+inline float expSumSSE2(const float *row, float max, int n) {
+    const __m128 vmax = _mm_set1_ps(max);
+    __m128 sum = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) sum = _mm_add_ps(sum, expSSE2(_mm_sub_ps(_mm_loadu_ps(row + i), vmax)));
+    return hsumSSE2(sum) + expSumScalar(row + i, max, n - i);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define YOLOS_SOFTMAX_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define YOLOS_SOFTMAX_AVX2_TARGET
+#endif
+
+#if defined(__GNUC__) || defined(__clang__) || defined(__AVX2__)
+YOLOS_SOFTMAX_AVX2_TARGET
+inline __m256 expAVX2(__m256 x) {
+    x = _mm256_max_ps(x, _mm256_set1_ps(kExpLow));
+    const __m256i n = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(kLog2e)));
+    const __m256 fn = _mm256_cvtepi32_ps(n);
+    __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(fn, _mm256_set1_ps(kLn2Hi)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(fn, _mm256_set1_ps(kLn2Lo)));
+    __m256 p = _mm256_set1_ps(kExpP0);
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(kExpP1));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(kExpP2));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(kExpP3));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(kExpP4));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(kExpP5));
+    p = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(p, r), r), r), _mm256_set1_ps(1.f));
+    const __m256i pow2n = _mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(pow2n));
+}
+
+YOLOS_SOFTMAX_AVX2_TARGET
+inline float rowMaxAVX2(const float *row, int n) {
+    if (n < 8) return rowMaxSSE2(row, n);
+    __m256 m = _mm256_loadu_ps(row);
+    int i = 8;
+    for (; i + 8 <= n; i += 8) m = _mm256_max_ps(m, _mm256_loadu_ps(row + i));
+    float result = hmaxSSE2(_mm_max_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1)));
+    for (; i < n; ++i) result = std::max(result, row[i]);
+    return result;
+}
+
+YOLOS_SOFTMAX_AVX2_TARGET
+inline float expSumAVX2(const float *row, float max, int n) {
+    const __m256 vmax = _mm256_set1_ps(max);
+    __m256 sum = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) sum = _mm256_add_ps(sum, expAVX2(_mm256_sub_ps(_mm256_loadu_ps(row + i), vmax)));
+    const float vectorSum = hsumSSE2(_mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1)));
+    return vectorSum + expSumSSE2(row + i, max, n - i);
+}
+#define YOLOS_SOFTMAX_HAS_AVX2 1
+#endif
+#endif // YOLOS_SOFTMAX_X86
+
+#if defined(YOLOS_SOFTMAX_NEON)
+inline float32x4_t expNEON(float32x4_t x) {
+    x = vmaxq_f32(x, vdupq_n_f32(kExpLow));
+    // x <= 0, so round-to-nearest is a truncation of x * log2(e) - 0.5
+    const int32x4_t n = vcvtq_s32_f32(vsubq_f32(vmulq_n_f32(x, kLog2e), vdupq_n_f32(0.5f)));
+    const float32x4_t fn = vcvtq_f32_s32(n);
+    float32x4_t r = vsubq_f32(x, vmulq_n_f32(fn, kLn2Hi));
+    r = vsubq_f32(r, vmulq_n_f32(fn, kLn2Lo));
+    float32x4_t p = vdupq_n_f32(kExpP0);
+    p = vmlaq_f32(vdupq_n_f32(kExpP1), p, r);
+    p = vmlaq_f32(vdupq_n_f32(kExpP2), p, r);
+    p = vmlaq_f32(vdupq_n_f32(kExpP3), p, r);
+    p = vmlaq_f32(vdupq_n_f32(kExpP4), p, r);
+    p = vmlaq_f32(vdupq_n_f32(kExpP5), p, r);
+    p = vaddq_f32(vaddq_f32(vmulq_f32(vmulq_f32(p, r), r), r), vdupq_n_f32(1.f));
+    const int32x4_t pow2n = vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23);
+    return vmulq_f32(p, vreinterpretq_f32_s32(pow2n));
+}
+
+inline float rowMaxNEON(const float *row, int n) {
+    if (n < 4) return rowMaxScalar(row, n);
+    float32x4_t m = vld1q_f32(row);
+    int i = 4;
+    for (; i + 4 <= n; i += 4) m = vmaxq_f32(m, vld1q_f32(row + i));
+    float32x2_t pair = vpmax_f32(vget_low_f32(m), vget_high_f32(m));
+    pair = vpmax_f32(pair, pair);
+    float result = vget_lane_f32(pair, 0);
+    for (; i < n; ++i) result = std::max(result, row[i]);
+    return result;
+}
+
+inline float expSumNEON(const float *row, float max, int n) {
+    const float32x4_t vmax = vdupq_n_f32(max);
+    float32x4_t sum = vdupq_n_f32(0.f);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) sum = vaddq_f32(sum, expNEON(vsubq_f32(vld1q_f32(row + i), vmax)));
+    float32x2_t pair = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+    pair = vpadd_f32(pair, pair);
+    return vget_lane_f32(pair, 0) + expSumScalar(row + i, max, n - i);
+}
+#endif
+
+struct SoftmaxKernels {
+    RowMaxFn rowMax;
+    ExpSumFn expSum;
+};
+
+/**
+ * @brief Picks the widest kernels supported by the running CPU (resolved once).
+ */
+inline SoftmaxKernels selectSoftmaxKernels() {
+#if defined(YOLOS_SOFTMAX_X86)
+#if defined(YOLOS_SOFTMAX_HAS_AVX2)
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {rowMaxAVX2, expSumAVX2};
+    }
+#else
+    return {rowMaxAVX2, expSumAVX2};
+#endif
+#endif
+    return {rowMaxSSE2, expSumSSE2};
+#elif defined(YOLOS_SOFTMAX_NEON)
+    return {rowMaxNEON, expSumNEON};
+#else
+    return {rowMaxScalar, expSumScalar};
+#endif
+}
+
+inline const SoftmaxKernels &softmaxKernels() {
+    static const SoftmaxKernels kernels = selectSoftmaxKernels();
+    return kernels;
+}
+
+} // namespace detail
+
+/**
+ * @brief Softmax normaliser of a score row: probability(i) = exp(scores[i] - max) / sum.
+ */
+struct SoftmaxNorm {
+    float max{0.f};
+    float sum{1.f};
+
+    float probability(float score) const { return std::exp(score - max) / sum; }
+};
+
+/**
+ * @brief Max and sum of exp(score - max) of scores[0..n), without writing the probabilities.
+ */
+inline SoftmaxNorm softmaxNorm(const float *scores, int n) {
+    if (n <= 0) {
+        return {};
+    }
+    const detail::SoftmaxKernels &kernels = detail::softmaxKernels();
+    SoftmaxNorm norm;
+    norm.max = kernels.rowMax(scores, n);
+    norm.sum = kernels.expSum(scores, norm.max, n);
+    return norm;
+}
+
+/**
+ * @brief Indices of the k highest of scores[0..n), best first (ties keep the lower index first).
+ *
+ * @param indices Receives min(k, n) indices; its capacity is reused across calls.
+ */
+inline void topKIndices(const float *scores, int n, int k, std::vector<int> &indices) {
+    k = std::max(0, std::min(k, n));
+    indices.clear();
+    if (k == 0) {
+        return;
+    }
+    if (k == 1) {
+        indices.push_back(static_cast<int>(std::max_element(scores, scores + n) - scores));
+        return;
+    }
+
+    auto better = [scores](int a, int b) { return scores[a] > scores[b] || (scores[a] == scores[b] && a < b); };
+    indices.resize(n);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::partial_sort(indices.begin(), indices.begin() + k, indices.end(), better);
+    indices.resize(k);
+}
+
+} // namespace yolos
+
+#endif // SOFTMAX_HPP
@@ -0,0 +1,323 @@
+// TensorBinding.hpp
+#ifndef TENSOR_BINDING_HPP
+#define TENSOR_BINDING_HPP
+
+/**
+ * @file TensorBinding.hpp
+ * @brief Persistent, aligned input/output buffers bound to an ONNX Runtime session.
+ *
+ * The detectors used to allocate a fresh blob in preprocess, copy it into a
+ * std::vector for the input tensor and let ONNX Runtime allocate the outputs on
+ * every call. TensorBinding owns one aligned input buffer that preprocessing
+ * writes into directly, and pre-binds output buffers through Ort::IoBinding
+ * whenever the output shape can be resolved from the input shape. As long as
+ * the input shape does not change, a run performs no heap allocation on our side.
+ *
+ * FP16 models are bound with binary16 tensors: preprocessing writes half values through
+ * prepareHalfInput(), and FLOAT16 outputs are widened into float buffers after each run, so
+ * decoders always read floats whatever the precision of the model.
+ *
+ * A TensorBinding (and therefore the detector owning it) must not be used from
+ * several threads at once.
+ */
+
+#include <onnxruntime_cxx_api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tools/Half.hpp"
+#include "tools/ScopedTimer.hpp"
+
+/**
+ * @brief Grow-only heap buffer with a fixed alignment (64 bytes by default, one cache line / AVX-512 vector).
+ */
+template <typename T, size_t Alignment = 64>
+class AlignedBuffer {
+public:
+    AlignedBuffer() = default;
+    ~AlignedBuffer() { release(); }
+
+    AlignedBuffer(const AlignedBuffer &) = delete;
+    AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+
+    AlignedBuffer(AlignedBuffer &&other) noexcept
+        : data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
+        other.data_ = nullptr;
+        other.size_ = other.capacity_ = 0;
+    }
+
+    AlignedBuffer &operator=(AlignedBuffer &&other) noexcept {
+        if (this != &other) {
+            release();
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            std::swap(capacity_, other.capacity_);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Resizes the buffer to n elements. Memory is only reallocated when n exceeds the capacity,
+     *        in which case the previous contents are discarded.
+     */
+    T *resize(size_t n) {
+        if (n > capacity_) {
+            release();
+            data_ = static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+            capacity_ = n;
+        }
+        size_ = n;
+        return data_;
+    }
+
+    T *data() { return data_; }
+    const T *data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    void release() {
+        if (data_) {
+            ::operator delete(data_, std::align_val_t(Alignment));
+        }
+        data_ = nullptr;
+        size_ = capacity_ = 0;
+    }
+
+    T *data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+/**
+ * @brief Binds a single float or float16 input and all outputs of a session to persistent buffers.
+ */
+class TensorBinding {
+public:
+    TensorBinding() = default;
+
+    /**
+     * @brief Reads the output metadata of the session. Call once after the session has been created.
+     *
+     * @param session Session to bind.
+     * @param inputName Name of the (single) image input.
+     * @param outputNames Names of the outputs to fetch.
+     */
+    void init(Ort::Session &session, const char *inputName, const std::vector<const char *> &outputNames) {
+        binding_ = Ort::IoBinding(session);
+        memoryInfo_ = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        inputName_ = inputName;
+
+        // Symbolic name of the input batch dimension, used to recognise the batch axis of the outputs
+        Ort::TypeInfo inputTypeInfo = session.GetInputTypeInfo(0);
+        auto inputInfo = inputTypeInfo.GetTensorTypeAndShapeInfo();
+        halfInput_ = isHalf(inputInfo.GetElementType(), "input");
+        std::vector<const char *> inputSymbols(inputInfo.GetDimensionsCount(), nullptr);
+        if (!inputSymbols.empty()) {
+            inputInfo.GetSymbolicDimensions(inputSymbols.data(), inputSymbols.size());
+            batchSymbol_ = inputSymbols[0] ? inputSymbols[0] : "";
+        }
+
+        outputs_.clear();
+        outputs_.resize(outputNames.size());
+        for (size_t i = 0; i < outputNames.size(); ++i) {
+            Ort::TypeInfo outputTypeInfo = session.GetOutputTypeInfo(i);
+            auto outputInfo = outputTypeInfo.GetTensorTypeAndShapeInfo();
+            Output &output = outputs_[i];
+            output.name = outputNames[i];
+            output.modelShape = outputInfo.GetShape();
+            output.half = isHalf(outputInfo.GetElementType(), "output");
+
+            // The leading axis follows the input batch only when both share the same symbolic name
+            std::vector<const char *> symbols(output.modelShape.size(), nullptr);
+            if (!symbols.empty()) {
+                outputInfo.GetSymbolicDimensions(symbols.data(), symbols.size());
+                output.batchAxis = !batchSymbol_.empty() && symbols[0] && batchSymbol_ == symbols[0];
+            }
+        }
+        inputShape_.clear();
+    }
+
+    /**
+     * @brief Returns the input buffer for the given shape, ready to be filled by preprocessing.
+     *        The input and the outputs are only re-bound when the shape differs from the previous call.
+     */
+    float *prepareInput(const std::vector<int64_t> &shape) {
+        if (halfInput_) {
+            throw std::runtime_error("TensorBinding: the model input is float16, use prepareHalfInput().");
+        }
+        if (shape != inputShape_) {
+            bind(shape);
+        }
+        return input_.data();
+    }
+
+    /**
+     * @brief prepareInput() for FP16 models: returns the binary16 input buffer for the given shape.
+     */
+    uint16_t *prepareHalfInput(const std::vector<int64_t> &shape) {
+        if (!halfInput_) {
+            throw std::runtime_error("TensorBinding: the model input is float32, use prepareInput().");
+        }
+        if (shape != inputShape_) {
+            bind(shape);
+        }
+        return halfInputBuffer_.data();
+    }
+
+    /**
+     * @brief Runs the session on the bound buffers.
+     */
+    void run(Ort::Session &session) {
+        {
+            ScopedTimer timer("inference");
+            session.Run(Ort::RunOptions{nullptr}, binding_);
+        }
+
+        if (!allOutputsPreBound_) {
+            // Outputs with data-dependent shapes are allocated by ONNX Runtime; refresh their views
+            dynamicValues_ = binding_.GetOutputValues();
+            for (size_t i = 0; i < outputs_.size(); ++i) {
+                Output &output = outputs_[i];
+                if (!output.preBound) {
+                    output.shape = dynamicValues_[i].GetTensorTypeAndShapeInfo().GetShape();
+                    if (output.half) {
+                        const size_t count = dynamicValues_[i].GetTensorTypeAndShapeInfo().GetElementCount();
+                        const auto *src = static_cast<const uint16_t *>(dynamicValues_[i].GetTensorRawData());
+                        yolos::halfToFloat(src, output.buffer.resize(count), count);
+                        output.data = output.buffer.data();
+                    } else {
+                        output.data = dynamicValues_[i].GetTensorData<float>();
+                    }
+                }
+            }
+        }
+
+        // Pre-bound FP16 outputs are widened in place of the float buffer the decoders read
+        for (Output &output : outputs_) {
+            if (output.preBound && output.half) {
+                yolos::halfToFloat(output.halfBuffer.data(), output.buffer.data(), output.buffer.size());
+            }
+        }
+    }
+
+    /// The input is bound as a float16 tensor (the model was exported in half precision)
+    bool halfInput() const { return halfInput_; }
+    /// Some output is produced as float16 (and widened to float after every run)
+    bool halfOutputs() const {
+        for (const Output &output : outputs_) {
+            if (output.half) return true;
+        }
+        return false;
+    }
+
+    size_t outputCount() const { return outputs_.size(); }
+    const float *outputData(size_t i) const { return outputs_[i].data; }
+    const std::vector<int64_t> &outputShape(size_t i) const { return outputs_[i].shape; }
+
+private:
+    struct Output {
+        const char *name = nullptr;
+        std::vector<int64_t> modelShape;  // Shape from the model metadata (-1 for dynamic axes)
+        std::vector<int64_t> shape;       // Shape of the last run
+        bool batchAxis = false;           // Leading axis is the input batch axis
+        bool preBound = false;            // Output lives in our buffer
+        bool half = false;                // Produced as float16 and widened into buffer
+        AlignedBuffer<float> buffer;
+        AlignedBuffer<uint16_t> halfBuffer;  // Bound float16 storage of pre-bound half outputs
+        Ort::Value value{nullptr};
+        const float *data = nullptr;
+    };
+
+    // FLOAT and FLOAT16 tensors are supported; anything else would be decoded as garbage
+    static bool isHalf(ONNXTensorElementDataType type, const char *what) {
+        if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+            return true;
+        }
+        if (type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+            throw std::runtime_error(std::string("TensorBinding: unsupported ") + what + " element type (expected float or float16).");
+        }
+        return false;
+    }
+
+    void bind(const std::vector<int64_t> &shape) {
+        size_t inputSize = 1;
+        for (int64_t dim : shape) inputSize *= static_cast<size_t>(dim);
+
+        binding_.ClearBoundInputs();
+        binding_.ClearBoundOutputs();
+
+        if (halfInput_) {
+            halfInputBuffer_.resize(inputSize);
+            inputValue_ = Ort::Value::CreateTensor(memoryInfo_, halfInputBuffer_.data(), inputSize * sizeof(uint16_t),
+                                                   shape.data(), shape.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16);
+        } else {
+            input_.resize(inputSize);
+            inputValue_ = Ort::Value::CreateTensor<float>(memoryInfo_, input_.data(), inputSize, shape.data(), shape.size());
+        }
+        binding_.BindInput(inputName_, inputValue_);
+
+        allOutputsPreBound_ = true;
+        for (Output &output : outputs_) {
+            // Resolve the output shape for this input; give up on any other dynamic axis
+            output.shape = output.modelShape;
+            if (!output.shape.empty() && output.shape[0] <= 0 && output.batchAxis) {
+                output.shape[0] = shape[0];
+            }
+            size_t outputSize = 1;
+            output.preBound = !output.shape.empty();
+            for (int64_t dim : output.shape) {
+                if (dim <= 0) {
+                    output.preBound = false;
+                    break;
+                }
+                outputSize *= static_cast<size_t>(dim);
+            }
+
+            if (output.preBound && output.half) {
+                output.buffer.resize(outputSize);
+                output.halfBuffer.resize(outputSize);
+                output.value = Ort::Value::CreateTensor(memoryInfo_, output.halfBuffer.data(), outputSize * sizeof(uint16_t),
+                                                        output.shape.data(), output.shape.size(),
+                                                        ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16);
+                binding_.BindOutput(output.name, output.value);
+                output.data = output.buffer.data();
+            } else if (output.preBound) {
+                output.buffer.resize(outputSize);
+                output.value = Ort::Value::CreateTensor<float>(memoryInfo_, output.buffer.data(), outputSize,
+                                                               output.shape.data(), output.shape.size());
+                binding_.BindOutput(output.name, output.value);
+                output.data = output.buffer.data();
+            } else {
+                binding_.BindOutput(output.name, memoryInfo_);
+                output.data = nullptr;
+                allOutputsPreBound_ = false;
+            }
+        }
+
+        inputShape_ = shape;
+    }
+
+    Ort::IoBinding binding_{nullptr};
+    Ort::MemoryInfo memoryInfo_{nullptr};
+    const char *inputName_ = nullptr;
+    std::string batchSymbol_;
+
+    bool halfInput_ = false;
+    AlignedBuffer<float> input_;
+    AlignedBuffer<uint16_t> halfInputBuffer_;  // Input of FP16 models
+    Ort::Value inputValue_{nullptr};
+    std::vector<int64_t> inputShape_;
+
+    std::vector<Output> outputs_;
+    std::vector<Ort::Value> dynamicValues_;  // ONNX Runtime-allocated outputs of the last run
+    bool allOutputsPreBound_ = false;
+};
+
+#endif // TENSOR_BINDING_HPP
@@ -0,0 +1,206 @@
+// Tiling.hpp
+#ifndef TILING_HPP
+#define TILING_HPP
+
+/**
+ * @file Tiling.hpp
+ * @brief Tile layout for sliced inference on images much larger than the model input.
+ *
+ * Letterboxing a 4K or aerial frame into 640x640 shrinks small objects below what the
+ * model can resolve. Sliced inference instead cuts the image into overlapping tiles of
+ * roughly the model input size, runs them through the batched path and merges the
+ * per-tile detections with NMS in image coordinates.
+ *
+ * planTiles() lays out the grid and drops tiles that an optional mask rules out (a motion
+ * mask, a region of interest, or the built-in low-texture test). The tiles are returned as
+ * ROI views of the source image, so no pixels are copied before preprocessing.
+ */
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace yolos {
+
+/**
+ * @brief Parameters of sliced (tiled) inference.
+ */
+struct TilingOptions {
+    /// Tile size in source pixels; empty uses the model input size
+    cv::Size tileSize;
+    /// Fraction of a tile shared with its neighbour, in [0, 1)
+    float overlap = 0.2f;
+    /// Also run the whole, downscaled image so objects larger than a tile are still found
+    bool includeFullImage = false;
+    /// Maximum number of tiles per batched run (bounds the input tensor size); <= 0 runs all at once
+    int maxBatch = 8;
+
+    /// Optional CV_8UC1 mask of any resolution, stretched over the image; nonzero = worth looking at
+    cv::Mat mask;
+    /// Minimum fraction of nonzero mask pixels for a tile to be kept (0 keeps any tile that touches the mask)
+    float minMaskCoverage = 0.0f;
+    /// Skip tiles whose grey-level standard deviation is below this (0 disables the test)
+    float minTileStdDev = 0.0f;
+};
+
+/**
+ * @brief Tiles selected for one image.
+ */
+struct TilePlan {
+    std::vector<cv::Rect> rects;   ///< Tile rectangles in image coordinates
+    std::vector<cv::Mat> views;    ///< ROI views of the source image, one per rect
+};
+
+namespace detail {
+
+// Tile origins along one axis: a regular stride, with the last tile aligned to the far edge
+inline std::vector<int> tileOrigins(int length, int tile, int stride) {
+    std::vector<int> origins;
+    if (tile >= length) {
+        origins.push_back(0);
+        return origins;
+    }
+    for (int pos = 0;; pos += stride) {
+        if (pos + tile >= length) {
+            origins.push_back(length - tile);
+            break;
+        }
+        origins.push_back(pos);
+    }
+    return origins;
+}
+
+// Maps an image rectangle onto a mask of a different resolution (at least one pixel)
+inline cv::Rect scaleRect(const cv::Rect &rect, const cv::Size &from, const cv::Size &to) {
+    const double sx = static_cast<double>(to.width) / from.width;
+    const double sy = static_cast<double>(to.height) / from.height;
+    const int x0 = std::min(static_cast<int>(std::floor(rect.x * sx)), to.width - 1);
+    const int y0 = std::min(static_cast<int>(std::floor(rect.y * sy)), to.height - 1);
+    const int x1 = std::max(static_cast<int>(std::ceil(rect.br().x * sx)), x0 + 1);
+    const int y1 = std::max(static_cast<int>(std::ceil(rect.br().y * sy)), y0 + 1);
+    return cv::Rect(x0, y0, std::min(x1, to.width) - x0, std::min(y1, to.height) - y0);
+}
+
+} // namespace detail
+
+/**
+ * @brief Lays out overlapping tiles covering an image.
+ *
+ * Tiles are placed on a grid with stride tileSize * (1 - overlap); the last row and column
+ * are shifted to end on the image border, so every tile has the full size unless the image
+ * itself is smaller than a tile.
+ */
+inline std::vector<cv::Rect> computeTiles(const cv::Size &imageSize, const cv::Size &tileSize, float overlap) {
+    if (imageSize.width <= 0 || imageSize.height <= 0) {
+        throw std::invalid_argument("computeTiles: image size must be positive.");
+    }
+    if (tileSize.width <= 0 || tileSize.height <= 0) {
+        throw std::invalid_argument("computeTiles: tile size must be positive.");
+    }
+    if (!(overlap >= 0.0f && overlap < 1.0f)) {
+        throw std::invalid_argument("computeTiles: overlap must be in [0, 1).");
+    }
+
+    const int tileW = std::min(tileSize.width, imageSize.width);
+    const int tileH = std::min(tileSize.height, imageSize.height);
+    const int strideX = std::max(1, static_cast<int>(std::lround(tileW * (1.0f - overlap))));
+    const int strideY = std::max(1, static_cast<int>(std::lround(tileH * (1.0f - overlap))));
+
+    std::vector<cv::Rect> tiles;
+    const std::vector<int> xs = detail::tileOrigins(imageSize.width, tileW, strideX);
+    const std::vector<int> ys = detail::tileOrigins(imageSize.height, tileH, strideY);
+    tiles.reserve(xs.size() * ys.size());
+    for (int y : ys) {
+        for (int x : xs) {
+            tiles.emplace_back(x, y, tileW, tileH);
+        }
+    }
+    return tiles;
+}
+
+/**
+ * @brief Selects the tiles of an image that are worth running.
+ *
+ * @param image Source image.
+ * @param options Tiling parameters.
+ * @param defaultTileSize Tile size used when options.tileSize is empty (the model input size).
+ * @return TilePlan Kept tiles with their ROI views; the full image comes last when includeFullImage is set.
+ */
+inline TilePlan planTiles(const cv::Mat &image, const TilingOptions &options, const cv::Size &defaultTileSize) {
+    if (image.empty()) {
+        throw std::invalid_argument("planTiles: input image is empty.");
+    }
+    if (!options.mask.empty() && options.mask.type() != CV_8UC1) {
+        throw std::invalid_argument("planTiles: mask must be CV_8UC1.");
+    }
+
+    const cv::Size tileSize = options.tileSize.empty() ? defaultTileSize : options.tileSize;
+    const std::vector<cv::Rect> tiles = computeTiles(image.size(), tileSize, options.overlap);
+
+    // The texture test runs on a small grey thumbnail, so it costs far less than one tile of inference
+    cv::Mat thumbnail;
+    if (options.minTileStdDev > 0.0f) {
+        const double shrink = std::min(1.0, 512.0 / std::max(image.cols, image.rows));
+        cv::Mat small;
+        cv::resize(image, small, cv::Size(), shrink, shrink, cv::INTER_AREA);
+        if (small.channels() == 3) {
+            cv::cvtColor(small, thumbnail, cv::COLOR_BGR2GRAY);
+        } else if (small.channels() == 4) {
+            cv::cvtColor(small, thumbnail, cv::COLOR_BGRA2GRAY);
+        } else {
+            thumbnail = small;
+        }
+    }
+
+    TilePlan plan;
+    plan.rects.reserve(tiles.size() + 1);
+    plan.views.reserve(tiles.size() + 1);
+    for (const cv::Rect &tile : tiles) {
+        if (!options.mask.empty()) {
+            const cv::Rect area = detail::scaleRect(tile, image.size(), options.mask.size());
+            const int active = cv::countNonZero(options.mask(area));
+            if (active == 0 || active < options.minMaskCoverage * area.area()) {
+                continue;
+            }
+        }
+        if (!thumbnail.empty()) {
+            cv::Scalar mean, stddev;
+            cv::meanStdDev(thumbnail(detail::scaleRect(tile, image.size(), thumbnail.size())), mean, stddev);
+            if (stddev[0] < options.minTileStdDev) {
+                continue;
+            }
+        }
+        plan.rects.push_back(tile);
+        plan.views.push_back(image(tile));
+    }
+
+    // A single tile already covering the image is the full-image pass
+    const bool singleFullTile = plan.rects.size() == 1 && plan.rects[0].size() == image.size();
+    if (options.includeFullImage && !singleFullTile) {
+        plan.rects.emplace_back(0, 0, image.cols, image.rows);
+        plan.views.push_back(image);
+    }
+    return plan;
+}
+
+/**
+ * @brief Number of tiles (or crops) to hand to one batched run.
+ *
+ * Dynamic-batch models take up to maxBatch tiles (all of them when maxBatch <= 0); fixed-batch models take a whole
+ * multiple of their batch size so that no chunk is padded with blank slots mid-image.
+ */
+inline size_t tileChunkSize(int maxBatch, int64_t modelBatchSize, size_t numTiles) {
+    const size_t limit = maxBatch > 0 ? static_cast<size_t>(maxBatch) : numTiles;
+    if (modelBatchSize <= 0) {
+        return std::max<size_t>(1, std::min(limit, numTiles));
+    }
+    const size_t batch = static_cast<size_t>(modelBatchSize);
+    return batch * std::max<size_t>(1, limit / batch);
+}
+
+} // namespace yolos
+
+#endif // TILING_HPP
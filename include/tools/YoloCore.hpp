@@ -0,0 +1,523 @@
+// YoloCore.hpp
+#ifndef YOLO_CORE_HPP
+#define YOLO_CORE_HPP
+
+/**
+ * @file YoloCore.hpp
+ * @brief Session setup, input/output buffers, preprocessing and batching shared by every task class.
+ *
+ * The detection, segmentation, pose, OBB and classification classes used to carry their own
+ * copy of the same plumbing: providers and threading, the optimized-model cache, input shape
+ * introspection, node names, the bound tensors, letterboxing, fixed/dynamic batch chunking and
+ * the split of batched outputs back per image. YoloCore<Policy> holds all of it once.
+ *
+ * The policy is a traits struct chosen at compile time by the task class:
+ *
+ *     struct PoseTaskPolicy {
+ *         static constexpr yolos::InputTransform transform = yolos::InputTransform::Letterbox;
+ *         static constexpr size_t outputs = 1;                       // Outputs to fetch
+ *         static constexpr const char *preprocessStage = "pose.preprocess";
+ *         static constexpr const char *preprocessBatchStage = "pose.preprocess_batch";
+ *     };
+ *
+ * Decoding is handed to run() / runBatch() as a callable
+ * (original size, model input size, const ImageOutputs &) -> Result, so every task's decode
+ * and NMS is instantiated and inlined into the batch loop instead of being dispatched per image.
+ *
+ * Dynamic-shape models letterbox each frame to its stride-32 minimal shape, so every new aspect
+ * ratio is a new input shape for the provider to plan (and, with TensorRT, possibly a new engine).
+ * With DetectorOptions::inputBuckets the shapes are restricted to a fixed set instead: a frame
+ * goes to the smallest bucket that holds it at the resolution the input size would give it, and
+ * each bucket keeps its own TensorBinding, so switching between buckets never re-binds. Frames no
+ * bucket can hold keep the minimal-shape path.
+ *
+ * FP16 models are recognised from the element type of their input and preprocessed straight into
+ * a binary16 tensor; INT8 (QDQ) models take float tensors like FP32 ones and are told apart by the
+ * "precision" metadata entry written by quantized_models/yolos_quantization.py (see precision()).
+ *
+ * A YoloCore (and therefore the task class owning it) must not be used from several threads at once.
+ */
+
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tools/Debug.hpp"
+#include "tools/ScopedTimer.hpp"
+#include "tools/TensorBinding.hpp"
+#include "tools/Preprocessing.hpp"
+#include "tools/SharedRuntime.hpp"
+#include "tools/DetectorOptions.hpp"
+#include "tools/ModelCache.hpp"
+
+namespace yolos {
+
+/**
+ * @brief How frames are mapped onto the model input.
+ */
+enum class InputTransform {
+    Letterbox,  ///< Aspect-preserving resize with gray padding; dynamic-shape models only pad up to the stride
+    Stretch     ///< Plain resize to the input shape without padding (classification)
+};
+
+/**
+ * @brief Wall-clock time spent in each stage of the last run() / runBatch() call.
+ *        Batched calls report the totals over all chunks.
+ */
+struct StageTimings {
+    double preprocessMs = 0.0;
+    double inferenceMs = 0.0;
+    double postprocessMs = 0.0;
+};
+
+/**
+ * @brief One output tensor of the last run, with the per-image slicing precomputed.
+ */
+struct OutputView {
+    const float *data = nullptr;      // Whole batch
+    std::vector<int64_t> shape;       // Whole batch
+    std::vector<int64_t> imageShape;  // One image: batch dimension set to 1
+    size_t imageSize = 0;             // Floats per image (0 when the tensor has no batch axis)
+};
+
+/**
+ * @brief Outputs of one image of a run, handed to the task's decoder.
+ */
+class ImageOutputs {
+public:
+    ImageOutputs(const std::vector<OutputView> &views, size_t batchIndex) : views_(views), batchIndex_(batchIndex) {}
+
+    size_t count() const { return views_.size(); }
+    size_t batchIndex() const { return batchIndex_; }
+
+    /// This image's slice of output i, shaped [1, ...]
+    const float *data(size_t i = 0) const { return views_[i].data + batchIndex_ * views_[i].imageSize; }
+    const std::vector<int64_t> &shape(size_t i = 0) const { return views_[i].imageShape; }
+
+    /// Whole output i, for layouts that are not batch-major (e.g. the flat [num_detections, 7] table of YOLOv7)
+    const float *batchData(size_t i = 0) const { return views_[i].data; }
+    const std::vector<int64_t> &batchShape(size_t i = 0) const { return views_[i].shape; }
+
+private:
+    const std::vector<OutputView> &views_;
+    size_t batchIndex_;
+};
+
+template <typename Policy>
+class YoloCore {
+public:
+    /**
+     * @brief Creates the session and binds its input and the policy's outputs.
+     *
+     * @param modelPath Path to the ONNX model file.
+     * @param options Execution providers (in order of preference), threading and model cache.
+     * @param runtime Runtime shared with other sessions (see SharedRuntime); a private one if null.
+     * @param providerStream CUDA stream for the CUDA provider (nullptr = its own stream).
+     * @param targetShape Preprocessing shape; empty to follow the model (640x640 for dynamic-shape models).
+     */
+    YoloCore(const std::string &modelPath, const DetectorOptions &options,
+             std::shared_ptr<SharedRuntime> runtime = nullptr, void *providerStream = nullptr,
+             const cv::Size &targetShape = cv::Size())
+        : runtime_(runtime ? std::move(runtime) : std::make_shared<SharedRuntime>()) {
+        // Threads, execution mode and providers; a runtime with a global pool replaces the per-session threads
+        provider_ = configureSession(options, sessionOptions_, providerStream, !runtime_->globalThreadPool);
+
+        // Load the model (through the optimized-model cache if enabled); sessions of one runtime share prepacked weights
+        session_ = createSession(runtime_->env, modelPath, options, sessionOptions_, provider_,
+                                 runtime_->prepackedWeights, &modelMapping_);
+
+        numInputNodes_ = session_.GetInputCount();
+        numOutputNodes_ = session_.GetOutputCount();
+        if (numInputNodes_ == 0 || numOutputNodes_ == 0) {
+            throw std::runtime_error("Model has no input or no output nodes.");
+        }
+
+        // Input shape: [N, 3, H, W] with possibly dynamic batch and spatial dimensions
+        modelInputShape_ = session_.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        const bool nchw = modelInputShape_.size() == 4;
+        if (!nchw && targetShape.empty()) {
+            throw std::runtime_error("Invalid input tensor shape: expected [N, C, H, W].");
+        }
+        isDynamicBatch_ = !nchw || modelInputShape_[0] <= 0;
+        modelBatchSize_ = isDynamicBatch_ ? 1 : modelInputShape_[0];
+        isDynamicInputShape_ = !nchw || modelInputShape_[2] <= 0 || modelInputShape_[3] <= 0;
+        if (!targetShape.empty()) {
+            inputImageShape_ = targetShape;
+        } else {
+            inputImageShape_ = isDynamicInputShape_
+                ? cv::Size(640, 640)
+                : cv::Size(static_cast<int>(modelInputShape_[3]), static_cast<int>(modelInputShape_[2]));
+        }
+
+        // Node names; only the outputs the task decodes are fetched
+        Ort::AllocatorWithDefaultOptions allocator;
+        inputNameAllocs_.push_back(session_.GetInputNameAllocated(0, allocator));
+        inputNames_.push_back(inputNameAllocs_.back().get());
+        const size_t fetched = std::min(numOutputNodes_, Policy::outputs);
+        for (size_t i = 0; i < fetched; ++i) {
+            outputNameAllocs_.push_back(session_.GetOutputNameAllocated(i, allocator));
+            outputNames_.push_back(outputNameAllocs_.back().get());
+        }
+
+        // Bind the persistent input/output buffers once the node names are known
+        tensorBinding_.init(session_, inputNames_[0], outputNames_);
+        views_.resize(fetched);
+        precision_ = detectPrecision();
+
+        // Buckets only make sense where the letterbox shape may vary
+        if (!options.inputBuckets.empty()) {
+            if (!isDynamicInputShape_ || Policy::transform == InputTransform::Stretch) {
+                DEBUG_PRINT("Input buckets ignored: the model input shape is fixed.");
+            } else {
+                for (const InputBucket &b : options.inputBuckets) {
+                    if (b.height <= 0 || b.width <= 0) {
+                        throw std::invalid_argument("Input buckets must have a positive size.");
+                    }
+                    buckets_.push_back({cv::Size(b.width, b.height), std::make_unique<TensorBinding>()});
+                    buckets_.back().binding->init(session_, inputNames_[0], outputNames_);
+                }
+                std::sort(buckets_.begin(), buckets_.end(),
+                          [](const Bucket &a, const Bucket &b) { return a.shape.area() < b.shape.area(); });
+            }
+        }
+    }
+
+    YoloCore(const YoloCore &) = delete;
+    YoloCore &operator=(const YoloCore &) = delete;
+
+    /**
+     * @brief Preprocesses, runs and decodes one image. Models exported with a fixed batch larger
+     *        than one only accept full batches and go through runBatch().
+     */
+    template <typename Decode>
+    auto run(const cv::Mat &image, Decode &&decode) -> decltype(decode(image.size(), cv::Size(), std::declval<const ImageOutputs &>())) {
+        if (!isDynamicBatch_ && modelBatchSize_ > 1) {
+            return std::move(runBatch(std::vector<cv::Mat>{image}, std::forward<Decode>(decode)).front());
+        }
+
+        const Clock::time_point t0 = Clock::now();
+        const cv::Size resized = preprocess(image);
+        const Clock::time_point t1 = Clock::now();
+
+        // Preprocessing wrote straight into the bound input tensor; outputs land in the pre-bound buffers
+        activeBinding_->run(session_);
+        refreshViews(1);
+        const Clock::time_point t2 = Clock::now();
+
+        auto result = decode(image.size(), resized, ImageOutputs(views_, 0));
+
+        lastTimings_.preprocessMs = elapsedMs(t0, t1);
+        lastTimings_.inferenceMs = elapsedMs(t1, t2);
+        lastTimings_.postprocessMs = elapsedMs(t2, Clock::now());
+        return result;
+    }
+
+    /**
+     * @brief Runs a batch with one session run per model batch and decodes every image, in input order.
+     *
+     * All images are preprocessed to the same input shape in one contiguous NCHW blob: the input
+     * size, or the smallest input bucket holding every image. Dynamic-batch models consume the whole
+     * request in one run; fixed-batch models are fed in chunks of their exported batch size, with
+     * unused slots of the last chunk zero-filled and ignored. Images may be ROI views of a larger
+     * frame (cv::Mat(frame, rect)); they are read in place, without a copy.
+     *
+     * @tparam ParallelDecode Decode the images of a chunk through cv::parallel_for_; decode must
+     *         then be thread-safe and its result default-constructible.
+     */
+    template <bool ParallelDecode = false, typename Decode>
+    auto runBatch(const std::vector<cv::Mat> &images, Decode &&decode)
+        -> std::vector<decltype(decode(cv::Size(), cv::Size(), std::declval<const ImageOutputs &>()))> {
+        std::vector<decltype(decode(cv::Size(), cv::Size(), std::declval<const ImageOutputs &>()))> results;
+        lastTimings_ = StageTimings{};
+        results.reserve(images.size());
+        if (images.empty()) {
+            return results;
+        }
+
+        // Dynamic-batch models take the whole request at once, fixed-batch models run in chunks
+        const size_t chunkSize = isDynamicBatch_ ? images.size() : static_cast<size_t>(modelBatchSize_);
+        const Bucket *bucket = selectBucket(images);
+        const cv::Size shape = bucket ? bucket->shape : inputImageShape_;
+        TensorBinding &binding = bucket ? *bucket->binding : tensorBinding_;
+        activeBinding_ = &binding;
+        batchInputShape_ = {static_cast<int64_t>(chunkSize), 3, shape.height, shape.width};
+
+        for (size_t begin = 0; begin < images.size(); begin += chunkSize) {
+            const size_t count = std::min(chunkSize, images.size() - begin);
+
+            const Clock::time_point t0 = Clock::now();
+            if (binding.halfInput()) {
+                preprocessBatch(images, begin, count, binding.prepareHalfInput(batchInputShape_), chunkSize, shape);
+            } else {
+                preprocessBatch(images, begin, count, binding.prepareInput(batchInputShape_), chunkSize, shape);
+            }
+            const Clock::time_point t1 = Clock::now();
+
+            // One session run for the whole chunk
+            binding.run(session_);
+            refreshViews(chunkSize);
+            const Clock::time_point t2 = Clock::now();
+
+            if constexpr (ParallelDecode) {
+                results.resize(begin + count);
+                cv::parallel_for_(cv::Range(0, static_cast<int>(count)), [&](const cv::Range &range) {
+                    for (int b = range.start; b < range.end; ++b) {
+                        results[begin + b] = decode(images[begin + b].size(), shape, ImageOutputs(views_, b));
+                    }
+                });
+            } else {
+                for (size_t b = 0; b < count; ++b) {
+                    results.emplace_back(decode(images[begin + b].size(), shape, ImageOutputs(views_, b)));
+                }
+            }
+
+            lastTimings_.preprocessMs += elapsedMs(t0, t1);
+            lastTimings_.inferenceMs += elapsedMs(t1, t2);
+            lastTimings_.postprocessMs += elapsedMs(t2, Clock::now());
+        }
+
+        return results;
+    }
+
+    /**
+     * @brief Preprocessing geometry of one image (what run() would feed the model).
+     */
+    LetterboxParams geometry(const cv::Size &imageSize) const {
+        if (const Bucket *bucket = selectBucket(imageSize)) {
+            return fitInto(imageSize, bucket->shape, false);
+        }
+        return fitInto(imageSize, inputImageShape_, isDynamicInputShape_);
+    }
+
+    /**
+     * @brief Frame sizes that exercise every input shape in a warmup: the buckets, or the input size.
+     */
+    std::vector<cv::Size> warmupSizes() const {
+        if (buckets_.empty()) {
+            return {inputImageShape_};
+        }
+        std::vector<cv::Size> sizes;
+        for (const Bucket &bucket : buckets_) sizes.push_back(bucket.shape);
+        return sizes;
+    }
+
+    Ort::Session &session() { return session_; }
+    ExecutionProvider provider() const { return provider_; }
+    const char *inputName() const { return inputNames_[0]; }
+    const char *outputName(size_t i) const { return outputNames_[i]; }
+    size_t numInputNodes() const { return numInputNodes_; }
+    size_t numOutputNodes() const { return numOutputNodes_; }
+
+    /// Output shape from the model metadata (-1 for dynamic axes), available before the first run
+    std::vector<int64_t> modelOutputShape(size_t i) const {
+        return session_.GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape();
+    }
+    const std::vector<int64_t> &modelInputShape() const { return modelInputShape_; }
+
+    bool isDynamicInputShape() const { return isDynamicInputShape_; }
+    bool isDynamicBatch() const { return isDynamicBatch_; }
+    int64_t modelBatchSize() const { return modelBatchSize_; }
+    /// Fixed batch size, or -1 if the model accepts a dynamic batch dimension
+    int64_t batchSize() const { return isDynamicBatch_ ? -1 : modelBatchSize_; }
+    const cv::Size &inputImageShape() const { return inputImageShape_; }
+
+    /// "fp32", "fp16" (float16 input) or the model's "precision" metadata entry (e.g. "int8")
+    const std::string &precision() const { return precision_; }
+    /// Input or outputs are float16 tensors; device-side paths that assume float tensors must step aside
+    bool hasHalfTensors() const { return tensorBinding_.halfInput() || tensorBinding_.halfOutputs(); }
+
+    const StageTimings &lastTimings() const { return lastTimings_; }
+    /// For task paths that bypass run() (e.g. device-side pre/postprocessing)
+    void setLastTimings(const StageTimings &timings) { lastTimings_ = timings; }
+    void resetTimings() { lastTimings_ = StageTimings{}; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static double elapsedMs(Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    // Input bucket with the TensorBinding bound to its shape
+    struct Bucket {
+        cv::Size shape;
+        std::unique_ptr<TensorBinding> binding;
+    };
+
+    LetterboxParams fitInto(const cv::Size &imageSize, const cv::Size &shape, bool padToStride) const {
+        if constexpr (Policy::transform == InputTransform::Stretch) {
+            return computeLetterbox(imageSize, shape, false, /*scaleFill=*/true);
+        }
+        return computeLetterbox(imageSize, shape, padToStride, false, true, 32);
+    }
+
+    // True if the bucket letterboxes the image at no less than the input-size scale
+    bool fitsBucket(const Bucket &bucket, const cv::Size &imageSize) const {
+        const float target = std::min(static_cast<float>(inputImageShape_.height) / imageSize.height,
+                                      static_cast<float>(inputImageShape_.width) / imageSize.width);
+        const float scale = std::min(static_cast<float>(bucket.shape.height) / imageSize.height,
+                                     static_cast<float>(bucket.shape.width) / imageSize.width);
+        return scale >= target * (1.0f - 1e-6f);
+    }
+
+    // Smallest bucket that fits the image (nullptr if none)
+    const Bucket *selectBucket(const cv::Size &imageSize) const {
+        for (const Bucket &bucket : buckets_) {
+            if (fitsBucket(bucket, imageSize)) {
+                return &bucket;
+            }
+        }
+        return nullptr;
+    }
+
+    // Smallest bucket that fits every image of a batch (nullptr if none). Buckets of equal area
+    // and opposite orientation each fit only one of a landscape and a portrait frame, so the
+    // batch is checked against every candidate rather than taking the largest per-image pick.
+    const Bucket *selectBucket(const std::vector<cv::Mat> &images) const {
+        for (const Bucket &bucket : buckets_) {
+            const bool fitsAll = std::all_of(images.begin(), images.end(),
+                                             [&](const cv::Mat &image) { return fitsBucket(bucket, image.size()); });
+            if (fitsAll) {
+                return &bucket;
+            }
+        }
+        return nullptr;
+    }
+
+    std::string detectPrecision() {
+        Ort::AllocatorWithDefaultOptions allocator;
+        Ort::AllocatedStringPtr tag = session_.GetModelMetadata().LookupCustomMetadataMapAllocated("precision", allocator);
+        if (tag && tag.get()[0] != '\0') {
+            return tag.get();
+        }
+        return tensorBinding_.halfInput() ? "fp16" : "fp32";
+    }
+
+    // Float for FP32/INT8 models, uint16_t (binary16) for FP16 models
+    template <typename T>
+    static void transform(LetterboxKernel &kernel, const cv::Mat &image, const LetterboxParams &params, T *dst) {
+        if constexpr (Policy::transform == InputTransform::Stretch) {
+            kernel.run(image, params, dst, /*swapRB=*/true, /*padValue=*/0.f);
+        } else {
+            kernel.run(image, params, dst);
+        }
+    }
+
+    // Resize/pad, BGR -> RGB, scale to [0, 1] and HWC -> CHW in one pass, straight into the bound input tensor
+    cv::Size preprocess(const cv::Mat &image) {
+        ScopedTimer timer(Policy::preprocessStage);
+
+        // Dynamic-shape models go to their input bucket, or only pad up to the next stride multiple
+        const Bucket *bucket = selectBucket(image.size());
+        const LetterboxParams params = bucket ? fitInto(image.size(), bucket->shape, false)
+                                              : fitInto(image.size(), inputImageShape_, isDynamicInputShape_);
+        activeBinding_ = bucket ? bucket->binding.get() : &tensorBinding_;
+        singleInputShape_ = {1, 3, params.outShape.height, params.outShape.width};
+        if (activeBinding_->halfInput()) {
+            transform(letterboxKernel_, image, params, activeBinding_->prepareHalfInput(singleInputShape_));
+        } else {
+            transform(letterboxKernel_, image, params, activeBinding_->prepareInput(singleInputShape_));
+        }
+        return params.outShape;
+    }
+
+    template <typename T>
+    void preprocessBatch(const std::vector<cv::Mat> &images, size_t begin, size_t count, T *blob, size_t batchSize,
+                         const cv::Size &shape) {
+        ScopedTimer timer(Policy::preprocessBatchStage);
+
+        const size_t imageSize = static_cast<size_t>(shape.width) * static_cast<size_t>(shape.height) * 3;
+        // Every image of the batch gets the same shape so the slices line up
+        auto transformImage = [&](LetterboxKernel &kernel, size_t b) {
+            const cv::Mat &image = images[begin + b];
+            transform(kernel, image, fitInto(image.size(), shape, false), blob + b * imageSize);
+        };
+
+        // Batches with an image per worker (e.g. many small crops) are split across images, each stripe
+        // with its own kernel; smaller batches keep the kernel's row bands parallel within each image
+        const int stripes = static_cast<int>(std::min<size_t>(count, static_cast<size_t>(cv::getNumThreads())));
+        if (stripes > 1 && count >= static_cast<size_t>(cv::getNumThreads())) {
+            while (batchKernels_.size() < static_cast<size_t>(stripes)) {
+                batchKernels_.push_back(std::make_unique<LetterboxKernel>());
+            }
+            cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range &range) {
+                for (int s = range.start; s < range.end; ++s) {
+                    const size_t first = count * s / stripes;
+                    const size_t last = count * (s + 1) / stripes;
+                    for (size_t b = first; b < last; ++b) {
+                        transformImage(*batchKernels_[s], b);
+                    }
+                }
+            });
+        } else {
+            for (size_t b = 0; b < count; ++b) {
+                transformImage(letterboxKernel_, b);
+            }
+        }
+
+        // Unused slots of a fixed-batch model are fed as blank images and ignored afterwards (0 is also a half zero)
+        std::fill(blob + count * imageSize, blob + batchSize * imageSize, T(0));
+    }
+
+    // Per-image slicing of the outputs of the last run
+    void refreshViews(size_t batchSize) {
+        for (size_t i = 0; i < views_.size(); ++i) {
+            OutputView &view = views_[i];
+            view.data = activeBinding_->outputData(i);
+            const std::vector<int64_t> &shape = activeBinding_->outputShape(i);
+            view.shape = shape;
+            view.imageShape = shape;
+            view.imageSize = 0;
+            // A tensor is batch-major when its leading axis matches the batch (rank-1 outputs never are)
+            if (shape.size() >= 2 && shape[0] == static_cast<int64_t>(batchSize)) {
+                view.imageShape[0] = 1;
+                view.imageSize = 1;
+                for (size_t d = 1; d < shape.size(); ++d) view.imageSize *= static_cast<size_t>(shape[d]);
+            }
+        }
+    }
+
+    std::shared_ptr<SharedRuntime> runtime_;       // ONNX Runtime environment (possibly shared, outlives the session)
+    Ort::SessionOptions sessionOptions_;
+    ModelMapping modelMapping_;                    // Mapped model file with DetectorOptions::mapModel (outlives the session)
+    Ort::Session session_{nullptr};
+    ExecutionProvider provider_{ExecutionProvider::CPU};
+
+    std::vector<int64_t> modelInputShape_;
+    bool isDynamicInputShape_{false};
+    bool isDynamicBatch_{false};
+    int64_t modelBatchSize_{1};
+    cv::Size inputImageShape_;                     // Preprocessing shape
+
+    std::vector<Ort::AllocatedStringPtr> inputNameAllocs_;
+    std::vector<const char *> inputNames_;
+    std::vector<Ort::AllocatedStringPtr> outputNameAllocs_;
+    std::vector<const char *> outputNames_;
+    size_t numInputNodes_{0}, numOutputNodes_{0};
+
+    TensorBinding tensorBinding_;                  // Persistent input/output buffers bound to the session
+    std::vector<Bucket> buckets_;                  // Input buckets by increasing area (dynamic-shape models only)
+    TensorBinding *activeBinding_{&tensorBinding_}; // Binding of the last preprocessed input
+    LetterboxKernel letterboxKernel_;              // Fused letterbox/normalize/CHW kernel writing into the input tensor
+    std::vector<std::unique_ptr<LetterboxKernel>> batchKernels_;  // One per image stripe of a parallel batch preprocess
+    std::vector<int64_t> singleInputShape_;
+    std::vector<int64_t> batchInputShape_;
+    std::vector<OutputView> views_;
+    StageTimings lastTimings_;
+    std::string precision_{"fp32"};                // Detected precision (see precision())
+};
+
+} // namespace yolos
+
+#endif // YOLO_CORE_HPP
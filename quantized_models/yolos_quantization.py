@@ -1,10 +1,45 @@
+"""
+Quantization and half-precision conversion of YOLO ONNX models for the YOLOs-CPP runtime.
 
+Three modes:
+    dynamic  Weight-only QUInt8 (the original workflow; little speedup on conv-heavy graphs).
+    static   INT8 QDQ with activation ranges calibrated on representative frames.
+    fp16     Float16 weights and float16 input/output tensors.
 
+Every output model carries a "precision" metadata entry ("int8" or "fp16") which the C++ side
+reports through getPrecision(); FP16 models are also recognised from their input element type.
 
+Example:
+    python yolos_quantization.py static ../models/yolo11n.onnx yolo11n_int8.onnx \\
+        --calibration-dir ../data/calibration --calibration-size 200
+"""
 
-from onnxruntime.quantization import quantize_dynamic, QuantType
+import argparse
+import random
 from pathlib import Path
-from typing import Union
+from typing import Iterator, List, Optional, Sequence, Union
+
+import numpy as np
+import onnx
+from onnxruntime.quantization import (CalibrationDataReader, CalibrationMethod, QuantFormat, QuantType,
+                                      quantize_dynamic, quantize_static)
+
+IMAGE_SUFFIXES = {".jpg", ".jpeg", ".png", ".bmp"}
+VIDEO_SUFFIXES = {".mp4", ".avi", ".mkv", ".mov"}
+
+
+def set_precision_metadata(model_path: Union[str, Path], precision: str):
+    """
+    Records the numeric precision of a model in its metadata ("precision" key).
+    """
+    model = onnx.load(str(model_path))
+    entries = {prop.key: prop for prop in model.metadata_props}
+    if "precision" in entries:
+        entries["precision"].value = precision
+    else:
+        model.metadata_props.add(key="precision", value=precision)
+    onnx.save(model, str(model_path))
+
 
 def quantize_onnx_model(onnx_model_path: Union[str, Path], quantized_model_path: Union[str, Path], per_channel: bool = False):
     """
@@ -23,24 +58,231 @@ def quantize_onnx_model(onnx_model_path: Union[str, Path], quantized_model_path:
     """
     # Quantize the model
     quantize_dynamic(
-        model_input=onnx_model_path, 
-        model_output=quantized_model_path, 
+        model_input=onnx_model_path,
+        model_output=quantized_model_path,
         per_channel=per_channel,  # Set to True if per-channel quantization is desired
         weight_type=QuantType.QUInt8  # Specify the weight type for quantization
     )
-    
+    set_precision_metadata(quantized_model_path, "int8")
+
     print("Quantization completed. Quantized model saved to:", quantized_model_path)
 
-if __name__ == "__main__":
 
-    # Load the original ONNX model file path
-    # onnx_model_path = 'yolo5-n6.onnx' 
-    # onnx_model_path = 'yolo7-tiny.onnx' 
-    # onnx_model_path = 'yolo8n.onnx'
-    onnx_model_path = 'yolo10n.onnx'   # Change this to your desired model
+def letterbox(image: np.ndarray, height: int, width: int, stretch: bool = False) -> np.ndarray:
+    """
+    Same input transform as the C++ preprocessing: BGR -> RGB, letterbox with 114 padding
+    (or a plain resize for classifiers), scale to [0, 1], HWC -> NCHW float32.
+    """
+    import cv2
+
+    if stretch:
+        canvas = cv2.resize(image, (width, height), interpolation=cv2.INTER_LINEAR)
+    else:
+        scale = min(height / image.shape[0], width / image.shape[1])
+        unpad_w, unpad_h = round(image.shape[1] * scale), round(image.shape[0] * scale)
+        resized = cv2.resize(image, (unpad_w, unpad_h), interpolation=cv2.INTER_LINEAR)
+        canvas = np.full((height, width, 3), 114, dtype=np.uint8)
+        top, left = (height - unpad_h) // 2, (width - unpad_w) // 2
+        canvas[top:top + unpad_h, left:left + unpad_w] = resized
+    tensor = canvas[:, :, ::-1].astype(np.float32) / 255.0
+    return np.ascontiguousarray(tensor.transpose(2, 0, 1)[np.newaxis])
+
+
+def collect_frames(sources: Sequence[Union[str, Path]], count: int, video_stride: int, seed: int) -> List[np.ndarray]:
+    """
+    Gathers up to count BGR frames from image files, directories of images and videos.
+
+    Videos contribute every video_stride-th frame; when more frames are found than needed,
+    a random (seeded) subset is kept so the calibration set covers all sources. The subset is
+    drawn by reservoir sampling while reading, so at most count frames are held in memory
+    however long the videos are.
+    """
+    import cv2
+
+    paths: List[Path] = []
+    for source in sources:
+        source = Path(source)
+        if source.is_dir():
+            paths.extend(sorted(p for p in source.rglob("*") if p.suffix.lower() in IMAGE_SUFFIXES | VIDEO_SUFFIXES))
+        elif source.exists():
+            paths.append(source)
+        else:
+            raise FileNotFoundError(f"Calibration source not found: {source}")
+
+    rng = random.Random(seed)
+    frames: List[np.ndarray] = []
+    seen = 0
+
+    def offer(frame: np.ndarray) -> None:
+        nonlocal seen
+        seen += 1
+        if len(frames) < count:
+            frames.append(frame)
+        else:
+            slot = rng.randrange(seen)
+            if slot < count:
+                frames[slot] = frame
+
+    for path in paths:
+        if path.suffix.lower() in VIDEO_SUFFIXES:
+            capture = cv2.VideoCapture(str(path))
+            index = 0
+            # Skipped frames are only grabbed, not decoded into images
+            while capture.grab():
+                if index % video_stride == 0:
+                    ok, frame = capture.retrieve()
+                    if ok:
+                        offer(frame)
+                index += 1
+            capture.release()
+        else:
+            frame = cv2.imread(str(path))
+            if frame is not None:
+                offer(frame)
+
+    if not frames:
+        raise RuntimeError("No calibration frames could be read")
+    return frames
+
+
+class FrameCalibrationReader(CalibrationDataReader):
+    """
+    Feeds preprocessed calibration frames to the ONNX Runtime calibrator, one at a time.
+    """
+
+    def __init__(self, model_path: Union[str, Path], frames: List[np.ndarray], stretch: bool,
+                 input_size: Optional[int] = None):
+        model = onnx.load(str(model_path))
+        model_input = model.graph.input[0]
+        dims = [d.dim_value for d in model_input.type.tensor_type.shape.dim]
+        self.input_name = model_input.name
+        # Dynamic spatial axes fall back to the requested (or default 640) size
+        self.height = dims[2] if len(dims) == 4 and dims[2] > 0 else (input_size or 640)
+        self.width = dims[3] if len(dims) == 4 and dims[3] > 0 else (input_size or 640)
+        self.frames = frames
+        self.stretch = stretch
+        self.iterator: Optional[Iterator[np.ndarray]] = None
 
-    # Specify the output path for the quantized model
-    quantized_model_path = 'yolo10n.onnx'  # Change this to your desired output file name
+    def get_next(self):
+        if self.iterator is None:
+            self.iterator = iter(self.frames)
+        frame = next(self.iterator, None)
+        if frame is None:
+            return None
+        return {self.input_name: letterbox(frame, self.height, self.width, self.stretch)}
 
-    # Call the quantization function
-    quantize_onnx_model(onnx_model_path, quantized_model_path, per_channel=True)  # Change True to False as needed
+    def rewind(self):
+        self.iterator = None
+
+
+def head_nodes(model_path: Union[str, Path], count: int) -> List[str]:
+    """
+    Names of the last count nodes of the graph (the box/score decoding of the detection head),
+    which are left in float: quantizing the concatenated box coordinates and scores into one
+    scale costs far more accuracy than it saves time.
+    """
+    if count <= 0:
+        return []
+    model = onnx.load(str(model_path))
+    return [node.name for node in model.graph.node[-count:] if node.name]
+
+
+def quantize_static_onnx_model(onnx_model_path: Union[str, Path], quantized_model_path: Union[str, Path],
+                               calibration_sources: Sequence[Union[str, Path]], calibration_size: int = 200,
+                               video_stride: int = 15, method: str = "minmax", per_channel: bool = True,
+                               stretch: bool = False, exclude_head_nodes: int = 0, input_size: Optional[int] = None,
+                               seed: int = 0):
+    """
+    Static INT8 quantization in QDQ format, calibrated on representative frames.
+
+    Args:
+        onnx_model_path: Path to the FP32 model.
+        quantized_model_path: Path to save the QDQ model.
+        calibration_sources: Images, image directories and videos from the deployment data.
+        calibration_size: Number of frames used for calibration (100-500 is usually enough).
+        video_stride: Every video_stride-th frame of a video is a calibration candidate.
+        method: Activation range estimator: "minmax", "entropy" or "percentile".
+        per_channel: Per-output-channel weight scales (recommended for YOLO convolutions).
+        stretch: Resize without letterboxing (classification models).
+        exclude_head_nodes: Keep the last N graph nodes in float (see head_nodes()).
+        input_size: Calibration resolution for models with dynamic spatial axes.
+        seed: Seed of the calibration frame sampling.
+    """
+    methods = {
+        "minmax": CalibrationMethod.MinMax,
+        "entropy": CalibrationMethod.Entropy,
+        "percentile": CalibrationMethod.Percentile,
+    }
+    if method not in methods:
+        raise ValueError(f"Unknown calibration method: {method}")
+
+    frames = collect_frames(calibration_sources, calibration_size, video_stride, seed)
+    print(f"Calibrating on {len(frames)} frames ({method})")
+    reader = FrameCalibrationReader(onnx_model_path, frames, stretch, input_size)
+
+    quantize_static(
+        model_input=onnx_model_path,
+        model_output=quantized_model_path,
+        calibration_data_reader=reader,
+        quant_format=QuantFormat.QDQ,        # Q/DQ pairs around float ops; fused into INT8 kernels by ORT/TensorRT
+        activation_type=QuantType.QUInt8,
+        weight_type=QuantType.QInt8,
+        per_channel=per_channel,
+        calibrate_method=methods[method],
+        nodes_to_exclude=head_nodes(onnx_model_path, exclude_head_nodes),
+        extra_options={"ActivationSymmetric": False, "WeightSymmetric": True},
+    )
+    set_precision_metadata(quantized_model_path, "int8")
+
+    print("Static quantization completed. Quantized model saved to:", quantized_model_path)
+
+
+def convert_fp16_onnx_model(onnx_model_path: Union[str, Path], fp16_model_path: Union[str, Path],
+                            keep_io_types: bool = False):
+    """
+    Converts a model to float16. With keep_io_types=False the input and outputs become float16
+    as well, so the C++ preprocessing writes half values directly (no Cast node at the input).
+    """
+    from onnxconverter_common import float16
+
+    model = onnx.load(str(onnx_model_path))
+    model = float16.convert_float_to_float16(model, keep_io_types=keep_io_types)
+    onnx.save(model, str(fp16_model_path))
+    set_precision_metadata(fp16_model_path, "fp16")
+
+    print("FP16 conversion completed. Model saved to:", fp16_model_path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Quantize or convert YOLO ONNX models for YOLOs-CPP")
+    parser.add_argument("mode", choices=["dynamic", "static", "fp16"])
+    parser.add_argument("model", help="FP32 ONNX model")
+    parser.add_argument("output", help="Output model path")
+    parser.add_argument("--calibration-dir", nargs="+", default=[],
+                        help="Images, image directories or videos to calibrate on (static mode)")
+    parser.add_argument("--calibration-size", type=int, default=200)
+    parser.add_argument("--video-stride", type=int, default=15)
+    parser.add_argument("--method", choices=["minmax", "entropy", "percentile"], default="minmax")
+    parser.add_argument("--per-tensor", action="store_true", help="Per-tensor instead of per-channel weight scales")
+    parser.add_argument("--stretch", action="store_true", help="Resize without letterboxing (classifiers)")
+    parser.add_argument("--exclude-head-nodes", type=int, default=0,
+                        help="Keep the last N nodes (detection head decoding) in float")
+    parser.add_argument("--input-size", type=int, default=None, help="Calibration size for dynamic-shape models")
+    parser.add_argument("--keep-io-types", action="store_true", help="FP16 mode: keep float32 input/outputs")
+    parser.add_argument("--seed", type=int, default=0)
+    args = parser.parse_args()
+
+    if args.mode == "dynamic":
+        quantize_onnx_model(args.model, args.output, per_channel=not args.per_tensor)
+    elif args.mode == "static":
+        if not args.calibration_dir:
+            parser.error("static mode needs --calibration-dir")
+        quantize_static_onnx_model(args.model, args.output, args.calibration_dir, args.calibration_size,
+                                   args.video_stride, args.method, not args.per_tensor, args.stretch,
+                                   args.exclude_head_nodes, args.input_size, args.seed)
+    else:
+        convert_fp16_onnx_model(args.model, args.output, args.keep_io_types)
+
+
+if __name__ == "__main__":
+    main()
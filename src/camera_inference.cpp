@@ -25,12 +25,21 @@
  * - `labelsPath`: Path to the class labels file (e.g., COCO dataset).
  * - `modelPath`: Path to the desired YOLO model file (e.g., ONNX format).
  * - `videoSource`: Path to the video capture device (e.g., camera).
+ * - `lowLatency`: Latest-frame-wins hand-off between capture and detection.
+ * - `track`: Pass "track" as 5th argument to detect only on the frames a
+ *   yolos::DetectionScheduler picks and track objects in between (det/Tracker.hpp),
+ *   or "motion" to detect only on the regions that changed (det/MotionGate.hpp).
  *
  * The application employs a double buffering technique by maintaining two bounded 
  * queues to efficiently manage the flow of frames between the producer and 
  * consumer threads. This setup helps prevent processing delays due to slow frame 
  * capture or detection times.
  *
+ * In low-latency mode (the default; pass "queued" as 4th argument to disable it)
+ * the capture thread publishes into a LatestFrameMailbox instead of the first
+ * queue: the detector always runs on the freshest frame, frames it has no time
+ * for are dropped and counted, and the capture-to-display latency is reported.
+ *
  * Debugging messages can be enabled by defining the `DEBUG_MODE` macro, allowing 
  * developers to trace the execution flow and internal state of the application 
  * during runtime.
@@ -52,13 +61,50 @@
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <string>
 
 #include <opencv2/highgui/highgui.hpp>
 #include "det/YOLO.hpp"
+#include "det/Tracker.hpp"
+#include "det/MotionGate.hpp"
+
+
+// Include the lock-free bounded queue and the frame pool
+#include "tools/RingQueue.hpp"
+#include "tools/FramePool.hpp"
+#include "tools/LatestFrameMailbox.hpp"
+
+// A captured frame and its detections
+struct CameraFrame {
+    yolos::FrameLease image;
+    std::vector<Detection> detections;
+    std::chrono::steady_clock::time_point captured;   // When the capture returned the frame
+};
 
+// Capture-to-display latency over the last reportEvery frames
+class LatencyReport {
+public:
+    explicit LatencyReport(size_t reportEvery = 100) : reportEvery(reportEvery) { samples.reserve(reportEvery); }
 
-// Include the bounded queue
-#include "tools/BoundedThreadSafeQueue.hpp"
+    void add(std::chrono::steady_clock::time_point captured, uint64_t dropped) {
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - captured).count());
+        if (samples.size() < reportEvery) {
+            return;
+        }
+        std::sort(samples.begin(), samples.end());
+        std::cout << "Latency (ms) p50: " << samples[samples.size() / 2]
+                  << ", p95: " << samples[samples.size() * 95 / 100]
+                  << ", max: " << samples.back()
+                  << " | frames dropped: " << dropped << std::endl;
+        samples.clear();
+    }
+
+private:
+    size_t reportEvery;
+    std::vector<double> samples;
+};
 
 int main(int argc, char* argv[])
 {
@@ -77,7 +123,13 @@ int main(int argc, char* argv[])
     if (argc > 3){
         labelsPath = argv[3];
     }
+    const bool lowLatency = !(argc > 4 && std::string(argv[4]) == "queued");
+    const std::string mode = argc > 5 ? argv[5] : "";
+    const bool track = mode == "track";
+    const bool motion = mode == "motion";
     YOLODetector detector(modelPath, labelsPath, isGPU);
+    TrackedStream trackedStream(detector);      // Only used by the consumer thread
+    MotionGatedStream motionGate(detector);     // Only used by the consumer thread
 
 
     // Open video capture
@@ -96,51 +148,75 @@ int main(int argc, char* argv[])
 
     // Initialize queues with bounded capacity
     const size_t max_queue_size = 2; // Double buffering
-    BoundedThreadSafeQueue<cv::Mat> frameQueue(max_queue_size);
-    BoundedThreadSafeQueue<std::pair<cv::Mat, std::vector<Detection>>> processedQueue(max_queue_size);
+    SpscRingQueue<CameraFrame> frameQueue(max_queue_size);      // One producer, one consumer each
+    SpscRingQueue<CameraFrame> processedQueue(max_queue_size);
+    LatestFrameMailbox<CameraFrame> latestFrame; // Replaces frameQueue in low-latency mode
     std::atomic<bool> stopFlag(false);
+    LatencyReport latency;
+
+    auto stopAll = [&]() {
+        stopFlag.store(true);
+        frameQueue.set_finished();
+        latestFrame.close();
+        processedQueue.set_finished();
+    };
+
+    // Frames are captured into recycled buffers: both queues, the detector, the display and the capture
+    const cv::Size frameSize(static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH)), static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    yolos::FramePool framePool(frameSize.empty() ? cv::Size(1280, 720) : frameSize, CV_8UC3, 2 * max_queue_size + 3);
 
     // Producer thread: Capture frames
     std::thread producer([&]() {
-        cv::Mat frame;
-        while (!stopFlag.load() && cap.read(frame))
+        while (!stopFlag.load())
         {
-            if (!frameQueue.enqueue(frame))
+            CameraFrame frame;
+            frame.image = framePool.acquire();
+            if (!cap.read(frame.image.mat()))
+                break;
+            frame.captured = std::chrono::steady_clock::now();
+            if (lowLatency)
+                latestFrame.publish(std::move(frame)); // Overwrites a frame the detector did not get to
+            else if (!frameQueue.enqueue(std::move(frame)))
                 break; // Queue is finished
         }
         frameQueue.set_finished();
+        latestFrame.close();
     });
 
     // Consumer thread: Process frames
     std::thread consumer([&]() {
-        cv::Mat frame;
-        while (!stopFlag.load() && frameQueue.dequeue(frame))
+        CameraFrame frame;
+        while (!stopFlag.load() && (lowLatency ? latestFrame.consume(frame) : frameQueue.dequeue(frame)))
         {
-            // Perform detection
-            std::vector<Detection> detections = detector.detect(frame);
+            // Perform detection, or propagate the tracks on frames the scheduler skips
+            if (track)
+                frame.detections = trackedStream.process(frame.image.mat());
+            else if (motion)
+                frame.detections = motionGate.process(frame.image.mat());
+            else
+                frame.detections = detector.detect(frame.image.mat());
 
             // Enqueue processed frame
-            if (!processedQueue.enqueue(std::make_pair(frame, detections)))
+            if (!processedQueue.enqueue(std::move(frame)))
                 break;
         }
         processedQueue.set_finished();
     });
 
-    std::pair<cv::Mat, std::vector<Detection>> item;
+    CameraFrame item;
 
     #ifdef __APPLE__
     // For macOS, ensure UI runs on the main thread
     while (!stopFlag.load() && processedQueue.dequeue(item))
     {
-        cv::Mat displayFrame = item.first;
-        detector.drawBoundingBoxMask(displayFrame, item.second);
+        cv::Mat &displayFrame = item.image.mat();
+        detector.drawBoundingBoxMask(displayFrame, item.detections);
 
         cv::imshow("Detections", displayFrame);
+        latency.add(item.captured, latestFrame.dropped());
         if (cv::waitKey(1) == 'q')
         {
-            stopFlag.store(true);
-            frameQueue.set_finished();
-            processedQueue.set_finished();
+            stopAll();
             break;
         }
     }
@@ -149,17 +225,16 @@ int main(int argc, char* argv[])
     std::thread displayThread([&]() {
         while (!stopFlag.load() && processedQueue.dequeue(item))
         {
-            cv::Mat displayFrame = item.first;
-            // detector.drawBoundingBox(displayFrame, item.second);
-            detector.drawBoundingBoxMask(displayFrame, item.second);
+            cv::Mat &displayFrame = item.image.mat();
+            // detector.drawBoundingBox(displayFrame, item.detections);
+            detector.drawBoundingBoxMask(displayFrame, item.detections);
 
             // Display the frame
             cv::imshow("Detections", displayFrame);
+            latency.add(item.captured, latestFrame.dropped());
             // Use a small delay and check for 'q' key press to quit
             if (cv::waitKey(1) == 'q') {
-                stopFlag.store(true);
-                frameQueue.set_finished();
-                processedQueue.set_finished();
+                stopAll();
                 break;
             }
         }
@@ -171,6 +246,19 @@ int main(int argc, char* argv[])
     producer.join();
     consumer.join();
 
+    if (track) {
+        std::cout << "Frames detected: " << trackedStream.schedule().detected()
+                  << ", tracked only: " << trackedStream.schedule().skipped() << std::endl;
+    }
+    if (motion) {
+        std::cout << "Frames detected in full: " << motionGate.fullFrameCount()
+                  << ", on changed regions: " << motionGate.regionFrameCount()
+                  << ", unchanged: " << motionGate.idleFrameCount() << std::endl;
+    }
+    if (lowLatency) {
+        std::cout << "Frames captured: " << latestFrame.published() << ", dropped: " << latestFrame.dropped() << std::endl;
+    }
+
     // Release resources
     cap.release();
     cv::destroyAllWindows();
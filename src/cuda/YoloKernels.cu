@@ -0,0 +1,175 @@
+// YoloKernels.cu
+//
+// Device implementations of the kernels declared in tools/CudaKernels.hpp.
+// Built into the yolos_cuda library when configured with -DYOLOS_ENABLE_CUDA=ON.
+
+#include "tools/CudaKernels.hpp"
+
+#include <cfloat>
+
+namespace yolos {
+namespace cuda {
+
+namespace {
+
+constexpr int kBlockX = 32;
+constexpr int kBlockY = 8;
+constexpr int kDecodeBlock = 256;
+
+// One thread per output pixel. Sampling follows cv::resize INTER_LINEAR (and LetterboxKernel on the host).
+__global__ void letterboxKernel(const uint8_t *__restrict__ src, size_t srcStep, LetterboxGeometry g,
+                                float *__restrict__ dst, int c0, int c2, float padValue, float scale) {
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+    if (x >= g.outW || y >= g.outH) {
+        return;
+    }
+
+    const size_t plane = static_cast<size_t>(g.outW) * g.outH;
+    const size_t o = static_cast<size_t>(y) * g.outW + x;
+
+    const int ux = x - g.padLeft;
+    const int uy = y - g.padTop;
+    if (ux < 0 || uy < 0 || ux >= g.unpadW || uy >= g.unpadH) {
+        const float pad = padValue * scale;
+        dst[o] = pad;
+        dst[o + plane] = pad;
+        dst[o + 2 * plane] = pad;
+        return;
+    }
+
+    float sx = (ux + 0.5f) * (static_cast<float>(g.srcW) / g.unpadW) - 0.5f;
+    float sy = (uy + 0.5f) * (static_cast<float>(g.srcH) / g.unpadH) - 0.5f;
+    sx = fmaxf(sx, 0.f);
+    sy = fmaxf(sy, 0.f);
+    int x0 = static_cast<int>(sx);
+    int y0 = static_cast<int>(sy);
+    float fx = sx - x0;
+    float fy = sy - y0;
+    if (x0 >= g.srcW - 1) { x0 = g.srcW - 1; fx = 0.f; }
+    if (y0 >= g.srcH - 1) { y0 = g.srcH - 1; fy = 0.f; }
+    const int x1 = min(x0 + 1, g.srcW - 1);
+    const int y1 = min(y0 + 1, g.srcH - 1);
+
+    const uint8_t *r0 = src + static_cast<size_t>(y0) * srcStep;
+    const uint8_t *r1 = src + static_cast<size_t>(y1) * srcStep;
+    const int p0 = x0 * g.srcChannels;
+    const int p1 = x1 * g.srcChannels;
+    const int channels[3] = {c0, 1, c2};
+#pragma unroll
+    for (int c = 0; c < 3; ++c) {
+        const int ch = channels[c];
+        const float top = r0[p0 + ch] + fx * (static_cast<float>(r0[p1 + ch]) - r0[p0 + ch]);
+        const float bottom = r1[p0 + ch] + fx * (static_cast<float>(r1[p1 + ch]) - r1[p0 + ch]);
+        dst[o + c * plane] = (top + fy * (bottom - top)) * scale;
+    }
+}
+
+// One thread per anchor; consecutive threads read consecutive columns so every class row load is coalesced.
+__global__ void decodeKernel(const float *__restrict__ output, int numClasses, int numAnchors, float confThreshold,
+                             Candidate *__restrict__ candidates, int *count, int maxCandidates) {
+    const int d = blockIdx.x * blockDim.x + threadIdx.x;
+    if (d >= numAnchors) {
+        return;
+    }
+
+    const float *scores = output + static_cast<size_t>(4) * numAnchors + d;
+    float maxScore = -FLT_MAX;
+    int classId = -1;
+    for (int c = 0; c < numClasses; ++c) {
+        const float score = scores[static_cast<size_t>(c) * numAnchors];
+        if (score > maxScore) {
+            maxScore = score;
+            classId = c;
+        }
+    }
+    if (!(maxScore > confThreshold)) {
+        return;
+    }
+
+    const int slot = atomicAdd(count, 1);
+    if (slot < maxCandidates) {
+        Candidate cand;
+        cand.cx = output[d];
+        cand.cy = output[numAnchors + d];
+        cand.w = output[2 * static_cast<size_t>(numAnchors) + d];
+        cand.h = output[3 * static_cast<size_t>(numAnchors) + d];
+        cand.score = maxScore;
+        cand.classId = classId;
+        cand.anchor = d;
+        candidates[slot] = cand;
+    }
+}
+
+// blockIdx.y picks the box; threads walk its outline band by band (top, bottom, left, right edge)
+__global__ void drawBoxesKernel(uint8_t *image, size_t step, int width, int height, int channels,
+                                const DeviceBox *__restrict__ boxes, int thickness) {
+    const DeviceBox box = boxes[blockIdx.y];
+    const int w = box.width, h = box.height;
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    const int perimeter = 2 * (w + h);
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i >= perimeter * thickness) {
+        return;
+    }
+
+    const int band = i / perimeter;
+    const int r = i - band * perimeter;
+    int x, y;
+    if (r < w) {
+        x = box.x + r;
+        y = box.y + band;
+    } else if (r < 2 * w) {
+        x = box.x + r - w;
+        y = box.y + h - 1 - band;
+    } else if (r < 2 * w + h) {
+        x = box.x + band;
+        y = box.y + r - 2 * w;
+    } else {
+        x = box.x + w - 1 - band;
+        y = box.y + r - 2 * w - h;
+    }
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return;
+    }
+
+    uint8_t *pixel = image + static_cast<size_t>(y) * step + static_cast<size_t>(x) * channels;
+    pixel[0] = box.color[0];
+    pixel[1] = box.color[1];
+    pixel[2] = box.color[2];
+}
+
+} // namespace
+
+void launchLetterbox(const uint8_t *src, size_t srcStep, const LetterboxGeometry &geometry, float *dst,
+                     bool swapRB, float padValue, float scale, cudaStream_t stream) {
+    const dim3 block(kBlockX, kBlockY);
+    const dim3 grid((geometry.outW + kBlockX - 1) / kBlockX, (geometry.outH + kBlockY - 1) / kBlockY);
+    letterboxKernel<<<grid, block, 0, stream>>>(src, srcStep, geometry, dst, swapRB ? 2 : 0, swapRB ? 0 : 2,
+                                                padValue, scale);
+    check(cudaGetLastError(), "letterbox kernel launch");
+}
+
+void launchDecode(const float *output, int numClasses, int numAnchors, float confThreshold,
+                  Candidate *candidates, int *count, int maxCandidates, cudaStream_t stream) {
+    check(cudaMemsetAsync(count, 0, sizeof(int), stream), "reset candidate counter");
+    const int grid = (numAnchors + kDecodeBlock - 1) / kDecodeBlock;
+    decodeKernel<<<grid, kDecodeBlock, 0, stream>>>(output, numClasses, numAnchors, confThreshold,
+                                                    candidates, count, maxCandidates);
+    check(cudaGetLastError(), "decode kernel launch");
+}
+
+void launchDrawBoxes(uint8_t *image, size_t step, int width, int height, int channels,
+                     const DeviceBox *boxes, int count, int maxPerimeter, int thickness, cudaStream_t stream) {
+    if (count <= 0 || maxPerimeter <= 0 || thickness <= 0) {
+        return;
+    }
+    const dim3 grid((maxPerimeter * thickness + kDecodeBlock - 1) / kDecodeBlock, count);
+    drawBoxesKernel<<<grid, kDecodeBlock, 0, stream>>>(image, step, width, height, channels, boxes, thickness);
+    check(cudaGetLastError(), "draw boxes kernel launch");
+}
+
+} // namespace cuda
+} // namespace yolos
@@ -13,6 +13,13 @@
  * - Detecting objects within each frame of the video.
  * - Drawing bounding boxes around detected objects and saving the result.
  *
+ * Frames go through a yolos::Pipeline (decode -> infer -> draw -> encode) with
+ * bounded queues between the stages, so memory stays flat however slow the
+ * writer is. Frames are decoded into buffers leased from a yolos::FramePool and
+ * recycled after encoding, so a steady-state run allocates no frame memory. The infer stage runs several detectors sharing one ONNX Runtime
+ * environment; the encoder receives the frames back in their original order.
+ * Per-stage queue depth and throughput are printed while the video is processed.
+ *
  * Configuration parameters can be adjusted to suit specific requirements:
  * - `isGPU`: Set to true to enable GPU processing for improved performance; 
  *   set to false for CPU processing.
@@ -20,6 +27,22 @@
  * - `videoPath`: Path to the input video file (e.g., input.mp4).
  * - `outputPath`: Path for saving the output video file (e.g., output.mp4).
  * - `modelPath`: Path to the desired YOLO model file (e.g., yolo.onnx format).
+ * - `inferWorkers`: Detectors running in parallel (5th argument).
+ * - `track`: Pass "track" as 6th argument to run the detector only on the frames a
+ *   yolos::DetectionScheduler picks (every few frames, or on motion) and carry the
+ *   boxes with a ByteTracker in between. Tracking needs the frames in order, so it
+ *   uses a single infer worker.
+ * - `motion`: Pass "motion" as 6th argument instead to detect only on the regions that
+ *   changed against a background model (det/MotionGate.hpp), carrying the previous
+ *   detections forward elsewhere. Also uses a single infer worker.
+ * - `nvdec`: Pass "nvdec" as 6th argument to decode with NVDEC and encode with NVENC
+ *   (cv::cudacodec, CUDA builds only): frames stay in device memory from the decoder
+ *   through letterboxing, inference and box drawing to the encoder. Without cudacodec,
+ *   or if NVDEC cannot open the video, the CPU path is used.
+ *
+ * On the CPU path, decoding and encoding ask OpenCV's FFmpeg backend for hardware
+ * acceleration (VAAPI, QSV, NVDEC/NVENC, D3D11, whichever is available, OpenCV >= 4.5.2).
+ * It falls back to software when none is.
  *
  * The application can be extended to use different YOLO versions by modifying 
  * the model path and the corresponding detector class.
@@ -39,51 +62,95 @@
 // Include necessary headers
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/videoio.hpp>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <thread>
-#include <queue>
-#include <mutex>
-#include <atomic>
-#include <condition_variable>
+#include <memory>
+#include <vector>
 #include "det/YOLO.hpp"
-// Thread-safe queue implementation
-template <typename T>
-class SafeQueue {
-public:
-    SafeQueue() : q(), m(), c() {}
-
-    // Add an element to the queue.
-    void enqueue(T t) {
-        std::lock_guard<std::mutex> lock(m);
-        q.push(t);
-        c.notify_one();
-    }
-
-    // Get the first element from the queue.
-    bool dequeue(T& t) {
-        std::unique_lock<std::mutex> lock(m);
-        while (q.empty()) {
-            if (finished) return false;
-            c.wait(lock);
+#include "det/Tracker.hpp"
+#include "det/MotionGate.hpp"
+#include "tools/FramePool.hpp"
+#include "tools/Pipeline.hpp"
+#include "tools/RingQueue.hpp"
+
+#define YOLOS_CV_VERSION_AT_LEAST(major, minor, revision) \
+    (CV_VERSION_MAJOR * 10000 + CV_VERSION_MINOR * 100 + CV_VERSION_REVISION >= (major) * 10000 + (minor) * 100 + (revision))
+
+// cv::cudacodec::VideoWriter (NVENC) took its current form in OpenCV 4.7
+#if defined(YOLOS_WITH_CUDA) && defined(HAVE_OPENCV_CUDACODEC) && YOLOS_CV_VERSION_AT_LEAST(4, 7, 0)
+#define YOLOS_VIDEO_NVCODEC 1
+#include <opencv2/cudacodec.hpp>
+#endif
+
+// A frame travelling through the pipeline
+struct VideoFrame {
+    yolos::FrameLease image;
+    std::vector<Detection> detections;
+};
+
+#ifdef YOLOS_VIDEO_NVCODEC
+// A device-resident frame travelling through the NVDEC -> detect -> draw -> NVENC pipeline
+struct DeviceVideoFrame {
+    cv::cuda::GpuMat image;
+    std::vector<Detection> detections;
+};
+
+// Decodes with NVDEC, letterboxes, detects and draws on the device, and encodes with NVENC
+static void runDeviceVideo(const std::string &videoPath, const std::string &outputPath, double fps,
+                           std::vector<std::unique_ptr<YOLODetector>> &detectors, size_t drawWorkers, size_t maxInFlight) {
+    cv::Ptr<cv::cudacodec::VideoReader> reader = cv::cudacodec::createVideoReader(videoPath);
+    reader->set(cv::cudacodec::ColorFormat::BGRA);
+    cv::Ptr<cv::cudacodec::VideoWriter> writer;         // Created with the size of the first frame
+
+    // Device frames are recycled like the host FramePool buffers, so steady state does not allocate.
+    // A new frame is only allocated when no spare is left, so the spares never outnumber the window.
+    MpmcRingQueue<cv::cuda::GpuMat> spareFrames(maxInFlight + 2);
+    std::vector<std::unique_ptr<CudaBoxRenderer>> renderers;
+    for (size_t i = 0; i < drawWorkers; ++i) {
+        renderers.emplace_back(new CudaBoxRenderer());
+    }
+
+    yolos::Pipeline<DeviceVideoFrame, MpmcRingQueue> pipeline("decode", "encode");
+    pipeline.setMaxInFlight(maxInFlight);
+    pipeline.addStage("infer", detectors.size(), [&](DeviceVideoFrame &frame, size_t worker) {
+        frame.detections = detectors[worker]->detect(frame.image);
+    });
+    pipeline.addStage("draw", drawWorkers, [&](DeviceVideoFrame &frame, size_t worker) {
+        detectors.front()->drawBoundingBox(frame.image, frame.detections, *renderers[worker]);
+    });
+
+    cv::cuda::Stream decodeStream;
+    auto decode = [&](DeviceVideoFrame &frame) {
+        spareFrames.try_dequeue(frame.image);
+        if (!reader->nextFrame(frame.image, decodeStream)) {
+            return false;
         }
-        t = q.front();
-        q.pop();
+        decodeStream.waitForCompletion(); // The detector reads the frame on its own stream
         return true;
-    }
+    };
 
-    void setFinished() {
-        std::lock_guard<std::mutex> lock(m);
-        finished = true;
-        c.notify_all();
-    }
+    size_t written = 0;
+    auto encode = [&](DeviceVideoFrame &frame) {
+        if (!writer) {
+            writer = cv::cudacodec::createVideoWriter(outputPath, frame.image.size(), cv::cudacodec::Codec::H264, fps,
+                                                      cv::cudacodec::ColorFormat::BGRA);
+        }
+        writer->write(frame.image);
+        spareFrames.enqueue(std::move(frame.image));
+        if (++written % 300 == 0) {
+            pipeline.printStats();
+        }
+    };
 
-private:
-    std::queue<T> q;
-    mutable std::mutex m;
-    std::condition_variable c;
-    bool finished = false;
-};
+    pipeline.run(decode, encode);
+    pipeline.printStats();
+    if (writer) {
+        writer->release();
+    }
+}
+#endif
 
 int main(int argc, char* argv[])
 {
@@ -106,12 +173,37 @@ int main(int argc, char* argv[])
         labelsPath = argv[4];
     }
 
-    // Initialize the YOLO detector
+    // Initialize the YOLO detectors: one per infer worker, sharing the environment and the weights
     bool isGPU = true; // Set to false for CPU processing
-    YOLODetector detector(modelPath, labelsPath, isGPU);
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    size_t inferWorkers = isGPU ? 2 : std::max<size_t>(1, cores / 4);
+    if (argc > 5){
+        inferWorkers = std::max(1, std::stoi(argv[5]));
+    }
+    const std::string mode = argc > 6 ? argv[6] : "";
+    const bool track = mode == "track";
+    const bool motion = mode == "motion";
+    if (track || motion) {
+        inferWorkers = 1; // The tracker / background model sees the frames in stream order
+    }
+    const size_t drawWorkers = 2;
+
+    yolos::DetectorOptions options = yolos::DetectorOptions::fromUseGPU(isGPU);
+    options.intraOpThreads = static_cast<int>(std::max<size_t>(1, cores / inferWorkers)); // Split the cores between the workers
+    auto runtime = std::make_shared<yolos::SharedRuntime>();
+    std::vector<std::unique_ptr<YOLODetector>> detectors;
+    for (size_t i = 0; i < inferWorkers; ++i) {
+        detectors.emplace_back(new YOLODetector(modelPath, labelsPath, options, runtime));
+    }
+    TrackedStream trackedStream(*detectors.front());
+    MotionGatedStream motionGate(*detectors.front());
 
     // Open the video file
+#if YOLOS_CV_VERSION_AT_LEAST(4, 5, 2)
+    cv::VideoCapture cap(videoPath, cv::CAP_ANY, {cv::CAP_PROP_HW_ACCELERATION, cv::VIDEO_ACCELERATION_ANY});
+#else
     cv::VideoCapture cap(videoPath);
+#endif
     if (!cap.isOpened())
     {
         std::cerr << "Error: Could not open or find the video file!\n";
@@ -125,65 +217,97 @@ int main(int argc, char* argv[])
     int fourcc = static_cast<int>(cap.get(cv::CAP_PROP_FOURCC)); // Get codec of input video
 
     // Create a VideoWriter object to save the output video with the same codec
+#ifdef YOLOS_VIDEO_NVCODEC
+    if (mode == "nvdec") {
+        cap.release();
+        try {
+            runDeviceVideo(videoPath, outputPath, fps, detectors, drawWorkers, 2 * (inferWorkers + drawWorkers) + 8);
+            std::cout << "Video processing completed successfully." << std::endl;
+            return 0;
+        } catch (const std::exception &e) {
+            std::cerr << "NVDEC/NVENC path unavailable (" << e.what() << "), falling back to CPU decoding." << std::endl;
+        }
+#if YOLOS_CV_VERSION_AT_LEAST(4, 5, 2)
+        cap.open(videoPath, cv::CAP_ANY, {cv::CAP_PROP_HW_ACCELERATION, cv::VIDEO_ACCELERATION_ANY});
+#else
+        cap.open(videoPath);
+#endif
+        if (!cap.isOpened())
+        {
+            std::cerr << "Error: Could not reopen the video file for CPU decoding!\n";
+            return -1;
+        }
+    }
+#else
+    if (mode == "nvdec") {
+        std::cerr << "Built without CUDA or cv::cudacodec, using CPU decoding." << std::endl;
+    }
+#endif
+
+#if YOLOS_CV_VERSION_AT_LEAST(4, 5, 2)
+    cv::VideoWriter out(outputPath, cv::CAP_ANY, fourcc, fps, cv::Size(frameWidth, frameHeight),
+                        {cv::VIDEOWRITER_PROP_HW_ACCELERATION, cv::VIDEO_ACCELERATION_ANY});
+#else
     cv::VideoWriter out(outputPath, fourcc, fps, cv::Size(frameWidth, frameHeight), true);
+#endif
     if (!out.isOpened())
     {
         std::cerr << "Error: Could not open the output video file for writing!\n";
         return -1;
     }
 
-    // Thread-safe queues and processing...
-    // Thread-safe queues
-    SafeQueue<cv::Mat> frameQueue;
-    SafeQueue<std::pair<int, cv::Mat>> processedQueue;
-
-    // Flag to indicate processing completion
-    std::atomic<bool> processingDone(false);
+    // Every frame in flight holds one pooled buffer, so the pool never needs more than the pipeline window
+    const size_t maxInFlight = 2 * (inferWorkers + drawWorkers) + 8;
+    yolos::FramePool framePool(cv::Size(frameWidth, frameHeight), CV_8UC3, maxInFlight);
 
-
-    // Capture thread
-    std::thread captureThread([&]() {
-        cv::Mat frame;
-        int frameCount = 0;
-        while (cap.read(frame))
-        {
-            frameQueue.enqueue(frame.clone()); // Clone to ensure thread safety
-            frameCount++;
+    yolos::Pipeline<VideoFrame, MpmcRingQueue> pipeline("decode", "encode"); // Lock-free hand-offs between the stages
+    pipeline.setMaxInFlight(maxInFlight);
+    pipeline.addStage("infer", inferWorkers, [&](VideoFrame &frame, size_t worker) {
+        // Detect objects in the frame, or propagate the tracks on frames the scheduler skips
+        if (track) {
+            frame.detections = trackedStream.process(frame.image.mat());
+        } else if (motion) {
+            frame.detections = motionGate.process(frame.image.mat());
+        } else {
+            frame.detections = detectors[worker]->detect(frame.image.mat());
         }
-        frameQueue.setFinished();
+    });
+    pipeline.addStage("draw", drawWorkers, [&](VideoFrame &frame, size_t) {
+        // Draw bounding boxes on the frame
+        detectors.front()->drawBoundingBoxMask(frame.image.mat(), frame.detections);
     });
 
-    // Processing thread
-    std::thread processingThread([&]() {
-        cv::Mat frame;
-        int frameIndex = 0;
-        while (frameQueue.dequeue(frame))
-        {
-            // Detect objects in the frame
-            std::vector<Detection> results = detector.detect(frame);
-
-            // Draw bounding boxes on the frame
-            detector.drawBoundingBoxMask(frame, results); // Uncomment for mask drawing
+    // Decode straight into a pooled buffer; it goes back to the pool once the frame is encoded
+    auto decode = [&](VideoFrame &frame) {
+        frame.image = framePool.acquire();
+        return cap.read(frame.image.mat());
+    };
 
-            // Enqueue the processed frame
-            processedQueue.enqueue(std::make_pair(frameIndex++, frame));
+    size_t written = 0;
+    auto encode = [&](VideoFrame &frame) {
+        out.write(frame.image.mat());
+        if (++written % 300 == 0) {
+            pipeline.printStats();
         }
-        processedQueue.setFinished();
-    });
+    };
 
-    // Writing thread
-    std::thread writingThread([&]() {
-        std::pair<int, cv::Mat> processedFrame;
-        while (processedQueue.dequeue(processedFrame))
-        {
-            out.write(processedFrame.second);
-        }
-    });
-
-    // Wait for all threads to finish
-    captureThread.join();
-    processingThread.join();
-    writingThread.join();
+    try {
+        pipeline.run(decode, encode);
+    } catch (const std::exception &e) {
+        std::cerr << "Error: Video processing failed: " << e.what() << std::endl;
+        return -1;
+    }
+    pipeline.printStats();
+    std::cout << "Frame buffers allocated: " << framePool.allocations() << std::endl;
+    if (track) {
+        std::cout << "Frames detected: " << trackedStream.schedule().detected()
+                  << ", tracked only: " << trackedStream.schedule().skipped() << std::endl;
+    }
+    if (motion) {
+        std::cout << "Frames detected in full: " << motionGate.fullFrameCount()
+                  << ", on changed regions: " << motionGate.regionFrameCount()
+                  << ", unchanged: " << motionGate.idleFrameCount() << std::endl;
+    }
 
     // Release resources
     cap.release();
@@ -193,4 +317,4 @@ int main(int argc, char* argv[])
     std::cout << "Video processing completed successfully." << std::endl;
 
     return 0;
-}
\ No newline at end of file
+}